@@ -21,6 +21,7 @@ namespace Echo
 		REGISTER_MODULE(AIModule)
 		REGISTER_MODULE(LightModule)
 		REGISTER_MODULE(ModelModule)
+		REGISTER_MODULE(OpenCrgModule)
 		REGISTER_MODULE(OpenDriveModule)
 		REGISTER_MODULE(OpenLabelModule)
 		REGISTER_MODULE(PhysxModule)
@@ -826,7 +826,9 @@ namespace Studio
 	{
 		Echo::i32 fps = Echo::FrameState::instance()->getFps();
 		Echo::i32 drawcall = Echo::FrameState::instance()->getDrawCalls();
-		statusBar()->showMessage(Echo::StringUtil::Format("Fps:%d Drawcall:%d", fps, drawcall).c_str());
+		Echo::i32 scriptCalls = Echo::FrameState::instance()->getScriptCalls();
+		float scriptTime = Echo::FrameState::instance()->getScriptMicroseconds() * 0.001f;
+		statusBar()->showMessage(Echo::StringUtil::Format("Fps:%d Drawcall:%d Script:%d calls %.2fms", fps, drawcall, scriptCalls, scriptTime).c_str());
 
 		hideWhiteLineOfQTabBar();
 	}
@@ -723,7 +723,7 @@ namespace Studio
 
 	void NodeTreePanel::importGltfScene()
 	{
-		Echo::String gltfFile = ResChooseDialog::getSelectingFile(this, ".gltf");
+		Echo::String gltfFile = ResChooseDialog::getSelectingFile(this, ".gltf|.glb");
 		if (!gltfFile.empty())
 		{
 			Echo::GltfResPtr asset = (Echo::GltfRes*)Echo::Res::get( gltfFile);
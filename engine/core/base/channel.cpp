@@ -1,9 +1,22 @@
 #include "channel.h"
+#include "channel_expression.h"
 #include "engine/core/script/lua/lua_binder.h"
+#include "engine/core/scene/node.h"
 #include "object.h"
+#include "engine/core/main/frame_state.h"
+#include "engine/core/util/Timer.h"
+#include "engine/core/log/Log.h"
 
 namespace Echo
 {
+    // channels with a native expression or a sync function, in dependency order
+    static vector<Channel*>::type g_syncChannels;
+    static bool g_isOrderDirty = false;
+
+    // sort states kept in m_syncIdx
+    static const i32 SortUnvisited = -2;
+    static const i32 SortVisiting = -3;
+
     Channel::Channel(Object* owner, const String& name, const String& expression)
         : m_owner(owner)
         , m_name(name)
@@ -13,41 +26,178 @@ namespace Echo
         static i32 id = 0;
         m_id = id++;
         
-        // register to lua
-        registerToLua();
+        m_property = Class::getProperty(m_owner, m_name);
+        if (m_property)
+        {
+            // native first, lua for what tinyexpr can't parse
+            if (!compileNative())
+                registerToLua();
+
+            if (m_native || m_functionRef)
+            {
+                m_syncIdx = i32(g_syncChannels.size());
+                g_syncChannels.push_back(this);
+                g_isOrderDirty = true;
+            }
+        }
+        else
+        {
+            EchoLogError("Channel property [%s] doesn't exist", m_name.c_str());
+        }
     }
     
     Channel::~Channel()
     {
+        if (m_syncIdx >= 0)
+        {
+            // swap with the last one, syncs don't create or delete channels
+            Channel* last = g_syncChannels.back();
+            last->m_syncIdx = m_syncIdx;
+            g_syncChannels[m_syncIdx] = last;
+            g_syncChannels.pop_back();
+            m_syncIdx = -1;
+            g_isOrderDirty = true;
+        }
+
+        EchoSafeDelete(m_native, ChannelExpression);
         unregisterFromLua();
     }
+
+    bool Channel::compileNative()
+    {
+        // references are resolved from the owner node
+        if (!ECHO_DOWN_CAST<Node*>(m_owner) && m_expression.find("ch") != String::npos)
+            return false;
+
+        m_native = EchoNew(ChannelExpression);
+        if (m_native->compile(m_expression))
+        {
+            bool isScalar = m_property->m_type == Variant::Type::Bool || m_property->m_type == Variant::Type::Int || m_property->m_type == Variant::Type::UInt || m_property->m_type == Variant::Type::Real;
+            if (isScalar || m_native->isPassthrough())
+                return true;
+        }
+
+        EchoSafeDelete(m_native, ChannelExpression);
+        return false;
+    }
     
     void Channel::registerToLua()
     {
         String getExpression = StringUtil::Replace(m_expression, "ch(", StringUtil::Format("objs._%d:ch(", m_owner->getId()));
-        PropertyInfoStatic* propertyInfo = ECHO_DOWN_CAST<PropertyInfoStatic*>(Class::getProperty(m_owner, m_name));
+        PropertyInfoStatic* propertyInfo = ECHO_DOWN_CAST<PropertyInfoStatic*>(m_property);
         if(propertyInfo)
         {
+            // lua channels read through the owner's script object
+            m_owner->registerToScript();
+
             String luaStr = StringUtil::Format
             (
-                "channels._%d = function()\n"\
+                "return function()\n"\
                 "    local result = %s\n"\
                 "    objs._%d:%s(result)\n"\
-                "end\n", m_id, getExpression.c_str(), m_owner->getId(), propertyInfo->m_setter.c_str()
+                "end\n", getExpression.c_str(), m_owner->getId(), propertyInfo->m_setter.c_str()
              );
             
-            LuaBinder::instance()->execString(luaStr);
+            m_functionRef = LuaBinder::instance()->execStringRef(luaStr);
         }
     }
     
     void Channel::unregisterFromLua()
     {
-        String luaStr = StringUtil::Format("channels._%d = nil", m_id);
-        LuaBinder::instance()->execString(luaStr);
+        LuaBinder::instance()->unref(m_functionRef);
+    }
+
+    void Channel::resolveNative()
+    {
+        if (m_native->resolve(ECHO_DOWN_CAST<Node*>(m_owner)))
+        {
+            m_isSynced = false;
+            g_isOrderDirty = true;
+        }
+    }
+
+    bool Channel::syncNative()
+    {
+        if (!m_native->isResolved())
+            return false;
+
+        if (!m_native->readInputs() && m_isSynced)
+            return false;
+
+        Variant value;
+        if (m_native->isResolved() && m_native->evaluate(m_property->m_type, value))
+        {
+            m_property->setPropertyValue(m_owner, m_name, value);
+            m_isSynced = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    void Channel::sortVisit(const map<String, Channel*>::type& producers, vector<Channel*>::type& sorted)
+    {
+        if (m_syncIdx != SortUnvisited)
+            return;
+
+        m_syncIdx = SortVisiting;
+        if (m_native)
+        {
+            for (const ChannelExpression::Input& input : m_native->getInputs())
+            {
+                map<String, Channel*>::type::const_iterator it = producers.find(StringUtil::Format("%d/%s", input.m_objectId, input.m_propertyName.c_str()));
+                if (it != producers.end())
+                    it->second->sortVisit(producers, sorted);
+            }
+        }
+
+        // a channel still visiting here is part of a cycle, it keeps its place
+        m_syncIdx = i32(sorted.size());
+        sorted.push_back(this);
+    }
+
+    void Channel::sortAll()
+    {
+        map<String, Channel*>::type producers;
+        for (Channel* channel : g_syncChannels)
+        {
+            producers[StringUtil::Format("%d/%s", channel->m_owner->getId(), channel->m_name.c_str())] = channel;
+            channel->m_syncIdx = SortUnvisited;
+        }
+
+        vector<Channel*>::type sorted;
+        sorted.reserve(g_syncChannels.size());
+        for (Channel* channel : g_syncChannels)
+            channel->sortVisit(producers, sorted);
+
+        g_syncChannels.swap(sorted);
+        g_isOrderDirty = false;
     }
     
     void Channel::syncAll()
     {
-        LuaBinder::instance()->execString("update_all_channels()", true);
+        ui64 startTime = Time::instance()->getMicroseconds();
+
+        // resolved before sorting, the order depends on the nodes read
+        for (Channel* channel : g_syncChannels)
+        {
+            if (channel->m_native && !channel->m_native->isResolved())
+                channel->resolveNative();
+        }
+
+        if (g_isOrderDirty)
+            sortAll();
+
+        // native channels only run when an input changed, lua ones every frame
+        ui32 calls = 0;
+        for (Channel* channel : g_syncChannels)
+        {
+            if (channel->m_native)
+                calls += channel->syncNative() ? 1 : 0;
+            else
+                calls += LuaBinder::instance()->callRef(channel->m_functionRef, 0) ? 1 : 0;
+        }
+
+        FrameState::instance()->addScriptCalls(calls, ui32(Time::instance()->getMicroseconds() - startTime));
     }
 }
@@ -6,10 +6,12 @@
 namespace Echo
 {
     class Object;
+    class ChannelExpression;
+    struct PropertyInfo;
     class Channel
     {
     public:
-        // sync all
+        // sync all, in dependency order
         static void syncAll();
         
     public:
@@ -23,15 +25,33 @@ namespace Echo
         const String& getExpression() const { return m_expression; }
         
     private:
+        // compile natively, false when the expression needs lua
+        bool compileNative();
+        
         // register to lua
         void registerToLua();
         void unregisterFromLua();
         
+        // find the nodes the native expression reads, they may be attached after the channel was loaded
+        void resolveNative();
+
+        // evaluate native expression if any input changed, returns whether it was evaluated
+        bool syncNative();
+        
+        // sort sync list so that channels run after the channels they read from
+        static void sortAll();
+        void sortVisit(const map<String, Channel*>::type& producers, vector<Channel*>::type& sorted);
+        
     protected:
-        i32         m_id = 0;
-        Object*     m_owner = nullptr;
-        String      m_name;
-        String      m_expression;
+        i32                 m_id = 0;
+        Object*             m_owner = nullptr;
+        String              m_name;
+        String              m_expression;
+        PropertyInfo*       m_property = nullptr;   // output property
+        ChannelExpression*  m_native = nullptr;     // compiled expression, nullptr for lua channels
+        bool                m_isSynced = false;     // output written since the inputs were resolved
+        i32                 m_functionRef = 0;      // lua registry reference of the sync function
+        i32                 m_syncIdx = -1;         // slot in the sync list
     };
     typedef std::vector<Channel*>* ChannelsPtr;
 }
@@ -0,0 +1,264 @@
+#include "channel_expression.h"
+#include "class.h"
+#include "engine/core/scene/node.h"
+#include "engine/core/log/Log.h"
+#include <thirdparty/tinyexpr/tinyexpr.h>
+
+namespace Echo
+{
+	static bool IsIdentifier(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+	}
+
+	static const char* SkipSpaces(const char* p)
+	{
+		while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+			p++;
+
+		return p;
+	}
+
+	// quoted string, returns the position after it or nullptr
+	static const char* ParseString(const char* p, String& result)
+	{
+		char quote = *p;
+		if (quote != '"' && quote != '\'')
+			return nullptr;
+
+		const char* end = strchr(p + 1, quote);
+		if (!end)
+			return nullptr;
+
+		result.assign(p + 1, end);
+		return end + 1;
+	}
+
+	// ch("path", "property") with an optional component, returns the position after it or nullptr
+	static const char* ParseReference(const char* p, ChannelExpression::Input& input)
+	{
+		p = SkipSpaces(p + 2);
+		if (*p != '(')
+			return nullptr;
+
+		p = ParseString(SkipSpaces(p + 1), input.m_path);
+		if (!p)
+			return nullptr;
+
+		p = SkipSpaces(p);
+		if (*p != ',')
+			return nullptr;
+
+		p = ParseString(SkipSpaces(p + 1), input.m_propertyName);
+		if (!p)
+			return nullptr;
+
+		p = SkipSpaces(p);
+		if (*p != ')')
+			return nullptr;
+
+		p++;
+		const char* component = SkipSpaces(p);
+		if (*component == '.' && !IsIdentifier(component[2]))
+		{
+			static const char* names = "xyzwrgba";
+			const char* name = component[1] ? strchr(names, component[1]) : nullptr;
+			if (name)
+			{
+				input.m_component = i32(name - names) % 4;
+				p = component + 2;
+			}
+		}
+
+		return p;
+	}
+
+	// numeric components of a value, 0 for types without any
+	static i32 ReadComponents(const Variant& value, double* result)
+	{
+		switch (value.getType())
+		{
+		case Variant::Type::Bool:		result[0] = value.toBool() ? 1.0 : 0.0;	return 1;
+		case Variant::Type::Int:		result[0] = value.toI32();				return 1;
+		case Variant::Type::UInt:		result[0] = value.toUI32();				return 1;
+		case Variant::Type::Real:		result[0] = value.toDouble();			return 1;
+		case Variant::Type::Vector2:
+		{
+			const Vector2& v = value.toVector2();
+			result[0] = v.x; result[1] = v.y;
+			return 2;
+		}
+		case Variant::Type::Vector3:
+		{
+			const Vector3& v = value.toVector3();
+			result[0] = v.x; result[1] = v.y; result[2] = v.z;
+			return 3;
+		}
+		case Variant::Type::Vector4:
+		{
+			const Vector4& v = value.toVector4();
+			result[0] = v.x; result[1] = v.y; result[2] = v.z; result[3] = v.w;
+			return 4;
+		}
+		case Variant::Type::Quaternion:
+		{
+			const Quaternion& q = value.toQuaternion();
+			result[0] = q.x; result[1] = q.y; result[2] = q.z; result[3] = q.w;
+			return 4;
+		}
+		case Variant::Type::Color:
+		{
+			const Color& c = value.toColor();
+			result[0] = c.r; result[1] = c.g; result[2] = c.b; result[3] = c.a;
+			return 4;
+		}
+		default:
+			return 0;
+		}
+	}
+
+	ChannelExpression::ChannelExpression()
+	{
+	}
+
+	ChannelExpression::~ChannelExpression()
+	{
+		te_free(m_expr);
+	}
+
+	bool ChannelExpression::compile(const String& expression)
+	{
+		// replace references by variables, the same reference twice is one input
+		String source;
+		const char* p = expression.c_str();
+		while (*p)
+		{
+			if (p[0] == 'c' && p[1] == 'h' && (p == expression.c_str() || !IsIdentifier(p[-1])) && !IsIdentifier(p[2]))
+			{
+				Input input;
+				const char* end = ParseReference(p, input);
+				if (!end)
+					return false;
+
+				size_t idx = 0;
+				while (idx < m_inputs.size() && !(m_inputs[idx].m_path == input.m_path && m_inputs[idx].m_propertyName == input.m_propertyName && m_inputs[idx].m_component == input.m_component))
+					idx++;
+
+				if (idx == m_inputs.size())
+					m_inputs.emplace_back(input);
+
+				source += StringUtil::Format(" ch_%d ", i32(idx));
+				p = end;
+			}
+			else
+			{
+				source += *p++;
+			}
+		}
+
+		// tinyexpr's ^ is left associative and binds looser than unary minus, % is fmod. Lua
+		// evaluates these differently, so they stay there
+		if (source.find_first_of("^%") != String::npos)
+			return false;
+
+		String trimmed = source;
+		StringUtil::Trim(trimmed);
+		m_isPassthrough = m_inputs.size() == 1 && m_inputs[0].m_component < 0 && trimmed == "ch_0";
+
+		StringArray names(m_inputs.size());
+		vector<te_variable>::type variables(m_inputs.size());
+		m_variables.assign(m_inputs.size(), 0.0);
+		for (size_t i = 0; i < m_inputs.size(); i++)
+		{
+			names[i] = StringUtil::Format("ch_%d", i32(i));
+			variables[i] = { names[i].c_str(), &m_variables[i], TE_VARIABLE, nullptr };
+		}
+
+		int error = 0;
+		m_expr = te_compile(source.c_str(), variables.data(), i32(variables.size()), &error);
+		return m_expr != nullptr;
+	}
+
+	bool ChannelExpression::resolve(Node* owner)
+	{
+		m_isResolved = true;
+		for (Input& input : m_inputs)
+		{
+			if (input.m_objectId < 0)
+			{
+				Node* source = owner ? owner->getNode(input.m_path.c_str()) : nullptr;
+				PropertyInfo* property = source ? Class::getProperty(source, input.m_propertyName) : nullptr;
+				if (property)
+				{
+					input.m_objectId = source->getId();
+					input.m_property = property;
+					input.m_valueCount = -1;
+				}
+				else
+				{
+					m_isResolved = false;
+				}
+			}
+		}
+
+		return m_isResolved;
+	}
+
+	bool ChannelExpression::readInputs()
+	{
+		bool isChanged = false;
+		for (size_t i = 0; i < m_inputs.size(); i++)
+		{
+			Input& input = m_inputs[i];
+			Object* source = Object::getById(input.m_objectId);
+			if (!source)
+			{
+				input.m_objectId = -1;
+				m_isResolved = false;
+				continue;
+			}
+
+			Variant value;
+			input.m_property->getPropertyValue(source, input.m_propertyName, value);
+
+			double values[4];
+			i32 count = ReadComponents(value, values);
+			bool isInputChanged = count == 0 || count != input.m_valueCount;
+			for (i32 c = 0; c < count && !isInputChanged; c++)
+				isInputChanged = values[c] != input.m_values[c];
+
+			if (isInputChanged)
+			{
+				input.m_valueCount = count;
+				for (i32 c = 0; c < count; c++)
+					input.m_values[c] = values[c];
+
+				input.m_value = value;
+				m_variables[i] = input.m_component < count ? values[std::max<i32>(input.m_component, 0)] : 0.0;
+
+				isChanged = true;
+			}
+		}
+
+		return isChanged;
+	}
+
+	bool ChannelExpression::evaluate(Variant::Type type, Variant& result) const
+	{
+		if (m_isPassthrough && m_inputs[0].m_value.getType() == type)
+		{
+			result = m_inputs[0].m_value;
+			return true;
+		}
+
+		double value = te_eval(m_expr);
+		switch (type)
+		{
+		case Variant::Type::Bool:	result = Variant(value != 0.0);					return true;
+		case Variant::Type::Int:	result = Variant(i32(value));					return true;
+		case Variant::Type::UInt:	result = Variant(ui32(std::max<double>(value, 0.0)));	return true;
+		case Variant::Type::Real:	result = Variant(value);						return true;
+		default:					return false;
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "variant.h"
+
+struct te_expr;
+
+namespace Echo
+{
+	struct PropertyInfo;
+	class Node;
+
+	// Channel expression compiled once. Every ch("path", "property") reference, optionally
+	// followed by a component .x .y .z .w, becomes an input read through the property info of
+	// the referenced node, the arithmetic around the inputs is compiled by tinyexpr. A single
+	// reference without anything around it copies the value when the types match. Expressions
+	// with ^ or % don't compile, tinyexpr and lua disagree on their results
+	class ChannelExpression
+	{
+	public:
+		struct Input
+		{
+			String			m_path;
+			String			m_propertyName;
+			i32				m_component = -1;		// -1 for the whole value
+			i32				m_objectId = -1;		// resolved handle, -1 until the node exists
+			PropertyInfo*	m_property = nullptr;
+			Variant			m_value;				// last read
+			double			m_values[4] = { 0.0, 0.0, 0.0, 0.0 };
+			i32				m_valueCount = -1;		// numeric components of the last read, -1 before the first one
+		};
+		typedef vector<Input>::type InputArray;
+
+	public:
+		ChannelExpression();
+		~ChannelExpression();
+
+		// parse and compile, false when the expression isn't supported natively
+		bool compile(const String& expression);
+
+		// find the referenced nodes and properties, false while some don't exist yet
+		bool resolve(Node* owner);
+		bool isResolved() const { return m_isResolved; }
+
+		// read all inputs, returns whether any changed since the last read. Inputs whose node
+		// was freed are unresolved again
+		bool readInputs();
+
+		// evaluate to a value of the type, anything but a copy has to be a scalar
+		bool evaluate(Variant::Type type, Variant& result) const;
+
+		// inputs
+		const InputArray& getInputs() const { return m_inputs; }
+
+		// a single reference copied as is
+		bool isPassthrough() const { return m_isPassthrough; }
+
+	private:
+		InputArray					m_inputs;
+		vector<double>::type		m_variables;			// bound to the tinyexpr variables, one per input
+		te_expr*					m_expr = nullptr;
+		bool						m_isPassthrough = false;
+		bool						m_isResolved = false;
+	};
+}
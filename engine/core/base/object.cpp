@@ -93,6 +93,7 @@ namespace Echo
         {
             String globalTableName = StringUtil::Format("objs._%d", this->getId());
             LuaBinder::instance()->registerObject(getClassName(), globalTableName.c_str(), this);
+            m_scriptRef = LuaBinder::instance()->getGlobalRef(globalTableName);
 
             m_registeredToScript = true;
         }
@@ -104,6 +105,7 @@ namespace Echo
         {
             String luaStr = StringUtil::Format("objs._%d = nil", getId());
             LuaBinder::instance()->execString(luaStr);
+            LuaBinder::instance()->unref(m_scriptRef);
         }
     }
 
@@ -163,9 +165,6 @@ namespace Echo
     
     bool Object::registerChannel(const String& propertyName, const String& expression)
     {
-        // channel depends on lua
-        registerToScript();
-        
 		if (!m_chanels)
 			m_chanels = new std::vector<Channel*>;
 		else
@@ -34,6 +34,7 @@ namespace Echo
         
         // register to script
         bool isRegisteredToScript() { return m_registeredToScript; }
+        i32 getScriptRef() const { return m_scriptRef; }
         virtual void registerToScript();
         virtual void unregisterFromScript();
 
@@ -118,5 +119,6 @@ namespace Echo
 		PropertyInfos	m_propertys;
         ChannelsPtr     m_chanels = nullptr;
         bool			m_registeredToScript = false;
+        i32				m_scriptRef = 0;			// lua registry reference of the object table
 	};
 }
@@ -23,6 +23,7 @@ namespace Echo
 
 		m_nearZ = near;
 		m_farZ = far;
+		m_isOrtho = false;
 
 		m_flags.set();
 	}
@@ -37,6 +38,7 @@ namespace Echo
 
 		m_nearZ = near;
 		m_farZ = far;
+		m_isOrtho = true;
 
 		m_flags.set();
 	}
@@ -191,4 +193,11 @@ namespace Echo
 
 		return true;
 	}
+
+	float Frustum::getScreenCoverage(const Vector3& center, float radius) const
+	{
+		// half height of the view at the distance of the center
+		float halfHeight = m_isOrtho ? m_upFactorNear * m_nearZ : std::max<float>((center - m_eyePosition).dot(m_forward), m_nearZ) * m_upFactorNear;
+		return halfHeight > 0.f ? radius / halfHeight : 1.f;
+	}
 }
\ No newline at end of file
@@ -53,6 +53,9 @@ namespace Echo
 		// is aabb in this frustm
 		bool  isAABBIn(const Vector3& minPoint, const Vector3& maxPoint) const;
 
+		// radius of a sphere over the half view height at its distance, 1 fills the view
+		float getScreenCoverage(const Vector3& center, float radius) const;
+
 	private:
 		Vector3					m_eyePosition;
 		Vector3					m_forward;
@@ -64,6 +67,7 @@ namespace Echo
 		float					m_upFactorFar;
 		float					m_nearZ;
 		float					m_farZ;
+		bool					m_isOrtho = false;
 		mutable Vector3			m_vertexes[8];
 		mutable AABB			m_aabb;
 		mutable array<Plane, 6>	m_planes;
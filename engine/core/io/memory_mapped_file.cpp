@@ -0,0 +1,104 @@
+#include "memory_mapped_file.h"
+#include "IO.h"
+#include "engine/core/log/Log.h"
+
+#ifdef ECHO_PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace Echo
+{
+    MemoryMappedFile::MemoryMappedFile()
+    {
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        close();
+    }
+
+    bool MemoryMappedFile::open(const String& file, Access access)
+    {
+        close();
+
+        // files inside packages can't be mapped
+        String fullPath = IO::instance()->convertResPathToFullPath(file);
+
+#ifdef ECHO_PLATFORM_WINDOWS
+        HANDLE handle = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (handle != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER size;
+            if (GetFileSizeEx(handle, &size) && size.QuadPart > 0)
+            {
+                HANDLE mapping = CreateFileMappingA(handle, nullptr, access == Access::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+                if (mapping)
+                {
+                    void* data = MapViewOfFile(mapping, access == Access::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+                    if (data)
+                    {
+                        m_file = handle;
+                        m_mapping = mapping;
+                        m_data = static_cast<Byte*>(data);
+                        m_size = static_cast<size_t>(size.QuadPart);
+
+                        return true;
+                    }
+
+                    CloseHandle(mapping);
+                }
+            }
+
+            CloseHandle(handle);
+        }
+#else
+        int handle = ::open(fullPath.c_str(), O_RDONLY);
+        if (handle != -1)
+        {
+            struct stat info;
+            if (fstat(handle, &info) == 0 && info.st_size > 0)
+            {
+                int protect = access == Access::CopyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+                void* data = mmap(nullptr, info.st_size, protect, MAP_PRIVATE, handle, 0);
+                if (data != MAP_FAILED)
+                {
+                    m_file = handle;
+                    m_data = static_cast<Byte*>(data);
+                    m_size = static_cast<size_t>(info.st_size);
+
+                    return true;
+                }
+            }
+
+            ::close(handle);
+        }
+#endif
+
+        EchoLogWarning("MemoryMappedFile::open failed [%s]", file.c_str());
+        return false;
+    }
+
+    void MemoryMappedFile::close()
+    {
+#ifdef ECHO_PLATFORM_WINDOWS
+        if (m_data)     UnmapViewOfFile(m_data);
+        if (m_mapping)  CloseHandle(m_mapping);
+        if (m_file)     CloseHandle(m_file);
+
+        m_mapping = nullptr;
+        m_file = nullptr;
+#else
+        if (m_data)     munmap(m_data, m_size);
+        if (m_file!=-1) ::close(m_file);
+
+        m_file = -1;
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "engine/core/util/StringUtil.h"
+
+namespace Echo
+{
+    // Maps a file into the address space, pages are loaded by the os on first touch
+    class MemoryMappedFile
+    {
+    public:
+        enum class Access
+        {
+            ReadOnly,
+            CopyOnWrite,        // writes go to private pages and never reach the file
+        };
+
+    public:
+        MemoryMappedFile();
+        ~MemoryMappedFile();
+
+        // open by res path or full path
+        bool open(const String& file, Access access = Access::ReadOnly);
+        void close();
+
+        // is open
+        bool isOpen() const { return m_data != nullptr; }
+
+        // get data
+        template <typename T> T getData() const { return reinterpret_cast<T>(m_data); }
+
+        // get size
+        size_t getSize() const { return m_size; }
+
+    private:
+        Byte*       m_data = nullptr;
+        size_t      m_size = 0;
+#ifdef ECHO_PLATFORM_WINDOWS
+        void*       m_file = nullptr;
+        void*       m_mapping = nullptr;
+#else
+        int         m_file = -1;
+#endif
+    };
+}
@@ -328,6 +328,7 @@ namespace Echo
 		// update logic
 		Module::updateAll(m_frameTime);
 		NodeTree::instance()->update(m_frameTime);
+		Module::lateUpdateAll(m_frameTime);
 
 		// render
 		RenderScene::renderAll();
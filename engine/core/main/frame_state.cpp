@@ -18,12 +18,16 @@ namespace Echo
     void FrameState::bindMethods()
     {
         CLASS_BIND_METHOD(FrameState, getFps);
+        CLASS_BIND_METHOD(FrameState, getScriptCalls);
+        CLASS_BIND_METHOD(FrameState, getScriptMicroseconds);
     }
 
     void FrameState::reset()
     {
         m_triangleNum = 0;
         m_drawCallTimes = 0;
+        m_scriptCalls = 0;
+        m_scriptMicroseconds = 0;
     }
 
     void FrameState::tick(float elapsedTime)
@@ -49,6 +49,12 @@ namespace Echo
         void increaseDrawCalls() { m_drawCallTimes++; }
         ui32 getDrawCalls() const { return m_drawCallTimes; }
         
+        // script calls from the engine and their time, the difference to the time spent in the
+        // scripts themselves is the dispatch overhead
+        void addScriptCalls(ui32 calls, ui32 microseconds) { m_scriptCalls += calls; m_scriptMicroseconds += microseconds; }
+        ui32 getScriptCalls() const { return m_scriptCalls; }
+        ui32 getScriptMicroseconds() const { return m_scriptMicroseconds; }
+        
         // get current time
         const ui32& getCurrentTime() const { return m_currentTime; }
         float* getCurrentTimeSecondsPtr() { return &m_currentTimeSeconds; }
@@ -66,5 +72,7 @@ namespace Echo
         ui32    m_triangleNum = 0;
 		ui32	m_rendertargetSize = 0;
 		ui32	m_drawCallTimes = 0;
+		ui32	m_scriptCalls = 0;
+		ui32	m_scriptMicroseconds = 0;
 	};
 }
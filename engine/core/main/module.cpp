@@ -87,4 +87,15 @@ namespace Echo
 			}
 		}
 	}
+
+	void Module::lateUpdateAll(float elapsedTime)
+	{
+		if (g_modules)
+		{
+			for (Module* module : *g_modules)
+			{
+				module->lateUpdate(elapsedTime);
+			}
+		}
+	}
 }
@@ -32,6 +32,9 @@ namespace Echo
         // update this module
 		virtual void update(float elapsedTime) {}
 
+		// update after node tree, before render
+		virtual void lateUpdate(float elapsedTime) {}
+
 		// enable
 		virtual void setEnable(bool isEnable) { m_isEnable = isEnable; }
 		bool isEnable() const { return m_isEnable; }
@@ -57,6 +60,9 @@ namespace Echo
 
 		// update all modules every frame(ms)
 		static void updateAll(float elapsedTime);
+
+		// late update all modules every frame(ms)
+		static void lateUpdateAll(float elapsedTime);
         
         // clear all
         static void clear();
@@ -9,6 +9,42 @@
 
 namespace Echo
 {
+	// a coarser level is only taken once the coverage is this far below its threshold
+	static const float LodHysteresis = 0.8f;
+
+	// octahedral mapping of a unit vector to 2 bytes
+	static void EncodeOctahedral(const Vector3& normal, Byte* result)
+	{
+		float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		float u = sum > 0.f ? normal.x / sum : 0.f;
+		float v = sum > 0.f ? normal.y / sum : 0.f;
+		if (normal.z < 0.f)
+		{
+			float foldU = (1.f - std::abs(v)) * (u >= 0.f ? 1.f : -1.f);
+			float foldV = (1.f - std::abs(u)) * (v >= 0.f ? 1.f : -1.f);
+			u = foldU;
+			v = foldV;
+		}
+
+		result[0] = Byte(Math::Clamp(u * 0.5f + 0.5f, 0.f, 1.f) * 255.f + 0.5f);
+		result[1] = Byte(Math::Clamp(v * 0.5f + 0.5f, 0.f, 1.f) * 255.f + 0.5f);
+	}
+
+	static Vector3 DecodeOctahedral(const Byte* data)
+	{
+		float u = data[0] / 255.f * 2.f - 1.f;
+		float v = data[1] / 255.f * 2.f - 1.f;
+		Vector3 normal(u, v, 1.f - std::abs(u) - std::abs(v));
+		if (normal.z < 0.f)
+		{
+			normal.x = (1.f - std::abs(v)) * (u >= 0.f ? 1.f : -1.f);
+			normal.y = (1.f - std::abs(u)) * (v >= 0.f ? 1.f : -1.f);
+		}
+
+		normal.normalize();
+		return normal;
+	}
+
 	Mesh* Mesh::create(bool isDynamicVertexBuffer, bool isDynamicIndicesBuffer)
 	{
 		return EchoNew(Mesh(isDynamicVertexBuffer, isDynamicIndicesBuffer));
@@ -97,6 +133,7 @@ namespace Echo
 	{
 		m_indices.clear();
 		m_indices.shrink_to_fit();
+		m_lods.clear();
 
 		EchoSafeDelete(m_vertexBuffer, GPUBuffer);
 		EchoSafeDelete(m_indexBuffer, GPUBuffer);
@@ -167,7 +204,7 @@ namespace Echo
 
 	void Mesh::buildIndexBuffer()
 	{
-		Buffer indexBuff(m_idxCount*m_idxStride, m_indices.data());
+		Buffer indexBuff(ui32(m_indices.size()), m_indices.data());
 		if (m_isDynamicIndicesBuffer)
 		{
 			if (!m_indexBuffer)
@@ -208,6 +245,7 @@ namespace Echo
 		// load indices
 		m_idxCount = indicesCount;
 		m_idxStride = indicesStride;
+		m_lods.clear();
 		if (m_idxCount)
 		{
 			const Byte* indicesInByte = (const Byte*)indices;
@@ -218,6 +256,39 @@ namespace Echo
 		}
 	}
 
+	void Mesh::updateLods(const MeshLodArray& lods, ui32 indicesCount, const void* indices)
+	{
+		// lods follow the indices of the mesh in the same buffer
+		m_indices.resize(m_idxCount * m_idxStride);
+		m_lods = lods;
+		for (MeshLod& lod : m_lods)
+			lod.m_startIndex += m_idxCount;
+
+		if (indicesCount)
+		{
+			const Byte* indicesInByte = (const Byte*)indices;
+			m_indices.insert(m_indices.end(), indicesInByte, indicesInByte + indicesCount * m_idxStride);
+		}
+
+		if (!m_indices.empty())
+			buildIndexBuffer();
+	}
+
+	i32 Mesh::selectLod(float coverage, i32 currentLod) const
+	{
+		i32 lod = 0;
+		for (i32 i = 0; i < i32(m_lods.size()); i++)
+		{
+			float threshold = m_lods[i].m_coverage * (i + 1 > currentLod ? LodHysteresis : 1.f);
+			if (coverage >= threshold)
+				break;
+
+			lod = i + 1;
+		}
+
+		return lod;
+	}
+
 	void Mesh::updateVertexs(const MeshVertexFormat& format, ui32 vertCount, const Byte* vertices)
 	{
 		m_vertData.set(format, vertCount);
@@ -252,6 +323,19 @@ namespace Echo
 		buildVertexBuffer();
 	}
 
+	ui32 Mesh::getSaveSize() const
+	{
+		const MeshVertexFormat& format = m_vertData.getFormat();
+		ui32 vertexSize = m_isQuantize ? sizeof(ui16) * 3 : sizeof(Vector3);
+		if (format.m_isUseNormal)
+			vertexSize += m_isQuantize ? 2 : 3;
+
+		if (format.m_isUseUV)
+			vertexSize += m_isQuantize ? sizeof(ui16) * 2 : sizeof(Vector2);
+
+		return vertexSize * m_vertData.getVertexCount() + ui32(m_indices.size());
+	}
+
 	Res* Mesh::load(const ResourcePath& path)
 	{
 		if (!path.isEmpty())
@@ -304,6 +388,19 @@ namespace Echo
 							vertexData.setPosition(i, positions[i]);
 						}
 					}
+					else if (!positionData.isEmpty() && positionData.m_type == "UShort3")
+					{
+						Vector3 boundsMin = StringUtil::ParseVec3(vertex.attribute("boundsMin").as_string());
+						Vector3 boundsExtent = (StringUtil::ParseVec3(vertex.attribute("boundsMax").as_string()) - boundsMin) / 65535.f;
+						ui16* positions = (ui16*)(positionData.m_data.data());
+						for (int i = 0; i < vertCount; i++)
+						{
+							Vector3 position(positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
+							vertexData.setPosition(i, boundsMin + position * boundsExtent);
+						}
+
+						res->setQuantize(true);
+					}
 
 					if (!normalData.isEmpty() && normalData.m_type == "Byte3")
 					{
@@ -317,6 +414,14 @@ namespace Echo
 							vertexData.setNormal(i, normal);
 						}
 					}
+					else if (!normalData.isEmpty() && normalData.m_type == "OctByte2")
+					{
+						Byte* normals = (Byte*)(normalData.m_data.data());
+						for (int i = 0; i < vertCount; i++)
+						{
+							vertexData.setNormal(i, DecodeOctahedral(normals + i * 2));
+						}
+					}
 
 					if (!uv0Data.isEmpty() && uv0Data.m_type == "Vector2")
 					{
@@ -326,11 +431,42 @@ namespace Echo
 							vertexData.setUV0(i, uvs[i]);
 						}
 					}
+					else if (!uv0Data.isEmpty() && uv0Data.m_type == "Half2")
+					{
+						ui16* uvs = (ui16*)(uv0Data.m_data.data());
+						for (int i = 0; i < vertCount; i++)
+						{
+							vertexData.setUV0(i, Vector2(Math::HalfToFloat(uvs[i * 2 + 0]), Math::HalfToFloat(uvs[i * 2 + 1])));
+						}
+					}
 
 					// set indices data
 					if (!indicesData.isEmpty())
 					{
 						res->updateIndices(indicesCount, indicesStride, indicesData.m_data.data());
+
+						// lods out of the indices that follow the mesh are dropped, the full range is drawn instead
+						ui32 totalIndicesCount = ui32(indicesData.m_data.size() / std::max<i32>(indicesStride, 1));
+						ui32 lodIndicesCount = totalIndicesCount > ui32(indicesCount) ? totalIndicesCount - indicesCount : 0;
+
+						MeshLodArray lods;
+						for (pugi::xml_node lodNode = indices.child("lod"); lodNode; lodNode = lodNode.next_sibling("lod"))
+						{
+							MeshLod lod;
+							lod.m_startIndex = lodNode.attribute("start").as_uint();
+							lod.m_indexCount = lodNode.attribute("count").as_uint();
+							lod.m_coverage = lodNode.attribute("coverage").as_float();
+							if (ui64(lod.m_startIndex) + lod.m_indexCount > lodIndicesCount)
+							{
+								EchoLogError("Mesh [%s] lod [%d, %d] is out of its %d indices", path.getPath().c_str(), lod.m_startIndex, lod.m_indexCount, lodIndicesCount);
+								continue;
+							}
+
+							lods.emplace_back(lod);
+						}
+
+						if (!lods.empty())
+							res->updateLods(lods, lodIndicesCount, indicesData.m_data.data() + indicesCount * indicesStride);
 					}
 
 					// set vertex data
@@ -356,13 +492,42 @@ namespace Echo
 		pugi::xml_node indices = root.append_child("indices");
 		indices.append_attribute("count").set_value(getIndexCount());
 		indices.append_attribute("stride").set_value(getIndexStride());
-		writer.addData("Indices", StringUtil::Format("Byte%d", getIndexStride()).c_str(), getIndices(), getIndexCount() * getIndexStride());
+		writer.addData("Indices", StringUtil::Format("Byte%d", getIndexStride()).c_str(), m_indices.data(), i32(m_indices.size()));
+
+		// lods, their indices follow the ones of the mesh
+		for (const MeshLod& lod : m_lods)
+		{
+			pugi::xml_node lodNode = indices.append_child("lod");
+			lodNode.append_attribute("start").set_value(lod.m_startIndex - m_idxCount);
+			lodNode.append_attribute("count").set_value(lod.m_indexCount);
+			lodNode.append_attribute("coverage").set_value(lod.m_coverage);
+		}
 
 		// vertex
 		pugi::xml_node vertex = root.append_child("vertex");
 		vertex.append_attribute("count").set_value(m_vertData.getVertexCount());
 
 		// positions
+		if (m_isQuantize)
+		{
+			vertex.append_attribute("boundsMin").set_value(StringUtil::ToString(m_box.vMin).c_str());
+			vertex.append_attribute("boundsMax").set_value(StringUtil::ToString(m_box.vMax).c_str());
+
+			Vector3 extent = m_box.vMax - m_box.vMin;
+			vector<ui16>::type positions(m_vertData.getVertexCount() * 3);
+			for (ui32 i = 0; i < m_vertData.getVertexCount(); i++)
+			{
+				const Vector3& position = m_vertData.getPosition(i);
+				for (i32 c = 0; c < 3; c++)
+				{
+					float ratio = extent[c] > 0.f ? (position[c] - m_box.vMin[c]) / extent[c] : 0.f;
+					positions[i * 3 + c] = ui16(Math::Clamp(ratio, 0.f, 1.f) * 65535.f + 0.5f);
+				}
+			}
+
+			writer.addData("Position", "UShort3", positions.data(), positions.size() * sizeof(ui16));
+		}
+		else
 		{
 			ByteArray positions = m_vertData.getPositions();
 			writer.addData("Position", "Vector3", positions.data(), positions.size());
@@ -371,8 +536,19 @@ namespace Echo
 		// normal
 		if (m_vertData.getFormat().m_isUseNormal)
 		{
-			ByteArray normals = m_vertData.getNormals();
-			writer.addData("Normal", "Byte3", normals.data(), normals.size());
+			if (m_isQuantize)
+			{
+				ByteArray normals(m_vertData.getVertexCount() * 2);
+				for (ui32 i = 0; i < m_vertData.getVertexCount(); i++)
+					EncodeOctahedral(m_vertData.getNormal(i), &normals[i * 2]);
+
+				writer.addData("Normal", "OctByte2", normals.data(), normals.size());
+			}
+			else
+			{
+				ByteArray normals = m_vertData.getNormals();
+				writer.addData("Normal", "Byte3", normals.data(), normals.size());
+			}
 		}
 
 		// color
@@ -384,8 +560,23 @@ namespace Echo
 		// uv
 		if (m_vertData.getFormat().m_isUseUV)
 		{
-			ByteArray uvs = m_vertData.getUV0s();
-			writer.addData("UV0", "Vector2", uvs.data(), uvs.size());
+			if (m_isQuantize)
+			{
+				vector<ui16>::type uvs(m_vertData.getVertexCount() * 2);
+				for (ui32 i = 0; i < m_vertData.getVertexCount(); i++)
+				{
+					const Vector2& uv = m_vertData.getUV0(i);
+					uvs[i * 2 + 0] = Math::FloatToHalf(uv.x);
+					uvs[i * 2 + 1] = Math::FloatToHalf(uv.y);
+				}
+
+				writer.addData("UV0", "Half2", uvs.data(), uvs.size() * sizeof(ui16));
+			}
+			else
+			{
+				ByteArray uvs = m_vertData.getUV0s();
+				writer.addData("UV0", "Vector2", uvs.data(), uvs.size());
+			}
 		}
 
 		// uv1
@@ -6,6 +6,15 @@
 
 namespace Echo
 {
+	// Coarser level of detail, indexing the vertices of the mesh
+	struct MeshLod
+	{
+		ui32	m_startIndex = 0;
+		ui32	m_indexCount = 0;
+		float	m_coverage = 0.f;		// used when the screen coverage of the bounds is below this
+	};
+	typedef vector<MeshLod>::type MeshLodArray;
+
 	/**
 	* Mesh 2013-11-6
 	*/
@@ -103,9 +112,24 @@ namespace Echo
 		// set primitive type
 		void setTopologyType(TopologyType type) { m_topologyType = type; }
 
-		// update indices data
+		// update indices data, lods are cleared
 		void updateIndices(ui32 indicesCount, ui32 indicesStride, const void* indices);
 
+		// Set lods coarser than the mesh. Indices of all lods are back to back in the index stride
+		// of the mesh, lod start indices are relative to them. Coverages have to be decreasing
+		void updateLods(const MeshLodArray& lods, ui32 indicesCount, const void* indices);
+
+		// lod count, level 0 is the mesh itself
+		ui32 getLodCount() const { return ui32(m_lods.size()) + 1; }
+
+		// index range of a level
+		ui32 getLodStartIndex(i32 lod) const { return lod > 0 && lod <= i32(m_lods.size()) ? m_lods[lod - 1].m_startIndex : m_startIdx; }
+		ui32 getLodIndexCount(i32 lod) const { return lod > 0 && lod <= i32(m_lods.size()) ? m_lods[lod - 1].m_indexCount : m_idxCount; }
+
+		// Level for a screen coverage, radius of the bounds over half the view height. Coarser
+		// levels than the current one need a lower coverage, so levels don't flip at a threshold
+		i32 selectLod(float coverage, i32 currentLod) const;
+
 		// update vertex data
 		void updateVertexs(const MeshVertexFormat& format, ui32 vertCount, const Byte* vertices);
 		void updateVertexs(const MeshVertexData& vertexData);
@@ -113,6 +137,14 @@ namespace Echo
 		// clear
 		void clear();
 
+		// Quantize attributes when saved, positions to 16 bit inside the bounds, octahedral normals
+		// and half float uvs. Expanded to the float layout when loaded
+		void setQuantize(bool isQuantize) { m_isQuantize = isQuantize; }
+		bool isQuantize() const { return m_isQuantize; }
+
+		// bytes of the vertex and index data written by save
+		ui32 getSaveSize() const;
+
 		// load|save
 		static Res* load(const ResourcePath& path);
 		virtual void save() override;
@@ -148,6 +180,8 @@ namespace Echo
 		bool						m_isDynamicIndicesBuffer = false;
 		GPUBuffer*					m_indexBuffer = nullptr;
 		vector<ui32>::type			m_boneIdxs;
+		bool						m_isQuantize = false;
+		MeshLodArray				m_lods;
 	};
 	typedef Echo::ResRef<Echo::Mesh> MeshPtr;
 }
@@ -0,0 +1,714 @@
+#include "mesh_optimizer.h"
+#include <unordered_map>
+#include <cfloat>
+
+namespace Echo
+{
+	// Fifo post transform cache, a vertex is cached while fewer than size misses came after it
+	struct MeshCacheSimulator
+	{
+		vector<ui32>::type	m_times;
+		ui32				m_size;
+		ui32				m_time;
+
+		MeshCacheSimulator(ui32 vertexCount, ui32 size)
+			: m_times(vertexCount, 0)
+			, m_size(size)
+			, m_time(size + 1)
+		{}
+
+		// returns the misses of the triangle
+		ui32 triangle(const ui32* triangle)
+		{
+			ui32 misses = 0;
+			for (i32 c = 0; c < 3; c++)
+			{
+				ui32 vertex = triangle[c];
+				if (m_time - m_times[vertex] > m_size)
+				{
+					m_times[vertex] = m_time++;
+					misses++;
+				}
+			}
+
+			return misses;
+		}
+
+		// flush
+		void reset()
+		{
+			m_time += m_size + 1;
+		}
+	};
+
+	// hashing whole vertices for welding
+	struct MeshVertexHasher
+	{
+		const Byte*	m_data;
+		ui32		m_stride;
+
+		size_t operator()(ui32 vertex) const
+		{
+			// fnv-1a
+			ui32 hash = 2166136261u;
+			const Byte* data = m_data + size_t(vertex) * m_stride;
+			for (ui32 i = 0; i < m_stride; i++)
+				hash = (hash ^ data[i]) * 16777619u;
+
+			return hash;
+		}
+
+		bool operator()(ui32 a, ui32 b) const
+		{
+			return memcmp(m_data + size_t(a) * m_stride, m_data + size_t(b) * m_stride, m_stride) == 0;
+		}
+	};
+
+	// copy vertices to their new position, remap entries of ~0u are dropped
+	static void RemapVertices(MeshVertexData& vertexData, const vector<ui32>::type& remap, ui32 newCount)
+	{
+		MeshVertexData result;
+		result.set(vertexData.getFormat(), newCount);
+
+		ui32 stride = vertexData.getVertexStride();
+		for (ui32 i = 0; i < vertexData.getVertexCount(); i++)
+		{
+			if (remap[i] != ~0u)
+				memcpy(result.getVertice(remap[i]), vertexData.getVertice(i), stride);
+		}
+
+		vertexData = result;
+	}
+
+	// Symmetric 4x4 error quadric of area weighted planes. The error of a position is the area
+	// weighted sum of its squared distances to the planes
+	struct MeshQuadric
+	{
+		double	m_a00 = 0.0, m_a01 = 0.0, m_a02 = 0.0, m_a11 = 0.0, m_a12 = 0.0, m_a22 = 0.0;
+		double	m_b0 = 0.0, m_b1 = 0.0, m_b2 = 0.0;
+		double	m_c = 0.0;
+		double	m_weight = 0.0;
+
+		// plane n.p + d = 0 with unit normal
+		void addPlane(const Vector3& n, float d, float weight)
+		{
+			double x = n.x, y = n.y, z = n.z, w = weight;
+			m_a00 += w * x * x; m_a01 += w * x * y; m_a02 += w * x * z;
+			m_a11 += w * y * y; m_a12 += w * y * z; m_a22 += w * z * z;
+			m_b0 += w * x * d; m_b1 += w * y * d; m_b2 += w * z * d;
+			m_c += w * double(d) * d;
+			m_weight += w;
+		}
+
+		void add(const MeshQuadric& q)
+		{
+			m_a00 += q.m_a00; m_a01 += q.m_a01; m_a02 += q.m_a02;
+			m_a11 += q.m_a11; m_a12 += q.m_a12; m_a22 += q.m_a22;
+			m_b0 += q.m_b0; m_b1 += q.m_b1; m_b2 += q.m_b2;
+			m_c += q.m_c;
+			m_weight += q.m_weight;
+		}
+
+		// squared distance, averaged by the weight
+		double error(const MeshQuadric& other, const Vector3& p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double a00 = m_a00 + other.m_a00, a01 = m_a01 + other.m_a01, a02 = m_a02 + other.m_a02;
+			double a11 = m_a11 + other.m_a11, a12 = m_a12 + other.m_a12, a22 = m_a22 + other.m_a22;
+			double e = x * (a00 * x + 2.0 * (a01 * y + a02 * z)) + y * (a11 * y + 2.0 * a12 * z) + a22 * z * z;
+			e += 2.0 * (x * (m_b0 + other.m_b0) + y * (m_b1 + other.m_b1) + z * (m_b2 + other.m_b2)) + m_c + other.m_c;
+			double weight = m_weight + other.m_weight;
+			return weight > 0.0 ? std::max<double>(e, 0.0) / weight : 0.0;
+		}
+	};
+
+	// candidate collapse of a vertex onto another
+	struct MeshCollapse
+	{
+		ui32	m_from;
+		ui32	m_to;
+		double	m_error;
+	};
+
+	String MeshOptimizer::Report::toString() const
+	{
+		return StringUtil::Format("acmr %.3f -> %.3f, vertices %d -> %d, bytes %d -> %d, lods %d", m_acmrBefore, m_acmrAfter, m_vertexCountBefore, m_vertexCountAfter, m_bytesBefore, m_bytesAfter, m_lodCount);
+	}
+
+	MeshOptimizer::Report MeshOptimizer::optimize(Mesh* mesh, const Options& options)
+	{
+		Report report;
+		if (!mesh || mesh->getTopologyType() != Mesh::TT_TRIANGLELIST)
+			return report;
+
+		MeshVertexData vertexData = mesh->getVertexData();
+		ui32 vertexCount = vertexData.getVertexCount();
+
+		// indices, meshes without them draw vertices in order
+		vector<ui32>::type indices;
+		const Byte* indicesData = (const Byte*)mesh->getIndices();
+		ui32 indicesStride = mesh->getIndexStride();
+		if (mesh->getIndexCount() && indicesData)
+		{
+			indices.resize(mesh->getIndexCount());
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				if (indicesStride == 1)			indices[i] = indicesData[i];
+				else if (indicesStride == 2)	indices[i] = ((const ui16*)indicesData)[i];
+				else							indices[i] = ((const ui32*)indicesData)[i];
+			}
+		}
+		else
+		{
+			indices.resize(vertexCount);
+			for (ui32 i = 0; i < vertexCount; i++)
+				indices[i] = i;
+		}
+
+		if (!vertexCount || indices.size() % 3)
+			return report;
+
+		for (ui32 index : indices)
+		{
+			if (index >= vertexCount)
+				return report;
+		}
+
+		report.m_vertexCountBefore = vertexCount;
+		report.m_acmrBefore = calcACMR(indices, vertexCount, options.m_cacheSize);
+		report.m_bytesBefore = mesh->getSaveSize();
+
+		if (options.m_isWeld)
+			vertexCount = weldVertices(vertexData, indices);
+
+		if (options.m_isOptimizeVertexCache)
+		{
+			vector<ui32>::type clusters;
+			optimizeVertexCache(indices, vertexCount, options.m_cacheSize, clusters);
+
+			if (options.m_isOptimizeOverdraw)
+				optimizeOverdraw(indices, clusters, vertexData, options.m_cacheSize, options.m_overdrawThreshold);
+		}
+
+		if (options.m_isOptimizeVertexFetch)
+			optimizeVertexFetch(vertexData, indices);
+
+		// 16 bit indices whenever they fit
+		if (vertexData.getVertexCount() <= 65536)
+		{
+			vector<ui16>::type shortIndices(indices.begin(), indices.end());
+			mesh->updateIndices(ui32(shortIndices.size()), sizeof(ui16), shortIndices.data());
+		}
+		else
+		{
+			mesh->updateIndices(ui32(indices.size()), sizeof(ui32), indices.data());
+		}
+
+		mesh->updateVertexs(vertexData);
+		mesh->setQuantize(options.m_isQuantize);
+
+		if (options.m_lodCount)
+			report.m_lodCount = generateLods(mesh, vertexData, indices, options);
+
+		report.m_vertexCountAfter = vertexData.getVertexCount();
+		report.m_acmrAfter = calcACMR(indices, vertexData.getVertexCount(), options.m_cacheSize);
+		report.m_bytesAfter = mesh->getSaveSize();
+
+		return report;
+	}
+
+	ui32 MeshOptimizer::weldVertices(MeshVertexData& vertexData, vector<ui32>::type& indices)
+	{
+		ui32 vertexCount = vertexData.getVertexCount();
+		MeshVertexHasher hasher = { vertexData.getVertices(), vertexData.getVertexStride() };
+		std::unordered_map<ui32, ui32, MeshVertexHasher, MeshVertexHasher> unique(vertexCount, hasher, hasher);
+
+		vector<ui32>::type remap(vertexCount, ~0u);
+		vector<ui32>::type welded(vertexCount);
+		ui32 newCount = 0;
+		for (ui32 i = 0; i < vertexCount; i++)
+		{
+			auto it = unique.emplace(i, newCount);
+			if (it.second)
+				remap[i] = newCount++;
+
+			welded[i] = it.first->second;
+		}
+
+		for (ui32& index : indices)
+			index = welded[index];
+
+		if (newCount != vertexCount)
+			RemapVertices(vertexData, remap, newCount);
+
+		return newCount;
+	}
+
+	void MeshOptimizer::optimizeVertexCache(vector<ui32>::type& indices, ui32 vertexCount, ui32 cacheSize, vector<ui32>::type& clusters)
+	{
+		clusters.clear();
+		ui32 triangleCount = ui32(indices.size() / 3);
+		if (!triangleCount)
+			return;
+
+		// vertex to triangle adjacency
+		vector<ui32>::type liveCount(vertexCount, 0);
+		for (ui32 index : indices)
+			liveCount[index]++;
+
+		vector<ui32>::type offsets(vertexCount + 1, 0);
+		for (ui32 i = 0; i < vertexCount; i++)
+			offsets[i + 1] = offsets[i] + liveCount[i];
+
+		vector<ui32>::type adjacency(indices.size());
+		vector<ui32>::type fill(offsets.begin(), offsets.end() - 1);
+		for (ui32 t = 0; t < triangleCount; t++)
+		{
+			for (ui32 c = 0; c < 3; c++)
+				adjacency[fill[indices[t * 3 + c]]++] = t;
+		}
+
+		vector<ui32>::type cacheTimes(vertexCount, 0);
+		vector<ui8>::type emitted(triangleCount, 0);
+		vector<ui32>::type deadEnd;
+		vector<ui32>::type candidates;
+		vector<ui32>::type result;
+		deadEnd.reserve(indices.size());
+		result.reserve(indices.size());
+		clusters.push_back(0);
+
+		ui32 time = cacheSize + 1;
+		ui32 cursor = 0;
+		i32 fanning = 0;
+		while (fanning >= 0)
+		{
+			// emit all live triangles around the fanning vertex
+			candidates.clear();
+			for (ui32 i = offsets[fanning]; i < offsets[fanning + 1]; i++)
+			{
+				ui32 t = adjacency[i];
+				if (emitted[t])
+					continue;
+
+				for (ui32 c = 0; c < 3; c++)
+				{
+					ui32 vertex = indices[t * 3 + c];
+					result.push_back(vertex);
+					deadEnd.push_back(vertex);
+					candidates.push_back(vertex);
+					liveCount[vertex]--;
+					if (time - cacheTimes[vertex] > cacheSize)
+						cacheTimes[vertex] = time++;
+				}
+
+				emitted[t] = 1;
+			}
+
+			// next fanning vertex is the oldest candidate whose triangles still fit in the cache
+			i32 next = -1;
+			i32 bestPriority = -1;
+			for (ui32 vertex : candidates)
+			{
+				if (liveCount[vertex])
+				{
+					i32 priority = 0;
+					if (time - cacheTimes[vertex] + 2 * liveCount[vertex] <= cacheSize)
+						priority = i32(time - cacheTimes[vertex]);
+
+					if (priority > bestPriority)
+					{
+						bestPriority = priority;
+						next = i32(vertex);
+					}
+				}
+			}
+
+			// dead end, continue with a recently used vertex or the next one in input order
+			if (next == -1)
+			{
+				while (!deadEnd.empty() && next == -1)
+				{
+					ui32 vertex = deadEnd.back();
+					deadEnd.pop_back();
+					if (liveCount[vertex])
+						next = i32(vertex);
+				}
+
+				while (cursor < vertexCount && next == -1)
+				{
+					if (liveCount[cursor])
+						next = i32(cursor);
+
+					cursor++;
+				}
+
+				// the cache is cold after a jump, which makes it a cluster boundary
+				ui32 offset = ui32(result.size() / 3);
+				if (next != -1 && offset != clusters.back())
+					clusters.push_back(offset);
+			}
+
+			fanning = next;
+		}
+
+		indices.swap(result);
+	}
+
+	void MeshOptimizer::optimizeOverdraw(vector<ui32>::type& indices, const vector<ui32>::type& clusters, MeshVertexData& vertexData, ui32 cacheSize, float threshold)
+	{
+		ui32 triangleCount = ui32(indices.size() / 3);
+		if (!triangleCount || clusters.empty())
+			return;
+
+		// split hard clusters where the acmr so far is within threshold of the whole cluster
+		vector<ui32>::type softClusters;
+		MeshCacheSimulator cache(vertexData.getVertexCount(), cacheSize);
+		for (size_t i = 0; i < clusters.size(); i++)
+		{
+			ui32 begin = clusters[i];
+			ui32 end = i + 1 < clusters.size() ? clusters[i + 1] : triangleCount;
+
+			cache.reset();
+			ui32 clusterMisses = 0;
+			for (ui32 t = begin; t < end; t++)
+				clusterMisses += cache.triangle(&indices[t * 3]);
+
+			float targetAcmr = threshold * float(clusterMisses) / float(end - begin);
+
+			cache.reset();
+			softClusters.push_back(begin);
+			ui32 start = begin;
+			ui32 misses = 0;
+			for (ui32 t = begin; t < end; t++)
+			{
+				misses += cache.triangle(&indices[t * 3]);
+				if (t + 1 < end && float(misses) <= targetAcmr * float(t + 1 - start))
+				{
+					softClusters.push_back(t + 1);
+					start = t + 1;
+					misses = 0;
+					cache.reset();
+				}
+			}
+		}
+
+		// area weighted centroid and normal of clusters
+		struct Cluster
+		{
+			ui32	m_begin;
+			ui32	m_end;
+			float	m_sortKey;
+		};
+
+		vector<Cluster>::type sorted(softClusters.size());
+		vector<Vector3>::type centroids(softClusters.size());
+		vector<Vector3>::type normals(softClusters.size());
+		Vector3 meshCentroid = Vector3::ZERO;
+		float meshArea = 0.f;
+		for (size_t i = 0; i < softClusters.size(); i++)
+		{
+			Cluster& cluster = sorted[i];
+			cluster.m_begin = softClusters[i];
+			cluster.m_end = i + 1 < softClusters.size() ? softClusters[i + 1] : triangleCount;
+
+			Vector3 centroid = Vector3::ZERO;
+			Vector3 normal = Vector3::ZERO;
+			float area = 0.f;
+			for (ui32 t = cluster.m_begin; t < cluster.m_end; t++)
+			{
+				const Vector3& p0 = vertexData.getPosition(indices[t * 3 + 0]);
+				const Vector3& p1 = vertexData.getPosition(indices[t * 3 + 1]);
+				const Vector3& p2 = vertexData.getPosition(indices[t * 3 + 2]);
+				Vector3 cross = (p1 - p0).cross(p2 - p0);
+				float triangleArea = cross.len();
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.f);
+				normal += cross;
+				area += triangleArea;
+			}
+
+			meshCentroid += centroid;
+			meshArea += area;
+			centroids[i] = area > 0.f ? centroid / area : centroid;
+			normals[i] = normal.len() > 0.f ? normal / normal.len() : Vector3::ZERO;
+		}
+
+		if (meshArea > 0.f)
+			meshCentroid /= meshArea;
+
+		// clusters facing away from the center are likely to occlude the others, draw them first
+		for (size_t i = 0; i < sorted.size(); i++)
+			sorted[i].m_sortKey = (centroids[i] - meshCentroid).dot(normals[i]);
+
+		std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.m_sortKey > b.m_sortKey; });
+
+		vector<ui32>::type result;
+		result.reserve(indices.size());
+		for (const Cluster& cluster : sorted)
+			result.insert(result.end(), indices.begin() + cluster.m_begin * 3, indices.begin() + cluster.m_end * 3);
+
+		indices.swap(result);
+	}
+
+	void MeshOptimizer::optimizeVertexFetch(MeshVertexData& vertexData, vector<ui32>::type& indices)
+	{
+		vector<ui32>::type remap(vertexData.getVertexCount(), ~0u);
+		ui32 newCount = 0;
+		for (ui32& index : indices)
+		{
+			if (remap[index] == ~0u)
+				remap[index] = newCount++;
+
+			index = remap[index];
+		}
+
+		RemapVertices(vertexData, remap, newCount);
+	}
+
+	float MeshOptimizer::simplify(MeshVertexData& vertexData, const vector<ui32>::type& indices, ui32 targetIndexCount, float maxError, vector<ui32>::type& result)
+	{
+		result = indices;
+		ui32 vertexCount = vertexData.getVertexCount();
+		if (!vertexCount || indices.size() % 3 || result.size() <= targetIndexCount)
+			return 0.f;
+
+		// bounds radius, errors are measured relative to it
+		AABB bounds;
+		for (ui32 i = 0; i < vertexCount; i++)
+			bounds.addPoint(vertexData.getPosition(i));
+
+		float radius = bounds.getDiagonalLen() * 0.5f;
+		if (radius <= 0.f)
+			return 0.f;
+
+		// Edges used by a single triangle are borders. Vertices sharing a position with different
+		// attributes are split, so their edges are single too and seams are kept as well
+		std::unordered_map<ui64, ui32> edges(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (i32 c = 0; c < 3; c++)
+			{
+				ui32 a = indices[i + c];
+				ui32 b = indices[i + (c + 1) % 3];
+				edges[(ui64(std::min<ui32>(a, b)) << 32) | std::max<ui32>(a, b)]++;
+			}
+		}
+
+		vector<bool>::type locked(vertexCount, false);
+		for (auto& it : edges)
+		{
+			if (it.second == 1)
+			{
+				locked[ui32(it.first >> 32)] = true;
+				locked[ui32(it.first & 0xffffffff)] = true;
+			}
+		}
+
+		vector<MeshQuadric>::type quadrics(vertexCount);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const Vector3& p0 = vertexData.getPosition(indices[i + 0]);
+			const Vector3& p1 = vertexData.getPosition(indices[i + 1]);
+			const Vector3& p2 = vertexData.getPosition(indices[i + 2]);
+			Vector3 normal = (p1 - p0).cross(p2 - p0);
+			float area = normal.len();
+			if (area <= 0.f)
+				continue;
+
+			normal /= area;
+			float d = -normal.dot(p0);
+			for (i32 c = 0; c < 3; c++)
+				quadrics[indices[i + c]].addPlane(normal, d, area * 0.5f);
+		}
+
+		// greedy passes, each one collapses the cheapest edges whose neighborhoods don't overlap
+		double maxErrorSquared = double(maxError * radius) * double(maxError * radius);
+		double resultError = 0.0;
+		vector<MeshCollapse>::type collapses;
+		vector<ui32>::type adjacencyOffsets;
+		vector<ui32>::type adjacency;
+		vector<ui32>::type remap(vertexCount);
+		vector<bool>::type touched(vertexCount);
+		while (result.size() > targetIndexCount)
+		{
+			ui32 triangleCount = ui32(result.size() / 3);
+
+			// vertex to triangle adjacency of the current triangles
+			adjacencyOffsets.assign(vertexCount + 1, 0);
+			for (ui32 index : result)
+				adjacencyOffsets[index + 1]++;
+
+			for (ui32 i = 0; i < vertexCount; i++)
+				adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+			adjacency.resize(result.size());
+			vector<ui32>::type fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (ui32 t = 0; t < triangleCount; t++)
+			{
+				for (i32 c = 0; c < 3; c++)
+					adjacency[fill[result[t * 3 + c]]++] = t;
+			}
+
+			// cheaper direction of every edge with a free vertex
+			collapses.clear();
+			for (ui32 t = 0; t < triangleCount; t++)
+			{
+				for (i32 c = 0; c < 3; c++)
+				{
+					ui32 a = result[t * 3 + c];
+					ui32 b = result[t * 3 + (c + 1) % 3];
+					if (a > b && !(locked[a] || locked[b]))
+						continue;
+
+					double errorAB = locked[a] ? DBL_MAX : quadrics[a].error(quadrics[b], vertexData.getPosition(b));
+					double errorBA = locked[b] ? DBL_MAX : quadrics[b].error(quadrics[a], vertexData.getPosition(a));
+					if (errorAB == DBL_MAX && errorBA == DBL_MAX)
+						continue;
+
+					if (errorAB <= errorBA)
+						collapses.push_back({ a, b, errorAB });
+					else
+						collapses.push_back({ b, a, errorBA });
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const MeshCollapse& a, const MeshCollapse& b) { return a.m_error < b.m_error; });
+
+			// a collapse removes two triangles on closed surfaces
+			ui32 collapseLimit = std::max<ui32>(ui32(result.size() - targetIndexCount) / 6, 1);
+			ui32 collapseCount = 0;
+			for (ui32 i = 0; i < vertexCount; i++)
+				remap[i] = i;
+
+			touched.assign(vertexCount, false);
+			for (const MeshCollapse& collapse : collapses)
+			{
+				if (collapse.m_error > maxErrorSquared || collapseCount >= collapseLimit)
+					break;
+
+				ui32 from = collapse.m_from;
+				ui32 to = collapse.m_to;
+				if (touched[from] || touched[to])
+					continue;
+
+				// triangles around from that stay must not flip
+				const Vector3& target = vertexData.getPosition(to);
+				bool isFlip = false;
+				for (ui32 j = adjacencyOffsets[from]; j < adjacencyOffsets[from + 1] && !isFlip; j++)
+				{
+					const ui32* triangle = &result[adjacency[j] * 3];
+					if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+						continue;
+
+					Vector3 p[3];
+					Vector3 q[3];
+					for (i32 c = 0; c < 3; c++)
+					{
+						p[c] = vertexData.getPosition(triangle[c]);
+						q[c] = triangle[c] == from ? target : p[c];
+					}
+
+					Vector3 before = (p[1] - p[0]).cross(p[2] - p[0]);
+					Vector3 after = (q[1] - q[0]).cross(q[2] - q[0]);
+					isFlip = before.dot(after) <= 0.f;
+				}
+
+				if (isFlip)
+					continue;
+
+				// neighbors keep their triangles for the flip tests of this pass
+				for (ui32 j = adjacencyOffsets[from]; j < adjacencyOffsets[from + 1]; j++)
+				{
+					const ui32* triangle = &result[adjacency[j] * 3];
+					touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+				}
+
+				remap[from] = to;
+				quadrics[to].add(quadrics[from]);
+				resultError = std::max<double>(resultError, collapse.m_error);
+				collapseCount++;
+			}
+
+			if (!collapseCount)
+				break;
+
+			// drop the triangles that became degenerate
+			size_t count = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				ui32 a = remap[result[i + 0]];
+				ui32 b = remap[result[i + 1]];
+				ui32 c = remap[result[i + 2]];
+				if (a != b && b != c && c != a)
+				{
+					result[count++] = a;
+					result[count++] = b;
+					result[count++] = c;
+				}
+			}
+
+			result.resize(count);
+		}
+
+		return float(std::sqrt(resultError)) / radius;
+	}
+
+	ui32 MeshOptimizer::generateLods(Mesh* mesh, MeshVertexData& vertexData, const vector<ui32>::type& indices, const Options& options)
+	{
+		MeshLodArray lods;
+		vector<ui32>::type lodIndices;
+		vector<ui32>::type levelIndices;
+		vector<ui32>::type clusters;
+		ui32 previousCount = ui32(indices.size());
+		float previousCoverage = FLT_MAX;
+		for (ui32 i = 0; i < options.m_lodCount; i++)
+		{
+			ui32 targetCount = ui32(float(previousCount) * options.m_lodRatio) / 3 * 3;
+			float error = simplify(vertexData, indices, targetCount, options.m_lodMaxError, levelIndices);
+
+			// a level has to save enough to be worth its indices
+			if (levelIndices.empty() || levelIndices.size() > previousCount * 9 / 10)
+				break;
+
+			optimizeVertexCache(levelIndices, vertexData.getVertexCount(), options.m_cacheSize, clusters);
+
+			// Used once the error projects below about a pixel at 1080p, half the view height is
+			// 540 pixels. Coverages have to decrease with the level
+			MeshLod lod;
+			lod.m_startIndex = ui32(lodIndices.size());
+			lod.m_indexCount = ui32(levelIndices.size());
+			lod.m_coverage = std::min<float>(error > 0.f ? 1.f / (540.f * error) : previousCoverage, previousCoverage);
+			lods.push_back(lod);
+
+			lodIndices.insert(lodIndices.end(), levelIndices.begin(), levelIndices.end());
+			previousCount = lod.m_indexCount;
+			previousCoverage = lod.m_coverage;
+		}
+
+		// same stride as the mesh indices
+		if (mesh->getIndexStride() == sizeof(ui16))
+		{
+			vector<ui16>::type shortIndices(lodIndices.begin(), lodIndices.end());
+			mesh->updateLods(lods, ui32(shortIndices.size()), shortIndices.data());
+		}
+		else
+		{
+			mesh->updateLods(lods, ui32(lodIndices.size()), lodIndices.data());
+		}
+
+		return ui32(lods.size());
+	}
+
+	float MeshOptimizer::calcACMR(const vector<ui32>::type& indices, ui32 vertexCount, ui32 cacheSize)
+	{
+		ui32 triangleCount = ui32(indices.size() / 3);
+		if (!triangleCount)
+			return 0.f;
+
+		ui32 misses = 0;
+		MeshCacheSimulator cache(vertexCount, cacheSize);
+		for (ui32 t = 0; t < triangleCount; t++)
+			misses += cache.triangle(&indices[t * 3]);
+
+		return float(misses) / float(triangleCount);
+	}
+}
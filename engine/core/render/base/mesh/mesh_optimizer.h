@@ -0,0 +1,70 @@
+#pragma once
+
+#include "mesh.h"
+
+namespace Echo
+{
+	// Import time optimization of triangle list meshes. Vertices are welded, triangles are
+	// ordered for the post transform cache (Tipsify) and then by cluster for overdraw, and
+	// vertices are finally laid out in the order they are fetched. Coarser lods are then made
+	// by quadric error edge collapse, indexing the same vertices
+	class MeshOptimizer
+	{
+	public:
+		struct Options
+		{
+			bool	m_isWeld = true;
+			bool	m_isOptimizeVertexCache = true;
+			bool	m_isOptimizeOverdraw = true;
+			float	m_overdrawThreshold = 1.05f;	// acmr of the sorted clusters may get this much worse
+			bool	m_isOptimizeVertexFetch = true;
+			bool	m_isQuantize = false;			// lossy, see Mesh::setQuantize
+			ui32	m_cacheSize = 16;
+			ui32	m_lodCount = 3;					// coarser levels, 0 disables lods
+			float	m_lodRatio = 0.5f;				// index count of a level relative to the previous one
+			float	m_lodMaxError = 0.05f;			// relative to the bounds radius
+		};
+
+		struct Report
+		{
+			ui32	m_vertexCountBefore = 0;
+			ui32	m_vertexCountAfter = 0;
+			float	m_acmrBefore = 0.f;
+			float	m_acmrAfter = 0.f;
+			ui32	m_bytesBefore = 0;				// bytes saved to the .mesh
+			ui32	m_bytesAfter = 0;
+			ui32	m_lodCount = 0;
+
+			// to string
+			String toString() const;
+		};
+
+	public:
+		// optimize vertices and indices of the mesh in place
+		static Report optimize(Mesh* mesh, const Options& options);
+
+		// merge vertices with identical data, returns the new vertex count
+		static ui32 weldVertices(MeshVertexData& vertexData, vector<ui32>::type& indices);
+
+		// Tipsify. Offsets of the triangles starting a new cluster are returned in clusters, the
+		// first one is always 0
+		static void optimizeVertexCache(vector<ui32>::type& indices, ui32 vertexCount, ui32 cacheSize, vector<ui32>::type& clusters);
+
+		// sort clusters of a cache optimized index list front to back from outside
+		static void optimizeOverdraw(vector<ui32>::type& indices, const vector<ui32>::type& clusters, MeshVertexData& vertexData, ui32 cacheSize, float threshold);
+
+		// reorder vertices by first use, unreferenced vertices are dropped
+		static void optimizeVertexFetch(MeshVertexData& vertexData, vector<ui32>::type& indices);
+
+		// Quadric error edge collapse of a triangle list down to target index count. Vertices on
+		// borders and attribute seams stay where they are and collapses stop past max error, which
+		// is relative to the bounds radius. Returns the error of the result the same way
+		static float simplify(MeshVertexData& vertexData, const vector<ui32>::type& indices, ui32 targetIndexCount, float maxError, vector<ui32>::type& result);
+
+		// simplify the optimized mesh into lods, returns the lod count set to the mesh
+		static ui32 generateLods(Mesh* mesh, MeshVertexData& vertexData, const vector<ui32>::type& indices, const Options& options);
+
+		// average cache miss count per triangle of a fifo cache
+		static float calcACMR(const vector<ui32>::type& indices, ui32 vertexCount, ui32 cacheSize);
+	};
+}
@@ -120,7 +120,7 @@ namespace Echo
 		return m_format.isVertexUsage(semantic);
 	}
 
-	Vector3& MeshVertexData::getPosition(Word index)
+	Vector3& MeshVertexData::getPosition(ui32 index)
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_POSITION));
 
@@ -150,7 +150,7 @@ namespace Echo
 			*(Vector4*)(getVertice(idx) + m_format.m_boneWeightsOffset) = joint;
 	}
 
-	const Vector3& MeshVertexData::getNormal(Word index)
+	const Vector3& MeshVertexData::getNormal(ui32 index)
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_NORMAL));
 
@@ -162,14 +162,14 @@ namespace Echo
 		Vector3::Normalize(*(Vector3*)(getVertice(idx) + m_format.m_normalOffset),normal);
 	}
 
-	Dword& MeshVertexData::getColor(Word index)
+	Dword& MeshVertexData::getColor(ui32 index)
 	{
 		EchoAssert(index < m_count && VS_COLOR);
 
 		return *(Dword*)(getVertice(index) + m_format.m_colorOffset);
 	}
 
-	const Vector2& MeshVertexData::getUV0(Word index)
+	const Vector2& MeshVertexData::getUV0(ui32 index)
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_TEXCOORD0));
 
@@ -181,14 +181,14 @@ namespace Echo
 		*(Vector2*)(getVertice(idx) + m_format.m_uv0Offset) = uv0;
 	}
 
-	const Vector2& MeshVertexData::getUV1(Word index)
+	const Vector2& MeshVertexData::getUV1(ui32 index)
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_TEXCOORD1));
 
 		return *(Vector2*)(getVertice(index) + m_format.m_uv1Offset);
 	}
 
-	Vector3& MeshVertexData::getTangent(Word index)
+	Vector3& MeshVertexData::getTangent(ui32 index)
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_TANGENT));
 
@@ -88,23 +88,23 @@ namespace Echo
 		bool isVertexUsage(VertexSemantic semantic) const;
 
 		// Position
-		Vector3& getPosition(Word index);
+		Vector3& getPosition(ui32 index);
 		void setPosition(int idx, const Vector3& pos);
 
 		// Normal
-		const Vector3& getNormal(Word index);
+		const Vector3& getNormal(ui32 index);
 		void setNormal(int idx, const Vector3& normal);
 
 		// Color
-		Dword& getColor(Word index);
+		Dword& getColor(ui32 index);
 		void setColor(i32 idx, Dword color);
 
 		// UV0
-		const Vector2& getUV0(Word index);
+		const Vector2& getUV0(ui32 index);
 		void setUV0(int idx, const Vector2& uv0);
 
 		// UV1
-		const Vector2& getUV1(Word index);
+		const Vector2& getUV1(ui32 index);
 
 		 // set skin weight
 		void setJoint(int idx, Dword weight);
@@ -113,7 +113,7 @@ namespace Echo
 		void setWeight(int idx, const Vector4& joint);
 
 		// tangent
-		Vector3& getTangent(Word index);
+		Vector3& getTangent(ui32 index);
 
 		// reset
 		void reset();
@@ -5,6 +5,7 @@
 #include "base/shader/material.h"
 #include "base/mesh/mesh.h"
 #include "engine/core/scene/render_node.h"
+#include "engine/core/geom/Frustum.h"
 #include "engine/core/main/engine.h"
 
 namespace Echo
@@ -57,6 +58,15 @@ namespace Echo
 		Renderer::instance()->updateRenderProxyBvh(this);
 	}
 
+	void RenderProxy::updateLod(const Frustum& frustum)
+	{
+		// most proxies have no lods, leave them before touching the bounds
+		if (m_mesh && m_mesh->getLodCount() > 1)
+			m_lod = m_mesh->selectLod(frustum.getScreenCoverage(m_boundsCenter, m_boundsRadius), m_lod);
+		else
+			m_lod = 0;
+	}
+
 	void RenderProxy::submitToRenderQueue(RenderPipeline* pipeline)
 	{
 		if (m_mesh && m_mesh->isValid())
@@ -13,6 +13,7 @@ namespace Echo
 
 	class Render;
 	class RenderCamera;
+	class Frustum;
 	class Material;
 	class RenderProxy : public Object, public Refable
 	{
@@ -67,6 +68,16 @@ namespace Echo
 		bool isCustomDepth() const { return m_customDepth; }
 		void setCustomDepth( bool customDepth) { m_customDepth = customDepth; }
 
+		// Local aabb, overrides the node's local aabb for culling when valid
+		const AABB& getLocalAABB() const { return m_localAABB; }
+		void setLocalAABB(const AABB& aabb) { m_localAABB = aabb; }
+
+		// Level of detail of the mesh to draw
+		i32 getLod() const { return m_lod; }
+
+		// Select the level of detail from the screen coverage of the world bounds
+		void updateLod(const Frustum& frustum);
+
 		// Is enable submit to render queues
 		bool isSubmitToRenderQueue() const;
 		void setSubmitToRenderQueue(bool enable);
@@ -86,6 +97,10 @@ namespace Echo
 		class Bvh*		m_bvh = nullptr;
 		MeshPtr			m_mesh;
 		MaterialPtr		m_material;
+		AABB			m_localAABB;
+		Vector3			m_boundsCenter = Vector3::ZERO;		// world bounding sphere, kept with the bvh proxy
+		float			m_boundsRadius = 0.f;
+		i32				m_lod = 0;
 		bool			m_raytracing = false;
 		bool			m_castShadow = false;
 		bool			m_customDepth = false;
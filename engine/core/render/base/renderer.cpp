@@ -310,23 +310,28 @@ namespace Echo
 			renderProxy->m_bvhNodeId = -1;
 		}
 
+		const AABB& localAABB = renderProxy->getLocalAABB().isValid() ? renderProxy->getLocalAABB() : renderNode->getLocalAABB();
 		if (renderProxy->m_bvhNodeId == -1)
 		{
-			AABB worldAABB = renderNode->getLocalAABB();
+			AABB worldAABB = localAABB;
 			if (worldAABB.isValid())
 			{
 				worldAABB = worldAABB.transform(renderNode->getWorldMatrix());
 				renderProxy->m_bvh = bvh;
 				renderProxy->m_bvhNodeId = bvh->createProxy(worldAABB, renderProxy->getId());
+				renderProxy->m_boundsCenter = worldAABB.getCenter();
+				renderProxy->m_boundsRadius = worldAABB.getDiagonalLen() * 0.5f;
 			}
 		}
 		else
 		{
-			AABB worldAABB = renderNode->getLocalAABB();
+			AABB worldAABB = localAABB;
 			if (worldAABB.isValid())
 			{
 				worldAABB = worldAABB.transform(renderNode->getWorldMatrix());
 				renderProxy->m_bvh->moveProxy(renderProxy->m_bvhNodeId, worldAABB, Vector3::ZERO);
+				renderProxy->m_boundsCenter = worldAABB.getCenter();
+				renderProxy->m_boundsRadius = worldAABB.getDiagonalLen() * 0.5f;
 			}
 		}
 	}
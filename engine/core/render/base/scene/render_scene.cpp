@@ -2,6 +2,7 @@
 #include <vector>
 #include "../pipeline/render_pipeline.h"
 #include "engine/core/main/frame_state.h"
+#include "engine/core/thread/job_system.h"
 
 namespace Echo
 {
@@ -35,6 +36,13 @@ namespace Echo
 	void RenderScene::render()
 	{
 		vector<RenderProxy*>::type visibleRenderProxies3D = Renderer::instance()->gatherRenderProxies(RenderProxy::RenderType3D, m_3dFrustum);
+
+		// lods of the visible proxies only, each one writes just its own level
+		JobSystem::instance()->parallelFor(i32(visibleRenderProxies3D.size()), [&](i32 i)
+		{
+			visibleRenderProxies3D[i]->updateLod(m_3dFrustum);
+		}, 1024);
+
 		for (RenderProxy* renderproxy : visibleRenderProxies3D)
 		{
 			renderproxy->submitToRenderQueue(RenderPipeline::current());
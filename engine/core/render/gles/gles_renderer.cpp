@@ -315,10 +315,10 @@ namespace Echo
 				else											idxType = GL_UNSIGNED_BYTE;
 
 				// index count
-				ui32 idxCount = mesh->getIndexCount();
+				ui32 idxCount = mesh->getLodIndexCount(renderable->getLod());
 
 				// index offset
-				Byte* idxOffset = 0; idxOffset += mesh->getStartIndex() * mesh->getIndexStride();
+				Byte* idxOffset = 0; idxOffset += mesh->getLodStartIndex(renderable->getLod()) * mesh->getIndexStride();
 
 				// draw
 				OGLESDebug(glDrawElements(glTopologyType, idxCount, idxType, idxOffset));
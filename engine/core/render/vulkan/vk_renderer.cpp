@@ -518,8 +518,8 @@ namespace Echo
 				MeshPtr mesh = renderable->getMesh();
 				if (mesh->getIndexBuffer())
 				{
-					ui32 idxCount = mesh->getIndexCount();
-					ui32 idxOffset = mesh->getStartIndex();
+					ui32 idxCount = mesh->getLodIndexCount(renderable->getLod());
+					ui32 idxOffset = mesh->getLodStartIndex(renderable->getLod());
 
 					vkCmdDrawIndexed(vkCommandbuffer, idxCount, 1, idxOffset, 0, 0);
 				}
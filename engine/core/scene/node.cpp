@@ -4,6 +4,7 @@
 #include "engine/core/main/Engine.h"
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/script/lua/lua_binder.h"
+#include "engine/core/scene/node_tree.h"
 #include <thirdparty/pugixml/pugixml.hpp>
 #include <thirdparty/pugixml/pugiconfig.hpp>
 
@@ -11,6 +12,7 @@ namespace Echo
 {
 	void Node::LuaScript::release(Node* obj)
 	{
+		releaseFunctions(obj);
 		if (obj->isRegisteredToScript())
 		{
 			String luaStr = StringUtil::Format("nodes._%d = nil", obj->getId());
@@ -40,19 +42,47 @@ namespace Echo
                     "package.loaded[\"%s\"] = nil\n", obj->getId(), obj->getId(), moduleName.c_str(), m_globalTableName.c_str(), moduleName.c_str());
 
                 LuaBinder::instance()->execString(luaStr);
+                resolveFunctions(obj);
             }
         }
     }
 
+	void Node::LuaScript::resolveFunctions(Node* obj)
+	{
+		releaseFunctions(obj);
+
+		m_startRef = LuaBinder::instance()->getFunctionRef(obj->getScriptRef(), "start");
+		resolveUpdate(obj);
+	}
+
+	void Node::LuaScript::resolveUpdate(Node* obj)
+	{
+		m_updateRef = LuaBinder::instance()->getFunctionRef(obj->getScriptRef(), "update");
+		if (m_updateRef)
+			NodeTree::instance()->addScriptNode(obj);
+	}
+
+	void Node::LuaScript::releaseFunctions(Node* obj)
+	{
+		if (m_updateIdx >= 0)
+			NodeTree::instance()->removeScriptNode(obj);
+
+		LuaBinder::instance()->unref(m_startRef);
+		LuaBinder::instance()->unref(m_updateRef);
+	}
+
 	void Node::LuaScript::start(Node* obj)
 	{
 		m_isHaveScript = IO::instance()->isExist(m_file.getPath());
 		if ( Engine::instance()->getConfig().m_isGame )
 		{
-			if ( m_isHaveScript)
+			// scripts may define start after they are bound
+			if (m_isHaveScript && !m_startRef)
+				m_startRef = LuaBinder::instance()->getFunctionRef(obj->getScriptRef(), "start");
+
+			if ( m_isHaveScript && m_startRef)
 			{
-				String luaStr = StringUtil::Format("%s:start()", m_globalTableName.c_str());
-				LuaBinder::instance()->execString(luaStr);
+				LuaBinder::instance()->callRef(m_startRef, obj->getScriptRef());
 			}
 		}
 	}
@@ -68,6 +98,10 @@ namespace Echo
             obj->start();
 			m_isStart = true;
 		}
+
+		// update may be defined later, start included, a field lookup until it is
+		if (m_isHaveScript && !m_updateRef)
+			resolveUpdate(obj);
 	}
 
 	Node::Node()
@@ -233,6 +267,7 @@ namespace Echo
 		m_children.insert(m_children.begin() + idx, node);
 
 		needUpdate();
+		onChildrenChanged();
 	}
 
 	void Node::remove()
@@ -242,6 +277,16 @@ namespace Echo
 			parent->removeChild(this);
 	}
 
+	void Node::setEnable(bool isEnable)
+	{
+		if (m_isEnable != isEnable)
+		{
+			m_isEnable = isEnable;
+			if (m_parent)
+				m_parent->onChildrenChanged();
+		}
+	}
+
 	bool Node::isChildExist(const String& name)
 	{
 		for (Node* child : m_children)
@@ -265,6 +310,7 @@ namespace Echo
 			if (*it == node)
 			{
 				m_children.erase(it);
+				onChildrenChanged();
 				return true;
 			}
 		}
@@ -379,8 +425,7 @@ namespace Echo
 		{
 			registerToScript();
 
-			String objectFun = StringUtil::Format("nodes._%d.%s", this->getId(), funName.c_str());
-			LuaBinder::instance()->call<void>(objectFun.c_str(), args, argCount);
+			LuaBinder::instance()->callMethod(getScriptRef(), funName.c_str(), args, argCount);
 		}
     }
 
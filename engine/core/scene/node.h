@@ -22,12 +22,20 @@ namespace Echo
 			bool			m_isHaveScript;
 			ResourcePath	m_file;					// file name
 			String			m_globalTableName;		// global table name
+			i32				m_startRef = 0;			// registry references of the script functions
+			i32				m_updateRef = 0;
+			i32				m_updateIdx = -1;		// slot in the script update list of the node tree
 
 			LuaScript() : m_isStart(false), m_isHaveScript(false), m_file("", ".lua"){}
             void bind(Node* obj);
 			void start(Node* obj);
 			void update(Node* obj);
 			void release(Node* obj);
+
+			// cache the script functions, nodes with update are dispatched by the node tree
+			void resolveFunctions(Node* obj);
+			void resolveUpdate(Node* obj);
+			void releaseFunctions(Node* obj);
 		};
 
 	public:
@@ -61,7 +69,7 @@ namespace Echo
 		void addChild(Node* node);
 		bool removeChild(Node* node);
 
-		void setEnable(bool isEnable) { m_isEnable = isEnable; }
+		void setEnable(bool isEnable);
 		bool isEnable() const { return m_isEnable; }
 
 		// is branch node
@@ -171,6 +179,9 @@ namespace Echo
         // update self
 		virtual void updateInternal(float elapsedTime) {}
 
+		// children added, removed, enabled or disabled
+		virtual void onChildrenChanged() {}
+
 	protected:
 		String			m_name;
 		ResourcePath	m_path;
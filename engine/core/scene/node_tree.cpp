@@ -1,5 +1,7 @@
 #include "node_tree.h"
 #include "engine/core/camera/Camera.h"
+#include "engine/core/main/frame_state.h"
+#include "engine/core/util/Timer.h"
 
 namespace Echo
 {
@@ -77,9 +79,65 @@ namespace Echo
 		m_invisibleRoot->update(elapsedTime, true);
 
 		// Update scripts
-		LuaBinder::instance()->execString("update_all_nodes()", true);
+		updateScripts();
         
         // Update channels
         Channel::syncAll();
     }
+
+	void NodeTree::addScriptNode(Node* node)
+	{
+		if (node->m_script.m_updateIdx < 0)
+		{
+			node->m_script.m_updateIdx = i32(m_scriptNodes.size());
+			m_scriptNodes.push_back(node);
+		}
+	}
+
+	void NodeTree::removeScriptNode(Node* node)
+	{
+		i32 idx = node->m_script.m_updateIdx;
+		if (idx >= 0 && idx < i32(m_scriptNodes.size()) && m_scriptNodes[idx] == node)
+		{
+			// scripts may free nodes while they are dispatched, slots are compacted later
+			m_scriptNodes[idx] = nullptr;
+			m_scriptNodeHoles++;
+		}
+
+		node->m_script.m_updateIdx = -1;
+	}
+
+	void NodeTree::updateScripts()
+	{
+		if (m_scriptNodeHoles)
+		{
+			size_t count = 0;
+			for (Node* node : m_scriptNodes)
+			{
+				if (node)
+				{
+					node->m_script.m_updateIdx = i32(count);
+					m_scriptNodes[count++] = node;
+				}
+			}
+
+			m_scriptNodes.resize(count);
+			m_scriptNodeHoles = 0;
+		}
+
+		// nodes added by scripts are appended and updated in this loop as well
+		ui64 startTime = Time::instance()->getMicroseconds();
+		ui32 calls = 0;
+		for (size_t i = 0; i < m_scriptNodes.size(); i++)
+		{
+			Node* node = m_scriptNodes[i];
+			if (node)
+			{
+				LuaBinder::instance()->callRef(node->m_script.m_updateRef, node->getScriptRef());
+				calls++;
+			}
+		}
+
+		FrameState::instance()->addScriptCalls(calls, ui32(Time::instance()->getMicroseconds() - startTime));
+	}
 }
@@ -40,14 +40,24 @@ namespace Echo
 	public:
 		void update( float elapsedTime);
 
+	public:
+		// nodes with a script update function
+		void addScriptNode(Node* node);
+		void removeScriptNode(Node* node);
+
 	private:
 		NodeTree();
 
+		// call script update of the nodes in one loop
+		void updateScripts();
+
 	protected:
 		Camera*			    m_3dCamera = nullptr;
 		Camera*				m_2dCamera = nullptr;
 		Camera*				m_uiCamera = nullptr;
 		RenderScenePtr		m_renderScene;				// Main render scene
         Node*				m_invisibleRoot = nullptr;	// Invisible root node
+		Node::NodeArray		m_scriptNodes;				// removed nodes leave a null slot until the next update
+		ui32				m_scriptNodeHoles = 0;
 	};
 }
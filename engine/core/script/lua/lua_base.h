@@ -2,6 +2,7 @@
 
 #include "engine/core/base/variant.h"
 #include "engine/core/util/object_pool.h"
+#include "lua_math.h"
 
 extern "C"
 {
@@ -144,11 +145,7 @@ namespace Echo
 	template<> INLINE const Vector2& lua_getvalue<const Vector2&>(lua_State* state, int idx)
 	{
 		Vector2& result = *LuaVec2Pool.newObj();
-		lua_getfield(state, idx, "x");
-		lua_getfield(state, idx, "y");
-		result.x = (float)lua_tonumber(state, -2);
-		result.y = (float)lua_tonumber(state, -1);
-		lua_pop(state, 2);
+		lua_readvec2(state, idx, result);
 		return result;
 	}
 
@@ -161,13 +158,7 @@ namespace Echo
 	template<> INLINE const Vector3& lua_getvalue<const Vector3&>(lua_State* state, int idx) 
 	{
 		Vector3& result = *LuaVec3Pool.newObj();
-		lua_getfield(state, idx, "x");
-		lua_getfield(state, idx, "y");
-		lua_getfield(state, idx, "z");
-		result.x = (float)lua_tonumber(state, -3);
-		result.y = (float)lua_tonumber(state, -2);
-		result.z = (float)lua_tonumber(state, -1);
-		lua_pop(state, 3);
+		lua_readvec3(state, idx, result);
 		return result; 
 	}
 
@@ -180,15 +171,7 @@ namespace Echo
 	template<> INLINE const Quaternion& lua_getvalue<const Quaternion&>(lua_State* state, int idx)
 	{
 		Quaternion& result = *LuaQuaternionPool.newObj();
-		lua_getfield(state, idx, "x");
-		lua_getfield(state, idx, "y");
-		lua_getfield(state, idx, "z");
-		lua_getfield(state, idx, "w");
-		result.x = (float)lua_tonumber(state, -4);
-		result.y = (float)lua_tonumber(state, -3);
-		result.z = (float)lua_tonumber(state, -2);
-		result.w = (float)lua_tonumber(state, -1);
-		lua_pop(state, 4);
+		lua_readquaternion(state, idx, result);
 		return result;
 	}
 
@@ -325,15 +308,7 @@ namespace Echo
 
 	template<> INLINE void lua_pushvalue<const Vector2&>(lua_State* state, const Vector2& value)
 	{
-		lua_newtable(state);
-        int idx = lua_gettop(state);
-		lua_pushnumber(state, value.x);
-		lua_setfield(state, idx, "x");
-		lua_pushnumber(state, value.y);
-		lua_setfield(state, idx, "y");
-        
-        lua_getglobal(state, "vec2");
-        lua_setmetatable(state, idx);
+		lua_pushvec2(state, value);
 	}
 
 	template<> INLINE void lua_pushvalue<const Vector2>(lua_State* state, const Vector2 value)
@@ -343,17 +318,7 @@ namespace Echo
 
 	template<> INLINE void lua_pushvalue<const Vector3&>(lua_State* state, const Vector3& value)
 	{
-		lua_newtable(state);
-		int idx = lua_gettop(state);
-		lua_pushnumber(state, value.x);
-		lua_setfield(state, idx, "x");
-		lua_pushnumber(state, value.y);
-		lua_setfield(state, idx, "y");
-		lua_pushnumber(state, value.z);
-		lua_setfield(state, idx, "z");
-
-		lua_getglobal(state, "vec3");
-		lua_setmetatable(state, idx);
+		lua_pushvec3(state, value);
 	}
 
 	template<> INLINE void lua_pushvalue<const Vector3>(lua_State* state, const Vector3 value)
@@ -363,19 +328,7 @@ namespace Echo
 
 	template<> INLINE void lua_pushvalue<const Quaternion&>(lua_State* state, const Quaternion& value)
 	{
-		lua_newtable(state);
-		int idx = lua_gettop(state);
-		lua_pushnumber(state, value.x);
-		lua_setfield(state, idx, "x");
-		lua_pushnumber(state, value.y);
-		lua_setfield(state, idx, "y");
-		lua_pushnumber(state, value.z);
-		lua_setfield(state, idx, "z");
-		lua_pushnumber(state, value.w);
-		lua_setfield(state, idx, "w");
-
-		lua_getglobal(state, "quaternion");
-		lua_setmetatable(state, idx);
+		lua_pushquaternion(state, value);
 	}
 
 	template<> INLINE void lua_pushvalue<Quaternion>(lua_State* state, Quaternion value)
@@ -149,6 +149,7 @@ namespace Echo
 	{
 		m_luaState = luaL_newstate();
 		luaL_openlibs(m_luaState);
+		lua_register_math(m_luaState);
 
 		addLoader(luaLoaderEcho);
 		setSearchPath("Res://");
@@ -339,6 +340,128 @@ namespace Echo
 		return false;
 	}
 
+	i32 LuaBinder::getGlobalRef(const String& name)
+	{
+		LUA_STACK_CHECK(m_luaState);
+
+		StringArray names = StringUtil::Split(name, ".");
+		lua_getglobal(m_luaState, names[0].c_str());
+		for (size_t idx = 1; idx < names.size() && !lua_isnil(m_luaState, -1); idx++)
+		{
+			lua_getfield(m_luaState, -1, names[idx].c_str());
+			lua_remove(m_luaState, -2);
+		}
+
+		if (lua_isnil(m_luaState, -1))
+		{
+			lua_pop(m_luaState, 1);
+			return 0;
+		}
+
+		return luaL_ref(m_luaState, LUA_REGISTRYINDEX);
+	}
+
+	i32 LuaBinder::getFunctionRef(i32 tableRef, const char* functionName)
+	{
+		if (tableRef <= 0)
+			return 0;
+
+		LUA_STACK_CHECK(m_luaState);
+
+		lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, tableRef);
+		lua_getfield(m_luaState, -1, functionName);
+		if (!lua_isfunction(m_luaState, -1))
+		{
+			lua_pop(m_luaState, 2);
+			return 0;
+		}
+
+		i32 ref = luaL_ref(m_luaState, LUA_REGISTRYINDEX);
+		lua_pop(m_luaState, 1);
+
+		return ref;
+	}
+
+	i32 LuaBinder::execStringRef(const String& script)
+	{
+		LUA_STACK_CHECK(m_luaState);
+
+		if (luaL_loadstring(m_luaState, script.c_str()) || lua_pcall(m_luaState, 0, 1, 0))
+		{
+			outputError();
+			return 0;
+		}
+
+		if (lua_isnil(m_luaState, -1))
+		{
+			lua_pop(m_luaState, 1);
+			return 0;
+		}
+
+		return luaL_ref(m_luaState, LUA_REGISTRYINDEX);
+	}
+
+	void LuaBinder::unref(i32& ref)
+	{
+		if (ref > 0)
+		{
+			luaL_unref(m_luaState, LUA_REGISTRYINDEX, ref);
+			ref = 0;
+		}
+	}
+
+	bool LuaBinder::callRef(i32 functionRef, i32 selfRef, const Variant** args, int argCount)
+	{
+		if (functionRef <= 0)
+			return false;
+
+		LUA_STACK_CHECK(m_luaState);
+
+		int narg = 0;
+		lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, functionRef);
+		if (selfRef > 0)
+		{
+			lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, selfRef);
+			narg++;
+		}
+
+		for (i32 i = 0; i < argCount; i++)
+		{
+			lua_pushvalue(m_luaState, args[i]);
+			narg++;
+		}
+
+		if (lua_pcall(m_luaState, narg, 0, 0) != 0)
+		{
+			outputError();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool LuaBinder::callMethod(i32 tableRef, const char* functionName, const Variant** args, int argCount)
+	{
+		if (tableRef <= 0)
+			return false;
+
+		LUA_STACK_CHECK(m_luaState);
+
+		lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, tableRef);
+		lua_getfield(m_luaState, -1, functionName);
+		lua_insert(m_luaState, -2);
+		for (i32 i = 0; i < argCount; i++)
+			lua_pushvalue(m_luaState, args[i]);
+
+		if (lua_pcall(m_luaState, argCount + 1, 0, 0) != 0)
+		{
+			outputError();
+			return false;
+		}
+
+		return true;
+	}
+
 	bool LuaBinder::getGlobalVariableBoolean(const String& varName)
 	{
 		LUA_STACK_CHECK(m_luaState);
@@ -39,6 +39,25 @@ namespace Echo
 		// exec script directly
 		bool execString(const String& script, bool execute=true);
 
+		// Registry reference of a global value, dotted names are resolved here once instead of on
+		// every call. 0 when the value is nil
+		i32 getGlobalRef(const String& name);
+
+		// reference of a function field of a referenced table, 0 when it isn't a function
+		i32 getFunctionRef(i32 tableRef, const char* functionName);
+
+		// reference of the value the script returns
+		i32 execStringRef(const String& script);
+
+		// release a reference and reset it to 0
+		void unref(i32& ref);
+
+		// call a referenced function, the referenced self table is passed first when not 0
+		bool callRef(i32 functionRef, i32 selfRef, const Variant** args=nullptr, int argCount=0);
+
+		// call a function of a referenced table with the table as self
+		bool callMethod(i32 tableRef, const char* functionName, const Variant** args, int argCount);
+
 		// call lua function with 0-10 parameters
 		template<typename ReturnT> ReturnT call(const char* const functionName, const Variant** args, int argCount);
 
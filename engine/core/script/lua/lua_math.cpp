@@ -0,0 +1,418 @@
+#include "lua_math.h"
+
+namespace Echo
+{
+	// The class table of a type is the metatable of its userdata too, so binders recognize a
+	// value by comparing metatable pointers instead of looking anything up by name
+	struct LuaMathClass
+	{
+		const char*	m_name;
+		int			m_count;
+		const void*	m_metatable;
+		int			m_ref;
+	};
+
+	static LuaMathClass g_vec2Class = { "vec2", 2, nullptr, LUA_NOREF };
+	static LuaMathClass g_vec3Class = { "vec3", 3, nullptr, LUA_NOREF };
+	static LuaMathClass g_quaternionClass = { "quaternion", 4, nullptr, LUA_NOREF };
+
+	template<typename T> static LuaMathClass& MathClass();
+	template<> LuaMathClass& MathClass<Vector2>() { return g_vec2Class; }
+	template<> LuaMathClass& MathClass<Vector3>() { return g_vec3Class; }
+	template<> LuaMathClass& MathClass<Quaternion>() { return g_quaternionClass; }
+
+	// component of a field name, components are x, y, z, w in memory order
+	template<typename T> static int FieldIndex(const char* key, size_t len)
+	{
+		if (len == 1)
+		{
+			int c = key[0] == 'w' ? 3 : key[0] - 'x';
+			if (c >= 0 && c < MathClass<T>().m_count)
+				return c;
+		}
+
+		return -1;
+	}
+
+	template<typename T> static T* ToValue(lua_State* state, int idx)
+	{
+		if (lua_type(state, idx) != LUA_TUSERDATA || !lua_getmetatable(state, idx))
+			return nullptr;
+
+		bool isValue = lua_topointer(state, -1) == MathClass<T>().m_metatable;
+		lua_pop(state, 1);
+
+		return isValue ? static_cast<T*>(lua_touserdata(state, idx)) : nullptr;
+	}
+
+	// userdata or table, false for anything else
+	template<typename T> static bool ReadValue(lua_State* state, int idx, T& result)
+	{
+		if (T* value = ToValue<T>(state, idx))
+		{
+			result = *value;
+			return true;
+		}
+
+		if (lua_istable(state, idx))
+		{
+			static const char* fields[] = { "x", "y", "z", "w" };
+			idx = lua_absindex(state, idx);
+			for (int c = 0; c < MathClass<T>().m_count; c++)
+			{
+				lua_getfield(state, idx, fields[c]);
+				result.m[c] = (Real)lua_tonumber(state, -1);
+				lua_pop(state, 1);
+			}
+
+			return true;
+		}
+
+		for (int c = 0; c < MathClass<T>().m_count; c++)
+			result.m[c] = 0.f;
+
+		return false;
+	}
+
+	template<typename T> static T CheckValue(lua_State* state, int idx)
+	{
+		T result;
+		if (!ReadValue<T>(state, idx, result))
+			luaL_typeerror(state, idx, MathClass<T>().m_name);
+
+		return result;
+	}
+
+	// write back to the value at idx, for methods changing self
+	template<typename T> static void WriteValue(lua_State* state, int idx, const T& value)
+	{
+		if (T* result = ToValue<T>(state, idx))
+		{
+			*result = value;
+		}
+		else if (lua_istable(state, idx))
+		{
+			static const char* fields[] = { "x", "y", "z", "w" };
+			idx = lua_absindex(state, idx);
+			for (int c = 0; c < MathClass<T>().m_count; c++)
+			{
+				lua_pushnumber(state, value.m[c]);
+				lua_setfield(state, idx, fields[c]);
+			}
+		}
+	}
+
+	template<typename T> static void PushValue(lua_State* state, const T& value)
+	{
+		T* result = static_cast<T*>(lua_newuserdatauv(state, sizeof(T), 0));
+		*result = value;
+
+		lua_rawgeti(state, LUA_REGISTRYINDEX, MathClass<T>().m_ref);
+		lua_setmetatable(state, -2);
+	}
+
+	// class:new(...) or class(...), missing components are 0
+	template<typename T> static int New(lua_State* state)
+	{
+		T value;
+		for (int c = 0; c < MathClass<T>().m_count; c++)
+			value.m[c] = (Real)luaL_optnumber(state, c + 2, 0.0);
+
+		PushValue<T>(state, value);
+		return 1;
+	}
+
+	// fields of userdata, methods of the class for both userdata and tables
+	template<typename T> static int Index(lua_State* state)
+	{
+		size_t len = 0;
+		const char* key = lua_type(state, 2) == LUA_TSTRING ? lua_tolstring(state, 2, &len) : nullptr;
+		if (key && lua_type(state, 1) == LUA_TUSERDATA)
+		{
+			int c = FieldIndex<T>(key, len);
+			if (c >= 0)
+			{
+				lua_pushnumber(state, static_cast<T*>(lua_touserdata(state, 1))->m[c]);
+				return 1;
+			}
+		}
+
+		lua_pushvalue(state, 2);
+		lua_rawget(state, lua_upvalueindex(1));
+		return 1;
+	}
+
+	template<typename T> static int NewIndex(lua_State* state)
+	{
+		if (lua_type(state, 1) == LUA_TUSERDATA)
+		{
+			size_t len = 0;
+			const char* key = lua_type(state, 2) == LUA_TSTRING ? lua_tolstring(state, 2, &len) : nullptr;
+			int c = key ? FieldIndex<T>(key, len) : -1;
+			if (c < 0)
+				return luaL_error(state, "%s has no field '%s'", MathClass<T>().m_name, key ? key : "?");
+
+			static_cast<T*>(lua_touserdata(state, 1))->m[c] = (Real)luaL_checknumber(state, 3);
+		}
+		else
+		{
+			lua_rawset(state, 1);
+		}
+
+		return 0;
+	}
+
+	template<typename T> static int Add(lua_State* state)
+	{
+		PushValue<T>(state, CheckValue<T>(state, 1) + CheckValue<T>(state, 2));
+		return 1;
+	}
+
+	template<typename T> static int Sub(lua_State* state)
+	{
+		PushValue<T>(state, CheckValue<T>(state, 1) - CheckValue<T>(state, 2));
+		return 1;
+	}
+
+	template<typename T> static int Unm(lua_State* state)
+	{
+		PushValue<T>(state, -CheckValue<T>(state, 1));
+		return 1;
+	}
+
+	// scale by a number on either side, vectors multiply per component
+	template<typename T> static int Mul(lua_State* state)
+	{
+		if (lua_type(state, 2) == LUA_TNUMBER)
+			PushValue<T>(state, CheckValue<T>(state, 1) * (Real)lua_tonumber(state, 2));
+		else if (lua_type(state, 1) == LUA_TNUMBER)
+			PushValue<T>(state, CheckValue<T>(state, 2) * (Real)lua_tonumber(state, 1));
+		else
+			PushValue<T>(state, CheckValue<T>(state, 1) * CheckValue<T>(state, 2));
+
+		return 1;
+	}
+
+	// quaternion times number, vec3 or quaternion
+	template<> int Mul<Quaternion>(lua_State* state)
+	{
+		if (lua_type(state, 2) == LUA_TNUMBER)
+			PushValue<Quaternion>(state, CheckValue<Quaternion>(state, 1) * (Real)lua_tonumber(state, 2));
+		else if (lua_type(state, 1) == LUA_TNUMBER)
+			PushValue<Quaternion>(state, CheckValue<Quaternion>(state, 2) * (Real)lua_tonumber(state, 1));
+		else if (Vector3* vec = ToValue<Vector3>(state, 2))
+			PushValue<Vector3>(state, CheckValue<Quaternion>(state, 1).rotateVec3(*vec));
+		else
+			PushValue<Quaternion>(state, CheckValue<Quaternion>(state, 1) * CheckValue<Quaternion>(state, 2));
+
+		return 1;
+	}
+
+	template<typename T> static int Eq(lua_State* state)
+	{
+		T a, b;
+		lua_pushboolean(state, ReadValue<T>(state, 1, a) && ReadValue<T>(state, 2, b) && a == b);
+		return 1;
+	}
+
+	template<typename T> static int ToString(lua_State* state)
+	{
+		T value = CheckValue<T>(state, 1);
+		luaL_Buffer buffer;
+		luaL_buffinit(state, &buffer);
+		luaL_addstring(&buffer, MathClass<T>().m_name);
+		for (int c = 0; c < MathClass<T>().m_count; c++)
+		{
+			lua_pushfstring(state, c ? ", %f" : "(%f", lua_Number(value.m[c]));
+			luaL_addvalue(&buffer);
+		}
+
+		luaL_addchar(&buffer, ')');
+		luaL_pushresult(&buffer);
+		return 1;
+	}
+
+	template<typename T> static int Length(lua_State* state)
+	{
+		T value = CheckValue<T>(state, 1);
+		Real sum = 0.f;
+		for (int c = 0; c < MathClass<T>().m_count; c++)
+			sum += value.m[c] * value.m[c];
+
+		lua_pushnumber(state, std::sqrt(sum));
+		return 1;
+	}
+
+	template<typename T> static int Dot(lua_State* state)
+	{
+		lua_pushnumber(state, CheckValue<T>(state, 1).dot(CheckValue<T>(state, 2)));
+		return 1;
+	}
+
+	// vec2 and quaternion return a normalized copy, vec3 normalizes itself and returns self
+	template<typename T> static int Normalize(lua_State* state)
+	{
+		T value = CheckValue<T>(state, 1);
+		value.normalize();
+		PushValue<T>(state, value);
+		return 1;
+	}
+
+	template<> int Normalize<Vector3>(lua_State* state)
+	{
+		Vector3 value = CheckValue<Vector3>(state, 1);
+		value.normalize();
+		WriteValue<Vector3>(state, 1, value);
+		lua_settop(state, 1);
+		return 1;
+	}
+
+	template<typename T> static int Set(lua_State* state)
+	{
+		T value;
+		for (int c = 0; c < MathClass<T>().m_count; c++)
+			value.m[c] = (Real)luaL_optnumber(state, c + 2, 0.0);
+
+		WriteValue<T>(state, 1, value);
+		return 0;
+	}
+
+	static int Vec3Cross(lua_State* state)
+	{
+		PushValue<Vector3>(state, CheckValue<Vector3>(state, 1).cross(CheckValue<Vector3>(state, 2)));
+		return 1;
+	}
+
+	static int QuaternionRotateVec3(lua_State* state)
+	{
+		PushValue<Vector3>(state, CheckValue<Quaternion>(state, 1).rotateVec3(CheckValue<Vector3>(state, 2)));
+		return 1;
+	}
+
+	static int QuaternionGetRadian(lua_State* state)
+	{
+		lua_pushnumber(state, std::acos(Math::Clamp<Real>(CheckValue<Quaternion>(state, 1).w, -1.f, 1.f)) * 2.0);
+		return 1;
+	}
+
+	static int QuaternionGetDegree(lua_State* state)
+	{
+		lua_pushnumber(state, std::acos(Math::Clamp<Real>(CheckValue<Quaternion>(state, 1).w, -1.f, 1.f)) * 2.0 * Math::RAD2DEG);
+		return 1;
+	}
+
+	template<typename T> static void RegisterMathClass(lua_State* state, const luaL_Reg* methods)
+	{
+		const luaL_Reg common[] =
+		{
+			{ "new",		New<T> },
+			{ "length",		Length<T> },
+			{ "normalize",	Normalize<T> },
+			{ "set",		Set<T> },
+			{ "__newindex",	NewIndex<T> },
+			{ "__add",		Add<T> },
+			{ "__sub",		Sub<T> },
+			{ "__mul",		Mul<T> },
+			{ "__unm",		Unm<T> },
+			{ "__eq",		Eq<T> },
+			{ "__tostring",	ToString<T> },
+			{ nullptr,		nullptr }
+		};
+
+		lua_newtable(state);
+		int classIdx = lua_gettop(state);
+		luaL_setfuncs(state, common, 0);
+		if (methods)
+			luaL_setfuncs(state, methods, 0);
+
+		lua_pushvalue(state, classIdx);
+		lua_pushcclosure(state, Index<T>, 1);
+		lua_setfield(state, classIdx, "__index");
+
+		// class(...) constructs like class:new(...)
+		lua_newtable(state);
+		lua_pushcfunction(state, New<T>);
+		lua_setfield(state, -2, "__call");
+		lua_setmetatable(state, classIdx);
+
+		LuaMathClass& info = MathClass<T>();
+		info.m_metatable = lua_topointer(state, classIdx);
+		lua_pushvalue(state, classIdx);
+		info.m_ref = luaL_ref(state, LUA_REGISTRYINDEX);
+
+		lua_setglobal(state, info.m_name);
+	}
+
+	void lua_register_math(lua_State* state)
+	{
+		const luaL_Reg vec2Methods[] =
+		{
+			{ "dot",		Dot<Vector2> },
+			{ nullptr,		nullptr }
+		};
+
+		const luaL_Reg vec3Methods[] =
+		{
+			{ "dot",		Dot<Vector3> },
+			{ "cross",		Vec3Cross },
+			{ nullptr,		nullptr }
+		};
+
+		const luaL_Reg quaternionMethods[] =
+		{
+			{ "rotateVec3",	QuaternionRotateVec3 },
+			{ "getRadian",	QuaternionGetRadian },
+			{ "getDegree",	QuaternionGetDegree },
+			{ nullptr,		nullptr }
+		};
+
+		RegisterMathClass<Vector2>(state, vec2Methods);
+		RegisterMathClass<Vector3>(state, vec3Methods);
+		RegisterMathClass<Quaternion>(state, quaternionMethods);
+	}
+
+	Vector2* lua_tovec2(lua_State* state, int idx)
+	{
+		return ToValue<Vector2>(state, idx);
+	}
+
+	Vector3* lua_tovec3(lua_State* state, int idx)
+	{
+		return ToValue<Vector3>(state, idx);
+	}
+
+	Quaternion* lua_toquaternion(lua_State* state, int idx)
+	{
+		return ToValue<Quaternion>(state, idx);
+	}
+
+	void lua_readvec2(lua_State* state, int idx, Vector2& result)
+	{
+		ReadValue<Vector2>(state, idx, result);
+	}
+
+	void lua_readvec3(lua_State* state, int idx, Vector3& result)
+	{
+		ReadValue<Vector3>(state, idx, result);
+	}
+
+	void lua_readquaternion(lua_State* state, int idx, Quaternion& result)
+	{
+		ReadValue<Quaternion>(state, idx, result);
+	}
+
+	void lua_pushvec2(lua_State* state, const Vector2& value)
+	{
+		PushValue<Vector2>(state, value);
+	}
+
+	void lua_pushvec3(lua_State* state, const Vector3& value)
+	{
+		PushValue<Vector3>(state, value);
+	}
+
+	void lua_pushquaternion(lua_State* state, const Quaternion& value)
+	{
+		PushValue<Quaternion>(state, value);
+	}
+}
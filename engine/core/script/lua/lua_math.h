@@ -0,0 +1,33 @@
+#pragma once
+
+#include "engine/core/math/Math.h"
+
+extern "C"
+{
+#include <thirdparty/lua/lua.h>
+#include <thirdparty/lua/lualib.h>
+#include <thirdparty/lua/lauxlib.h>
+}
+
+namespace Echo
+{
+	// Register the vec2, vec3 and quaternion classes. Values are full userdata with the class
+	// table as metatable, fields and methods are read through it. Tables with x, y, z fields
+	// are still accepted anywhere a value is expected
+	void lua_register_math(lua_State* state);
+
+	// userdata at idx, nullptr when the value is anything else
+	Vector2* lua_tovec2(lua_State* state, int idx);
+	Vector3* lua_tovec3(lua_State* state, int idx);
+	Quaternion* lua_toquaternion(lua_State* state, int idx);
+
+	// read userdata or table
+	void lua_readvec2(lua_State* state, int idx, Vector2& result);
+	void lua_readvec3(lua_State* state, int idx, Vector3& result);
+	void lua_readquaternion(lua_State* state, int idx, Quaternion& result);
+
+	// push new userdata
+	void lua_pushvec2(lua_State* state, const Vector2& value);
+	void lua_pushvec3(lua_State* state, const Vector3& value);
+	void lua_pushquaternion(lua_State* state, const Quaternion& value);
+}
@@ -0,0 +1,181 @@
+#include "job_system.h"
+
+namespace Echo
+{
+	JobSystem::JobSystem()
+	{
+#ifndef ECHO_PLATFORM_HTML5
+		i32 workerCount = std::max<i32>(i32(std::thread::hardware_concurrency()) - 1, 1);
+		for (i32 i = 0; i < workerCount; i++)
+			m_workers.emplace_back(new std::thread(&JobSystem::workerMain, this));
+#endif
+	}
+
+	JobSystem::~JobSystem()
+	{
+#ifndef ECHO_PLATFORM_HTML5
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isQuit = true;
+		}
+
+		m_wakeCondition.notify_all();
+		for (std::thread* worker : m_workers)
+		{
+			worker->join();
+			delete worker;
+		}
+
+		m_workers.clear();
+#endif
+	}
+
+	JobSystem* JobSystem::instance()
+	{
+		static JobSystem* inst = new JobSystem();
+		return inst;
+	}
+
+	bool JobSystem::runBatch(Batch& batch)
+	{
+		bool isClaimed = false;
+		for (;;)
+		{
+			i32 begin = batch.m_next.fetch_add(batch.m_grain);
+			if (begin >= batch.m_count)
+				break;
+
+			i32 end = std::min<i32>(begin + batch.m_grain, batch.m_count);
+			for (i32 i = begin; i < end; i++)
+				(*batch.m_func)(i);
+
+			isClaimed = true;
+#ifndef ECHO_PLATFORM_HTML5
+			if (batch.m_done.fetch_add(end - begin) + (end - begin) == batch.m_count)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_doneCondition.notify_all();
+			}
+#endif
+		}
+
+		return isClaimed;
+	}
+
+	void JobSystem::parallelFor(i32 count, const ForFunc& func, i32 grain)
+	{
+		if (count <= 0)
+			return;
+
+		Batch batch;
+		batch.m_func = &func;
+		batch.m_count = count;
+		batch.m_grain = std::max<i32>(grain, 1);
+		batch.m_next = 0;
+		batch.m_done = 0;
+
+#ifndef ECHO_PLATFORM_HTML5
+		// not worth waking anybody
+		if (m_workers.empty() || count <= batch.m_grain)
+		{
+			for (i32 i = 0; i < count; i++)
+				func(i);
+
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_batches.emplace_back(&batch);
+		}
+		m_wakeCondition.notify_all();
+
+		runBatch(batch);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCondition.wait(lock, [&batch]() { return batch.m_done.load() == batch.m_count && batch.m_workerCount == 0; });
+		m_batches.erase(std::remove(m_batches.begin(), m_batches.end(), &batch), m_batches.end());
+#else
+		runBatch(batch);
+#endif
+	}
+
+	void JobSystem::async(const TaskFunc& task)
+	{
+#ifndef ECHO_PLATFORM_HTML5
+		if (!m_workers.empty())
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_tasks.emplace_back(task);
+			}
+			m_wakeCondition.notify_one();
+			return;
+		}
+#endif
+		task();
+	}
+
+	void JobSystem::workerMain()
+	{
+#ifndef ECHO_PLATFORM_HTML5
+		for (;;)
+		{
+			Batch* batch = nullptr;
+			TaskFunc task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wakeCondition.wait(lock, [this]()
+				{
+					if (m_isQuit || !m_tasks.empty())
+						return true;
+
+					for (Batch* pending : m_batches)
+					{
+						if (pending->m_next.load() < pending->m_count)
+							return true;
+					}
+
+					return false;
+				});
+
+				if (m_isQuit)
+					return;
+
+				for (Batch* pending : m_batches)
+				{
+					if (pending->m_next.load() < pending->m_count)
+					{
+						batch = pending;
+						break;
+					}
+				}
+
+				// the caller keeps the batch alive until every worker has left it
+				if (batch)
+				{
+					batch->m_workerCount++;
+				}
+				else if (!m_tasks.empty())
+				{
+					task = std::move(m_tasks.front());
+					m_tasks.pop_front();
+				}
+			}
+
+			if (batch)
+			{
+				runBatch(*batch);
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				batch->m_workerCount--;
+				m_doneCondition.notify_all();
+			}
+			else if (task)
+			{
+				task();
+			}
+		}
+#endif
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Threading.h"
+#include "engine/core/memory/MemAllocDef.h"
+#include <atomic>
+#include <functional>
+
+namespace Echo
+{
+	// Fixed worker threads running index ranges, the calling thread always takes part
+	// so nested or concurrent parallelFor calls never wait on an idle pool
+	class JobSystem
+	{
+	public:
+		typedef std::function<void(i32)> ForFunc;
+		typedef std::function<void()> TaskFunc;
+
+	public:
+		~JobSystem();
+
+		// instance
+		static JobSystem* instance();
+
+		// threads that can run jobs, calling thread included
+		i32 getThreadCount() const { return i32(m_workers.size()) + 1; }
+
+		// run func(i) for i in [0, count), returns when all indices are done
+		void parallelFor(i32 count, const ForFunc& func, i32 grain = 1);
+
+		// run task on a worker without waiting, parallelFor batches are served first
+		void async(const TaskFunc& task);
+
+	private:
+		JobSystem();
+
+		// range of one parallelFor call
+		struct Batch
+		{
+			const ForFunc*		m_func = nullptr;
+			i32					m_count = 0;
+			i32					m_grain = 1;
+			std::atomic<i32>	m_next;
+			std::atomic<i32>	m_done;
+			i32					m_workerCount = 0;	// workers inside the batch, guarded by m_mutex
+		};
+
+		// run chunks of batch until none is left, returns false if nothing was claimed
+		bool runBatch(Batch& batch);
+
+		// worker loop
+		void workerMain();
+
+	private:
+#ifndef ECHO_PLATFORM_HTML5
+		vector<std::thread*>::type	m_workers;
+		std::mutex					m_mutex;
+		std::condition_variable		m_wakeCondition;
+		std::condition_variable		m_doneCondition;
+		vector<Batch*>::type		m_batches;
+		deque<TaskFunc>::type		m_tasks;
+		bool						m_isQuit = false;
+#else
+		vector<void*>::type			m_workers;
+#endif
+	};
+}
@@ -0,0 +1,355 @@
+#include "anim_compressed_track.h"
+
+namespace Echo
+{
+	// longest run of keys a single interpolated span may replace, bounds the reduction cost
+	static const i32 MaxReduceSpan = 256;
+
+	// range of smallest three components is [-1/sqrt(2), 1/sqrt(2)]
+	static const float RotationComponentRange = 0.70710678f;
+	static const float RotationQuantize = 32767.f;
+
+	// Greedy error bounded reduction. A span [anchor, end] is extended while the interpolation
+	// between its ends reproduces every key inside it, otherwise the previous key is kept
+	template<typename IsWithinT> static void ReduceKeys(i32 count, IsWithinT isWithin, vector<i32>::type& kept)
+	{
+		kept.clear();
+		kept.push_back(0);
+
+		i32 anchor = 0;
+		for (i32 end = 2; end < count; end++)
+		{
+			bool within = end - anchor <= MaxReduceSpan;
+			for (i32 k = anchor + 1; k < end && within; k++)
+				within = isWithin(anchor, end, k);
+
+			if (!within)
+			{
+				anchor = end - 1;
+				kept.push_back(anchor);
+			}
+		}
+
+		if (count > 1)
+			kept.push_back(count - 1);
+	}
+
+	static float SpanRatio(ui32 time, ui32 preTime, ui32 nextTime)
+	{
+		return time <= preTime ? 0.f : Math::Clamp(float(time - preTime) / float(nextTime - preTime), 0.f, 1.f);
+	}
+
+	// Angle between two rotations. acos of the dot can't resolve small angles once the inputs are
+	// off unit length by float rounding, the angle between the 4d vectors is well conditioned
+	static double RotationAngle(const Quaternion& a, const Quaternion& b)
+	{
+		double sign = (double(a.x) * b.x + double(a.y) * b.y + double(a.z) * b.z + double(a.w) * b.w) < 0.0 ? -1.0 : 1.0;
+		double diff = 0.0;
+		double sum = 0.0;
+		for (i32 c = 0; c < 4; c++)
+		{
+			double d = a.m[c] - sign * b.m[c];
+			double s = a.m[c] + sign * b.m[c];
+			diff += d * d;
+			sum += s * s;
+		}
+
+		return 4.0 * std::atan2(std::sqrt(diff), std::sqrt(sum));
+	}
+
+	AnimCompressedTrack* AnimCompressedTrack::compress(const AnimCurve::TimeArray& times, const float* values, i32 channels, AnimCurve::InterpolationType type, ui32 length, float tolerance)
+	{
+		i32 count = i32(times.size());
+		if (!count || channels <= 0 || channels > 4)
+			return nullptr;
+
+		AnimCompressedTrack* track = EchoNew(AnimCompressedTrack);
+		track->m_format = Format::Range;
+		track->m_type = type;
+		track->m_channels = channels;
+		track->m_stride = channels;
+		track->m_length = length;
+		track->m_mins.assign(channels, 0.f);
+		track->m_extents.assign(channels, 0.f);
+
+		for (i32 c = 0; c < channels; c++)
+		{
+			float minValue = values[c];
+			float maxValue = values[c];
+			for (i32 i = 1; i < count; i++)
+			{
+				minValue = std::min<float>(minValue, values[i * channels + c]);
+				maxValue = std::max<float>(maxValue, values[i * channels + c]);
+			}
+
+			track->m_mins[c] = minValue;
+			track->m_extents[c] = maxValue - minValue;
+		}
+
+		// channels whose quantized keys already miss the tolerance are kept as raw floats
+		auto quantize = [&](i32 c, float value)
+		{
+			float extent = track->m_extents[c];
+			float ratio = extent > 0.f ? (value - track->m_mins[c]) / extent : 0.f;
+			return ui16(Math::Clamp(ratio, 0.f, 1.f) * 65535.f + 0.5f);
+		};
+
+		for (i32 c = 0; c < channels; c++)
+		{
+			bool isWithin = true;
+			for (i32 i = 0; i < count && isWithin; i++)
+			{
+				float value = values[i * channels + c];
+				float decoded = track->m_mins[c] + track->m_extents[c] * (float(quantize(c, value)) / 65535.f);
+				isWithin = std::abs(decoded - value) <= tolerance;
+			}
+
+			if (!isWithin)
+			{
+				track->m_rawChannels |= 1u << c;
+				track->m_stride++;
+			}
+		}
+
+		// quantize all keys first, so the reduction measures the error of what is stored
+		vector<ui16>::type records(count * track->m_stride);
+		for (i32 i = 0; i < count; i++)
+		{
+			ui16* record = &records[i * track->m_stride];
+			for (i32 c = 0; c < channels; c++)
+			{
+				float value = values[i * channels + c];
+				if (track->m_rawChannels & (1u << c))
+				{
+					std::memcpy(record, &value, sizeof(float));
+					record += 2;
+				}
+				else
+				{
+					*record++ = quantize(c, value);
+				}
+			}
+		}
+
+		track->m_times = times;
+		track->m_records = records;
+
+		vector<float>::type pre(channels);
+		vector<float>::type next(channels);
+		vector<i32>::type kept;
+		ReduceKeys(count, [&](i32 anchor, i32 end, i32 k)
+		{
+			track->decode(anchor, pre.data());
+			track->decode(end, next.data());
+			float ratio = type == AnimCurve::InterpolationType::Discrete ? 0.f : SpanRatio(times[k], times[anchor], times[end]);
+			for (i32 c = 0; c < channels; c++)
+			{
+				float value = pre[c] + (next[c] - pre[c]) * ratio;
+				if (std::abs(value - values[k * channels + c]) > tolerance)
+					return false;
+			}
+
+			return true;
+		}, kept);
+
+		track->keep(kept, records);
+		return track;
+	}
+
+	AnimCompressedTrack* AnimCompressedTrack::compressRotations(const AnimCurve::TimeArray& times, const Quaternion* values, ui32 length, float tolerance)
+	{
+		i32 count = i32(times.size());
+		if (!count)
+			return nullptr;
+
+		AnimCompressedTrack* track = EchoNew(AnimCompressedTrack);
+		track->m_format = Format::Rotation;
+		track->m_channels = 4;
+		track->m_stride = 3;
+		track->m_length = length;
+
+		vector<ui16>::type records(count * 3);
+		for (i32 i = 0; i < count; i++)
+		{
+			Quaternion q = values[i];
+			q.normalize();
+
+			// drop the largest component, its sign is made positive as q and -q are the same rotation
+			i32 largest = 0;
+			for (i32 c = 1; c < 4; c++)
+			{
+				if (std::abs(q.m[c]) > std::abs(q.m[largest]))
+					largest = c;
+			}
+
+			float sign = q.m[largest] < 0.f ? -1.f : 1.f;
+			ui16* record = &records[i * 3];
+			for (i32 c = 0, r = 0; c < 4; c++)
+			{
+				if (c != largest)
+				{
+					float ratio = (float(q.m[c]) * sign / RotationComponentRange) * 0.5f + 0.5f;
+					record[r++] = ui16(Math::Clamp(ratio, 0.f, 1.f) * RotationQuantize + 0.5f);
+				}
+			}
+
+			record[0] |= ui16((largest & 1) << 15);
+			record[1] |= ui16((largest >> 1) << 15);
+		}
+
+		track->m_times = times;
+		track->m_records = records;
+
+		// kept keys carry the quantization error, the caller keeps the source keys if it is too large
+		Quaternion decoded;
+		for (i32 i = 0; i < count; i++)
+		{
+			track->decode(i, decoded);
+			if (RotationAngle(decoded, values[i]) > tolerance)
+			{
+				EchoSafeDelete(track, AnimCompressedTrack);
+				return nullptr;
+			}
+		}
+
+		Quaternion pre;
+		Quaternion next;
+		Quaternion value;
+		vector<i32>::type kept;
+		ReduceKeys(count, [&](i32 anchor, i32 end, i32 k)
+		{
+			track->decode(anchor, pre);
+			track->decode(end, next);
+			Quaternion::Slerp(value, pre, next, SpanRatio(times[k], times[anchor], times[end]), true);
+			return RotationAngle(value, values[k]) <= tolerance;
+		}, kept);
+
+		track->keep(kept, records);
+		return track;
+	}
+
+	void AnimCompressedTrack::keep(const vector<i32>::type& keys, const vector<ui16>::type& records)
+	{
+		AnimCurve::TimeArray times;
+		times.reserve(keys.size());
+		m_records.clear();
+		m_records.reserve(keys.size() * m_stride);
+		for (i32 key : keys)
+		{
+			times.push_back(m_times[key]);
+			m_records.insert(m_records.end(), records.begin() + key * m_stride, records.begin() + (key + 1) * m_stride);
+		}
+
+		// every kept key with the same record is a constant track
+		bool isConstant = true;
+		for (size_t i = m_stride; i < m_records.size() && isConstant; i++)
+			isConstant = m_records[i] == m_records[i % m_stride];
+
+		if (isConstant)
+		{
+			times.resize(1);
+			m_records.resize(m_stride);
+		}
+
+		m_times.swap(times);
+		m_times.shrink_to_fit();
+		m_records.shrink_to_fit();
+	}
+
+	void AnimCompressedTrack::decode(i32 key, float* values) const
+	{
+		const ui16* record = &m_records[key * m_stride];
+		for (i32 c = 0; c < m_channels; c++)
+		{
+			if (m_rawChannels & (1u << c))
+			{
+				std::memcpy(&values[c], record, sizeof(float));
+				record += 2;
+			}
+			else
+			{
+				values[c] = m_mins[c] + m_extents[c] * (float(*record++) / 65535.f);
+			}
+		}
+	}
+
+	void AnimCompressedTrack::decode(i32 key, Quaternion& value) const
+	{
+		const ui16* record = &m_records[key * m_stride];
+		i32 largest = ((record[0] >> 15) & 1) | (((record[1] >> 15) & 1) << 1);
+
+		float sum = 0.f;
+		for (i32 c = 0, r = 0; c < 4; c++)
+		{
+			if (c != largest)
+			{
+				float component = ((float(record[r++] & 0x7fff) / RotationQuantize) * 2.f - 1.f) * RotationComponentRange;
+				value.m[c] = component;
+				sum += component * component;
+			}
+		}
+
+		value.m[largest] = std::sqrt(std::max<float>(1.f - sum, 0.f));
+	}
+
+	void AnimCompressedTrack::sample(ui32 time, float* values, i32& cursor) const
+	{
+		if (m_times.size() < 2)
+		{
+			if (m_times.empty())
+			{
+				for (i32 c = 0; c < m_channels; c++)
+					values[c] = 0.f;
+			}
+			else
+			{
+				decode(0, values);
+			}
+
+			return;
+		}
+
+		i32 idx = AnimCurve::findKey(m_times, time, cursor);
+		ui32 preTime = m_times[idx];
+		ui32 nextTime = m_times[idx + 1];
+		if (m_type == AnimCurve::InterpolationType::Discrete)
+		{
+			decode(time >= nextTime ? idx + 1 : idx, values);
+		}
+		else
+		{
+			float next[4];
+			decode(idx, values);
+			decode(idx + 1, next);
+
+			float ratio = SpanRatio(time, preTime, nextTime);
+			for (i32 c = 0; c < m_channels; c++)
+				values[c] = values[c] + (next[c] - values[c]) * ratio;
+		}
+	}
+
+	void AnimCompressedTrack::sample(ui32 time, Quaternion& value, i32& cursor) const
+	{
+		if (m_times.size() < 2)
+		{
+			if (m_times.empty())
+				value = Quaternion::IDENTITY;
+			else
+				decode(0, value);
+
+			return;
+		}
+
+		Quaternion pre;
+		Quaternion next;
+		i32 idx = AnimCurve::findKey(m_times, time, cursor);
+		decode(idx, pre);
+		decode(idx + 1, next);
+		Quaternion::Slerp(value, pre, next, SpanRatio(time, m_times[idx], m_times[idx + 1]), true);
+	}
+
+	size_t AnimCompressedTrack::getMemorySize() const
+	{
+		return sizeof(AnimCompressedTrack) + m_times.size() * sizeof(ui32) + m_records.size() * sizeof(ui16) + (m_mins.size() + m_extents.size()) * sizeof(float);
+	}
+}
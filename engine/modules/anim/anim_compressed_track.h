@@ -0,0 +1,54 @@
+#pragma once
+
+#include "engine/core/math/Math.h"
+#include "anim_curve.h"
+
+namespace Echo
+{
+	// Key track reduced within an error bound and quantized to 16 bit. Times are kept apart
+	// for the key search, values are one record per key, so a sample reads two adjacent
+	// records and decodes only them. Channels whose range is too wide for 16 bit to stay
+	// within the error bound are stored as raw floats
+	struct AnimCompressedTrack
+	{
+		enum class Format
+		{
+			Range,				// per channel ui16 relative to the range of the channel, or a raw float in two
+			Rotation,			// smallest three, 15 bits per component, index of the dropped one in the high bits
+		};
+
+		Format							m_format = Format::Range;
+		AnimCurve::InterpolationType	m_type = AnimCurve::InterpolationType::Linear;
+		i32								m_channels = 0;
+		ui32							m_length = 0;		// length of the source track
+		AnimCurve::TimeArray			m_times;
+		vector<float>::type				m_mins;				// Range only
+		vector<float>::type				m_extents;
+		ui32							m_rawChannels = 0;	// Range only, bit per channel stored as raw float
+		vector<ui16>::type				m_records;			// m_stride values per key
+		i32								m_stride = 0;
+
+		// Compress count keys of channels interleaved floats. Max error of any channel at any
+		// source key, kept or dropped, stays within tolerance
+		static AnimCompressedTrack* compress(const AnimCurve::TimeArray& times, const float* values, i32 channels, AnimCurve::InterpolationType type, ui32 length, float tolerance);
+
+		// Compress rotations, tolerance is the max angle in radians. Returns nullptr when the
+		// quantization alone would exceed it
+		static AnimCompressedTrack* compressRotations(const AnimCurve::TimeArray& times, const Quaternion* values, ui32 length, float tolerance);
+
+		// sample
+		void sample(ui32 time, float* values, i32& cursor) const;
+		void sample(ui32 time, Quaternion& value, i32& cursor) const;
+
+		// bytes used
+		size_t getMemorySize() const;
+
+	private:
+		// decode one key
+		void decode(i32 key, float* values) const;
+		void decode(i32 key, Quaternion& value) const;
+
+		// keep the records of the given keys
+		void keep(const vector<i32>::type& keys, const vector<ui16>::type& records);
+	};
+}
@@ -4,40 +4,86 @@
 
 namespace Echo
 {
-	// get value
+	void AnimCurve::cook()
+	{
+		m_times.clear();
+		m_values.clear();
+		m_times.reserve(m_keys.size());
+		m_values.reserve(m_keys.size());
+		for (auto& it : m_keys)
+		{
+			m_times.push_back(it.first);
+			m_values.push_back(it.second);
+		}
+
+		m_cursor = 0;
+		m_isCooked = true;
+	}
+
+	i32 AnimCurve::findKey(const TimeArray& times, ui32 time, i32& cursor)
+	{
+		i32 last = i32(times.size()) - 2;
+		if (last <= 0)
+		{
+			cursor = 0;
+			return 0;
+		}
+
+		// playback moves forward a key at most per frame, so try the cursor and its neighbour first
+		i32 idx = Math::Clamp(cursor, 0, last);
+		if (time < times[idx] || time >= times[idx + 1])
+		{
+			if (idx < last && time >= times[idx + 1] && time < times[idx + 2])
+			{
+				idx++;
+			}
+			else
+			{
+				TimeArray::const_iterator it = std::upper_bound(times.begin(), times.end(), time);
+				idx = Math::Clamp(i32(it - times.begin()) - 1, 0, last);
+			}
+		}
+
+		cursor = idx;
+		return idx;
+	}
+
 	float AnimCurve::getValue(ui32 time)
 	{
-		if (m_keys.empty())
+		return getValue(time, m_cursor);
+	}
+
+	float AnimCurve::getValue(ui32 time, i32& cursor)
+	{
+		if (!m_isCooked)
+			cook();
+
+		if (m_times.empty())
 		{
 			return 0.f;
 		}
 
-		if (m_keys.size() == 1)
+		if (m_times.size() == 1)
 		{
-			return m_keys.begin()->second;
+			return m_values[0];
 		}
 
 		// get base key and next key
-		KeyMap::iterator curKey = m_keys.begin();
-		KeyMap::iterator nextKey = ++m_keys.begin();
-		KeyMap::iterator lastKey = --m_keys.end();
-		for ( ; nextKey !=lastKey; curKey++, nextKey++)
-		{
-			if (time >= curKey->first && time < nextKey->first)
-				break;
-		}
+		i32 idx = findKey(m_times, time, cursor);
+		ui32 curTime = m_times[idx];
+		ui32 nextTime = m_times[idx + 1];
 
 		// calculate
 		switch (m_type)
 		{
 		case InterpolationType::Linear:
 		{
-			float ratio = Math::Clamp(float(time - curKey->first) / float(nextKey->first - curKey->first), 0.f, 1.f);
-			return curKey->second * (1.f - ratio) + nextKey->second * ratio;
+			float ratio = time <= curTime ? 0.f : Math::Clamp(float(time - curTime) / float(nextTime - curTime), 0.f, 1.f);
+			return m_values[idx] * (1.f - ratio) + m_values[idx + 1] * ratio;
 		}
 		case InterpolationType::Discrete:
 		{
-			return curKey->second;
+			return time >= nextTime ? m_values[idx + 1] : m_values[idx];
 		}
 		break;
 		default:
@@ -51,52 +97,31 @@ namespace Echo
 
 	void AnimCurve::setValueByKeyIdx(i32 index, float value)
 	{
-		if (index < (int)m_keys.size())
-		{
-			KeyMap::iterator it = m_keys.begin();
-			while (index > 0)
-			{
-				it++;
-				index--;
-			}
+		if (!m_isCooked)
+			cook();
 
-			it->second = value;
+		if (index >= 0 && index < (int)m_times.size())
+		{
+			m_keys[m_times[index]] = value;
+			m_values[index] = value;
 		}
 	}
 
 	float AnimCurve::getValueByKeyIdx(i32 index)
 	{
-		if (index < (int)m_keys.size())
-		{
-			KeyMap::iterator it = m_keys.begin();
-			while (index > 0)
-			{
-				it++;
-				index--;
-			}
+		if (!m_isCooked)
+			cook();
 
-			return it->second;
-		}
-
-		return 0.f;
+		return index >= 0 && index < (int)m_values.size() ? m_values[index] : 0.f;
 	}
 
 	// get key time by idx
 	ui32 AnimCurve::getKeyTime(int idx)
 	{
-		if (idx < (int)m_keys.size())
-		{
-			KeyMap::iterator it = m_keys.begin();
-			while (idx > 0)
-			{
-				it++;
-				idx--;
-			}
-
-			return it->first;
-		}
+		if (!m_isCooked)
+			cook();
 
-		return 0;
+		return idx >= 0 && idx < (int)m_times.size() ? m_times[idx] : 0;
 	}
 
 	// get time length
@@ -118,6 +143,7 @@ namespace Echo
 	// optimize
 	float AnimCurve::optimize()
 	{
+		cook();
 		return 0.f;
 		//size_t beginNum = m_keys.size();
 		//if (m_type == InterpolationType::Linear)
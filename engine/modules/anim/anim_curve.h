@@ -7,6 +7,7 @@ namespace Echo
 	struct AnimCurve
 	{
 		typedef map<ui32, float>::type KeyMap;
+		typedef vector<ui32>::type TimeArray;
 
 		String					m_name;
 		enum class InterpolationType
@@ -14,7 +15,13 @@ namespace Echo
 			Linear,
 			Discrete,
 		}		m_type = InterpolationType::Linear;
-		KeyMap	m_keys;
+		KeyMap	m_keys;							// authoring form, edited by tools and saved
+
+		// Cooked form for sampling, rebuilt from m_keys when dirty
+		TimeArray				m_times;
+		vector<float>::type		m_values;
+		bool					m_isCooked = false;
+		i32						m_cursor = 0;
 
 		AnimCurve() {}
 
@@ -22,7 +29,7 @@ namespace Echo
 		void setType(InterpolationType type) { m_type = type;}
 
 		// add key
-		void addKey(ui32 time, float value) { m_keys[time] = value; }
+		void addKey(ui32 time, float value) { m_keys[time] = value; m_isCooked = false; }
 
 		// set key value
 		void setValue(ui32 time, float value) { addKey(time, value); }
@@ -31,8 +38,12 @@ namespace Echo
 		// key size
 		i32 getKeyCount() const { return i32(m_keys.size()); }
 
-		// get value
+		// cook flat arrays from the key map
+		void cook();
+
+		// get value, the cursor remembers the last key so forward playback doesn't search
 		float getValue(ui32 time);
+		float getValue(ui32 time, i32& cursor);
 		float getValueByKeyIdx(i32 index);
 
 		// get key time by idx
@@ -45,5 +56,9 @@ namespace Echo
 
 		// optimize
 		float optimize();
+
+		// Index i of the key pair [i, i + 1] around time, clamped to the first and last pair.
+		// The cursor is checked first and updated, so a monotonic time walks in O(1)
+		static i32 findKey(const TimeArray& times, ui32 time, i32& cursor);
 	};
-}
\ No newline at end of file
+}
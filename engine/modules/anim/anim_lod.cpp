@@ -0,0 +1,96 @@
+#include "anim_lod.h"
+#include "engine/core/camera/camera.h"
+
+namespace Echo
+{
+	// a level is only left for a lower one once the coverage is this far below its threshold
+	static const float LodHysteresis = 0.8f;
+
+	AnimLod::AnimLod()
+	{
+	}
+
+	AnimLodLevel AnimLod::calcLevel(const AnimLodState& state, const AABB& worldBox, Camera* camera) const
+	{
+		if (!m_isEnable || !camera || !worldBox.isValid())
+			return AnimLodLevel::Full;
+
+		if (!camera->getFrustum().isAABBIn(worldBox.vMin, worldBox.vMax))
+			return AnimLodLevel::Culled;
+
+		float radius = worldBox.getDiagonalLen() * 0.5f;
+		float coverage = 1.f;
+		if (camera->getProjectionMode() == Camera::ProjMode::PM_ORTHO)
+		{
+			float halfHeight = camera->getHeight() * camera->getScale() * 0.5f;
+			coverage = halfHeight > 0.f ? radius / halfHeight : 1.f;
+		}
+		else
+		{
+			float distance = (worldBox.getCenter() - camera->getPosition()).len();
+			float halfHeight = distance * std::tan(camera->getFov() * 0.5f);
+			coverage = halfHeight > radius ? radius / halfHeight : 1.f;
+		}
+
+		// thresholds of levels at or below the current one are lowered, so small changes of size don't flip levels
+		float reducedCoverage = state.m_level >= AnimLodLevel::Reduced && state.m_level != AnimLodLevel::Culled ? m_reducedCoverage : m_reducedCoverage * LodHysteresis;
+		float farCoverage = state.m_level == AnimLodLevel::Far ? m_farCoverage : m_farCoverage * LodHysteresis;
+		if (coverage < farCoverage)
+			return AnimLodLevel::Far;
+		else if (coverage < reducedCoverage)
+			return AnimLodLevel::Reduced;
+
+		return AnimLodLevel::Full;
+	}
+
+	bool AnimLod::update(AnimLodState& state, const AABB& worldBox, Camera* camera, float frameTime, float& elapsed, bool isBlendable, bool isCullable)
+	{
+		bool isFirst = state.m_frame < 0;
+		state.m_pendingTime += frameTime;
+
+		AnimLodLevel level = calcLevel(state, worldBox, camera);
+		if (level == AnimLodLevel::Culled && !isCullable)
+			level = AnimLodLevel::Far;
+
+		if ((level == AnimLodLevel::Reduced || level == AnimLodLevel::Far) && !isBlendable)
+			level = AnimLodLevel::Full;
+		bool wasCulled = state.m_level == AnimLodLevel::Culled;
+		state.m_level = level;
+		switch (level)
+		{
+		case AnimLodLevel::Reduced:	state.m_interval = m_reducedInterval;	break;
+		case AnimLodLevel::Far:		state.m_interval = m_farInterval;		break;
+		default:					state.m_interval = 1;					break;
+		}
+
+		bool isEvaluate = false;
+		if (level == AnimLodLevel::Culled)
+			isEvaluate = false;
+		else if (isFirst || wasCulled || state.m_interval <= 1)
+			isEvaluate = true;
+		else
+			isEvaluate = ++state.m_frame >= state.m_interval;
+
+		if (isEvaluate)
+		{
+			elapsed = state.m_pendingTime;
+			state.m_pendingTime = 0.f;
+			state.m_isSnap = isFirst || wasCulled;
+
+			// spread instances of the same interval over different frames
+			state.m_frame = isFirst ? i32(m_nextPhase++ % ui32(m_farInterval)) : 0;
+		}
+		else
+		{
+			elapsed = 0.f;
+			state.m_frame = std::max<i32>(state.m_frame, 0);
+		}
+
+		return isEvaluate;
+	}
+
+	float AnimLod::getBlend(const AnimLodState& state)
+	{
+		return state.m_interval > 1 ? Math::Clamp(float(state.m_frame + 1) / float(state.m_interval), 0.f, 1.f) : 1.f;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "engine/core/geom/AABB.h"
+#include "engine/core/memory/MemAllocDef.h"
+
+namespace Echo
+{
+	class Camera;
+
+	// Update rate of an animated instance
+	enum class AnimLodLevel
+	{
+		Full,			// every frame
+		Reduced,		// every ReducedInterval frames
+		Far,			// every FarInterval frames
+		Culled,			// time advance only
+	};
+
+	// Kept by each animated instance
+	struct AnimLodState
+	{
+		AnimLodLevel	m_level = AnimLodLevel::Full;
+		i32				m_interval = 1;
+		i32				m_frame = -1;			// frames since the last evaluation, -1 until the first update
+		float			m_pendingTime = 0.f;	// seconds skipped since the last evaluation
+		bool			m_isSnap = true;		// evaluation after being culled, blending instances jump to the pose
+	};
+
+	// Picks the update rate of animated instances from frustum visibility and the projected size
+	// of their bounds. Instances ask every frame and advance by the accumulated time when told to
+	// evaluate, so a throttled or culled instance always shows the pose of the current time
+	class AnimLod
+	{
+	public:
+		AnimLod();
+
+		// enable
+		bool isEnable() const { return m_isEnable; }
+		void setEnable(bool isEnable) { m_isEnable = isEnable; }
+
+		// Projected size, bounds radius over the half screen height, below which a level is used
+		float getReducedCoverage() const { return m_reducedCoverage; }
+		void setReducedCoverage(float coverage) { m_reducedCoverage = coverage; }
+		float getFarCoverage() const { return m_farCoverage; }
+		void setFarCoverage(float coverage) { m_farCoverage = coverage; }
+
+		// Frames between evaluations
+		i32 getReducedInterval() const { return m_reducedInterval; }
+		void setReducedInterval(i32 interval) { m_reducedInterval = std::max<i32>(interval, 1); }
+		i32 getFarInterval() const { return m_farInterval; }
+		void setFarInterval(i32 interval) { m_farInterval = std::max<i32>(interval, 1); }
+
+		// Advance the state by one frame. Returns true when the instance should evaluate, elapsed
+		// is then the time to advance by including the skipped frames. Invalid bounds or no camera
+		// keep the instance at full rate. Only instances that blend towards their last evaluation, see
+		// getBlend, are throttled, the others would visibly step. Instances that aren't cullable,
+		// because they drive more than what is drawn, are updated instead of culled
+		bool update(AnimLodState& state, const AABB& worldBox, Camera* camera, float frameTime, float& elapsed, bool isBlendable, bool isCullable = true);
+
+		// Position of a skipped frame inside the interval, for instances interpolating towards their last evaluation
+		static float getBlend(const AnimLodState& state);
+
+	private:
+		// level from visibility and coverage
+		AnimLodLevel calcLevel(const AnimLodState& state, const AABB& worldBox, Camera* camera) const;
+
+	private:
+		bool	m_isEnable = true;
+		float	m_reducedCoverage = 0.1f;
+		float	m_farCoverage = 0.03f;
+		i32		m_reducedInterval = 2;
+		i32		m_farInterval = 4;
+		ui32	m_nextPhase = 0;
+	};
+}
@@ -18,7 +18,22 @@ namespace Echo
 
 	void AnimModule::bindMethods()
 	{
+		CLASS_BIND_METHOD(AnimModule, isLodEnable);
+		CLASS_BIND_METHOD(AnimModule, setLodEnable);
+		CLASS_BIND_METHOD(AnimModule, getLodReducedCoverage);
+		CLASS_BIND_METHOD(AnimModule, setLodReducedCoverage);
+		CLASS_BIND_METHOD(AnimModule, getLodFarCoverage);
+		CLASS_BIND_METHOD(AnimModule, setLodFarCoverage);
+		CLASS_BIND_METHOD(AnimModule, getLodReducedInterval);
+		CLASS_BIND_METHOD(AnimModule, setLodReducedInterval);
+		CLASS_BIND_METHOD(AnimModule, getLodFarInterval);
+		CLASS_BIND_METHOD(AnimModule, setLodFarInterval);
 
+		CLASS_REGISTER_PROPERTY(AnimModule, "LodEnable", Variant::Type::Bool, isLodEnable, setLodEnable);
+		CLASS_REGISTER_PROPERTY(AnimModule, "LodReducedCoverage", Variant::Type::Real, getLodReducedCoverage, setLodReducedCoverage);
+		CLASS_REGISTER_PROPERTY(AnimModule, "LodFarCoverage", Variant::Type::Real, getLodFarCoverage, setLodFarCoverage);
+		CLASS_REGISTER_PROPERTY(AnimModule, "LodReducedInterval", Variant::Type::Int, getLodReducedInterval, setLodReducedInterval);
+		CLASS_REGISTER_PROPERTY(AnimModule, "LodFarInterval", Variant::Type::Int, getLodFarInterval, setLodFarInterval);
 	}
 
 	void AnimModule::registerTypes()
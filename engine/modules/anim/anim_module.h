@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/core/main/module.h"
+#include "anim_lod.h"
 
 namespace Echo
 {
@@ -16,5 +17,23 @@ namespace Echo
 
 		// register all types of the module
 		virtual void registerTypes() override;
+
+		// animation lod shared by all animated nodes
+		AnimLod& getLod() { return m_lod; }
+
+		// lod settings
+		bool isLodEnable() const { return m_lod.isEnable(); }
+		void setLodEnable(bool isEnable) { m_lod.setEnable(isEnable); }
+		float getLodReducedCoverage() const { return m_lod.getReducedCoverage(); }
+		void setLodReducedCoverage(float coverage) { m_lod.setReducedCoverage(coverage); }
+		float getLodFarCoverage() const { return m_lod.getFarCoverage(); }
+		void setLodFarCoverage(float coverage) { m_lod.setFarCoverage(coverage); }
+		i32 getLodReducedInterval() const { return m_lod.getReducedInterval(); }
+		void setLodReducedInterval(i32 interval) { m_lod.setReducedInterval(interval); }
+		i32 getLodFarInterval() const { return m_lod.getFarInterval(); }
+		void setLodFarInterval(i32 interval) { m_lod.setFarInterval(interval); }
+
+	private:
+		AnimLod		m_lod;
 	};
 }
@@ -39,6 +39,7 @@ namespace Echo
     AnimPropertyCurve::~AnimPropertyCurve()
     {
         EchoSafeDeleteContainer(m_curves, AnimCurve);
+        EchoSafeDelete(m_compressed, AnimCompressedTrack);
     }
 
 	void AnimPropertyCurve::setInterpolationType(AnimCurve::InterpolationType type)
@@ -52,14 +53,136 @@ namespace Echo
 
 	void AnimPropertyCurve::optimize()
 	{
+		if (m_compressed)
+			return;
+
 		for (AnimCurve* curve : m_curves)
 		{
 			curve->optimize();
 		}
+
+		cook();
+	}
+
+	void AnimPropertyCurve::cook()
+	{
+		for (AnimCurve* curve : m_curves)
+		{
+			if (!curve->m_isCooked)
+				curve->cook();
+		}
+
+		// curves keyed at the same times (all imported clips) share one time array
+		m_isShared = !m_curves.empty();
+		for (size_t i = 1; i < m_curves.size() && m_isShared; i++)
+			m_isShared = m_curves[i]->m_times == m_curves[0]->m_times;
+
+		m_times.clear();
+		m_values.clear();
+		if (m_isShared)
+		{
+			size_t stride = m_curves.size();
+			m_times = m_curves[0]->m_times;
+			m_values.resize(m_times.size() * stride);
+			for (size_t c = 0; c < stride; c++)
+			{
+				const vector<float>::type& values = m_curves[c]->m_values;
+				for (size_t k = 0; k < values.size(); k++)
+					m_values[k * stride + c] = values[k];
+			}
+		}
+
+		m_cursor = 0;
+		m_isCooked = true;
+	}
+
+	void AnimPropertyCurve::compress(float tolerance)
+	{
+		if (m_compressed)
+			return;
+
+		// only curves keyed together can share a track
+		cook();
+		if (!m_isShared)
+			return;
+
+		m_compressed = AnimCompressedTrack::compress(m_times, m_values.data(), i32(m_curves.size()), m_curves[0]->m_type, getLength(), tolerance);
+		if (m_compressed)
+		{
+			for (AnimCurve* curve : m_curves)
+			{
+				AnimCurve::KeyMap().swap(curve->m_keys);
+				AnimCurve::TimeArray().swap(curve->m_times);
+				vector<float>::type().swap(curve->m_values);
+			}
+
+			AnimCurve::TimeArray().swap(m_times);
+			vector<float>::type().swap(m_values);
+		}
+	}
+
+	void AnimPropertyCurve::sample(ui32 time, float* values, i32& cursor)
+	{
+		if (m_compressed)
+		{
+			m_compressed->sample(time, values, cursor);
+			return;
+		}
+
+		bool isCooked = m_isCooked;
+		for (size_t i = 0; i < m_curves.size() && isCooked; i++)
+			isCooked = m_curves[i]->m_isCooked;
+
+		if (!isCooked)
+			cook();
+
+		i32 stride = i32(m_curves.size());
+		// curves keyed apart search from the instance cursor, their own one is shared by all instances
+		if (!m_isShared)
+		{
+			i32 first = cursor;
+			for (i32 c = 0; c < stride; c++)
+			{
+				i32 channelCursor = first;
+				values[c] = m_curves[c]->getValue(time, channelCursor);
+				cursor = c == 0 ? channelCursor : cursor;
+			}
+
+			return;
+		}
+
+		if (m_times.size() < 2)
+		{
+			for (i32 c = 0; c < stride; c++)
+				values[c] = m_times.empty() ? 0.f : m_values[c];
+
+			return;
+		}
+
+		i32 idx = AnimCurve::findKey(m_times, time, cursor);
+		ui32 curTime = m_times[idx];
+		ui32 nextTime = m_times[idx + 1];
+		const float* pre = &m_values[idx * stride];
+		const float* next = pre + stride;
+		if (m_curves[0]->m_type == AnimCurve::InterpolationType::Discrete)
+		{
+			const float* key = time >= nextTime ? next : pre;
+			for (i32 c = 0; c < stride; c++)
+				values[c] = key[c];
+		}
+		else
+		{
+			float ratio = time <= curTime ? 0.f : Math::Clamp(float(time - curTime) / float(nextTime - curTime), 0.f, 1.f);
+			for (i32 c = 0; c < stride; c++)
+				values[c] = pre[c] + (next[c] - pre[c]) * ratio;
+		}
 	}
 
 	ui32 AnimPropertyCurve::getLength()
 	{
+		if (m_compressed)
+			return m_compressed->m_length;
+
 		ui32 length = 0;
 		for (AnimCurve* curve : m_curves)
 		{
@@ -73,11 +196,13 @@ namespace Echo
 	void AnimPropertyCurve::setKeyValue(int curveIdx, int keyIdx, float value)
 	{
 		m_curves[curveIdx]->setValueByKeyIdx(keyIdx, value);
+		m_isCooked = false;
 	}
 
 	void AnimPropertyCurve::addKeyToCurve(int curveIdx, ui32 time, float value)
 	{
 		m_curves[curveIdx]->addKey(time, value);
+		m_isCooked = false;
 	}
 
 	AnimPropertyFloat::AnimPropertyFloat()
@@ -88,12 +213,13 @@ namespace Echo
 	{
 		for (size_t i = 0; i < m_curves.size(); i++)
 			m_curves[i]->addKey(time, value);
+
+		m_isCooked = false;
 	}
 
 	void AnimPropertyFloat::updateToTime(ui32 time, ui32 deltaTime)
 	{
-		for (size_t i = 0; i < m_curves.size(); i++)
-			m_value = m_curves[i]->getValue(time);
+		sample(time, &m_value, m_cursor);
 	}
 
 	AnimPropertyVec3::AnimPropertyVec3()
@@ -104,12 +230,13 @@ namespace Echo
 	{
 		for (int i = 0; i < int(m_curves.size()); i++)
 			m_curves[i]->addKey(time, value[i]);
+
+		m_isCooked = false;
 	}
 
 	void AnimPropertyVec3::updateToTime(ui32 time, ui32 deltaTime)
 	{
-		for (int i = 0; i < int(m_curves.size()); i++)
-			m_value[i] = m_curves[i]->getValue(time);
+		sample(time, &m_value.x, m_cursor);
 	}
 
 	AnimPropertyVec4::AnimPropertyVec4() 
@@ -120,35 +247,47 @@ namespace Echo
 	{
 		for (int i = 0; i < int(m_curves.size()); i++)
 			m_curves[i]->addKey(time, value[i]);
+
+		m_isCooked = false;
 	}
 
 	void AnimPropertyVec4::updateToTime(ui32 time, ui32 deltaTime)
 	{
-		for (int i = 0; i < int(m_curves.size()); i++)
-			m_value[i] = m_curves[i]->getValue(time);
+		sample(time, &m_value.x, m_cursor);
 	}
 
 	void AnimPropertyBool::addKey(ui32 time, bool value)
 	{
 		m_keys[time] = value;
+		m_isCooked = false;
+	}
+
+	void AnimPropertyBool::cook()
+	{
+		m_times.clear();
+		m_values.clear();
+		for (auto& it : m_keys)
+		{
+			m_times.push_back(it.first);
+			m_values.push_back(it.second);
+		}
+
+		m_isCooked = true;
 	}
 
 	void AnimPropertyBool::updateToTime(ui32 time, ui32 deltaTime)
 	{
 		if (deltaTime)
 		{
-			m_isActive = false;
-
-			for (auto it : m_keys)
-			{
-				ui32 preTime = time - deltaTime;
-				if (it.first >= preTime && it.first <= time)
-				{
-					m_value = it.second;
-					m_isActive = true;
-					break;
-				}
-			}
+			if (!m_isCooked)
+				cook();
+
+			// first key inside [time - deltaTime, time]
+			ui32 preTime = time - deltaTime;
+			AnimCurve::TimeArray::const_iterator it = std::lower_bound(m_times.begin(), m_times.end(), preTime);
+			m_isActive = it != m_times.end() && *it <= time;
+			if (m_isActive)
+				m_value = m_values[it - m_times.begin()];
 		}
 	}
 
@@ -170,42 +309,96 @@ namespace Echo
 	void AnimPropertyQuat::addKey(ui32 time, const Quaternion& value)
 	{
 		m_keys.emplace_back(time, value);
+		m_isCooked = false;
 	}
 
-	ui32 AnimPropertyQuat::getLength()
+	void AnimPropertyQuat::cook()
 	{
-		return m_keys.size() ? m_keys.back().m_time : 0;
+		vector<Key>::type keys = m_keys;
+		std::stable_sort(keys.begin(), keys.end(), [](const Key& a, const Key& b) { return a.m_time < b.m_time; });
+
+		m_times.clear();
+		m_values.clear();
+		m_times.reserve(keys.size());
+		m_values.reserve(keys.size());
+		for (const Key& key : keys)
+		{
+			m_times.push_back(key.m_time);
+			m_values.push_back(key.m_value);
+		}
+
+		m_cursor = 0;
+		m_isCooked = true;
 	}
 
-	void AnimPropertyQuat::updateToTime(ui32 time, ui32 deltaTime)
+	void AnimPropertyQuat::sample(ui32 time, Quaternion& value, i32& cursor)
 	{
-		if (m_keys.empty())
+		if (m_compressed)
+		{
+			m_compressed->sample(time, value, cursor);
+			return;
+		}
+
+		if (!m_isCooked)
+			cook();
+
+		if (m_times.empty())
 		{
-			m_vlaue = Quaternion::IDENTITY;
+			value = Quaternion::IDENTITY;
 		}
-		else if (m_keys.size() == 1)
+		else if (m_times.size() == 1)
 		{
-			m_vlaue = m_keys[0].m_value;
+			value = m_values[0];
 		}
 		else
 		{
-			// get base key and next key
-			i32 curKey = 0;
-			i32 keyTotal = i32(m_keys.size()) - 1;
-			for (i32 i = 0; i < keyTotal; i++)
-			{
-				if (time > m_keys[i].m_time && time < m_keys[i + 1].m_time)
-					curKey = i;
-			}
+			i32 idx = AnimCurve::findKey(m_times, time, cursor);
+			ui32 preTime = m_times[idx];
+			ui32 nextTime = m_times[idx + 1];
+			float ratio = time <= preTime ? 0.f : Math::Clamp(float(time - preTime) / float(nextTime - preTime), 0.f, 1.f);
+			Quaternion::Slerp(value, m_values[idx], m_values[idx + 1], ratio, true);
+		}
+	}
 
-			// calculate value
-			const Key& pre = m_keys[curKey];
-			const Key& next = m_keys[curKey + 1];
-			float ratio = Math::Clamp(float(time - pre.m_time) / float(next.m_time - pre.m_time), 0.f, 1.f);
-			Quaternion::Slerp(m_vlaue, pre.m_value, next.m_value, ratio, true);
+	AnimPropertyQuat::~AnimPropertyQuat()
+	{
+		EchoSafeDelete(m_compressed, AnimCompressedTrack);
+	}
+
+	void AnimPropertyQuat::optimize()
+	{
+		if (!m_compressed)
+			cook();
+	}
+
+	void AnimPropertyQuat::compress(float tolerance)
+	{
+		if (m_compressed)
+			return;
+
+		cook();
+		m_compressed = AnimCompressedTrack::compressRotations(m_times, m_values.data(), getLength(), tolerance);
+		if (m_compressed)
+		{
+			vector<Key>::type().swap(m_keys);
+			AnimCurve::TimeArray().swap(m_times);
+			vector<Quaternion>::type().swap(m_values);
 		}
 	}
 
+	ui32 AnimPropertyQuat::getLength()
+	{
+		if (m_compressed)
+			return m_compressed->m_length;
+
+		return m_keys.size() ? m_keys.back().m_time : 0;
+	}
+
+	void AnimPropertyQuat::updateToTime(ui32 time, ui32 deltaTime)
+	{
+		sample(time, m_vlaue, m_cursor);
+	}
+
 	ui32 AnimPropertyObject::getLength()
 	{
 		return 0;
@@ -219,24 +412,35 @@ namespace Echo
 	void AnimPropertyString::addKey(ui32 time, const String& value)
 	{
 		m_keys[time] = value;
+		m_isCooked = false;
+	}
+
+	void AnimPropertyString::cook()
+	{
+		m_times.clear();
+		m_values.clear();
+		for (auto& it : m_keys)
+		{
+			m_times.push_back(it.first);
+			m_values.push_back(it.second);
+		}
+
+		m_isCooked = true;
 	}
 
 	void AnimPropertyString::updateToTime(ui32 time, ui32 deltaTime)
 	{
 		if (deltaTime)
 		{
-			m_isActive = false;
-
-			for (auto it : m_keys)
-			{
-				ui32 preTime = time - deltaTime;
-				if (it.first >= preTime && it.first <= time)
-				{
-					m_value = it.second;
-					m_isActive = true;
-					break;
-				}
-			}
+			if (!m_isCooked)
+				cook();
+
+			// first key inside [time - deltaTime, time]
+			ui32 preTime = time - deltaTime;
+			AnimCurve::TimeArray::const_iterator it = std::lower_bound(m_times.begin(), m_times.end(), preTime);
+			m_isActive = it != m_times.end() && *it <= time;
+			if (m_isActive)
+				m_value = m_values[it - m_times.begin()];
 		}
 	}
 
@@ -3,6 +3,7 @@
 #include "engine/core/base/variant.h"
 #include "engine/core/math/Math.h"
 #include "anim_curve.h"
+#include "anim_compressed_track.h"
 
 namespace Echo
 {
@@ -36,6 +37,10 @@ namespace Echo
 		// optimize
 		virtual void optimize() = 0;
 
+		// Replace the keys by a compressed track for playback only, keys can't be edited or
+		// saved afterwards. tolerance is in value units, radians for rotations
+		virtual void compress(float tolerance) {}
+
 		// update to time
 		virtual void updateToTime(ui32 time, ui32 deltaTime) = 0;
 
@@ -53,6 +58,15 @@ namespace Echo
 	{
 		vector<AnimCurve*>::type m_curves;
 
+		// Cooked form, when all curves share key times the values are interleaved per key
+		// so every channel is sampled with one search and one blend loop
+		AnimCurve::TimeArray	m_times;
+		vector<float>::type		m_values;
+		bool					m_isCooked = false;
+		bool					m_isShared = false;
+		i32						m_cursor = 0;
+		AnimCompressedTrack*	m_compressed = nullptr;
+
 		AnimPropertyCurve(Type type, i32 curveCount);
         virtual ~AnimPropertyCurve();
 
@@ -62,6 +76,9 @@ namespace Echo
 		// optimize
 		virtual void optimize() override;
 
+		// compress
+		virtual void compress(float tolerance) override;
+
 		// update to time
 		virtual void updateToTime(ui32 time, ui32 deltaTime) override{}
 
@@ -73,6 +90,12 @@ namespace Echo
 
 		// add key
 		void addKeyToCurve(int curveIdx, ui32 time, float value);
+
+		// cook flat arrays from the curves
+		void cook();
+
+		// sample all curves into values, one float per curve
+		void sample(ui32 time, float* values, i32& cursor);
 	};
 
 	struct AnimPropertyFloat : public AnimPropertyCurve
@@ -131,6 +154,11 @@ namespace Echo
 		bool	m_value;
 		bool	m_isActive = false;
 
+		// Cooked form for sampling
+		AnimCurve::TimeArray	m_times;
+		vector<bool>::type		m_values;
+		bool					m_isCooked = false;
+
 		AnimPropertyBool() : AnimProperty(Type::Bool) {}
 
 		// is active
@@ -142,11 +170,14 @@ namespace Echo
 		// add key
 		void addKey(ui32 time, bool value);
 
+		// cook flat arrays from the key map
+		void cook();
+
 		// correct data
 		virtual void correct() {}
 
 		// optimize
-		virtual void optimize() override {}
+		virtual void optimize() override { cook(); }
 
 		// update to time
 		virtual void updateToTime(ui32 time, ui32 deltaTime) override;
@@ -173,7 +204,15 @@ namespace Echo
 		Quaternion				m_vlaue;
 		vector<Key>::type		m_keys;
 
+		// Cooked form for sampling
+		AnimCurve::TimeArray		m_times;
+		vector<Quaternion>::type	m_values;
+		bool						m_isCooked = false;
+		i32							m_cursor = 0;
+		AnimCompressedTrack*		m_compressed = nullptr;
+
 		AnimPropertyQuat() : AnimProperty(Type::Quaternion), m_vlaue(Quaternion::IDENTITY) {}
+		virtual ~AnimPropertyQuat();
 
 		// get value
 		const Quaternion& getValue() { return m_vlaue; }
@@ -181,11 +220,20 @@ namespace Echo
 		// add key
 		void addKey(ui32 time, const Quaternion& value);
 
+		// cook flat arrays from the keys
+		void cook();
+
+		// sample
+		void sample(ui32 time, Quaternion& value, i32& cursor);
+
 		// correct data
 		virtual void correct() {}
 
 		// optimize
-		virtual void optimize() override {}
+		virtual void optimize() override;
+
+		// compress
+		virtual void compress(float tolerance) override;
 
 		// update to time
 		virtual void updateToTime(ui32 time, ui32 deltaTime) override;
@@ -219,6 +267,11 @@ namespace Echo
 		Echo::String	m_value;
 		bool			m_isActive = false;
 
+		// Cooked form for sampling
+		AnimCurve::TimeArray		m_times;
+		vector<String>::type		m_values;
+		bool						m_isCooked = false;
+
 		AnimPropertyString() : AnimProperty(Type::String) {}
 
 		// is active
@@ -230,11 +283,14 @@ namespace Echo
 		// add key
 		void addKey(ui32 time, const String& value);
 
+		// cook flat arrays from the key map
+		void cook();
+
 		// correct data
 		virtual void correct() {}
 
 		// optimize
-		virtual void optimize() override {}
+		virtual void optimize() override { cook(); }
 
 		// update to time
 		virtual void updateToTime(ui32 time, ui32 deltaTime) override;
@@ -1,6 +1,8 @@
 #include "anim_timeline.h"
+#include "anim_module.h"
 #include "engine/core/main/Engine.h"
 #include "engine/core/scene/node.h"
+#include "engine/core/scene/render_node.h"
 #include <thirdparty/pugixml/pugixml.hpp>
 #include <thirdparty/pugixml/pugiconfig.hpp>
 #include <thirdparty/pugixml/pugixml_ext.hpp>
@@ -52,6 +54,7 @@ namespace Echo
 			m_animations.addOption(clip->m_name);
 
 			m_isAnimDataDirty = true;
+			m_isLodTargetsDirty = true;
 		}
 	}
 
@@ -90,6 +93,7 @@ namespace Echo
 				m_animations.removeOption(animName);
 
 				m_isAnimDataDirty = true;
+				m_isLodTargetsDirty = true;
 
 				break;
 			}
@@ -102,19 +106,26 @@ namespace Echo
 		m_animations.m_options[idx] = newName;
 
 		m_isAnimDataDirty = true;
+		m_isLodTargetsDirty = true;
 	}
 
 	void Timeline::updateInternal(float elapsedTime)
 	{
 		if (m_animations.isValid() && m_playState == PlayState::Playing)
 		{
-			ui32 deltaTime = Engine::instance()->getFrameTimeMS();
 			AnimClip* clip = m_clips[m_animations.getIdx()];
 			if (clip)
 			{
-				clip->update(ui32(deltaTime * m_timeScale));
+				// timelines not animating any render node have no bounds and always run at full rate
+				updateLodBounds(clip);
 
-				extractClipData(clip);
+				float elapsed = 0.f;
+				if (AnimModule::instance()->getLod().update(m_lodState, m_lodBox, m_lodCamera, Engine::instance()->getFrameTime(), elapsed, false, m_isLodCullable))
+				{
+					clip->update(ui32(elapsed * 1000.f * m_timeScale));
+
+					extractClipData(clip);
+				}
 			}
 		}
 	}
@@ -224,6 +235,7 @@ namespace Echo
 		// clear
 		EchoSafeDeleteContainer(m_clips, AnimClip);
 		m_animData = data;
+		m_isLodTargetsDirty = true;
 
 		// parse clips
 		pugi::xml_document doc; 
@@ -341,6 +353,7 @@ namespace Echo
 			clip->m_objects.emplace_back(animNode);
 
 			m_isAnimDataDirty = true;
+			m_isLodTargetsDirty = true;
 		}
 	}
 
@@ -384,6 +397,7 @@ namespace Echo
 					{
 						animObject->addProperty(propertyName, propertyType);
 						m_isAnimDataDirty = true;
+						m_isLodTargetsDirty = true;
 
 						return true;
 					}
@@ -428,6 +442,7 @@ namespace Echo
 
 		// dirty flag
 		m_isAnimDataDirty = true;
+		m_isLodTargetsDirty = true;
 	}
 
 	void Timeline::setKey(const String& animName, const String& objectPath, const String& propertyName, int curveIdx, int keyIdx, float value)
@@ -457,6 +472,63 @@ namespace Echo
 		}
 	}
 
+	void Timeline::updateLodTargets(AnimClip* clip)
+	{
+		m_lodTargets.clear();
+		m_lodClip = clip;
+		m_isLodTargetsDirty = false;
+		m_isLodCullable = true;
+
+		for (AnimObject* animNode : clip->m_objects)
+		{
+			const ObjectUserData& objUserData = any_cast<ObjectUserData>(animNode->m_userData);
+			for (AnimProperty* property : animNode->m_properties)
+			{
+				// bool, string and object tracks drive logic, which has to run off screen too
+				AnimProperty::Type type = property->getType();
+				if (type == AnimProperty::Type::Bool || type == AnimProperty::Type::String || type == AnimProperty::Type::Object)
+					m_isLodCullable = false;
+
+				Echo::Object* node = getLastObject(objUserData.m_path.c_str(), StringUtil::Split(property->m_name));
+				Render* render = dynamic_cast<Render*>(node);
+				if (render)
+				{
+					if (std::find(m_lodTargets.begin(), m_lodTargets.end(), render->getId()) == m_lodTargets.end())
+						m_lodTargets.push_back(render->getId());
+				}
+				else if (node)
+				{
+					m_isLodCullable = false;
+				}
+			}
+		}
+	}
+
+	void Timeline::updateLodBounds(AnimClip* clip)
+	{
+		if (m_isLodTargetsDirty || clip != m_lodClip)
+			updateLodTargets(clip);
+
+		m_lodBox.reset();
+		m_lodCamera = nullptr;
+		for (i32 id : m_lodTargets)
+		{
+			// ids aren't reused, a target found is still the render node it was
+			Render* render = static_cast<Render*>(Object::getById(id));
+			if (!render)
+			{
+				m_isLodTargetsDirty = true;
+			}
+			else if (render->getLocalAABB().isValid())
+			{
+				AABB worldBox;
+				render->buildWorldAABB(worldBox);
+				m_lodBox.unionBox(worldBox);
+				m_lodCamera = m_lodCamera ? m_lodCamera : render->getCamera();
+			}
+		}
+	}
+
 	void Timeline::extractClipData(AnimClip* clip)
 	{
 		if (clip)
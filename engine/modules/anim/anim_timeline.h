@@ -3,6 +3,7 @@
 #include "engine/core/scene/node.h"
 #include "engine/core/util/base64.h"
 #include "anim_clip.h"
+#include "anim_lod.h"
 
 namespace Echo
 {
@@ -116,6 +117,11 @@ namespace Echo
 		// apply clip
 		void extractClipData(AnimClip* clip);
 
+		// world bounds of the animated render nodes, rebuilt every frame as they may be moved by anything.
+		// The render nodes are resolved once per clip and again when the clips change
+		void updateLodBounds(AnimClip* clip);
+		void updateLodTargets(AnimClip* clip);
+
 		// get anim property type by node path and property name
 		AnimProperty::Type getAnimPropertyType(const String& objectPath, const StringArray& propertyChain);
 		Variant::Type getAnimPropertyVariableType(const String& objectPath, const StringArray& propertyChain);
@@ -130,5 +136,12 @@ namespace Echo
 		String					m_animData;
 		bool					m_isAnimDataDirty = false;
 		StringOption			m_animations = StringOption("");
+		AnimLodState			m_lodState;
+		AABB					m_lodBox;			// world bounds of the animated render nodes this frame
+		Camera*					m_lodCamera = nullptr;
+		bool					m_isLodCullable = true;		// only animates render nodes, nothing runs while off screen
+		vector<i32>::type		m_lodTargets;				// ids of the animated render nodes
+		AnimClip*				m_lodClip = nullptr;
+		bool					m_isLodTargetsDirty = true;
 	};
 }
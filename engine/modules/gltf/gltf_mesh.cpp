@@ -1,4 +1,5 @@
 #include "gltf_mesh.h"
+#include "gltf_module.h"
 #include "engine/core/log/Log.h"
 #include "engine/core/scene/node_tree.h"
 #include "base/renderer.h"
@@ -25,6 +26,7 @@ namespace Echo
 
 	GltfMesh::~GltfMesh()
 	{
+		GltfModule::instance()->removeMesh(this);
 		clear();
 	}
 
@@ -90,7 +92,7 @@ namespace Echo
 			const GltfSkinInfo& skinInfo = m_asset->m_skins[m_skinIdx];
 			if (skinInfo.m_joints.size())
 			{
-				m_jointMatrixs.resize(/*skinInfo.m_joints.size()*/ 72);
+				m_jointMatrixs.assign(GltfSkeleton::MaxJoints, Matrix4::IDENTITY);
 			}
 		}
 
@@ -148,10 +150,12 @@ namespace Echo
 				m_skeletonDirty = false;
 			}
 
+			// node transform and skin palette come from the skeleton once it is evaluated
 			if (m_skeleton)
 			{
-				syncGltfNodeAnim();
-				syncGltfSkinAnim();
+				GltfModule::instance()->addMesh(this);
+				if (m_skinIdx != -1)
+					m_skeleton->getSkinPalette(m_skinIdx);
 			}
 
 			if(/*m_isUseLight*/ true)
@@ -171,26 +175,9 @@ namespace Echo
 		if (m_skeleton)
 		{
 			if (m_skeleton->getGltfNodeTransform(m_localTransform, m_nodeIdx))
-				needUpdate();
-		}
-	}
-
-	void GltfMesh::syncGltfSkinAnim()
-	{
-		if (m_skeleton && m_skinIdx!=-1)
-		{
-			Transform tranform;
-
-			const GltfSkinInfo& skinInfo = m_asset->m_skins[m_skinIdx];
-			for (size_t i = 0; i < skinInfo.m_joints.size(); i++)
 			{
-				if (m_skeleton->getGltfNodeTransform(tranform, skinInfo.m_joints[i]))
-				{
-					tranform.buildMatrix(m_jointMatrixs[i]);
-
-					// inverse matrix
-					m_jointMatrixs[i] = skinInfo.m_inverseMatrixs[i] * m_jointMatrixs[i];
-				}
+				needUpdate();
+				getWorldMatrix();
 			}
 		}
 	}
@@ -229,7 +216,8 @@ namespace Echo
 		}
 		else if (name == "u_JointMatrixs")
 		{
-			return m_jointMatrixs.data();
+			const vector<Matrix4>::type* palette = m_skeleton ? m_skeleton->getSkinPalette(m_skinIdx) : nullptr;
+			return palette ? (void*)palette->data() : (void*)m_jointMatrixs.data();
 		}
 		else if (name == "u_DiffuseEnvSampler")
 		{
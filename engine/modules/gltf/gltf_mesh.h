@@ -42,6 +42,9 @@ namespace Echo
 		const NodePath& getSkeletonPath() { return m_skeletonPath; }
 		void setSkeletonPath(const NodePath& skeletonPath);
 
+		// gltf anim, called by GltfModule once the skeleton pose of this frame is evaluated
+		void syncGltfNodeAnim();
+
 	protected:
 		// build drawable
 		void buildRenderable();
@@ -56,10 +59,6 @@ namespace Echo
 		void clear();
 		void clearRenderable();
 
-		// gltf anim
-		void syncGltfNodeAnim();
-		void syncGltfSkinAnim();
-
 		// light data
 		void syncLightData();
 
@@ -67,7 +66,7 @@ namespace Echo
 		bool					m_renderableDirty = true;
 		RenderProxyPtr			m_renderable;
 		Matrix4					m_matWVP;
-		ResourcePath			m_assetPath = ResourcePath("", ".gltf");
+		ResourcePath			m_assetPath = ResourcePath("", ".gltf|.glb");
 		GltfResPtr				m_asset;			                        // gltf asset ptr
 		i32						m_nodeIdx = -1;			                       // node index in the asset, used by skeleton
 		i32						m_meshIdx;			                        // mesh index in the asset
@@ -78,7 +77,7 @@ namespace Echo
 		NodePath				m_skeletonPath;
 		bool					m_skeletonDirty;	                        // dirty flag
 		GltfSkeleton*			m_skeleton;
-		vector<Matrix4>::type	m_jointMatrixs;
+		vector<Matrix4>::type	m_jointMatrixs;								// bind pose, used until a skeleton palette is available
 		i32						m_iblDiffuseSlot;
 		i32						m_iblSpecularSlot;
 		i32						m_iblBrdfSlot;
@@ -1,6 +1,7 @@
 #include "gltf_module.h"
 #include "gltf_mesh.h"
 #include "gltf_skeleton.h"
+#include "engine/core/thread/job_system.h"
 
 namespace Echo
 {
@@ -27,4 +28,44 @@ namespace Echo
 		Class::registerType<GltfMesh>();
 		Class::registerType<GltfSkeleton>();
 	}
-}
\ No newline at end of file
+
+	void GltfModule::lateUpdate(float elapsedTime)
+	{
+		// instances only write their own pose
+		if (!m_skeletons.empty())
+		{
+			JobSystem::instance()->parallelFor(i32(m_skeletons.size()), [this](i32 i)
+			{
+				m_skeletons[i]->evaluate();
+			}, 4);
+		}
+
+		for (GltfMesh* mesh : m_meshes)
+			mesh->syncGltfNodeAnim();
+
+		m_skeletons.clear();
+		m_meshes.clear();
+	}
+
+	void GltfModule::addSkeleton(GltfSkeleton* skeleton)
+	{
+		// nodes update once per frame, so no duplicates
+		m_skeletons.emplace_back(skeleton);
+	}
+
+	void GltfModule::removeSkeleton(GltfSkeleton* skeleton)
+	{
+		m_skeletons.erase(std::remove(m_skeletons.begin(), m_skeletons.end(), skeleton), m_skeletons.end());
+	}
+
+	void GltfModule::addMesh(GltfMesh* mesh)
+	{
+		// nodes update once per frame, so no duplicates
+		m_meshes.emplace_back(mesh);
+	}
+
+	void GltfModule::removeMesh(GltfMesh* mesh)
+	{
+		m_meshes.erase(std::remove(m_meshes.begin(), m_meshes.end(), mesh), m_meshes.end());
+	}
+}
@@ -4,6 +4,9 @@
 
 namespace Echo
 {
+	class GltfSkeleton;
+	class GltfMesh;
+
 	class GltfModule : public Module
 	{
 		ECHO_SINGLETON_CLASS(GltfModule, Module)
@@ -16,5 +19,20 @@ namespace Echo
 
 		// register all types of the module
 		virtual void registerTypes() override;
+
+		// evaluate skeletons advanced this frame, then sync meshes bound to them
+		virtual void lateUpdate(float elapsedTime) override;
+
+		// skeletons to evaluate this frame
+		void addSkeleton(GltfSkeleton* skeleton);
+		void removeSkeleton(GltfSkeleton* skeleton);
+
+		// meshes following a skeleton this frame
+		void addMesh(GltfMesh* mesh);
+		void removeMesh(GltfMesh* mesh);
+
+	private:
+		vector<GltfSkeleton*>::type	m_skeletons;
+		vector<GltfMesh*>::type		m_meshes;
 	};
 }
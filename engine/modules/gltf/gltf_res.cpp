@@ -4,26 +4,35 @@
 #include "gltf_skeleton.h"
 #include "engine/core/io/stream/DataStream.h"
 #include "engine/core/log/Log.h"
+#include "engine/core/thread/job_system.h"
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/util/base64.h"
 #include "engine/core/util/magic_enum.hpp"
 #include "engine/modules/light/light_module.h"
+#include "engine/core/render/base/renderer.h"
+#include "engine/core/render/base/image/image.h"
+#include "engine/core/render/base/image/pixel_util.h"
 
 namespace Echo
 {
 	// init static variables
 	GltfMaterialInfo  GltfMaterialInfo::DEFAULT = GltfMaterialInfo();
 
+	// error bounds of animation compression, rotations in radians
+	static const float AnimTranslationTolerance = 0.0005f;
+	static const float AnimRotationTolerance = 0.0005f;
+	static const float AnimScaleTolerance = 0.0005f;
+
 	// parse float value of json node
 	static bool parseJsonValueFloat(float& oValue, nlohmann::json& json, const String& key, bool isMustExist)
 	{
-		if (json.find(key) != json.end())
+		nlohmann::json::iterator it = json.find(key);
+		if (it != json.end())
 		{
-			nlohmann::json& subJson = json[key];
-			if (!subJson.is_number())
+			if (!it->is_number())
 				return false;
 
-			oValue = subJson.get<float>();
+			oValue = it->get<float>();
 
 			return true;
 		}
@@ -34,13 +43,13 @@ namespace Echo
 	// parse int value of json node
 	static bool parseJsonValueI32(i32& oValue, nlohmann::json& json, const String& key, bool isMustExist)
 	{
-		if (json.find(key) != json.end())
+		nlohmann::json::iterator it = json.find(key);
+		if (it != json.end())
 		{
-			nlohmann::json& subJson = json[key];
-			if (!subJson.is_number())
+			if (!it->is_number())
 				return false;
 
-			oValue = subJson.get<i32>();
+			oValue = it->get<i32>();
 
 			return true;
 		}
@@ -51,13 +60,13 @@ namespace Echo
 	// parse int value of json node
 	static bool parseJsonValueUI32(ui32& oValue, nlohmann::json& json, const String& key, bool isMustExist)
 	{
-		if (json.find(key) != json.end())
+		nlohmann::json::iterator it = json.find(key);
+		if (it != json.end())
 		{
-			nlohmann::json& subJson = json[key];
-			if (!subJson.is_number())
+			if (!it->is_number())
 				return false;
 
-			oValue = subJson.get<i32>();
+			oValue = it->get<i32>();
 
 			return true;
 		}
@@ -69,13 +78,13 @@ namespace Echo
 	// parse bool value of json node
 	static bool parseJsonValueBool(bool& oValue, nlohmann::json& json, const String& key, bool isMustExist)
 	{
-		if (json.find(key) != json.end())
+		nlohmann::json::iterator it = json.find(key);
+		if (it != json.end())
 		{
-			nlohmann::json& subJson = json[key];
-			if (!subJson.is_boolean())
+			if (!it->is_boolean())
 				return false;
 
-			oValue = subJson.get<bool>();
+			oValue = it->get<bool>();
 
 			return true;
 		}
@@ -86,13 +95,13 @@ namespace Echo
 	// parse string value of json node
 	static bool parseJsonValueString(String& oValue, nlohmann::json& json, const String& key, bool isMustExist)
 	{
-		if (json.find(key) != json.end())
+		nlohmann::json::iterator it = json.find(key);
+		if (it != json.end())
 		{
-			nlohmann::json& subJson = json[key];
-			if (!subJson.is_string())
+			if (!it->is_string())
 				return false;
 
-			oValue = subJson.get<std::string>();
+			oValue = it->get<std::string>();
 
 			return true;
 		}
@@ -125,97 +134,180 @@ namespace Echo
 	// load
 	bool GltfRes::load()
 	{
-		MemoryReader memReader(m_path.getPath());
-		if (memReader.getSize())
+		// the file is only mapped while loading, buffer views of a glb point into it
+		if (m_file.open(m_path.getPath()))
 		{
-			using namespace nlohmann;
-			json j =  json::parse(memReader.getData<char*>());
+			m_fileData = m_file.getData<const Byte*>();
+			m_fileSize = m_file.getSize();
+		}
+		else
+		{
+			m_reader = EchoNew(MemoryReader(m_path.getPath()));
+			m_fileData = m_reader->getData<const Byte*>();
+			m_fileSize = m_reader->getSize();
+		}
 
-			// load asset
-			if (!loadAsset(j))
-			{
-				EchoLogError("gltf parse asset failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		if (m_fileData && m_fileSize)
+			m_isLoaded = loadFile();
 
-			if (!loadScenes(j))
-			{
-				EchoLogError("gltf parse scenes failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		releaseBufferData();
+		EchoSafeDelete(m_reader, MemoryReader);
+		m_file.close();
+		m_fileData = nullptr;
+		m_fileSize = 0;
 
-			if (!loadNodes(j))
-			{
-				EchoLogError("gltf parse nodes failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		return m_isLoaded;
+	}
 
-			if (!loadBuffers(j))
-			{
-				EchoLogError("gltf parse buffers failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+	// drop extras while parsing, nothing reads them
+	static bool DiscardJsonExtras(int depth, nlohmann::json::parse_event_t event, nlohmann::json& parsed)
+	{
+		return !(event == nlohmann::json::parse_event_t::key && parsed == "extras");
+	}
 
-			if (!loadBufferViews(j))
-			{
-				EchoLogError("gltf parse bufferViews failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+	bool GltfRes::loadFile()
+	{
+		const Byte* jsonBegin = m_fileData;
+		const Byte* jsonEnd = jsonBegin + m_fileSize;
+		if (!loadGlbChunks(jsonBegin, jsonEnd))
+		{
+			EchoLogError("gltf parse glb chunks failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
 
-			if (!loadAccessors(j))
-			{
-				EchoLogError("gltf parse accessors failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		// parsed in place from the mapped file, without exceptions
+		nlohmann::json j = nlohmann::json::parse(jsonBegin, jsonEnd, DiscardJsonExtras, false);
+		if (j.is_discarded())
+		{
+			EchoLogError("gltf parse json failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
 
-			if (!loadMaterials(j))
-			{
-				EchoLogError("gltf parse materials failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		// load asset
+		if (!loadAsset(j))
+		{
+			EchoLogError("gltf parse asset failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
 
-			if (!loadImages(j))
-			{
-				EchoLogError("gltf parse images failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		if (!loadScenes(j))
+		{
+			EchoLogError("gltf parse scenes failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
 
-			if (!loadSamplers(j))
-			{
-				EchoLogError("gltf parse samples failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		if (!loadNodes(j))
+		{
+			EchoLogError("gltf parse nodes failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
 
-			if (!loadTextures(j))
-			{
-				EchoLogError("gltf parse textures failed when load resource [%s].", m_path.getPath().c_str());
-				return false;
-			}
+		if (!loadBuffers(j))
+		{
+			EchoLogError("gltf parse buffers failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
 
-			if (!loadMeshes(j))
-			{
-				EchoLogError("gltf parse meshes failed when load resource [%s].", m_path.getPath().c_str());
+		if (!loadBufferViews(j))
+		{
+			EchoLogError("gltf parse bufferViews failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadAccessors(j))
+		{
+			EchoLogError("gltf parse accessors failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadMaterials(j))
+		{
+			EchoLogError("gltf parse materials failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadImages(j))
+		{
+			EchoLogError("gltf parse images failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadSamplers(j))
+		{
+			EchoLogError("gltf parse samples failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadTextures(j))
+		{
+			EchoLogError("gltf parse textures failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadMeshes(j))
+		{
+			EchoLogError("gltf parse meshes failed when load resource [%s].", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadSkins(j))
+		{
+			EchoLogError("gltf parse skins failed when load resource [%s]", m_path.getPath().c_str());
+			return false;
+		}
+
+		if (!loadAnimations(j))
+		{
+			EchoLogError("gltf parse animations failed when load resource [%s]", m_path.getPath().c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool GltfRes::loadGlbChunks(const Byte*& jsonBegin, const Byte*& jsonEnd)
+	{
+		static const ui32 GlbMagic = 0x46546C67;		// "glTF"
+		static const ui32 GlbChunkJson = 0x4E4F534A;	// "JSON"
+		static const ui32 GlbChunkBin = 0x004E4942;		// "BIN"
+
+		// text gltf, the whole file is json
+		size_t size = m_fileSize;
+		const Byte* data = m_fileData;
+		if (size < 12 || *(const ui32*)data != GlbMagic)
+			return true;
+
+		ui32 version = *(const ui32*)(data + 4);
+		ui32 length = *(const ui32*)(data + 8);
+		if (version != 2 || length > size)
+			return false;
+
+		jsonBegin = nullptr;
+		jsonEnd = nullptr;
+		for (ui32 offset = 12; offset + 8 <= length;)
+		{
+			ui32 chunkLength = *(const ui32*)(data + offset);
+			ui32 chunkType = *(const ui32*)(data + offset + 4);
+			const Byte* chunk = data + offset + 8;
+			if (chunkLength > length - offset - 8)
 				return false;
-			}
 
-			if (!loadSkins(j))
+			if (chunkType == GlbChunkJson && !jsonBegin)
 			{
-				EchoLogError("gltf parse skins failed when load resource [%s]", m_path.getPath().c_str());
-				return false;
+				jsonBegin = chunk;
+				jsonEnd = chunk + chunkLength;
 			}
-
-			if (!loadAnimations(j))
+			else if (chunkType == GlbChunkBin && !m_binChunk)
 			{
-				EchoLogError("gltf parse animations failed when load resource [%s]", m_path.getPath().c_str());
-				return false;
+				m_binChunk = chunk;
+				m_binChunkSize = chunkLength;
 			}
 
-			m_isLoaded = true;
-
-			return true;
+			// chunks are 4 byte aligned, unknown chunk types are skipped
+			offset += 8 + ((chunkLength + 3) & ~3u);
 		}
 
-		return false;
+		return jsonBegin != nullptr;
 	}
 
 	bool GltfRes::loadAsset(nlohmann::json& json)
@@ -443,19 +535,25 @@ namespace Echo
 				}
 			}
 
-			if (!loadBufferData(m_buffers[i]))
+			if (!loadBufferData(m_buffers[i], i))
 				return false;
 		}
 
 		return true;
 	}
 
-	bool GltfRes::loadBufferData(GltfBufferInfo& buffer)
+	bool GltfRes::loadBufferData(GltfBufferInfo& buffer, ui32 bufferIdx)
 	{
-		if (buffer.m_uri.empty() && buffer.m_byteLength > 0)
-			return false;
+		// the first buffer of a glb has no uri, its data is the binary chunk
+		if (buffer.m_uri.empty())
+		{
+			if (bufferIdx != 0 || !m_binChunk)
+				return buffer.m_byteLength <= 0;
+
+			buffer.m_data = m_binChunk;
+			return buffer.m_byteLength <= i32(m_binChunkSize);
+		}
 
-		// create MemoryReader based on Uri type
 		if (buffer.m_uriType == GltfBufferInfo::UriType::Data)
 		{
 			// extract data
@@ -463,26 +561,44 @@ namespace Echo
 						
 			// decode base64 data
 			Base64Decode decode(base64Data);
-			if (!decode.getSize())
+			if (!decode.getSize() || buffer.m_byteLength != i32(decode.getSize()))
 				return false;
 
-			// construct memReader
-			buffer.m_data = EchoNew(MemoryReader(decode.getData(), decode.getSize()));
-			if (buffer.m_byteLength != buffer.m_data->getSize())
-				return false;
+			buffer.m_decoded.assign(decode.getData(), decode.getData() + decode.getSize());
+			buffer.m_data = buffer.m_decoded.data();
+			return true;
 		}
 		else
 		{
-			buffer.m_data = EchoNew(MemoryReader(buffer.m_uri));
-		}
+			// external buffers are mapped, views read them in place
+			buffer.m_file = EchoNew(MemoryMappedFile);
+			if (buffer.m_file->open(buffer.m_uri))
+			{
+				if (buffer.m_file->getSize() < size_t(buffer.m_byteLength))
+					return false;
 
-		// is have data
-		if (buffer.m_data->getSize())
-		{
+				buffer.m_data = buffer.m_file->getData<const Byte*>();
+				return true;
+			}
+
+			// files inside packages are read instead
+			buffer.m_reader = EchoNew(MemoryReader(buffer.m_uri));
+			if (buffer.m_reader->getSize() < ui32(std::max<i32>(buffer.m_byteLength, 1)))
+				return false;
+
+			buffer.m_data = buffer.m_reader->getData<const Byte*>();
 			return true;
 		}
+	}
 
-		return false;
+	void GltfRes::releaseBufferData()
+	{
+		// everything read from buffers is copied into meshes, skins and clips by now
+		for (GltfBufferInfo& buffer : m_buffers)
+			buffer.release();
+
+		m_binChunk = nullptr;
+		m_binChunkSize = 0;
 	}
 
 	bool GltfRes::loadAccessors(nlohmann::json& json)
@@ -730,6 +846,14 @@ namespace Echo
 						case GltfAccessorInfo::Type::Vec4:		addKeyToAnimProperty<Quaternion, AnimPropertyQuat>(timeAccess, keyAccess, animProperty);break;
                         default: break;
 						}
+
+						// playback only, the keys of imported clips are never edited
+						switch (channel.m_path)
+						{
+						case GltfAnimChannel::Path::Rotation:	animProperty->compress(AnimRotationTolerance);	break;
+						case GltfAnimChannel::Path::Scale:		animProperty->compress(AnimScaleTolerance);		break;
+						default:								animProperty->compress(AnimTranslationTolerance);	break;
+						}
 					}
 
 					animClip->m_objects.emplace_back(animNode);
@@ -802,45 +926,72 @@ namespace Echo
 				{
 					m_meshes[i].m_primitives[j].m_attributes[it.key()] = it.value();
 				}
-
-				if (!buildPrimitiveData(i, j))
-				{
-					EchoLogError("gltf build primitive data error");
-				}
 			}
 		}
-		return true;
+
+		return buildMeshes();
 	}
 
-	bool GltfRes::buildPrimitiveData(int meshIdx, int primitiveIdx)
+	bool GltfRes::buildMeshes()
 	{
-		GltfPrimitive& primitive = m_meshes[meshIdx].m_primitives[primitiveIdx];
-		const GltfAttributes& attributes = primitive.m_attributes;
+		struct PrimitiveRef
+		{
+			i32	m_mesh;
+			i32	m_primitive;
+		};
 
-		// indices
-		void* indicesDataVoid = nullptr;
-		ui32  indicesCount = 0;
-		ui32  indicesStride = 0;
-		if (primitive.m_indices != -1)
+		vector<PrimitiveRef>::type primitives;
+		for (size_t i = 0; i < m_meshes.size(); i++)
 		{
-			GltfAccessorInfo&   access = m_accessors[primitive.m_indices];
-			indicesDataVoid = getAccessData<Byte*>(access);
-			indicesCount = access.m_count;
+			for (size_t j = 0; j < m_meshes[i].m_primitives.size(); j++)
+				primitives.push_back({ i32(i), i32(j) });
+		}
 
-			// stride
-			if (access.m_componentType == GltfAccessorInfo::UnsignedByte)
-				indicesStride = 1;
-			else if (access.m_componentType == GltfAccessorInfo::UnsignedShort)
-				indicesStride = 2;
-			else if (access.m_componentType == GltfAccessorInfo::UnsignedInt)
-				indicesStride = 4;
-			else
-			{
-				EchoLogError("gltf mesh index type isn't UnsignedShort when buildPrimitiveData()");
-				return false;
-			}
+		// accessor conversion only reads the mapped buffers, primitives are converted on workers
+		vector<MeshVertexData>::type vertexDatas(primitives.size());
+		vector<ui8>::type results(primitives.size(), 0);
+		JobSystem::instance()->parallelFor(i32(primitives.size()), [&](i32 i)
+		{
+			const PrimitiveRef& ref = primitives[i];
+			results[i] = buildPrimitiveVertexData(m_meshes[ref.m_mesh].m_primitives[ref.m_primitive], vertexDatas[i]);
+		});
+
+		// meshes and materials are created on this thread
+		for (size_t i = 0; i < primitives.size(); i++)
+		{
+			if (!results[i] || !buildPrimitiveData(primitives[i].m_mesh, primitives[i].m_primitive, vertexDatas[i]))
+				EchoLogError("gltf build primitive data error");
+
+			vertexDatas[i].reset();
 		}
 
+		return true;
+	}
+
+	const Byte* GltfRes::getAccessData(const GltfAccessorInfo& access, ui32 elementSize, ui32& stride)
+	{
+		if (access.m_bufferView < 0 || access.m_bufferView >= i32(m_bufferViews.size()))
+			return nullptr;
+
+		const GltfBufferViewInfo& bufferView = m_bufferViews[access.m_bufferView];
+		if (bufferView.m_bufferIdx >= m_buffers.size())
+			return nullptr;
+
+		const GltfBufferInfo& buffer = m_buffers[bufferView.m_bufferIdx];
+		stride = bufferView.m_byteStride ? bufferView.m_byteStride : elementSize;
+
+		// data is read in place, so everything the accessor covers has to be inside the buffer
+		ui64 end = ui64(access.m_byteOffset) + (access.m_count ? ui64(stride) * (access.m_count - 1) + elementSize : 0);
+		if (!buffer.m_data || end > bufferView.m_byteLength || ui64(bufferView.m_byteOffset) + bufferView.m_byteLength > ui64(buffer.m_byteLength))
+			return nullptr;
+
+		return buffer.m_data + bufferView.m_byteOffset + access.m_byteOffset;
+	}
+
+	bool GltfRes::buildPrimitiveVertexData(const GltfPrimitive& primitive, MeshVertexData& vertexData)
+	{
+		const GltfAttributes& attributes = primitive.m_attributes;
+
 		// parse vertex format
 		MeshVertexFormat vertFormat;
 		vertFormat.m_isUseNormal = attributes.find("NORMAL") != attributes.end();
@@ -849,10 +1000,13 @@ namespace Echo
 		vertFormat.m_isUseBlendingData = attributes.find("WEIGHTS_0") != attributes.end() && attributes.find("JOINTS_0") != attributes.end();
 
 		// parse vertex count
-		int vertCount = 0;
-		for (auto& it : primitive.m_attributes)
+		ui32 vertCount = 0;
+		for (auto& it : attributes)
 		{
-			GltfAccessorInfo&  access = m_accessors[it.second];
+			if (it.second >= m_accessors.size())
+				return false;
+
+			const GltfAccessorInfo& access = m_accessors[it.second];
 			if (vertCount != 0 && vertCount != access.m_count)
 				return false;
 
@@ -860,112 +1014,142 @@ namespace Echo
 		}
 
 		// init vertex data
-		MeshVertexData vertexData;
 		vertexData.set(vertFormat, vertCount);
 
 		// vertices data
-		for (auto& it : primitive.m_attributes)
+		ui32 stride = 0;
+		for (auto& it : attributes)
 		{
-			int attributeIdx = it.second;
-			GltfAccessorInfo&   access = m_accessors[attributeIdx];
-			vertexData.set(vertFormat, access.m_count);
+			const GltfAccessorInfo& access = m_accessors[it.second];
 			if (it.first == "POSITION")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec3 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector3* positions = getAccessData<Vector3*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setPosition(i, positions[i]);
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec3 || access.m_componentType != GltfAccessorInfo::ComponentType::Float)
 					return false;
-				}
+
+				const Byte* positions = getAccessData(access, sizeof(Vector3), stride);
+				if (!positions)
+					return false;
+
+				for (ui32 i = 0; i < vertCount; i++)
+					vertexData.setPosition(i, *(const Vector3*)(positions + i * stride));
 			}
 			else if (it.first == "NORMAL")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec3 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector3* normals = getAccessData<Vector3*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setNormal(i, normals[i]);
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec3 || access.m_componentType != GltfAccessorInfo::ComponentType::Float)
 					return false;
-				}
+
+				const Byte* normals = getAccessData(access, sizeof(Vector3), stride);
+				if (!normals)
+					return false;
+
+				for (ui32 i = 0; i < vertCount; i++)
+					vertexData.setNormal(i, *(const Vector3*)(normals + i * stride));
 			}
 			else if (it.first == "TEXCOORD_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec2 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector2* uv0s = getAccessData<Vector2*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setUV0(i, uv0s[i]);
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec2 || access.m_componentType != GltfAccessorInfo::ComponentType::Float)
 					return false;
-				}
+
+				const Byte* uv0s = getAccessData(access, sizeof(Vector2), stride);
+				if (!uv0s)
+					return false;
+
+				for (ui32 i = 0; i < vertCount; i++)
+					vertexData.setUV0(i, *(const Vector2*)(uv0s + i * stride));
 			}
 			else if (it.first == "COLOR_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec4 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Color* color0s = getAccessData<Color*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setColor(i, color0s[i]);
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec4 || access.m_componentType != GltfAccessorInfo::ComponentType::Float)
 					return false;
-				}
+
+				const Byte* color0s = getAccessData(access, sizeof(Color), stride);
+				if (!color0s)
+					return false;
+
+				for (ui32 i = 0; i < vertCount; i++)
+					vertexData.setColor(i, *(const Color*)(color0s + i * stride));
 			}
 			else if (it.first == "WEIGHTS_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec4 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector4* weights = getAccessData<Vector4*>(access);
-					for (int i = 0; i < vertCount; i++)
-					{
-						vertexData.setWeight(i, weights[i]);
-					}
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec4 || access.m_componentType != GltfAccessorInfo::ComponentType::Float)
 					return false;
-				}
+
+				const Byte* weights = getAccessData(access, sizeof(Vector4), stride);
+				if (!weights)
+					return false;
+
+				for (ui32 i = 0; i < vertCount; i++)
+					vertexData.setWeight(i, *(const Vector4*)(weights + i * stride));
 			}
 			else if (it.first == "JOINTS_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec4 && access.m_componentType==GltfAccessorInfo::ComponentType::UnsignedShort)
-				{
-					ui8 joint[4];
-					ui16* joints = getAccessData<ui16*>(access);
-					for (int i = 0; i < vertCount; i++)
-					{
-						joint[0] = (ui8)joints[i * 4 + 0];
-						joint[1] = (ui8)joints[i * 4 + 1];
-						joint[2] = (ui8)joints[i * 4 + 2];
-						joint[3] = (ui8)joints[i * 4 + 3];
-						vertexData.setJoint(i, *(const Dword*)joint);		
-					}
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec4 || access.m_componentType != GltfAccessorInfo::ComponentType::UnsignedShort)
 					return false;
+
+				const Byte* joints = getAccessData(access, sizeof(ui16) * 4, stride);
+				if (!joints)
+					return false;
+
+				ui8 joint[4];
+				for (ui32 i = 0; i < vertCount; i++)
+				{
+					const ui16* vertexJoints = (const ui16*)(joints + i * stride);
+					joint[0] = (ui8)vertexJoints[0];
+					joint[1] = (ui8)vertexJoints[1];
+					joint[2] = (ui8)vertexJoints[2];
+					joint[3] = (ui8)vertexJoints[3];
+					vertexData.setJoint(i, *(const Dword*)joint);
 				}
 			}
 		}
 
+		return true;
+	}
+
+	bool GltfRes::buildPrimitiveData(int meshIdx, int primitiveIdx, MeshVertexData& vertexData)
+	{
+		GltfPrimitive& primitive = m_meshes[meshIdx].m_primitives[primitiveIdx];
+
+		// indices
+		const Byte* indicesData = nullptr;
+		ui32  indicesCount = 0;
+		ui32  indicesStride = 0;
+		if (primitive.m_indices != -1)
+		{
+			if (primitive.m_indices >= m_accessors.size())
+				return false;
+
+			GltfAccessorInfo&   access = m_accessors[primitive.m_indices];
+			indicesCount = access.m_count;
+
+			// stride
+			if (access.m_componentType == GltfAccessorInfo::UnsignedByte)
+				indicesStride = 1;
+			else if (access.m_componentType == GltfAccessorInfo::UnsignedShort)
+				indicesStride = 2;
+			else if (access.m_componentType == GltfAccessorInfo::UnsignedInt)
+				indicesStride = 4;
+			else
+			{
+				EchoLogError("gltf mesh index type isn't UnsignedShort when buildPrimitiveData()");
+				return false;
+			}
+
+			// index buffers are tightly packed
+			ui32 stride = 0;
+			indicesData = getAccessData(access, indicesStride, stride);
+			if (!indicesData || stride != indicesStride)
+				return false;
+		}
+
 		// create mesh
 		if (!primitive.m_mesh)
 		{
 			primitive.m_mesh = Mesh::create(true, true);
 
-			// update indices
-			if(indicesDataVoid)
-				primitive.m_mesh->updateIndices(indicesCount, indicesStride, indicesDataVoid);
+			// update indices, read straight from the buffer
+			if(indicesData)
+				primitive.m_mesh->updateIndices(indicesCount, indicesStride, indicesData);
 
 			// update vertices
 			primitive.m_mesh->updateVertexs(vertexData);
@@ -1041,6 +1225,15 @@ namespace Echo
 		return true;
 	}
 
+	// embedded images are decoded at load, the others are loaded by path
+	static void setMaterialTexture(MaterialPtr material, const String& uniformName, const GltfImageInfo& image)
+	{
+		if (image.m_texture)
+			material->setUniformTexture(uniformName, image.m_texture);
+		else
+			material->setUniformTexture(uniformName, image.m_uri);
+	}
+
 	bool GltfRes::buildMaterial(int meshIdx, int primitiveIdx)
 	{
 		GltfPrimitive& primitive = m_meshes[meshIdx].m_primitives[primitiveIdx];
@@ -1084,14 +1277,14 @@ namespace Echo
 		if (baseColorTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[baseColorTextureIdx].m_source;
-			primitive.m_materialInst->setUniformTexture("BaseColor", m_images[imageIdx].m_uri);
+			setMaterialTexture(primitive.m_materialInst, "BaseColor", m_images[imageIdx]);
 		}
 
 		// normal map
 		if (normalTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[normalTextureIdx].m_source;
-			primitive.m_materialInst->setUniformTexture("u_NormalSampler", m_images[imageIdx].m_uri);
+			setMaterialTexture(primitive.m_materialInst, "u_NormalSampler", m_images[imageIdx]);
 			primitive.m_materialInst->setUniformValue("u_NormalScale", &matInfo.m_normalTexture.m_scale);
 		}
 
@@ -1099,7 +1292,7 @@ namespace Echo
 		if (emissiveTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[emissiveTextureIdx].m_source;
-			primitive.m_materialInst->setUniformTexture("u_EmissiveSampler", m_images[imageIdx].m_uri);
+			setMaterialTexture(primitive.m_materialInst, "u_EmissiveSampler", m_images[imageIdx]);
 			primitive.m_materialInst->setUniformValue("u_EmissiveFactor", &matInfo.m_emissiveTexture.m_factor);
 		}
 
@@ -1107,14 +1300,14 @@ namespace Echo
 		if (metalicRoughnessIdx != -1)
 		{
 			i32 imageIdx = m_textures[metalicRoughnessIdx].m_source;
-			primitive.m_materialInst->setUniformTexture("u_MetallicRoughnessSampler", m_images[imageIdx].m_uri);
+			setMaterialTexture(primitive.m_materialInst, "u_MetallicRoughnessSampler", m_images[imageIdx]);
 		}
 
 		// occlusion map
 		if (occusionTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[occusionTextureIdx].m_source;
-			primitive.m_materialInst->setUniformTexture("u_OcclusionSampler", m_images[imageIdx].m_uri);
+			setMaterialTexture(primitive.m_materialInst, "u_OcclusionSampler", m_images[imageIdx]);
 			primitive.m_materialInst->setUniformValue("u_OcclusionStrength", &matInfo.m_occlusionTexture.m_strength);
 		}
 
@@ -1309,12 +1502,13 @@ namespace Echo
 			if (!parseJsonValueString(m_images[i].m_name, image, "name", false))
 				return false;
 
-			// uri
-			if (parseJsonValueString(m_images[i].m_uri, image, "uri", false))
-				m_images[i].m_uri = PathUtil::GetFileDirPath(m_path.getPath()) + m_images[i].m_uri;
-			else
+			// uri, images embedded in a glb have a bufferView instead
+			if (!parseJsonValueString(m_images[i].m_uri, image, "uri", false))
 				return false;
 
+			if (!m_images[i].m_uri.empty() && !StringUtil::StartWith(m_images[i].m_uri, "data:"))
+				m_images[i].m_uri = PathUtil::GetFileDirPath(m_path.getPath()) + m_images[i].m_uri;
+
 			// mimeType
 			if (!parseJsonValueString(m_images[i].m_mimeType, image, "mimeType", false))
 				return false;
@@ -1322,16 +1516,65 @@ namespace Echo
 			// bufferView
 			if (!parseJsonValueI32(m_images[i].m_bufferView, image, "bufferView", false))
 				return false;
+
+			// decoded now, buffers are released once loading is done
+			if ((m_images[i].m_uri.empty() || StringUtil::StartWith(m_images[i].m_uri, "data:")) && !loadImageData(m_images[i], i))
+				EchoLogError("gltf decode image [%d] failed when load resource [%s].", i, m_path.getPath().c_str());
 		}
 
-		// TODO: Handle dependencies between mimeType and bufferView
-		// TODO: Handle the fact that we want an uri OR a bufferView
 		// TODO: images[i]["extensions"]
 		// TODO: images[i]["extras"]
 
 		return true;
 	}
 
+	bool GltfRes::loadImageData(GltfImageInfo& image, ui32 imageIdx)
+	{
+		// data:image/png;base64,..., the mimeType comes with the uri
+		if (!image.m_uri.empty())
+		{
+			String header = StringUtil::Substr(image.m_uri, ",", true);
+			String mimeType = StringUtil::Substr(StringUtil::Substr(header, ";", true), ":", false);
+			if (image.m_mimeType.empty())
+				image.m_mimeType = mimeType;
+
+			Base64Decode decode(StringUtil::Substr(image.m_uri, ",", false));
+			if (!decode.getSize())
+				return false;
+
+			return loadImageTexture(image, imageIdx, (const Byte*)decode.getData(), ui32(decode.getSize()));
+		}
+
+		if (image.m_bufferView < 0 || image.m_bufferView >= i32(m_bufferViews.size()))
+			return false;
+
+		const GltfBufferViewInfo& bufferView = m_bufferViews[image.m_bufferView];
+		if (bufferView.m_bufferIdx >= m_buffers.size())
+			return false;
+
+		const GltfBufferInfo& buffer = m_buffers[bufferView.m_bufferIdx];
+		if (!buffer.m_data || ui64(bufferView.m_byteOffset) + bufferView.m_byteLength > ui64(buffer.m_byteLength))
+			return false;
+
+		return loadImageTexture(image, imageIdx, buffer.m_data + bufferView.m_byteOffset, bufferView.m_byteLength);
+	}
+
+	bool GltfRes::loadImageTexture(GltfImageInfo& image, ui32 imageIdx, const Byte* data, ui32 dataSize)
+	{
+		// mimeType is required with a bufferView, png and jpeg are the only ones allowed
+		ImageFormat format = image.m_mimeType == "image/png" ? IF_PNG : (image.m_mimeType == "image/jpeg" ? IF_JPG : IF_UNKNOWN);
+		Image* decoded = Image::createFromMemory(Buffer(dataSize, const_cast<Byte*>(data), false), format);
+		if (!decoded)
+			return false;
+
+		ui32 size = PixelUtil::CalcSurfaceSize(decoded->getWidth(), decoded->getHeight(), 1, 1, decoded->getPixelFormat());
+		image.m_texture = Renderer::instance()->createTexture2D(StringUtil::Format("%s#image%d", m_path.getPath().c_str(), imageIdx));
+		image.m_texture->updateTexture2D(decoded->getPixelFormat(), Texture::TU_GPU_READ, decoded->getWidth(), decoded->getHeight(), decoded->getData(), size);
+		EchoSafeDelete(decoded, Image);
+
+		return true;
+	}
+
 	bool GltfRes::loadSamplers(nlohmann::json& json)
 	{
 		if (json.find("samplers") == json.end())
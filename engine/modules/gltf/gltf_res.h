@@ -3,6 +3,8 @@
 #include "engine/core/memory/MemAllocDef.h"
 #include "engine/core/math/Math.h"
 #include "engine/core/io/IO.h"
+#include "engine/core/io/memory_mapped_file.h"
+#include "engine/core/io/memory_reader.h"
 #include "engine/core/scene/node.h"
 #include "engine/core/render/base/mesh/mesh.h"
 #include "engine/core/resource/Res.h"
@@ -87,18 +89,31 @@ namespace Echo
 			Blob
 		}					m_uriType = UriType::Uri;
 		i32					m_byteLength;
-		MemoryReader*		m_data = nullptr;
+		const Byte*			m_data = nullptr;		// points into m_file, m_decoded or the binary chunk of a glb
+		MemoryMappedFile*	m_file = nullptr;		// external .bin
+		MemoryReader*		m_reader = nullptr;		// external .bin that can't be mapped
+		vector<Byte>::type	m_decoded;				// data uri
 
 		// destructor
 		~GltfBufferInfo()
 		{
-			EchoSafeDelete(m_data, MemoryReader);
+			release();
 		}
 
 		// get data
 		void* getData(ui32 offset)
 		{
-			return m_data ? m_data->getData<char*>() + offset : nullptr;
+			return m_data ? (void*)(m_data + offset) : nullptr;
+		}
+
+		// release data, only needed while loading
+		void release()
+		{
+			EchoSafeDelete(m_file, MemoryMappedFile);
+			EchoSafeDelete(m_reader, MemoryReader);
+			m_decoded.clear();
+			m_decoded.shrink_to_fit();
+			m_data = nullptr;
 		}
 	};
 
@@ -203,8 +218,9 @@ namespace Echo
 	{
 		String	m_name;
 		String	m_uri;
-		String	m_mimeType;
-		i32		m_bufferView = -1;
+		String		m_mimeType;
+		i32			m_bufferView = -1;
+		TexturePtr	m_texture;			// decoded from the buffer view or data uri, other images are loaded by path
 	};
 
 	struct GltfSamplerInfo
@@ -282,7 +298,7 @@ namespace Echo
 
 	class GltfRes : public Res
 	{
-		ECHO_RES(GltfRes, Res, ".gltf", nullptr, GltfRes::load);
+		ECHO_RES(GltfRes, Res, ".gltf|.glb", nullptr, GltfRes::load);
 
 	public:
 		GltfMetaInfo						m_metaInfo;
@@ -315,29 +331,39 @@ namespace Echo
 		GltfRes(const ResourcePath& path);
 		~GltfRes();
 		bool load();
+		bool loadFile();
+		bool loadGlbChunks(const Byte*& jsonBegin, const Byte*& jsonEnd);
 		bool loadAsset(nlohmann::json& json);
 		bool loadScenes(nlohmann::json& json);
 		bool loadNodes(nlohmann::json& json);
 		bool loadBuffers(nlohmann::json& json);
 		bool loadAccessors(nlohmann::json& json);
 		bool loadBufferViews(nlohmann::json& json);
-		bool loadBufferData(GltfBufferInfo& buffer);
+		bool loadBufferData(GltfBufferInfo& buffer, ui32 bufferIdx);
+		void releaseBufferData();
 		bool loadMaterials(nlohmann::json& json);
 		bool loadTextureInfo(GltfMaterialInfo::Texture& texture, nlohmann::json& json);
 		bool loadImages(nlohmann::json& json);
+		bool loadImageData(GltfImageInfo& image, ui32 imageIdx);
+		bool loadImageTexture(GltfImageInfo& image, ui32 imageIdx, const Byte* data, ui32 dataSize);
 		bool loadSamplers(nlohmann::json& json);
 		bool loadTextures(nlohmann::json& json);
 		bool loadMeshes(nlohmann::json& json);
 		bool loadSkins(nlohmann::json& json);
 		bool loadAnimations(nlohmann::json& json);
 		bool buildAnimationData();
-		bool buildPrimitiveData(int meshIdx, int primitiveIdx);
+		bool buildMeshes();
+		bool buildPrimitiveVertexData(const GltfPrimitive& primitive, MeshVertexData& vertexData);
+		bool buildPrimitiveData(int meshIdx, int primitiveIdx, MeshVertexData& vertexData);
 		bool buildMaterial(int meshIdx, int primitiveIdx);
 		void createNode(vector<Node*>::type& nodes, int idx);
 		Node*createSkeleton();
 		void bindSkeleton(Node* parent);
 		
 	private:
+		// accessor data with the stride of its buffer view, nullptr if it doesn't fit in the buffer
+		const Byte* getAccessData(const GltfAccessorInfo& access, ui32 elementSize, ui32& stride);
+
 		// help function for get access data
 		template<typename T> T getAccessData(GltfAccessorInfo& access)
 		{
@@ -357,6 +383,14 @@ namespace Echo
 				((AnimPropertyTypeT*)animProperty)->addKey(time, keyData[i]);
 			}
 		}
+
+	private:
+		MemoryMappedFile	m_file;					// mapped while loading
+		MemoryReader*		m_reader = nullptr;		// read instead when the file can't be mapped, in a package
+		const Byte*			m_fileData = nullptr;	// points into m_file or m_reader
+		size_t				m_fileSize = 0;
+		const Byte*			m_binChunk = nullptr;	// binary chunk of a glb, data of the first buffer
+		ui32				m_binChunkSize = 0;
 	};
 	typedef Echo::ResRef<Echo::GltfRes> GltfResPtr;
 }
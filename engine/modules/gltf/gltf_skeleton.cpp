@@ -1,6 +1,9 @@
 #include "gltf_skeleton.h"
+#include "gltf_module.h"
 #include "engine/core/log/Log.h"
 #include "engine/core/main/Engine.h"
+#include "engine/core/scene/node_tree.h"
+#include "engine/modules/anim/anim_module.h"
 #include "engine/core/util/magic_enum.hpp"
 
 namespace Echo
@@ -12,6 +15,7 @@ namespace Echo
 
 	GltfSkeleton::~GltfSkeleton()
 	{
+		GltfModule::instance()->removeSkeleton(this);
 	}
 
 	void GltfSkeleton::bindMethods()
@@ -48,9 +52,13 @@ namespace Echo
 
 				if (m_asset->m_animations.size() && m_asset->m_nodes.size())
 				{
-					if (m_nodeTransforms.empty())
-						m_nodeTransforms.resize(m_asset->m_nodes.size());
+					buildNodeOrder();
 				}
+
+				m_skinRequested.assign(m_asset->m_skins.size(), false);
+				m_skinPalettes.assign(m_asset->m_skins.size(), vector<Matrix4>::type());
+				m_trackClip = nullptr;
+				m_tracks.clear();
 			}
 		}
 	}
@@ -58,7 +66,8 @@ namespace Echo
 	// play anim
 	void GltfSkeleton::setAnim(const StringOption& animName)
 	{
-		m_animations.setValue(animName.getValue());
+		if (m_animations.setValue(animName.getValue()))
+			m_time = 0;
 	}
 
 	// get current anim clip
@@ -73,11 +82,26 @@ namespace Echo
 		{
 			ui32 deltaTime = Engine::instance()->getFrameTimeMS();
 			AnimClip* clip = m_clips[m_animations.getIdx()];
-			if (clip)
+			if (clip && !m_nodeTransforms.empty())
 			{
-				clip->update(deltaTime);
+				if (clip != m_trackClip)
+					bindTracks(clip);
+
+				m_time += deltaTime;
+				if (m_time > clip->m_length)
+					m_time = 0;
+
+				// time always advances, the lod decides whether the pose is sampled, blended or left alone
+				AABB worldBox;
+				if (m_localAABB.isValid())
+					buildWorldAABB(worldBox);
 
-				extractClipData(clip);
+				float elapsed = 0.f;
+				m_isPoseDirty = AnimModule::instance()->getLod().update(m_lodState, worldBox, NodeTree::instance()->get3dCamera(), Engine::instance()->getFrameTime(), elapsed, true);
+
+				// pose is evaluated with all other skeletons by GltfModule::lateUpdate
+				if (m_lodState.m_level != AnimLodLevel::Culled)
+					GltfModule::instance()->addSkeleton(this);
 			}
 		}
 	}
@@ -107,56 +131,187 @@ namespace Echo
 		}
 	}
 
-	void GltfSkeleton::extractClipData(AnimClip* clip)
+	void GltfSkeleton::bindTracks(AnimClip* clip)
 	{
-		if (clip)
+		m_tracks.clear();
+		for (AnimObject* animNode : clip->m_objects)
 		{
-			// reset
-			for (Transform& transform : m_nodeTransforms)
+			i32 nodeIdx = any_cast<i32>(animNode->m_userData);
+			for (AnimProperty* property : animNode->m_properties)
 			{
-				transform.reset();
+				Track track;
+				track.m_node = nodeIdx;
+				track.m_path = magic_enum::enum_cast<GltfAnimChannel::Path>(property->m_name.c_str()).value_or(GltfAnimChannel::Path::Translation);
+				track.m_property = property;
+
+				// sampling is lazy cooked, cook here so workers only read
+				property->optimize();
+
+				if (nodeIdx >= 0 && nodeIdx < i32(m_nodeTransforms.size()))
+					m_tracks.emplace_back(track);
 			}
+		}
+
+		m_trackClip = clip;
+	}
 
-			for (AnimObject* animNode : clip->m_objects)
+	void GltfSkeleton::buildNodeOrder()
+	{
+		size_t nodeCount = m_asset->m_nodes.size();
+		vector<i32>::type depths(nodeCount, 0);
+		for (size_t i = 0; i < nodeCount; i++)
+		{
+			for (i32 parent = m_asset->m_nodes[i].m_parent; parent != -1 && depths[i] < i32(nodeCount); parent = m_asset->m_nodes[parent].m_parent)
+				depths[i]++;
+		}
+
+		m_nodeOrder.resize(nodeCount);
+		for (size_t i = 0; i < nodeCount; i++)
+			m_nodeOrder[i] = i32(i);
+
+		std::stable_sort(m_nodeOrder.begin(), m_nodeOrder.end(), [&depths](i32 a, i32 b) { return depths[a] < depths[b]; });
+
+		m_restTranslations.resize(nodeCount);
+		m_restRotations.resize(nodeCount);
+		m_restScales.resize(nodeCount);
+		for (size_t i = 0; i < nodeCount; i++)
+		{
+			const GltfNodeInfo& nodeInfo = m_asset->m_nodes[i];
+			m_restTranslations[i] = nodeInfo.m_translation;
+			m_restRotations[i] = nodeInfo.m_rotation;
+			m_restScales[i] = nodeInfo.m_scale;
+		}
+
+		m_localTranslations = m_restTranslations;
+		m_localRotations = m_restRotations;
+		m_localScales = m_restScales;
+		m_nodeTransforms.resize(nodeCount);
+		m_poseTransforms.resize(nodeCount);
+		m_fromTransforms.resize(nodeCount);
+	}
+
+	void GltfSkeleton::evaluate()
+	{
+		if (m_isPoseDirty)
+		{
+			// throttled instances blend from what is shown now, so the pose never jumps
+			extractClipData();
+			jointInhertParentTransform();
+			updateLocalAABB();
+
+			m_fromTransforms = m_lodState.m_isSnap ? m_poseTransforms : m_nodeTransforms;
+
+			m_isPoseDirty = false;
+		}
+
+		blendPose(AnimLod::getBlend(m_lodState));
+		buildSkinPalettes();
+	}
+
+	void GltfSkeleton::extractClipData()
+	{
+		// nodes without channels keep their rest pose
+		m_localTranslations = m_restTranslations;
+		m_localRotations = m_restRotations;
+		m_localScales = m_restScales;
+
+		for (Track& track : m_tracks)
+		{
+			switch (track.m_path)
 			{
-				// copy all properties results of this node
-				i32 nodeIdx = any_cast<i32>(animNode->m_userData);
-				for (AnimProperty* property : animNode->m_properties)
-				{
-					GltfAnimChannel::Path channelPath = magic_enum::enum_cast<GltfAnimChannel::Path>(property->m_name.c_str()).value_or(GltfAnimChannel::Path::Translation);
-					switch (channelPath)
-					{
-					case GltfAnimChannel::Path::Translation:	m_nodeTransforms[nodeIdx].m_pos = ((AnimPropertyVec3*)property)->getValue(); break;
-					case GltfAnimChannel::Path::Rotation:		m_nodeTransforms[nodeIdx].m_quat = ((AnimPropertyQuat*)property)->getValue(); break;
-					case GltfAnimChannel::Path::Scale:			m_nodeTransforms[nodeIdx].m_scale = ((AnimPropertyVec3*)property)->getValue(); break;
-					//case GltfAnimChannel::Path::Weights:		m_nodeTransforms[nodeIdx].m_pos = ((AnimPropertyVec3*)property)->getValue(); break;
-					default: EchoLogError("Unprocessed gltf anim data form gltf skeleton");	break;
-					}
-				}
+			case GltfAnimChannel::Path::Translation:	((AnimPropertyVec3*)track.m_property)->sample(m_time, &m_localTranslations[track.m_node].x, track.m_cursor); break;
+			case GltfAnimChannel::Path::Rotation:		((AnimPropertyQuat*)track.m_property)->sample(m_time, m_localRotations[track.m_node], track.m_cursor); break;
+			case GltfAnimChannel::Path::Scale:			((AnimPropertyVec3*)track.m_property)->sample(m_time, &m_localScales[track.m_node].x, track.m_cursor); break;
+			default: break;
 			}
+		}
+	}
+
+	void GltfSkeleton::jointInhertParentTransform()
+	{
+		// parents are ordered before their children, so one pass builds the model pose
+		for (i32 nodeIdx : m_nodeOrder)
+		{
+			Transform local(m_localTranslations[nodeIdx], m_localScales[nodeIdx], m_localRotations[nodeIdx]);
+			i32 parent = m_asset->m_nodes[nodeIdx].m_parent;
+			m_poseTransforms[nodeIdx] = parent != -1 ? m_poseTransforms[parent] * local : local;
+		}
+	}
+
+	void GltfSkeleton::blendPose(float blend)
+	{
+		if (blend >= 1.f)
+		{
+			m_nodeTransforms = m_poseTransforms;
+			return;
+		}
+
+		for (size_t i = 0; i < m_nodeTransforms.size(); i++)
+		{
+			const Transform& from = m_fromTransforms[i];
+			const Transform& to = m_poseTransforms[i];
+			Transform& transform = m_nodeTransforms[i];
+			transform.m_pos = from.m_pos + (to.m_pos - from.m_pos) * blend;
+			transform.m_scale = from.m_scale + (to.m_scale - from.m_scale) * blend;
+			Quaternion::Lerp(transform.m_quat, from.m_quat, to.m_quat, blend, true);
+		}
+	}
 
-			for (GltfSceneInfo& scene : m_asset->m_scenes)
+	void GltfSkeleton::updateLocalAABB()
+	{
+		// joints lie inside the skin, pad the box so the mesh around them is covered
+		AABB box;
+		for (const Transform& transform : m_poseTransforms)
+			box.addPoint(transform.m_pos);
+
+		if (box.isValid())
+		{
+			float padding = box.getDiagonalLen() * 0.25f;
+			box.inflate(padding, padding, padding);
+		}
+
+		m_localAABB = box;
+	}
+
+	void GltfSkeleton::buildSkinPalettes()
+	{
+		Matrix4 jointMatrix;
+		for (size_t skinIdx = 0; skinIdx < m_skinPalettes.size(); skinIdx++)
+		{
+			if (m_skinRequested[skinIdx])
 			{
-				for (ui32 rootNodeIdx : scene.m_nodes)
+				const GltfSkinInfo& skinInfo = m_asset->m_skins[skinIdx];
+				vector<Matrix4>::type& palette = m_skinPalettes[skinIdx];
+				size_t jointCount = std::min<size_t>(std::min<size_t>(skinInfo.m_joints.size(), skinInfo.m_inverseMatrixs.size()), palette.size());
+				for (size_t i = 0; i < jointCount; i++)
 				{
-					jointInhertParentTransform(rootNodeIdx);
+					i32 nodeIdx = skinInfo.m_joints[i];
+					if (nodeIdx >= 0 && nodeIdx < i32(m_nodeTransforms.size()))
+					{
+						m_nodeTransforms[nodeIdx].buildMatrix(jointMatrix);
+						palette[i] = skinInfo.m_inverseMatrixs[i] * jointMatrix;
+					}
 				}
 			}
 		}
 	}
 
-	void GltfSkeleton::jointInhertParentTransform(i32 nodeIdx)
+	const vector<Matrix4>::type* GltfSkeleton::getSkinPalette(i32 skinIdx)
 	{
-		const GltfNodeInfo& nodeInfo = m_asset->m_nodes[nodeIdx];
-		if (nodeInfo.m_parent != -1)
+		if (skinIdx >= 0 && skinIdx < i32(m_skinPalettes.size()))
 		{
-			m_nodeTransforms[nodeIdx] = m_nodeTransforms[nodeInfo.m_parent] * m_nodeTransforms[nodeIdx];
-		}
+			if (!m_skinRequested[skinIdx])
+			{
+				m_skinPalettes[skinIdx].assign(std::max<size_t>(m_asset->m_skins[skinIdx].m_joints.size(), MaxJoints), Matrix4::IDENTITY);
+				m_skinRequested[skinIdx] = true;
+				if (!m_nodeTransforms.empty())
+					buildSkinPalettes();
+			}
 
-		for (ui32 child : nodeInfo.m_children)
-		{
-			jointInhertParentTransform(child);
+			return &m_skinPalettes[skinIdx];
 		}
+
+		return nullptr;
 	}
 
 	bool GltfSkeleton::getGltfNodeTransform(Transform& transform, size_t nodeIdx)
@@ -3,6 +3,7 @@
 #include "engine/core/scene/node.h"
 #include "engine/core/util/base64.h"
 #include "engine/modules/anim/anim_clip.h"
+#include "engine/modules/anim/anim_lod.h"
 #include "gltf_res.h"
 
 namespace Echo
@@ -11,6 +12,19 @@ namespace Echo
 	{
 		ECHO_CLASS(GltfSkeleton, Node)
 
+	public:
+		// Palette size, matches the u_JointMatrixs array of the gltf shaders
+		static const i32 MaxJoints = 72;
+
+		// Animated channel of a node, bound once per clip
+		struct Track
+		{
+			i32						m_node;
+			GltfAnimChannel::Path	m_path;
+			AnimProperty*			m_property;
+			i32						m_cursor = 0;
+		};
+
 	public:
 		GltfSkeleton();
 		virtual ~GltfSkeleton();
@@ -34,6 +48,15 @@ namespace Echo
 		// get node transform
 		bool getGltfNodeTransform(Transform& transform, size_t nodeIdx);
 
+		// Skinning palette of a skin, shared by all meshes bound to the skin. Requesting
+		// a palette is what makes the skeleton compute it
+		const vector<Matrix4>::type* getSkinPalette(i32 skinIdx);
+
+		// Evaluate local pose, model pose and the requested palettes at the current time. Frames
+		// skipped by the animation lod blend towards the last evaluated pose instead.
+		// Only touches this instance, GltfModule runs it for all skeletons on worker threads
+		void evaluate();
+
 	protected:
 		// update self
 		virtual void updateInternal(float elapsedTime) override;
@@ -42,17 +65,48 @@ namespace Echo
 		// generate unique name
 		void generateUniqueName(String& oName);
 
+		// bind clip channels to nodes
+		void bindTracks(AnimClip* clip);
+
+		// parent ordered node list and rest pose
+		void buildNodeOrder();
+
 		//  query clip data
-		void extractClipData(AnimClip* clip);
+		void extractClipData();
 
 		// joint transform
-		void jointInhertParentTransform(i32 parent);
+		void jointInhertParentTransform();
+
+		// blend displayed pose from the pose of the previous evaluation towards the current one
+		void blendPose(float blend);
+
+		// bounds of the joints, used by the animation lod
+		void updateLocalAABB();
+
+		// skinning palettes
+		void buildSkinPalettes();
 
 	private:
 		ResourcePath					m_assetPath;
 		GltfResPtr						m_asset;			// gltf asset ptr
 		StringOption					m_animations;
 		vector<AnimClip*>::type			m_clips;
-		vector<Transform>::type			m_nodeTransforms;
+		AnimClip*						m_trackClip = nullptr;
+		vector<Track>::type				m_tracks;
+		ui32							m_time = 0;			// per instance, clips are shared by the asset
+		bool							m_isPoseDirty = false;
+		vector<i32>::type				m_nodeOrder;		// parents before children
+		vector<Vector3>::type			m_restTranslations;
+		vector<Quaternion>::type		m_restRotations;
+		vector<Vector3>::type			m_restScales;
+		vector<Vector3>::type			m_localTranslations;
+		vector<Quaternion>::type		m_localRotations;
+		vector<Vector3>::type			m_localScales;
+		vector<Transform>::type			m_nodeTransforms;	// model pose, displayed
+		vector<Transform>::type			m_poseTransforms;	// model pose of the last evaluation
+		vector<Transform>::type			m_fromTransforms;	// displayed model pose at the last evaluation
+		AnimLodState					m_lodState;
+		vector<bool>::type				m_skinRequested;
+		vector<vector<Matrix4>::type>::type	m_skinPalettes;
 	};
 }
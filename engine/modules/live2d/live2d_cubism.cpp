@@ -4,6 +4,7 @@
 #include "base/renderer.h"
 #include "base/shader/shader_program.h"
 #include "engine/core/main/Engine.h"
+#include "engine/modules/anim/anim_module.h"
 
 namespace Echo
 {
@@ -277,14 +278,23 @@ namespace Echo
 		{
 			if (m_model && m_renderable)
 			{
-				if (m_curMotion)
+				// skipped and culled frames only accumulate time, the next evaluation catches up
+				AABB worldBox;
+				if (m_localAABB.isValid())
+					buildWorldAABB(worldBox);
+
+				float elapsed = 0.f;
+				if (AnimModule::instance()->getLod().update(m_lodState, worldBox, getCamera(), Engine::instance()->getFrameTime(), elapsed, false))
 				{
-					m_curMotion->tick(Engine::instance()->getFrameTime(), m_model, m_table);
-				}
+					if (m_curMotion)
+					{
+						m_curMotion->tick(elapsed, m_model, m_table);
+					}
 
-				csmUpdateModel((csmModel*)m_model);
+					csmUpdateModel((csmModel*)m_model);
 
-				updateMeshBuffer();
+					updateMeshBuffer();
+				}
 			}
 		}
 
@@ -5,6 +5,7 @@
 #include "engine/core/render/base/mesh/mesh.h"
 #include "engine/core/render/base/shader/material.h"
 #include "engine/core/render/base/proxy/render_proxy.h"
+#include "engine/modules/anim/anim_lod.h"
 #include "live2d_cubism_motion.h"
 
 namespace Echo
@@ -143,5 +144,6 @@ namespace Echo
         ShaderProgramPtr        m_shaderDefault;
 		MaterialPtr				m_materialDefault;
 		RenderProxyPtr			m_renderable;
+		AnimLodState			m_lodState;
 	};
 }
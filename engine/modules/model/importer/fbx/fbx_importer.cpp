@@ -2,7 +2,9 @@
 #include "engine/core/editor/editor.h"
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/io/io.h"
-#include "engine/core/render/base/mesh/mesh.h"
+#include "engine/core/render/base/mesh/mesh_optimizer.h"
+#include "../../model_module.h"
+#include "engine/core/log/Log.h"
 
 #ifdef ECHO_EDITOR_MODE
 
@@ -133,6 +135,12 @@ namespace Echo
 
 					if (mesh)
 					{
+						MeshOptimizer::Options options;
+						options.m_isQuantize = ModelModule::instance()->isImportQuantize();
+
+						MeshOptimizer::Report report = MeshOptimizer::optimize(mesh, options);
+						EchoLogInfo("fbx import mesh [%s] %s", fbxMesh->name, report.toString().c_str());
+
 						String meshName = PathUtil::GetPureFilename(fbxFile, false);
 						mesh->setPath(m_targetFoler + "/" + meshName + ".mesh");
 						mesh->save();
@@ -2,6 +2,9 @@
 #include "gltf_loader.h"
 #include "engine/core/editor/editor.h"
 #include "engine/core/util/PathUtil.h"
+#include "engine/core/render/base/mesh/mesh_optimizer.h"
+#include "../../model_module.h"
+#include "engine/core/log/Log.h"
 
 #ifdef ECHO_EDITOR_MODE
 namespace Echo
@@ -50,6 +53,12 @@ namespace Echo
 				MeshPtr mesh = meshInfo.m_primitives[j].m_mesh;
 				if (mesh)
 				{
+					MeshOptimizer::Options options;
+					options.m_isQuantize = ModelModule::instance()->isImportQuantize();
+
+					MeshOptimizer::Report report = MeshOptimizer::optimize(mesh, options);
+					EchoLogInfo("gltf import mesh [%s] %s", meshInfo.m_name.c_str(), report.toString().c_str());
+
 					if (!meshInfo.m_name.empty())
 					{
 						mesh->setPath(m_targetFoler + "/" + meshInfo.m_name  +".mesh");
@@ -21,7 +21,10 @@ namespace Echo
 
 	void ModelModule::bindMethods()
 	{
+		CLASS_BIND_METHOD(ModelModule, isImportQuantize);
+		CLASS_BIND_METHOD(ModelModule, setImportQuantize);
 
+		CLASS_REGISTER_PROPERTY(ModelModule, "ImportQuantize", Variant::Type::Bool, isImportQuantize, setImportQuantize);
 	}
 
 	void ModelModule::registerTypes()
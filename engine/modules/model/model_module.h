@@ -16,5 +16,13 @@ namespace Echo
 
 		// register all types of the module
 		virtual void registerTypes() override;
+
+		// Quantize imported meshes, see Mesh::setQuantize. Positions are relative to the bounds of
+		// each mesh, so edges shared by adjacent meshes may no longer match exactly
+		bool isImportQuantize() const { return m_isImportQuantize; }
+		void setImportQuantize(bool isQuantize) { m_isImportQuantize = isQuantize; }
+
+	private:
+		bool	m_isImportQuantize = false;
 	};
 }
@@ -0,0 +1,183 @@
+#include "opencrg.h"
+#include "../opendrive/opendrive.h"
+#include "engine/core/thread/job_system.h"
+
+namespace Echo
+{
+	OpenCrg::OpenCrg()
+		: Node()
+	{
+	}
+
+	OpenCrg::~OpenCrg()
+	{
+	}
+
+	void OpenCrg::bindMethods()
+	{
+		CLASS_BIND_METHOD(OpenCrg, getCrgRes);
+		CLASS_BIND_METHOD(OpenCrg, setCrgRes);
+		CLASS_BIND_METHOD(OpenCrg, getInterpolation);
+		CLASS_BIND_METHOD(OpenCrg, setInterpolation);
+		CLASS_BIND_METHOD(OpenCrg, getRoadId);
+		CLASS_BIND_METHOD(OpenCrg, setRoadId);
+		CLASS_BIND_METHOD(OpenCrg, getOffsetS);
+		CLASS_BIND_METHOD(OpenCrg, setOffsetS);
+		CLASS_BIND_METHOD(OpenCrg, getOffsetT);
+		CLASS_BIND_METHOD(OpenCrg, setOffsetT);
+		CLASS_BIND_METHOD(OpenCrg, getOffsetZ);
+		CLASS_BIND_METHOD(OpenCrg, setOffsetZ);
+		CLASS_BIND_METHOD(OpenCrg, queryPositions);
+
+		CLASS_REGISTER_PROPERTY(OpenCrg, "Crg", Variant::Type::ResourcePath, getCrgRes, setCrgRes);
+		CLASS_REGISTER_PROPERTY(OpenCrg, "Interpolation", Variant::Type::StringOption, getInterpolation, setInterpolation);
+		CLASS_REGISTER_PROPERTY(OpenCrg, "RoadId", Variant::Type::Int, getRoadId, setRoadId);
+		CLASS_REGISTER_PROPERTY(OpenCrg, "OffsetS", Variant::Type::Real, getOffsetS, setOffsetS);
+		CLASS_REGISTER_PROPERTY(OpenCrg, "OffsetT", Variant::Type::Real, getOffsetT, setOffsetT);
+		CLASS_REGISTER_PROPERTY(OpenCrg, "OffsetZ", Variant::Type::Real, getOffsetZ, setOffsetZ);
+	}
+
+	void OpenCrg::setCrgRes(const ResourcePath& path)
+	{
+		if (m_crgRes.setPath(path.getPath()))
+		{
+			m_crgDirty = true;
+		}
+	}
+
+	StringOption OpenCrg::getInterpolation() const
+	{
+		return StringOption::fromEnum(m_interpolation);
+	}
+
+	void OpenCrg::setInterpolation(const StringOption& option)
+	{
+		m_interpolation = option.toEnum(OpenCrgGrid::Bilinear);
+	}
+
+	OpenDrive* OpenCrg::getOpenDrive()
+	{
+		for (Node* node = getParent(); node; node = node->getParent())
+		{
+			OpenDrive* drive = dynamic_cast<OpenDrive*>(node);
+			if (drive)
+				return drive;
+		}
+
+		return nullptr;
+	}
+
+	void OpenCrg::queryContacts(const Vector3* positions, i32 count, Contact* contacts)
+	{
+		if (m_crgDirty || !m_grid.isOpen() || count <= 0)
+		{
+			for (i32 i = 0; i < count; i++)
+				contacts[i] = Contact();
+
+			return;
+		}
+
+		// echo (x, h, -y) to inertial (x, y)
+		vector<double>::type xy(count * 2);
+		for (i32 i = 0; i < count; i++)
+		{
+			xy[i * 2] = positions[i].x;
+			xy[i * 2 + 1] = -positions[i].z;
+		}
+
+		// inertial to grid (u, v), heading of the reference line is kept for the normals
+		vector<double>::type uv(count * 2);
+		vector<double>::type headings(count);
+		vector<bool>::type valids(count, false);
+		OpenDrive* drive = m_roadId >= 0 ? getOpenDrive() : nullptr;
+		if (drive)
+		{
+			vector<OpenDrive::Location>::type locations(count);
+			drive->localize(xy.data(), count, locations.data());
+			for (i32 i = 0; i < count; i++)
+			{
+				const OpenDrive::Location& location = locations[i];
+				valids[i] = location.isValid() && location.m_roadId == m_roadId;
+				uv[i * 2] = location.m_s - m_offsetS;
+				uv[i * 2 + 1] = location.m_t - m_offsetT;
+				headings[i] = location.m_heading;
+			}
+		}
+		else if (m_roadId < 0)
+		{
+			vector<char>::type results(count, 0);
+			JobSystem::instance()->parallelFor(count, [&](i32 i)
+			{
+				results[i] = m_grid.project(xy[i * 2], xy[i * 2 + 1], uv[i * 2], uv[i * 2 + 1], headings[i]) ? 1 : 0;
+			}, 256);
+
+			for (i32 i = 0; i < count; i++)
+				valids[i] = results[i] != 0;
+		}
+
+		vector<float>::type heights(count);
+		vector<float>::type slopesU(count);
+		vector<float>::type slopesV(count);
+		m_grid.evaluate(uv.data(), count, m_interpolation, heights.data(), slopesU.data(), slopesV.data());
+
+		for (i32 i = 0; i < count; i++)
+		{
+			Contact& contact = contacts[i];
+			contact = Contact();
+			if (valids[i] && !std::isnan(heights[i]))
+			{
+				// n = (-dz/du * forward - dz/dv * left + up) in inertial space
+				double c = cos(headings[i]);
+				double s = sin(headings[i]);
+				double nx = -slopesU[i] * c + slopesV[i] * s;
+				double ny = -slopesU[i] * s - slopesV[i] * c;
+
+				contact.m_position = Vector3(positions[i].x, float(heights[i] + m_offsetZ), positions[i].z);
+				contact.m_normal = OpenDrive::toVec3(nx, ny, 1.0);
+				contact.m_normal.normalize();
+				contact.m_isValid = true;
+			}
+		}
+	}
+
+	void OpenCrg::queryWheelContacts(const Vector3* centers, const float* radii, i32 count, Contact* contacts)
+	{
+		queryContacts(centers, count, contacts);
+
+		for (i32 i = 0; i < count; i++)
+		{
+			if (contacts[i].m_isValid)
+				contacts[i].m_penetration = radii[i] - (centers[i].y - contacts[i].m_position.y);
+		}
+	}
+
+	RealVector OpenCrg::queryPositions(const RealVector& positions)
+	{
+		i32 count = i32(positions.size() / 3);
+		vector<Vector3>::type points(count);
+		for (i32 i = 0; i < count; i++)
+			points[i] = Vector3(float(positions[i * 3]), float(positions[i * 3 + 1]), float(positions[i * 3 + 2]));
+
+		vector<Contact>::type contacts(count);
+		queryContacts(points.data(), count, contacts.data());
+
+		RealVector result;
+		result.reserve(count * 5);
+		for (const Contact& contact : contacts)
+			result.insert(result.end(), { contact.m_isValid ? 1.0 : 0.0, contact.m_position.y, contact.m_normal.x, contact.m_normal.y, contact.m_normal.z });
+
+		return result;
+	}
+
+	void OpenCrg::updateInternal(float elapsedTime)
+	{
+		if (m_crgDirty)
+		{
+			m_grid.close();
+			if (!m_crgRes.isEmpty())
+				m_grid.open(m_crgRes.getPath());
+
+			m_crgDirty = false;
+		}
+	}
+}
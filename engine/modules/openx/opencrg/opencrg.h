@@ -0,0 +1,79 @@
+#pragma once
+
+#include "engine/core/scene/node.h"
+#include "opencrg_grid.h"
+
+namespace Echo
+{
+	class OpenDrive;
+
+	// Road surface elevation from an OpenCRG file. The grid either follows its own reference
+	// line, or is laid onto the reference line of an OpenDrive road (u -> s, v -> t)
+	class OpenCrg : public Node
+	{
+		ECHO_CLASS(OpenCrg, Node)
+
+	public:
+		// Surface point under a query position
+		struct Contact
+		{
+			Vector3	m_position = Vector3::ZERO;
+			Vector3	m_normal = Vector3::UNIT_Y;
+			float	m_penetration = 0.f;		// wheel queries only, radius minus height of the center above the surface
+			bool	m_isValid = false;
+		};
+
+	public:
+		OpenCrg();
+		virtual ~OpenCrg();
+
+		// Crg file
+		void setCrgRes(const ResourcePath& path);
+		const ResourcePath& getCrgRes() { return m_crgRes; }
+
+		// Interpolation
+		StringOption getInterpolation() const;
+		void setInterpolation(const StringOption& option);
+
+		// OpenDrive road the grid is laid onto, -1 uses the reference line of the crg
+		i32 getRoadId() const { return m_roadId; }
+		void setRoadId(i32 roadId) { m_roadId = roadId; }
+
+		// Offsets of the grid on the road
+		double getOffsetS() const { return m_offsetS; }
+		void setOffsetS(double offset) { m_offsetS = offset; }
+		double getOffsetT() const { return m_offsetT; }
+		void setOffsetT(double offset) { m_offsetT = offset; }
+		double getOffsetZ() const { return m_offsetZ; }
+		void setOffsetZ(double offset) { m_offsetZ = offset; }
+
+		// Grid
+		OpenCrgGrid& getGrid() { return m_grid; }
+
+		// Surface under count world positions
+		void queryContacts(const Vector3* positions, i32 count, Contact* contacts);
+
+		// Surface under count wheel centers, for vehicle wheels running on the crg instead of scene raycasts
+		void queryWheelContacts(const Vector3* centers, const float* radii, i32 count, Contact* contacts);
+
+		// Script friendly query, returns [valid, height, normal x, normal y, normal z] per position
+		RealVector queryPositions(const RealVector& positions);
+
+	protected:
+		// Nearest OpenDrive ancestor
+		OpenDrive* getOpenDrive();
+
+		// Update
+		virtual void updateInternal(float elapsedTime) override;
+
+	protected:
+		ResourcePath				m_crgRes = ResourcePath("", ".crg");
+		bool						m_crgDirty = true;
+		OpenCrgGrid::Interpolation	m_interpolation = OpenCrgGrid::Bilinear;
+		i32							m_roadId = -1;
+		double						m_offsetS = 0.0;
+		double						m_offsetT = 0.0;
+		double						m_offsetZ = 0.0;
+		OpenCrgGrid					m_grid;
+	};
+}
@@ -0,0 +1,500 @@
+#include "opencrg_grid.h"
+#include "engine/core/log/Log.h"
+#include "engine/core/util/StringUtil.h"
+#include "engine/core/thread/job_system.h"
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+
+namespace Echo
+{
+	// Samples evaluated together, stages of a batch are plain loops over these arrays
+	static const i32 BatchSize = 64;
+
+	// Rows per bounding circle of the reference line
+	static const i32 ReferenceBlockRows = 64;
+
+	// Header records of binary files are padded to this size
+	static const size_t HeaderRecordSize = 80;
+
+	struct NativeFloatDecoder
+	{
+		static const size_t Size = sizeof(float);
+		static float get(const Byte* p) { float v; std::memcpy(&v, p, sizeof(float)); return v; }
+	};
+
+	struct Float32BEDecoder
+	{
+		static const size_t Size = sizeof(float);
+		static float get(const Byte* p)
+		{
+			ui32 bits = (ui32(p[0]) << 24) | (ui32(p[1]) << 16) | (ui32(p[2]) << 8) | ui32(p[3]);
+			float v; std::memcpy(&v, &bits, sizeof(float));
+			return v;
+		}
+	};
+
+	struct Float64BEDecoder
+	{
+		static const size_t Size = sizeof(double);
+		static float get(const Byte* p)
+		{
+			ui64 bits = 0;
+			for (i32 i = 0; i < 8; i++)
+				bits = (bits << 8) | ui64(p[i]);
+
+			double v; std::memcpy(&v, &bits, sizeof(double));
+			return float(v);
+		}
+	};
+
+	static double wrapAngle(double angle)
+	{
+		while (angle > Math::PI)	angle -= Math::PI * 2.0;
+		while (angle < -Math::PI)	angle += Math::PI * 2.0;
+		return angle;
+	}
+
+	// Catmull-Rom weights and their derivatives
+	static void cubicWeights(float t, float* w, float* dw)
+	{
+		float t2 = t * t;
+		float t3 = t2 * t;
+		w[0] = -0.5f * t3 + t2 - 0.5f * t;
+		w[1] = 1.5f * t3 - 2.5f * t2 + 1.f;
+		w[2] = -1.5f * t3 + 2.f * t2 + 0.5f * t;
+		w[3] = 0.5f * t3 - 0.5f * t2;
+		dw[0] = -1.5f * t2 + 2.f * t - 0.5f;
+		dw[1] = 4.5f * t2 - 5.f * t;
+		dw[2] = -4.5f * t2 + 4.f * t + 0.5f;
+		dw[3] = 1.5f * t2 - t;
+	}
+
+	OpenCrgGrid::OpenCrgGrid()
+	{
+	}
+
+	OpenCrgGrid::~OpenCrgGrid()
+	{
+		close();
+	}
+
+	bool OpenCrgGrid::open(const String& path)
+	{
+		close();
+
+		if (!m_file.open(path))
+			return false;
+
+		const char* text = m_file.getData<const char*>();
+		size_t dataOffset = parseHeader(text, m_file.getSize());
+		if (!dataOffset || m_columns <= 0)
+		{
+			EchoLogError("OpenCrg : Invalid header [%s]", path.c_str());
+			close();
+			return false;
+		}
+
+		if (m_format == Format::Float32BE || m_format == Format::Float64BE)
+		{
+			m_rowStride = m_channels * (m_format == Format::Float32BE ? sizeof(float) : sizeof(double));
+
+			// data starts right after the header, or at the next record boundary when the header is padded
+			size_t paddedOffset = (dataOffset + HeaderRecordSize - 1) / HeaderRecordSize * HeaderRecordSize;
+			if ((m_file.getSize() - dataOffset) % m_rowStride != 0 && paddedOffset <= m_file.getSize() && (m_file.getSize() - paddedOffset) % m_rowStride == 0)
+				dataOffset = paddedOffset;
+
+			m_rows = i32((m_file.getSize() - dataOffset) / m_rowStride);
+			m_data = m_file.getData<const Byte*>() + dataOffset;
+		}
+		else
+		{
+			// ascii grids are small, keep the parsed values and drop the mapping
+			if (!parseAsciiData(text + dataOffset, m_file.getSize() - dataOffset))
+			{
+				EchoLogError("OpenCrg : Invalid data section [%s]", path.c_str());
+				close();
+				return false;
+			}
+
+			m_file.close();
+			m_format = Format::Float;
+			m_rowStride = m_channels * sizeof(float);
+			m_rows = i32(m_values.size() / m_channels);
+			m_data = reinterpret_cast<const Byte*>(m_values.data());
+		}
+
+		if (m_rows <= 0)
+		{
+			EchoLogError("OpenCrg : No data [%s]", path.c_str());
+			close();
+			return false;
+		}
+
+		buildReferenceLine();
+
+		return true;
+	}
+
+	void OpenCrgGrid::close()
+	{
+		m_file.close();
+		m_values.clear();
+		m_data = nullptr;
+		m_format = Format::Unknown;
+		m_rows = m_columns = m_channels = 0;
+		m_firstColumn = 0;
+		m_phiChannel = -1;
+		m_rowStride = 0;
+		m_u0 = m_v0 = 0.0;
+		m_du = m_dv = 1.0;
+		m_startX = m_startY = m_startPhi = 0.0;
+		m_lineX.clear();
+		m_lineY.clear();
+		m_linePhi.clear();
+		m_blockX.clear();
+		m_blockY.clear();
+		m_blockRadius.clear();
+	}
+
+	size_t OpenCrgGrid::parseHeader(const char* data, size_t size)
+	{
+		enum class Section { None, RoadCrg, KdDefinition, Other } section = Section::None;
+
+		vector<double>::type columnVs;
+		double vIncrement = 0.0;
+		size_t lineStart = 0;
+		while (lineStart < size)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(data + lineStart, '\n', size - lineStart));
+			size_t next = lineEnd ? size_t(lineEnd - data) + 1 : size;
+
+			String line(data + lineStart, next - lineStart);
+			StringUtil::Trim(line);
+			lineStart = next;
+
+			if (StringUtil::StartWith(line, "$$$$"))
+			{
+				if (!columnVs.empty())
+				{
+					m_columns = i32(columnVs.size());
+					m_v0 = columnVs.front();
+					m_dv = columnVs.size() > 1 ? columnVs[1] - columnVs[0] : (vIncrement > 0.0 ? vIncrement : 1.0);
+				}
+
+				return next;
+			}
+			else if (line.empty() || line[0] == '*')
+			{
+				continue;
+			}
+			else if (line[0] == '$')
+			{
+				String name = line.substr(1);
+				StringUtil::UpperCase(name);
+				if (StringUtil::StartWith(name, "ROAD_CRG"))			section = Section::RoadCrg;
+				else if (StringUtil::StartWith(name, "KD_DEFINITION"))	section = Section::KdDefinition;
+				else													section = name.empty() ? Section::None : Section::Other;
+			}
+			else if (section == Section::RoadCrg)
+			{
+				size_t equal = line.find('=');
+				if (equal != String::npos)
+				{
+					String key = line.substr(0, equal);
+					String value = line.substr(equal + 1, line.find('!') == String::npos ? String::npos : line.find('!') - equal - 1);
+					StringUtil::Trim(key);
+					StringUtil::Trim(value);
+					StringUtil::UpperCase(key);
+
+					if		(key == "REFERENCE_LINE_START_U")		m_u0 = StringUtil::ParseDouble(value);
+					else if (key == "REFERENCE_LINE_INCREMENT")		m_du = StringUtil::ParseDouble(value, 1.0);
+					else if (key == "REFERENCE_LINE_START_X")		m_startX = StringUtil::ParseDouble(value);
+					else if (key == "REFERENCE_LINE_START_Y")		m_startY = StringUtil::ParseDouble(value);
+					else if (key == "REFERENCE_LINE_START_PHI")		m_startPhi = StringUtil::ParseDouble(value);
+					else if (key == "LONG_SECTION_V_INCREMENT")		vIncrement = StringUtil::ParseDouble(value);
+				}
+			}
+			else if (section == Section::KdDefinition)
+			{
+				String upper = line;
+				StringUtil::UpperCase(upper);
+				if (StringUtil::StartWith(upper, "#:"))
+				{
+					if		(StringUtil::StartWith(upper, "#:KRBI"))	m_format = Format::Float32BE;
+					else if (StringUtil::StartWith(upper, "#:LRBI"))	m_format = Format::Float64BE;
+					else												m_format = Format::Float;
+				}
+				else if (StringUtil::StartWith(upper, "D:"))
+				{
+					if (upper.find("LONG SECTION") != String::npos)
+					{
+						if (columnVs.empty())
+							m_firstColumn = m_channels;
+
+						size_t equal = upper.find('=');
+						columnVs.push_back(equal != String::npos ? std::atof(upper.c_str() + equal + 1) : 0.0);
+					}
+					else if (upper.find("REFERENCE LINE PHI") != String::npos)
+					{
+						m_phiChannel = m_channels;
+					}
+
+					m_channels++;
+				}
+			}
+		}
+
+		return 0;
+	}
+
+	bool OpenCrgGrid::parseAsciiData(const char* data, size_t size)
+	{
+		// strtod stops at the terminating zero the mapped file doesn't have, parse line by line
+		String line;
+		size_t lineStart = 0;
+		while (lineStart < size)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(data + lineStart, '\n', size - lineStart));
+			size_t next = lineEnd ? size_t(lineEnd - data) + 1 : size;
+			line.assign(data + lineStart, next - lineStart);
+			lineStart = next;
+
+			const char* cursor = line.c_str();
+			for (;;)
+			{
+				char* end = nullptr;
+				double value = std::strtod(cursor, &end);
+				if (end == cursor)
+					break;
+
+				m_values.push_back(float(value));
+				cursor = end;
+			}
+		}
+
+		m_values.resize(m_values.size() / m_channels * m_channels);
+		return !m_values.empty();
+	}
+
+	void OpenCrgGrid::buildReferenceLine()
+	{
+		if (m_phiChannel < 0)
+			return;
+
+		// one sequential pass over the phi channel, integrated with the mid point heading
+		size_t phiOffset = m_phiChannel * (m_format == Format::Float64BE ? sizeof(double) : sizeof(float));
+		auto getPhi = [&](i32 row) -> double
+		{
+			const Byte* p = m_data + row * m_rowStride + phiOffset;
+			if (m_format == Format::Float32BE)	return Float32BEDecoder::get(p);
+			if (m_format == Format::Float64BE)	return Float64BEDecoder::get(p);
+			return NativeFloatDecoder::get(p);
+		};
+
+		m_lineX.resize(m_rows);
+		m_lineY.resize(m_rows);
+		m_linePhi.resize(m_rows);
+		m_lineX[0] = m_startX;
+		m_lineY[0] = m_startY;
+		m_linePhi[0] = getPhi(0);
+		for (i32 i = 1; i < m_rows; i++)
+		{
+			m_linePhi[i] = getPhi(i);
+
+			double phi = m_linePhi[i - 1] + wrapAngle(m_linePhi[i] - m_linePhi[i - 1]) * 0.5;
+			m_lineX[i] = m_lineX[i - 1] + cos(phi) * m_du;
+			m_lineY[i] = m_lineY[i - 1] + sin(phi) * m_du;
+		}
+
+		for (i32 begin = 0; begin < m_rows; begin += ReferenceBlockRows)
+		{
+			i32 end = std::min<i32>(begin + ReferenceBlockRows, m_rows - 1);
+			double centerX = (m_lineX[begin] + m_lineX[end]) * 0.5;
+			double centerY = (m_lineY[begin] + m_lineY[end]) * 0.5;
+
+			double radius = 0.0;
+			for (i32 i = begin; i <= end; i++)
+				radius = std::max<double>(radius, std::hypot(m_lineX[i] - centerX, m_lineY[i] - centerY));
+
+			m_blockX.push_back(centerX);
+			m_blockY.push_back(centerY);
+			m_blockRadius.push_back(radius);
+		}
+	}
+
+	void OpenCrgGrid::evaluateReferenceLine(double u, double& x, double& y, double& phi) const
+	{
+		double du = std::max<double>(std::min<double>(u, getEndU()), m_u0) - m_u0;
+		if (m_lineX.empty())
+		{
+			phi = m_startPhi;
+			x = m_startX + cos(phi) * du;
+			y = m_startY + sin(phi) * du;
+		}
+		else
+		{
+			i32    row = std::min<i32>(i32(du / m_du), m_rows - 1);
+			i32    next = std::min<i32>(row + 1, m_rows - 1);
+			double t = du / m_du - row;
+			x = m_lineX[row] + (m_lineX[next] - m_lineX[row]) * t;
+			y = m_lineY[row] + (m_lineY[next] - m_lineY[row]) * t;
+			phi = m_linePhi[row] + wrapAngle(m_linePhi[next] - m_linePhi[row]) * t;
+		}
+	}
+
+	bool OpenCrgGrid::project(double x, double y, double& u, double& v, double& phi) const
+	{
+		if (!isOpen())
+			return false;
+
+		if (m_lineX.empty())
+		{
+			double dx = x - m_startX;
+			double dy = y - m_startY;
+			phi = m_startPhi;
+			u = m_u0 + dx * cos(phi) + dy * sin(phi);
+			v = -dx * sin(phi) + dy * cos(phi);
+		}
+		else
+		{
+			// blocks can be skipped once their bounding circle is farther than the best segment
+			double bestDistance = std::numeric_limits<double>::max();
+			for (size_t block = 0; block < m_blockX.size(); block++)
+			{
+				if (std::hypot(x - m_blockX[block], y - m_blockY[block]) - m_blockRadius[block] >= bestDistance)
+					continue;
+
+				i32 begin = i32(block) * ReferenceBlockRows;
+				i32 end = std::min<i32>(begin + ReferenceBlockRows, m_rows - 1);
+				for (i32 i = begin; i < std::max<i32>(end, begin + 1) && i < m_rows; i++)
+				{
+					i32    next = std::min<i32>(i + 1, m_rows - 1);
+					double sx = m_lineX[next] - m_lineX[i];
+					double sy = m_lineY[next] - m_lineY[i];
+					double length2 = sx * sx + sy * sy;
+					double t = length2 > 0.0 ? ((x - m_lineX[i]) * sx + (y - m_lineY[i]) * sy) / length2 : 0.0;
+					t = std::max<double>(0.0, std::min<double>(t, 1.0));
+
+					double dx = x - (m_lineX[i] + sx * t);
+					double dy = y - (m_lineY[i] + sy * t);
+					double distance = std::hypot(dx, dy);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						phi = m_linePhi[i] + wrapAngle(m_linePhi[next] - m_linePhi[i]) * t;
+						u = m_u0 + (i + t) * m_du;
+						v = -dx * sin(phi) + dy * cos(phi);
+					}
+				}
+			}
+		}
+
+		double halfCell = m_dv * 0.5;
+		return u >= m_u0 && u <= getEndU() && v >= std::min<double>(getStartV(), getEndV()) - halfCell && v <= std::max<double>(getStartV(), getEndV()) + halfCell;
+	}
+
+	void OpenCrgGrid::evaluate(const double* uv, i32 count, Interpolation interpolation, float* heights, float* slopesU, float* slopesV) const
+	{
+		if (!isOpen())
+		{
+			for (i32 i = 0; i < count; i++)
+			{
+				heights[i] = std::numeric_limits<float>::quiet_NaN();
+				slopesU[i] = slopesV[i] = 0.f;
+			}
+			return;
+		}
+
+		i32 batchCount = (count + BatchSize - 1) / BatchSize;
+		JobSystem::instance()->parallelFor(batchCount, [&](i32 batch)
+		{
+			i32 offset = batch * BatchSize;
+			i32 batchSize = std::min<i32>(BatchSize, count - offset);
+			switch (m_format)
+			{
+			case Format::Float32BE: evaluateBatch<Float32BEDecoder>(uv + offset * 2, batchSize, interpolation, heights + offset, slopesU + offset, slopesV + offset);		break;
+			case Format::Float64BE: evaluateBatch<Float64BEDecoder>(uv + offset * 2, batchSize, interpolation, heights + offset, slopesU + offset, slopesV + offset);		break;
+			default:				evaluateBatch<NativeFloatDecoder>(uv + offset * 2, batchSize, interpolation, heights + offset, slopesU + offset, slopesV + offset);	break;
+			}
+		}, 16);
+	}
+
+	template<typename Decoder>
+	void OpenCrgGrid::evaluateBatch(const double* uv, i32 count, Interpolation interpolation, float* heights, float* slopesU, float* slopesV) const
+	{
+		// cells and fractions
+		i32   rows[BatchSize], columns[BatchSize];
+		float tu[BatchSize], tv[BatchSize];
+		for (i32 i = 0; i < count; i++)
+		{
+			double fu = std::max<double>(0.0, std::min<double>((uv[i * 2] - m_u0) / m_du, m_rows - 1));
+			double fv = std::max<double>(0.0, std::min<double>((uv[i * 2 + 1] - m_v0) / m_dv, m_columns - 1));
+			rows[i] = std::min<i32>(i32(fu), std::max<i32>(m_rows - 2, 0));
+			columns[i] = std::min<i32>(i32(fv), std::max<i32>(m_columns - 2, 0));
+			tu[i] = float(fu - rows[i]);
+			tv[i] = float(fv - columns[i]);
+		}
+
+		// gather, neighbours outside of the grid repeat the border
+		const i32 kernel = interpolation == Bicubic ? 4 : 2;
+		const i32 first = interpolation == Bicubic ? -1 : 0;
+		float samples[16][BatchSize];
+		for (i32 r = 0; r < kernel; r++)
+		{
+			for (i32 i = 0; i < count; i++)
+			{
+				i32 row = std::max<i32>(0, std::min<i32>(rows[i] + first + r, m_rows - 1));
+				const Byte* rowData = m_data + row * m_rowStride + m_firstColumn * Decoder::Size;
+				for (i32 c = 0; c < kernel; c++)
+				{
+					i32 column = std::max<i32>(0, std::min<i32>(columns[i] + first + c, m_columns - 1));
+					samples[r * kernel + c][i] = Decoder::get(rowData + column * Decoder::Size);
+				}
+			}
+		}
+
+		// weights
+		float invDu = float(1.0 / m_du);
+		float invDv = float(1.0 / m_dv);
+		if (interpolation == Bicubic)
+		{
+			for (i32 i = 0; i < count; i++)
+			{
+				float wu[4], dwu[4], wv[4], dwv[4];
+				cubicWeights(tu[i], wu, dwu);
+				cubicWeights(tv[i], wv, dwv);
+
+				float height = 0.f, slopeU = 0.f, slopeV = 0.f;
+				for (i32 r = 0; r < 4; r++)
+				{
+					for (i32 c = 0; c < 4; c++)
+					{
+						float z = samples[r * 4 + c][i];
+						height += wu[r] * wv[c] * z;
+						slopeU += dwu[r] * wv[c] * z;
+						slopeV += wu[r] * dwv[c] * z;
+					}
+				}
+
+				heights[i] = height;
+				slopesU[i] = slopeU * invDu;
+				slopesV[i] = slopeV * invDv;
+			}
+		}
+		else
+		{
+			for (i32 i = 0; i < count; i++)
+			{
+				float z00 = samples[0][i], z01 = samples[1][i], z10 = samples[2][i], z11 = samples[3][i];
+				float z0 = z00 + (z01 - z00) * tv[i];
+				float z1 = z10 + (z11 - z10) * tv[i];
+
+				heights[i] = z0 + (z1 - z0) * tu[i];
+				slopesU[i] = (z1 - z0) * invDu;
+				slopesV[i] = ((z01 - z00) + ((z11 - z10) - (z01 - z00)) * tu[i]) * invDv;
+			}
+		}
+	}
+}
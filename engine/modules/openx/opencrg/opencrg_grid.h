@@ -0,0 +1,99 @@
+#pragma once
+
+#include "engine/core/io/memory_mapped_file.h"
+#include "engine/core/memory/MemAllocDef.h"
+
+namespace Echo
+{
+	// OpenCRG road surface grid. Binary data sections are memory mapped and decoded on
+	// the fly, so only the pages touched by queries are ever loaded
+	// https://www.asam.net/standards/detail/opencrg/
+	class OpenCrgGrid
+	{
+	public:
+		// Interpolation
+		enum Interpolation
+		{
+			Bilinear,
+			Bicubic,
+		};
+
+		// Storage of the data section
+		enum class Format
+		{
+			Unknown,
+			Float,			// native floats, ascii files are parsed into this
+			Float32BE,		// KRBI
+			Float64BE,		// LRBI
+		};
+
+	public:
+		OpenCrgGrid();
+		~OpenCrgGrid();
+
+		// Open, binary data is mapped, ascii data is parsed into memory
+		bool open(const String& path);
+		void close();
+
+		// Is open
+		bool isOpen() const { return m_data != nullptr; }
+
+		// Grid size
+		i32 getRowCount() const { return m_rows; }
+		i32 getColumnCount() const { return m_columns; }
+
+		// u range along reference line, v range across it (left positive)
+		double getStartU() const { return m_u0; }
+		double getEndU() const { return m_u0 + m_du * (m_rows - 1); }
+		double getStartV() const { return m_v0; }
+		double getEndV() const { return m_v0 + m_dv * (m_columns - 1); }
+
+		// Reference line of the crg itself, heading of each row comes from the phi channel
+		void evaluateReferenceLine(double u, double& x, double& y, double& phi) const;
+
+		// Closest (u, v) of inertial (x, y) on the crg reference line
+		bool project(double x, double y, double& u, double& v, double& phi) const;
+
+		// Evaluate count (u, v) pairs. Height and slopes along u and v are written per sample,
+		// a nan height means no data. Samples outside of the grid take the border values
+		void evaluate(const double* uv, i32 count, Interpolation interpolation, float* heights, float* slopesU, float* slopesV) const;
+
+	private:
+		// Parse text header, returns offset of the data section
+		size_t parseHeader(const char* data, size_t size);
+
+		// Parse ascii data section
+		bool parseAsciiData(const char* data, size_t size);
+
+		// Reference line polyline
+		void buildReferenceLine();
+
+		// Evaluate up to BatchSize samples
+		template<typename Decoder> void evaluateBatch(const double* uv, i32 count, Interpolation interpolation, float* heights, float* slopesU, float* slopesV) const;
+
+	private:
+		MemoryMappedFile		m_file;
+		vector<float>::type		m_values;				// ascii data
+		const Byte*				m_data = nullptr;
+		Format					m_format = Format::Unknown;
+		i32						m_rows = 0;				// u samples
+		i32						m_columns = 0;			// v samples
+		i32						m_channels = 0;			// values per row
+		i32						m_firstColumn = 0;		// channel of the first long section
+		i32						m_phiChannel = -1;
+		size_t					m_rowStride = 0;		// bytes per row
+		double					m_u0 = 0.0;
+		double					m_du = 1.0;
+		double					m_v0 = 0.0;
+		double					m_dv = 1.0;
+		double					m_startX = 0.0;
+		double					m_startY = 0.0;
+		double					m_startPhi = 0.0;
+		vector<double>::type	m_lineX;				// reference line per row
+		vector<double>::type	m_lineY;
+		vector<double>::type	m_linePhi;
+		vector<double>::type	m_blockX;				// bounding circles of row blocks, for projection
+		vector<double>::type	m_blockY;
+		vector<double>::type	m_blockRadius;
+	};
+}
@@ -0,0 +1,27 @@
+#include "opencrg_module.h"
+#include "opencrg.h"
+
+namespace Echo
+{
+	DECLARE_MODULE(OpenCrgModule, __FILE__)
+
+	OpenCrgModule::OpenCrgModule()
+	{
+	}
+
+	OpenCrgModule* OpenCrgModule::instance()
+	{
+		static OpenCrgModule* inst = EchoNew(OpenCrgModule);
+		return inst;
+	}
+
+	void OpenCrgModule::bindMethods()
+	{
+
+	}
+
+	void OpenCrgModule::registerTypes()
+	{
+		Class::registerType<OpenCrg>();
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "engine/core/main/module.h"
+
+namespace Echo
+{
+	class OpenCrgModule : public Module
+	{
+		ECHO_SINGLETON_CLASS(OpenCrgModule, Module)
+
+	public:
+		OpenCrgModule();
+
+		// instance
+		static OpenCrgModule* instance();
+
+		// register all types of the module
+		virtual void registerTypes() override;
+	};
+}
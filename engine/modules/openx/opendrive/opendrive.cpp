@@ -3,12 +3,23 @@
 #include "opendrive_debug_draw.h"
 #include "opendrive_dynamic_mesh.h"
 #include "opendrive_module.h"
+#include "opendrive_spatial_index.h"
+#include "opendrive_cache.h"
 #include "engine/core/io/io.h"
+#include "engine/core/io/memory_reader.h"
 #include "engine/core/log/Log.h"
 #include "engine/core/main/engine.h"
+#include "engine/core/thread/job_system.h"
 
 namespace Echo
 {
+	// Shortest sample step, and max chord error of lane meshes
+	static const double MinSampleStep = 0.1;
+	static const double MeshSampleTolerance = 0.02;
+
+	// Step cap for lane sections whose widths change along s
+	static const double VaryingWidthSampleStep = 5.0;
+
 	void OpenDrive::Geometry::getHeading(double& x, double& y)
 	{
 		x = cos(m_hdg);
@@ -36,6 +47,75 @@ namespace Echo
 		return getAngleInInterval2PI(m_hdg);
 	}
 
+	double OpenDrive::Geometry::getCurvature(double ds)
+	{
+		double step = std::min<double>(0.01, m_length * 0.5);
+		double ds0 = std::max<double>(ds - step, 0.0);
+		double ds1 = std::min<double>(ds + step, m_length);
+		if (ds1 - ds0 < 1e-9)
+			return 0.0;
+
+		double x, y, h0, h1;
+		evaluate(ds0, x, y, h0);
+		evaluate(ds1, x, y, h1);
+
+		return (h1 - h0) / (ds1 - ds0);
+	}
+
+	void OpenDrive::Geometry::sample(double ds0, double ds1, double tolerance, double maxStep, RealVector& result)
+	{
+		// chord error of a circle with curvature k over step l is about k * l^2 / 8
+		auto getStep = [&](double curvature)
+		{
+			double k = std::fabs(curvature);
+			return k > 1e-9 ? std::max<double>(std::min<double>(sqrt(8.0 * tolerance / k), maxStep), MinSampleStep) : maxStep;
+		};
+
+		double ds = ds0;
+		result.push_back(ds);
+		while (ds < ds1)
+		{
+			// curvature may grow inside the step (spiral), take the tighter one of both ends
+			double step = getStep(getCurvature(ds));
+			step = std::min<double>(step, getStep(getCurvature(std::min<double>(ds + step, ds1))));
+
+			double remain = ds1 - ds;
+			if (remain <= step)
+				ds = ds1;
+			else
+				ds += remain < step * 2.0 ? remain * 0.5 : step;
+
+			result.push_back(ds);
+		}
+	}
+
+	double OpenDrive::Geometry::project(double x, double y, double ds0, double ds1)
+	{
+		// f(ds) = (p - c(ds)) . tangent, f'(ds) = -1 + curvature * lateral
+		double ds = (ds0 + ds1) * 0.5;
+		for (i32 i = 0; i < 8; i++)
+		{
+			double cx, cy, h;
+			evaluate(ds, cx, cy, h);
+
+			double dx = x - cx;
+			double dy = y - cy;
+			double along = dx * cos(h) + dy * sin(h);
+			double lateral = dy * cos(h) - dx * sin(h);
+
+			// inside the osculating circle the slope flips, fall back to a damped step
+			double slope = std::max<double>(1.0 - getCurvature(ds) * lateral, 0.1);
+			double step = along / slope;
+			double next = std::clamp<double>(ds + step, ds0, ds1);
+			if (std::fabs(next - ds) < 1e-6)
+				return next;
+
+			ds = next;
+		}
+
+		return ds;
+	}
+
 	void OpenDrive::Line::evaluate(double sampleLength, double& x, double& y, double& h)
 	{
 		h = m_hdg;
@@ -43,6 +123,12 @@ namespace Echo
 		y = m_y + sampleLength * sin(h);
 	}
 
+	double OpenDrive::Line::project(double x, double y, double ds0, double ds1)
+	{
+		double ds = (x - m_x) * cos(m_hdg) + (y - m_y) * sin(m_hdg);
+		return std::clamp<double>(ds, ds0, ds1);
+	}
+
 	void OpenDrive::Arc::evaluate(double ds, double& x, double& y, double& h)
 	{
 		// Reference https://github.com/esmini/esmini/blob/cc6238ca1c0ade9aefb94a1e7f2e48bc143b8e1f/EnvironmentSimulator/Modules/RoadManager/RoadManager.cpp
@@ -173,6 +259,16 @@ namespace Echo
 		}
 	}
 
+	double OpenDrive::Spiral::getCurvature(double ds)
+	{
+		if (m_line)
+			return 0.0;
+		else if (m_arc)
+			return m_arc->m_curvature;
+		else
+			return m_curvatureStart + m_cdot * ds;
+	}
+
 	void OpenDrive::Spiral::getStart(double& x, double& y)
 	{
 		if (m_line || m_arc)
@@ -349,6 +445,18 @@ namespace Echo
 		h = hdg + atan2(m_poly3V.evaluatePrim(p), m_poly3U.evaluatePrim(p));
 	}
 
+	double OpenDrive::ParamPoly3::getCurvature(double ds)
+	{
+		double p = s2p(ds);
+		double du = m_poly3U.evaluatePrim(p);
+		double dv = m_poly3V.evaluatePrim(p);
+		double ddu = m_poly3U.evaluatePrimPrim(p);
+		double ddv = m_poly3V.evaluatePrimPrim(p);
+		double speed = std::max<double>(du * du + dv * dv, 1e-12);
+
+		return (du * ddv - dv * ddu) / (speed * sqrt(speed));
+	}
+
 	OpenDrive::LaneWidth* OpenDrive::Lane::getWidth(double s)
 	{
 		if (!m_widthes.empty())
@@ -484,16 +592,13 @@ namespace Echo
 
 	OpenDrive::Geometry* OpenDrive::Road::getGeometryByS(double ds)
 	{
-		if (!m_geometries.empty())
+		// geometries are sorted by s, take the last one starting before ds
+		GeometryArray::iterator it = std::upper_bound(m_geometries.begin(), m_geometries.end(), ds, [](double value, const Geometry* geometry) { return value < geometry->m_s; });
+		if (it != m_geometries.begin())
 		{
-			for (int i = 0; i < int(m_geometries.size()); i++)
-			{
-				double rangeBegin = m_geometries[i]->m_s;
-				double rangeEnd = rangeBegin + m_geometries[i]->m_length;
-
-				if (ds >= rangeBegin && ds <= rangeEnd)
-					return m_geometries[i];
-			}
+			Geometry* geometry = *(it - 1);
+			if (ds <= geometry->m_s + geometry->m_length)
+				return geometry;
 		}
 
 		return nullptr;
@@ -503,13 +608,12 @@ namespace Echo
 	{
 		if (!m_laneSections.empty())
 		{
-			for (int i = 0; i < int(m_laneSections.size()); i++)
+			LaneSectionArray::iterator it = std::upper_bound(m_laneSections.begin(), m_laneSections.end(), ds, [](double value, const LaneSection& laneSection) { return value < laneSection.m_s; });
+			if (it != m_laneSections.begin())
 			{
-				double rangeBegin = m_laneSections[i].m_s;
-				double rangeEnd = rangeBegin + m_laneSections[i].m_length;
-
-				if (ds >= rangeBegin && ds <= rangeEnd)
-					return &m_laneSections[i];
+				LaneSection& laneSection = *(it - 1);
+				if (ds <= laneSection.m_s + laneSection.m_length)
+					return &laneSection;
 			}
 
 			if (ds <= m_length)
@@ -528,10 +632,65 @@ namespace Echo
 		}
 	}
 
+	void OpenDrive::Road::sample(double s0, double s1, double tolerance, double maxStep, RealVector& result)
+	{
+		for (Geometry* geometry : m_geometries)
+		{
+			double geoS = geometry->m_s;
+			double geoE = geometry->m_s + geometry->getLength();
+			if (geoE < s0 || geoS > s1)
+				continue;
+
+			size_t begin = result.size();
+			geometry->sample(std::max<double>(s0, geoS) - geoS, std::min<double>(s1, geoE) - geoS, tolerance, maxStep, result);
+			for (size_t i = begin; i < result.size(); i++)
+				result[i] += geoS;
+
+			// end of the previous geometry is the start of this one
+			if (begin > 0 && result[begin] <= result[begin - 1])
+				result.erase(result.begin() + begin);
+		}
+	}
+
+	void OpenDrive::Road::getWidth(double s, double& left, double& right)
+	{
+		left = right = 0.0;
+
+		LaneSection* laneSection = getLaneSectionByS(s);
+		if (laneSection)
+		{
+			for (i32 laneId = 1; laneSection->getLaneById(laneId); laneId++)
+				left += laneSection->getLaneWidth(s, laneId);
+
+			for (i32 laneId = -1; laneSection->getLaneById(laneId); laneId--)
+				right += laneSection->getLaneWidth(s, laneId);
+		}
+	}
+
+	i32 OpenDrive::Road::getLaneIdByT(double s, double t)
+	{
+		LaneSection* laneSection = getLaneSectionByS(s);
+		if (laneSection)
+		{
+			i32    step = t >= 0.0 ? 1 : -1;
+			double offset = std::fabs(t);
+			double outer = 0.0;
+			for (i32 laneId = step; laneSection->getLaneById(laneId); laneId += step)
+			{
+				outer += laneSection->getLaneWidth(s, laneId);
+				if (offset <= outer)
+					return laneId;
+			}
+		}
+
+		return 0;
+	}
+
 	OpenDrive::OpenDrive()
 		: Node()
 	{
 		m_debugDraw = EchoNew(OpenDriveDebugDraw);
+		m_spatialIndex = EchoNew(OpenDriveSpatialIndex);
 	}
 
 	OpenDrive::~OpenDrive()
@@ -539,6 +698,7 @@ namespace Echo
 		reset();
 
 		EchoSafeDelete(m_debugDraw, OpenDriveDebugDraw);
+		EchoSafeDelete(m_spatialIndex, OpenDriveSpatialIndex);
 	}
 
 	void OpenDrive::bindMethods()
@@ -547,6 +707,8 @@ namespace Echo
 		CLASS_BIND_METHOD(OpenDrive, setXodrRes);
 		CLASS_BIND_METHOD(OpenDrive, getDebugDraw);
 		CLASS_BIND_METHOD(OpenDrive, setDebugDraw);
+		CLASS_BIND_METHOD(OpenDrive, localizePosition);
+		CLASS_BIND_METHOD(OpenDrive, localizePositions);
 
 		CLASS_REGISTER_PROPERTY(OpenDrive, "Xodr", Variant::Type::ResourcePath, getXodrRes, setXodrRes);
 		CLASS_REGISTER_PROPERTY(OpenDrive, "DebugDraw", Variant::Type::Object, getDebugDraw, setDebugDraw);
@@ -555,6 +717,9 @@ namespace Echo
 
 	void OpenDrive::reset()
 	{
+		if (m_spatialIndex)
+			m_spatialIndex->clear();
+
 		for (Road& road : m_roads)
 		{
 			EchoSafeDeleteContainer(road.m_geometries, Geometry);
@@ -563,6 +728,46 @@ namespace Echo
 		m_roads.clear();
 	}
 
+	bool OpenDrive::localize(double x, double y, Location& location)
+	{
+		return m_spatialIndex->localize(m_roads, x, y, location);
+	}
+
+	void OpenDrive::localize(const double* xy, i32 count, Location* locations)
+	{
+		JobSystem::instance()->parallelFor(count, [&](i32 i)
+		{
+			m_spatialIndex->localize(m_roads, xy[i * 2], xy[i * 2 + 1], locations[i]);
+		}, 256);
+	}
+
+	RealVector OpenDrive::localizePosition(const Vector3& position)
+	{
+		return localizePositions({ position.x, position.y, position.z });
+	}
+
+	RealVector OpenDrive::localizePositions(const RealVector& positions)
+	{
+		// echo (x, h, -y) back to opendrive inertial (x, y)
+		i32 count = i32(positions.size() / 3);
+		vector<double>::type xy(count * 2);
+		for (i32 i = 0; i < count; i++)
+		{
+			xy[i * 2] = positions[i * 3];
+			xy[i * 2 + 1] = -positions[i * 3 + 2];
+		}
+
+		vector<Location>::type locations(count);
+		localize(xy.data(), count, locations.data());
+
+		RealVector result;
+		result.reserve(count * 5);
+		for (const Location& location : locations)
+			result.insert(result.end(), { double(location.m_roadId), double(location.m_laneId), location.m_s, location.m_t, location.m_heading });
+
+		return result;
+	}
+
 	void OpenDrive::setXodrRes(const ResourcePath& path)
 	{
 		if (m_xodrRes.setPath(path.getPath()))
@@ -571,10 +776,33 @@ namespace Echo
 		}
 	}
 
-	void OpenDrive::parseXodr(const String& content)
+	void OpenDrive::loadXodr(const String& path)
+	{
+		MemoryReader reader(path);
+		if (reader.getSize())
+		{
+			ui64 hash = OpenDriveCache::hash(reader.getData<const char*>(), reader.getSize());
+			if (!OpenDriveCache::load(OpenDriveCache::getCachePath(path), hash, m_roads) &&
+				!OpenDriveCache::load(OpenDriveCache::getUserCachePath(path), hash, m_roads))
+			{
+				parseXodr(reader.getData<const char*>(), reader.getSize());
+
+				// resource directory is read only for packed games
+				if (!OpenDriveCache::save(OpenDriveCache::getCachePath(path), hash, m_roads))
+					OpenDriveCache::save(OpenDriveCache::getUserCachePath(path), hash, m_roads);
+			}
+		}
+
+		m_spatialIndex->build(m_roads);
+
+		refreshDebugDraw();
+		refreshDynamicMeshes();
+	}
+
+	void OpenDrive::parseXodr(const char* content, size_t size)
 	{
 		pugi::xml_document doc;
-		doc.load_string(content.c_str());
+		doc.load_buffer(content, size);
 
 		pugi::xml_node openDriveNode = doc.child("OpenDRIVE");
 		for (pugi::xml_node roadNode = openDriveNode.child("road"); roadNode; roadNode = roadNode.next_sibling("road"))
@@ -592,9 +820,6 @@ namespace Echo
 
 			m_roads.emplace_back(road);
 		}
-
-		refreshDebugDraw();
-		refreshDynamicMeshes();
 	}
 
 	void OpenDrive::parseGeometry(Road& road, pugi::xml_node roadNode)
@@ -876,7 +1101,7 @@ namespace Echo
 		if (m_xodrDirty)
 		{
 			reset();
-			parseXodr(IO::instance()->loadFileToString(m_xodrRes.getPath()));
+			loadXodr(m_xodrRes.getPath());
 
 			m_xodrDirty = false;
 		}
@@ -896,11 +1121,26 @@ namespace Echo
 			}
 		}
 
-		for (OpenDrive::Road& road : getRoads())
+		// Sample roads on worker threads, meshes are only touched on this thread
+		vector<vector<LaneStrip>::type>::type roadStrips(m_roads.size());
+		JobSystem::instance()->parallelFor(i32(m_roads.size()), [&](i32 i)
 		{
-			for (OpenDrive::LaneSection& laneSection : road.m_laneSections)
+			sampleRoadLanes(m_roads[i], roadStrips[i]);
+		}, 4);
+
+		map<LaneType, OpenDriveDynamicMesh*>::type laneMeshes;
+		for (vector<LaneStrip>::type& strips : roadStrips)
+		{
+			for (LaneStrip& strip : strips)
 			{
-				drawLane(road, laneSection);
+				OpenDriveDynamicMesh*& laneMesh = laneMeshes[strip.m_lane->m_type];
+				if (!laneMesh)
+					laneMesh = getLaneMesh(*strip.m_lane);
+
+				for (size_t i = 0; i < strip.m_centers.size(); i++)
+				{
+					laneMesh->add(strip.m_centers[i], strip.m_forwards[i], Vector3::UNIT_Y, strip.m_widths[i], Echo::Color::GREEN, i == 0 ? true : false);
+				}
 			}
 		}
 	}
@@ -924,75 +1164,66 @@ namespace Echo
 		return newMesh;
 	}
 
-	void OpenDrive::drawLane(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection)
+	void OpenDrive::sampleRoadLanes(OpenDrive::Road& road, vector<LaneStrip>::type& strips)
 	{
-		vector<double>::type samplePoints = sampleLaneSection(road, laneSection);
-
-		for (OpenDrive::Lane& lane : laneSection.m_lanes)
+		RealVector samplePoints;
+		RealVector headings;
+		vector<Vector3>::type centers;
+		for (OpenDrive::LaneSection& laneSection : road.m_laneSections)
 		{
-			if (lane.m_id != 0)
+			samplePoints.clear();
+			sampleLaneSection(road, laneSection, MeshSampleTolerance, samplePoints);
+
+			// Reference line is evaluated once and shared by all lanes
+			centers.resize(samplePoints.size());
+			headings.resize(samplePoints.size());
+			for (size_t i = 0; i < samplePoints.size(); i++)
 			{
-				for (size_t i = 0; i < samplePoints.size(); i++)
-				{
-					double startX, startY, startH;
-					double ds0 = samplePoints[i];
-					road.evaluate(ds0, startX, startY, startH);
+				double x, y;
+				road.evaluate(samplePoints[i], x, y, headings[i]);
+				centers[i] = toVec3(x, y);
+			}
 
-					Vector3 center0 = toVec3(startX, startY);
+			for (OpenDrive::Lane& lane : laneSection.m_lanes)
+			{
+				if (lane.m_id != 0 && !samplePoints.empty())
+				{
+					strips.emplace_back();
+					LaneStrip& strip = strips.back();
+					strip.m_lane = &lane;
+					strip.m_centers.reserve(samplePoints.size());
+					strip.m_forwards.reserve(samplePoints.size());
+					strip.m_widths.reserve(samplePoints.size());
 
-					double laneCenterOffset0 = laneSection.getLaneCenterOffset(ds0, lane.m_id);
-					double laneWidth = laneSection.getLaneWidth(ds0, lane.m_id);
 					double offsetH = lane.m_id > 0 ? Math::PI_DIV2 : -Math::PI_DIV2;
-
-					Vector3 forward = toDir3(startH);
-					Vector3 leftDir0 = toDir3(startH + offsetH);
-					Vector3 laneCenter0 = center0 + leftDir0 * laneCenterOffset0;
-
-					OpenDriveDynamicMesh* laneMesh = getLaneMesh(lane);
-					if (laneMesh)
+					for (size_t i = 0; i < samplePoints.size(); i++)
 					{
-						laneMesh->add(laneCenter0, forward, Vector3::UNIT_Y, laneWidth, Echo::Color::GREEN, i == 0 ? true : false);
+						double ds0 = samplePoints[i];
+						double laneCenterOffset0 = laneSection.getLaneCenterOffset(ds0, lane.m_id);
+
+						strip.m_centers.push_back(centers[i] + toDir3(headings[i] + offsetH) * laneCenterOffset0);
+						strip.m_forwards.push_back(toDir3(headings[i]));
+						strip.m_widths.push_back(float(laneSection.getLaneWidth(ds0, lane.m_id)));
 					}
 				}
 			}
 		}
 	}
 
-	vector<double>::type OpenDrive::sampleLaneSection(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection)
+	void OpenDrive::sampleLaneSection(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection, double tolerance, RealVector& result)
 	{
-		vector<double>::type result;
-
-		double laneS = laneSection.m_s;
-		double laneE = laneSection.m_s + laneSection.getLength();
-
-		for (OpenDrive::Geometry* geometry : road.m_geometries)
+		// straight constant width lanes need their end points only
+		double maxStep = laneSection.getLength();
+		for (OpenDrive::Lane& lane : laneSection.m_lanes)
 		{
-			double geoS = geometry->m_s;
-			double geoE = geometry->m_s + geometry->getLength();
-
-			if (!(geoS > laneE || geoE < laneS))
+			for (OpenDrive::LaneWidth& width : lane.m_widthes)
 			{
-				double finalS = std::max<double>(laneS, geoS);
-				double finalE = std::min<double>(laneE, geoE);
-
-				if (geometry->isType(OpenDrive::Geometry::Line))
-				{
-					result.push_back(finalS);
-					result.push_back(finalE);
-				}
-				else
-				{
-					double finalLength = finalE - finalS;
-					i32    stepCount = std::max<i32>(i32(finalLength / 1), 1);
-					double stepLength = finalLength / stepCount;
-
-					for (i32 i = 0; i <= stepCount; i++)
-						result.push_back(i * stepLength + finalS);
-				}
+				if (lane.m_widthes.size() > 1 || width.m_poly3.m_b != 0.0 || width.m_poly3.m_c != 0.0 || width.m_poly3.m_d != 0.0)
+					maxStep = std::min<double>(maxStep, VaryingWidthSampleStep);
 			}
 		}
 
-		return result;
+		road.sample(laneSection.m_s, laneSection.m_s + laneSection.getLength(), tolerance, std::max<double>(maxStep, MinSampleStep), result);
 	}
 
 	Vector3 OpenDrive::toDir3(double radian, double h)
@@ -9,6 +9,7 @@ namespace Echo
 {
 	class OpenDriveDebugDraw;
 	class OpenDriveDynamicMesh;
+	class OpenDriveSpatialIndex;
 
 	// https://www.asam.net/standards/detail/opendrive/
 	class OpenDrive : public Node
@@ -52,6 +53,7 @@ namespace Echo
 				, m_length(length)
 				, m_s(s)
 			{}
+			virtual ~Geometry() {}
 
 			// Check type
 			bool isType(Type type) const { return m_type == type; }
@@ -67,6 +69,15 @@ namespace Echo
 
 			// Hdg
 			virtual double getHdg() const;
+
+			// Curvature, central difference of heading by default
+			virtual double getCurvature(double ds);
+
+			// Closest ds in [ds0, ds1] to point (x, y), newton iterations on the tangent error
+			virtual double project(double x, double y, double ds0, double ds1);
+
+			// Append ds of [ds0, ds1], step shrinks with curvature so chord error stays under tolerance
+			void sample(double ds0, double ds1, double tolerance, double maxStep, RealVector& result);
 		};
 		typedef vector<Geometry*>::type GeometryArray;
 
@@ -79,6 +90,12 @@ namespace Echo
 
 			// Evaluate
 			virtual void evaluate(double sampleLength, double& x, double& y, double& h) override;
+
+			// Curvature
+			virtual double getCurvature(double ds) override { return 0.0; }
+
+			// Closed form projection
+			virtual double project(double x, double y, double ds0, double ds1) override;
 		};
 
 		// Line
@@ -94,6 +111,9 @@ namespace Echo
 			// Evaluate
 			virtual void evaluate(double sampleLength, double& x, double& y, double& h) override;
 
+			// Curvature
+			virtual double getCurvature(double ds) override { return m_curvature; }
+
 			// Radius
 			double getRadius() const { return 1.0 / std::fabs(m_curvature); }
 
@@ -124,6 +144,9 @@ namespace Echo
 			// Heading
 			virtual void getHeading(double& x, double& y);
 
+			// Curvature changes linearly
+			virtual double getCurvature(double ds) override;
+
 			// Start position
 			virtual void getStart(double& x, double& y);
 		};
@@ -174,6 +197,7 @@ namespace Echo
 				ArcLength,
 			};
 
+			RangeType	m_rangeType = RangeType::Normalized;
 			Polynomial	m_poly3U;
 			Polynomial	m_poly3V;
 			double		m_s2pMap[PARAMPOLY3_STEPS + 1][2];
@@ -182,6 +206,7 @@ namespace Echo
 						double aU, double bU, double cU, double dU,
 						double aV, double bV, double cV, double dV)
 				: Geometry(s, x, y, hdg, length, Geometry::ParamPoly3)
+				, m_rangeType(type)
 			{
 				m_poly3U.set(aU, bU, cU, dU, type == RangeType::Normalized ? 1.0 / length : 1.0);
 				m_poly3V.set(aV, bV, cV, dV, type == RangeType::Normalized ? 1.0 / length : 1.0);
@@ -192,6 +217,9 @@ namespace Echo
 			// Evaluate
 			virtual void evaluate(double ds, double& x, double& y, double& h) override;
 
+			// Curvature of the parametric curve
+			virtual double getCurvature(double ds) override;
+
 			// s2p
 			double s2p(double s);
 
@@ -386,12 +414,44 @@ namespace Echo
 			ElevationArray		m_superElevationProfile;
 			LaneSectionArray	m_laneSections;
 
-			// Get by s
+			// Get by s, binary search
 			Geometry* getGeometryByS(double ds);
 			LaneSection* getLaneSectionByS(double ds);
 
 			// Evaluate reference line
 			void evaluate(double s, double& x, double& y, double& h);
+
+			// Append curvature adaptive s of [s0, s1] over all geometries
+			void sample(double s0, double s1, double tolerance, double maxStep, RealVector& result);
+
+			// Outer offsets of the outermost left and right lanes
+			void getWidth(double s, double& left, double& right);
+
+			// Lane at lateral offset t (left positive), 0 if t is outside of the lanes
+			i32 getLaneIdByT(double s, double t);
+		};
+
+		// Lane center samples of one lane section, appended to the lane mesh of its type
+		struct LaneStrip
+		{
+			Lane*					m_lane = nullptr;
+			vector<Vector3>::type	m_centers;
+			vector<Vector3>::type	m_forwards;
+			vector<float>::type		m_widths;
+		};
+
+		// World position on road network
+		struct Location
+		{
+			i32		m_roadIndex = -1;		// index of getRoads()
+			i32		m_roadId = -1;
+			i32		m_laneId = 0;
+			double	m_s = 0.0;
+			double	m_t = 0.0;				// lateral offset to reference line, left positive
+			double	m_heading = 0.0;		// heading of reference line at s
+
+			// Valid
+			bool isValid() const { return m_roadIndex >= 0; }
 		};
 
 	public:
@@ -409,6 +469,16 @@ namespace Echo
 		// Roads
 		vector<Road>::type& getRoads() { return m_roads; }
 
+		// Localize inertial (x, y) to road, lane, s, t and heading
+		bool localize(double x, double y, Location& location);
+
+		// Localize count points of xy pairs on worker threads
+		void localize(const double* xy, i32 count, Location* locations);
+
+		// Script friendly localization of echo positions, returns [roadId, laneId, s, t, heading] per position
+		RealVector localizePosition(const Vector3& position);
+		RealVector localizePositions(const RealVector& positions);
+
 		// Reset
 		void reset();
 
@@ -417,9 +487,15 @@ namespace Echo
 		static Vector3 toDir3(double radian, double h = 0.0);
 		static Vector3 toVec3(double x, double y, double h = 0.0);
 
+		// Sample Lane Section, adaptive to reference line curvature and lane width changes
+		static void sampleLaneSection(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection, double tolerance, RealVector& result);
+
 	private:
+		// Load from binary cache, or parse the xodr and cook the cache
+		void loadXodr(const String& path);
+
 		// Parse
-		void parseXodr(const String& content);
+		void parseXodr(const char* content, size_t size);
 		void parseGeometry(Road& road, pugi::xml_node roadNode);
 		void parseRoadLink(Road& road, pugi::xml_node roadNode);
 		void parseLanes(Road& road, pugi::xml_node roadNode);
@@ -429,11 +505,8 @@ namespace Echo
 		void refreshDebugDraw();
 		void refreshDynamicMeshes();
 
-		// Draw lane
-		void drawLane(OpenDrive::Road& road, LaneSection& laneSection);
-
-		// Sample Lane Section
-		vector<double>::type sampleLaneSection(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection);
+		// Lane strips of one road, safe to run on worker threads
+		void sampleRoadLanes(OpenDrive::Road& road, vector<LaneStrip>::type& strips);
 
 		// Get lane mesh
 		OpenDriveDynamicMesh* getLaneMesh(Lane& lane);
@@ -445,6 +518,7 @@ namespace Echo
 		ResourcePath						m_xodrRes = ResourcePath("", ".xodr");
 		bool								m_xodrDirty = true;
 		vector<Road>::type					m_roads;
+		OpenDriveSpatialIndex*				m_spatialIndex = nullptr;
 		OpenDriveDebugDraw*					m_debugDraw = nullptr;
 	};
 }
@@ -0,0 +1,438 @@
+#include "opendrive_cache.h"
+#include "engine/core/io/io.h"
+#include "engine/core/io/memory_reader.h"
+#include "engine/core/log/Log.h"
+#include "engine/core/util/PathUtil.h"
+
+namespace Echo
+{
+	// Bump the version whenever the layout below changes
+	static const ui32 CacheFileMagic = 'E' | ('O' << 8) | ('D' << 16) | ('R' << 24);
+	static const ui32 CacheFileVersion = 1;
+
+	struct CacheFileHeader
+	{
+		ui32	m_magic = CacheFileMagic;
+		ui32	m_version = CacheFileVersion;
+		ui64	m_hash = 0;
+	};
+
+	// Appends everything to one buffer, written to disk in one go
+	class CacheWriter
+	{
+	public:
+		template<typename T> void write(const T& value)
+		{
+			const Byte* bytes = reinterpret_cast<const Byte*>(&value);
+			m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(T));
+		}
+
+		void write(const String& value)
+		{
+			write<ui32>(ui32(value.size()));
+			m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+		}
+
+		void write(const OpenDrive::Polynomial& poly)
+		{
+			write(poly.m_a);
+			write(poly.m_b);
+			write(poly.m_c);
+			write(poly.m_d);
+		}
+
+		const vector<Byte>::type& getBuffer() const { return m_buffer; }
+
+	private:
+		vector<Byte>::type	m_buffer;
+	};
+
+	// Bounds checked reads, a truncated file makes the whole load fail
+	class CacheReader
+	{
+	public:
+		CacheReader(const Byte* data, size_t size)
+			: m_data(data), m_end(data + size)
+		{}
+
+		template<typename T> T read()
+		{
+			T value = T();
+			if (m_data + sizeof(T) <= m_end)
+			{
+				std::memcpy(&value, m_data, sizeof(T));
+				m_data += sizeof(T);
+			}
+			else
+			{
+				m_isValid = false;
+			}
+
+			return value;
+		}
+
+		String readString()
+		{
+			ui32 size = read<ui32>();
+			if (m_isValid && m_data + size <= m_end)
+			{
+				String value(reinterpret_cast<const char*>(m_data), size);
+				m_data += size;
+				return value;
+			}
+
+			m_isValid = false;
+			return StringUtil::BLANK;
+		}
+
+		void readPolynomial(double& a, double& b, double& c, double& d)
+		{
+			a = read<double>();
+			b = read<double>();
+			c = read<double>();
+			d = read<double>();
+		}
+
+		// Element count, rejected if the rest of the file can't hold count elements of elementSize bytes
+		ui32 readCount(size_t elementSize)
+		{
+			ui32 count = read<ui32>();
+			if (!m_isValid || size_t(m_end - m_data) / elementSize < count)
+			{
+				m_isValid = false;
+				return 0;
+			}
+
+			return count;
+		}
+
+		bool isValid() const { return m_isValid; }
+
+	private:
+		const Byte*		m_data;
+		const Byte*		m_end;
+		bool			m_isValid = true;
+	};
+
+	static void writeGeometry(CacheWriter& writer, OpenDrive::Geometry* geometry)
+	{
+		writer.write<i32>(geometry->m_type);
+		writer.write(geometry->m_s);
+		writer.write(geometry->m_x);
+		writer.write(geometry->m_y);
+		writer.write(geometry->m_hdg);
+		writer.write(geometry->m_length);
+
+		switch (geometry->m_type)
+		{
+		case OpenDrive::Geometry::Arc:
+		{
+			writer.write(ECHO_DOWN_CAST<OpenDrive::Arc*>(geometry)->m_curvature);
+		}
+		break;
+		case OpenDrive::Geometry::Spiral:
+		{
+			OpenDrive::Spiral* spiral = ECHO_DOWN_CAST<OpenDrive::Spiral*>(geometry);
+			writer.write(spiral->m_curvatureStart);
+			writer.write(spiral->m_curvatureEnd);
+		}
+		break;
+		case OpenDrive::Geometry::Poly3:
+		{
+			writer.write(ECHO_DOWN_CAST<OpenDrive::Poly3*>(geometry)->m_poly3);
+		}
+		break;
+		case OpenDrive::Geometry::ParamPoly3:
+		{
+			OpenDrive::ParamPoly3* paramPoly3 = ECHO_DOWN_CAST<OpenDrive::ParamPoly3*>(geometry);
+			writer.write<i32>(paramPoly3->m_rangeType);
+			writer.write(paramPoly3->m_poly3U);
+			writer.write(paramPoly3->m_poly3V);
+		}
+		break;
+		default: break;
+		}
+	}
+
+	// Derived data (spiral start point, paramPoly3 arc length table ...) is rebuilt by the constructors
+	static OpenDrive::Geometry* readGeometry(CacheReader& reader)
+	{
+		i32    type = reader.read<i32>();
+		double s = reader.read<double>();
+		double x = reader.read<double>();
+		double y = reader.read<double>();
+		double hdg = reader.read<double>();
+		double length = reader.read<double>();
+
+		switch (type)
+		{
+		case OpenDrive::Geometry::Line:
+		{
+			return EchoNew(OpenDrive::Line(s, x, y, hdg, length));
+		}
+		case OpenDrive::Geometry::Arc:
+		{
+			double curvature = reader.read<double>();
+			return EchoNew(OpenDrive::Arc(s, x, y, hdg, length, curvature));
+		}
+		case OpenDrive::Geometry::Spiral:
+		{
+			double curvatureStart = reader.read<double>();
+			double curvatureEnd = reader.read<double>();
+			return EchoNew(OpenDrive::Spiral(s, x, y, hdg, length, curvatureStart, curvatureEnd));
+		}
+		case OpenDrive::Geometry::Poly3:
+		{
+			double a, b, c, d;
+			reader.readPolynomial(a, b, c, d);
+			return EchoNew(OpenDrive::Poly3(s, x, y, hdg, length, a, b, c, d));
+		}
+		case OpenDrive::Geometry::ParamPoly3:
+		{
+			OpenDrive::ParamPoly3::RangeType rangeType = OpenDrive::ParamPoly3::RangeType(reader.read<i32>());
+			double aU, bU, cU, dU, aV, bV, cV, dV;
+			reader.readPolynomial(aU, bU, cU, dU);
+			reader.readPolynomial(aV, bV, cV, dV);
+			return EchoNew(OpenDrive::ParamPoly3(s, x, y, hdg, length, rangeType, aU, bU, cU, dU, aV, bV, cV, dV));
+		}
+		default: return nullptr;
+		}
+	}
+
+	static void writeElevations(CacheWriter& writer, const OpenDrive::ElevationArray& elevations)
+	{
+		writer.write<ui32>(ui32(elevations.size()));
+		for (const OpenDrive::Elevation& elevation : elevations)
+		{
+			writer.write(elevation.m_s);
+			writer.write(elevation.m_length);
+			writer.write(elevation.m_poly3);
+		}
+	}
+
+	static void readElevations(CacheReader& reader, OpenDrive::ElevationArray& elevations)
+	{
+		ui32 count = reader.readCount(sizeof(double) * 6);
+		elevations.reserve(count);
+		for (ui32 i = 0; i < count; i++)
+		{
+			double s = reader.read<double>();
+			double length = reader.read<double>();
+			double a, b, c, d;
+			reader.readPolynomial(a, b, c, d);
+
+			OpenDrive::Elevation elevation(s, a, b, c, d);
+			elevation.m_length = length;
+			elevations.emplace_back(elevation);
+		}
+	}
+
+	static void writeLane(CacheWriter& writer, const OpenDrive::Lane& lane)
+	{
+		writer.write(lane.m_id);
+		writer.write(lane.m_globalId);
+		writer.write(lane.m_type);
+		writer.write(lane.m_level);
+		writer.write(lane.m_predecessor.m_id);
+		writer.write(lane.m_successor.m_id);
+
+		writer.write<ui32>(ui32(lane.m_widthes.size()));
+		for (const OpenDrive::LaneWidth& width : lane.m_widthes)
+		{
+			writer.write(width.m_offset);
+			writer.write(width.m_poly3);
+		}
+
+		writer.write<ui32>(ui32(lane.m_roadMarks.size()));
+		for (const OpenDrive::LaneRoadMark& roadMark : lane.m_roadMarks)
+		{
+			writer.write(roadMark.m_offset);
+			writer.write(roadMark.m_width);
+			writer.write(roadMark.m_height);
+			writer.write(roadMark.m_type);
+			writer.write(roadMark.m_weight);
+			writer.write(roadMark.m_color);
+			writer.write(roadMark.m_material);
+			writer.write(roadMark.m_laneChange);
+		}
+	}
+
+	static void readLane(CacheReader& reader, OpenDrive::Lane& lane)
+	{
+		lane.m_id = reader.read<i32>();
+		lane.m_globalId = reader.read<i32>();
+		lane.m_type = reader.read<OpenDrive::LaneType>();
+		lane.m_level = reader.read<i32>();
+		lane.m_predecessor.m_id = reader.read<i32>();
+		lane.m_successor.m_id = reader.read<i32>();
+
+		ui32 widthCount = reader.readCount(sizeof(double) * 5);
+		lane.m_widthes.reserve(widthCount);
+		for (ui32 i = 0; i < widthCount; i++)
+		{
+			double offset = reader.read<double>();
+			double a, b, c, d;
+			reader.readPolynomial(a, b, c, d);
+
+			lane.m_widthes.emplace_back(OpenDrive::LaneWidth(offset, a, b, c, d));
+		}
+
+		ui32 roadMarkCount = reader.readCount(sizeof(double) * 3);
+		lane.m_roadMarks.resize(roadMarkCount);
+		for (OpenDrive::LaneRoadMark& roadMark : lane.m_roadMarks)
+		{
+			roadMark.m_offset = reader.read<double>();
+			roadMark.m_width = reader.read<double>();
+			roadMark.m_height = reader.read<double>();
+			roadMark.m_type = reader.read<OpenDrive::LaneRoadMark::MarkType>();
+			roadMark.m_weight = reader.read<OpenDrive::LaneRoadMark::MarkWeight>();
+			roadMark.m_color = reader.read<OpenDrive::LaneRoadMark::MarkColor>();
+			roadMark.m_material = reader.read<OpenDrive::LaneRoadMark::MarkMaterial>();
+			roadMark.m_laneChange = reader.read<OpenDrive::LaneRoadMark::MarkLaneChange>();
+		}
+	}
+
+	static void writeRoad(CacheWriter& writer, const OpenDrive::Road& road)
+	{
+		writer.write(road.m_name);
+		writer.write(road.m_length);
+		writer.write(road.m_id);
+		writer.write(road.m_junction);
+		writer.write(road.m_predecessor);
+		writer.write(road.m_successor);
+
+		writer.write<ui32>(ui32(road.m_geometries.size()));
+		for (OpenDrive::Geometry* geometry : road.m_geometries)
+			writeGeometry(writer, geometry);
+
+		writeElevations(writer, road.m_elevationProfile);
+		writeElevations(writer, road.m_superElevationProfile);
+
+		writer.write<ui32>(ui32(road.m_laneSections.size()));
+		for (const OpenDrive::LaneSection& laneSection : road.m_laneSections)
+		{
+			writer.write(laneSection.m_s);
+			writer.write(laneSection.m_singleSide);
+			writer.write(laneSection.m_length);
+
+			writer.write<ui32>(ui32(laneSection.m_lanes.size()));
+			for (const OpenDrive::Lane& lane : laneSection.m_lanes)
+				writeLane(writer, lane);
+		}
+	}
+
+	static void readRoad(CacheReader& reader, OpenDrive::Road& road)
+	{
+		road.m_name = reader.readString();
+		road.m_length = reader.read<double>();
+		road.m_id = reader.read<i32>();
+		road.m_junction = reader.read<i32>();
+		road.m_predecessor = reader.read<OpenDrive::RoadLink>();
+		road.m_successor = reader.read<OpenDrive::RoadLink>();
+
+		ui32 geometryCount = reader.readCount(sizeof(double) * 5);
+		road.m_geometries.reserve(geometryCount);
+		for (ui32 i = 0; i < geometryCount && reader.isValid(); i++)
+		{
+			OpenDrive::Geometry* geometry = readGeometry(reader);
+			if (geometry)
+				road.m_geometries.push_back(geometry);
+		}
+
+		readElevations(reader, road.m_elevationProfile);
+		readElevations(reader, road.m_superElevationProfile);
+
+		ui32 laneSectionCount = reader.readCount(sizeof(double) * 2);
+		road.m_laneSections.resize(laneSectionCount);
+		for (OpenDrive::LaneSection& laneSection : road.m_laneSections)
+		{
+			laneSection.m_s = reader.read<double>();
+			laneSection.m_singleSide = reader.read<bool>();
+			laneSection.m_length = reader.read<double>();
+
+			ui32 laneCount = reader.readCount(sizeof(i32) * 6);
+			laneSection.m_lanes.resize(laneCount);
+			for (OpenDrive::Lane& lane : laneSection.m_lanes)
+				readLane(reader, lane);
+		}
+	}
+
+	ui64 OpenDriveCache::hash(const char* data, size_t size)
+	{
+		ui64 result = 14695981039346656037ull;
+		for (size_t i = 0; i < size; i++)
+		{
+			result ^= ui8(data[i]);
+			result *= 1099511628211ull;
+		}
+
+		return result;
+	}
+
+	String OpenDriveCache::getCachePath(const String& xodrPath)
+	{
+		return PathUtil::GetRenameExtFile(xodrPath, ".xodrc");
+	}
+
+	String OpenDriveCache::getUserCachePath(const String& xodrPath)
+	{
+		return "User://" + PathUtil::GetPureFilename(getCachePath(xodrPath));
+	}
+
+	bool OpenDriveCache::load(const String& path, ui64 hash, vector<OpenDrive::Road>::type& roads)
+	{
+		if (!IO::instance()->isExist(path))
+			return false;
+
+		MemoryReader memReader(path);
+		CacheReader reader(memReader.getData<const Byte*>(), memReader.getSize());
+
+		CacheFileHeader header = reader.read<CacheFileHeader>();
+		if (!reader.isValid() || header.m_magic != CacheFileMagic || header.m_version != CacheFileVersion || header.m_hash != hash)
+			return false;
+
+		vector<OpenDrive::Road>::type result(reader.readCount(sizeof(double) * 2));
+		for (OpenDrive::Road& road : result)
+		{
+			readRoad(reader, road);
+			if (!reader.isValid())
+				break;
+		}
+
+		if (!reader.isValid())
+		{
+			for (OpenDrive::Road& road : result)
+				EchoSafeDeleteContainer(road.m_geometries, Geometry);
+
+			EchoLogError("OpenDrive : Corrupted road network cache [%s]", path.c_str());
+			return false;
+		}
+
+		roads.swap(result);
+		return true;
+	}
+
+	bool OpenDriveCache::save(const String& path, ui64 hash, const vector<OpenDrive::Road>::type& roads)
+	{
+		CacheFileHeader header;
+		header.m_hash = hash;
+
+		CacheWriter writer;
+		writer.write(header);
+		writer.write<ui32>(ui32(roads.size()));
+		for (const OpenDrive::Road& road : roads)
+			writeRoad(writer, road);
+
+		DataStream* stream = IO::instance()->open(path, DataStream::WRITE);
+		if (stream && stream->isWriteable())
+		{
+			stream->write(writer.getBuffer().data(), writer.getBuffer().size());
+			stream->close();
+			EchoSafeDelete(stream, DataStream);
+			return true;
+		}
+
+		EchoSafeDelete(stream, DataStream);
+		return false;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "opendrive.h"
+
+namespace Echo
+{
+	// Cooked binary form of a parsed road network, stored next to the .xodr and keyed
+	// by a hash of the xodr content. Loading it is one file read and no xml parsing
+	class OpenDriveCache
+	{
+	public:
+		// Content hash (fnv-1a 64)
+		static ui64 hash(const char* data, size_t size);
+
+		// Cache file of a xodr, next to it or in the user directory
+		static String getCachePath(const String& xodrPath);
+		static String getUserCachePath(const String& xodrPath);
+
+		// Load, fails if the file is missing, of an old version or cooked from other content
+		static bool load(const String& path, ui64 hash, vector<OpenDrive::Road>::type& roads);
+
+		// Save
+		static bool save(const String& path, ui64 hash, const vector<OpenDrive::Road>::type& roads);
+	};
+}
@@ -1,9 +1,13 @@
 #include "opendrive_debug_draw.h"
 #include "opendrive_module.h"
 #include "engine/core/main/Engine.h"
+#include "engine/core/thread/job_system.h"
 
 namespace Echo
 {
+	// Max chord error of debug lines
+	static const double DebugSampleTolerance = 0.01;
+
 	OpenDriveDebugDraw::OpenDriveDebugDraw()
 	{
 		m_gizmo = ECHO_DOWN_CAST<Echo::Gizmos*>(Echo::Class::create("Gizmos"));
@@ -57,10 +61,22 @@ namespace Echo
 					}
 				}
 
-				for (OpenDrive::LaneSection& laneSection : road.m_laneSections)
-				{
-					drawLaneOuterBorder(road, laneSection);
-				}
+			}
+
+			// Lane borders are sampled per road on worker threads, gizmo is fed on this thread
+			vector<OpenDrive::Road>::type& roads = drive->getRoads();
+			vector<vector<BorderLine>::type>::type roadLines(roads.size());
+			JobSystem::instance()->parallelFor(i32(roads.size()), [&](i32 i)
+			{
+				for (OpenDrive::LaneSection& laneSection : roads[i].m_laneSections)
+					sampleLaneOuterBorder(roads[i], laneSection, roadLines[i]);
+			}, 4);
+
+			Color rightColor = m_laneBorderColor * 0.75f;
+			for (vector<BorderLine>::type& lines : roadLines)
+			{
+				for (BorderLine& line : lines)
+					m_gizmo->drawLine(line.m_start, line.m_end, line.m_isLeft ? m_laneBorderColor : rightColor);
 			}
 		}
 	}
@@ -93,20 +109,20 @@ namespace Echo
 			double endH;
 
 			// Draw arc
-			i32    stepCount = std::max<i32>(i32(arc->getLength() / 0.1), 1);
-			double stepLength = arc->getLength() / stepCount;
+			RealVector samples;
+			arc->sample(0.0, arc->getLength(), DebugSampleTolerance, arc->getLength(), samples);
 			Color  color = arc->m_curvature > 0.0 ? m_arcColor : m_arcColor * 0.75f;
-			for (i32 i = 0; i < stepCount; i++)
+			for (size_t i = 1; i < samples.size(); i++)
 			{
-				double ds0 = i * stepLength;
-				double ds1 = ds0 + stepLength;
+				double ds0 = samples[i - 1];
+				double ds1 = samples[i];
 
 				arc->evaluate(ds0, startX, startY, startH);
 				arc->evaluate(ds1, endX, endY, endH);
 
 				m_gizmo->drawLine(OpenDrive::toVec3(startX, startY), OpenDrive::toVec3(endX, endY), color);
 
-				if ((i + 1) == stepCount)
+				if ((i + 1) == samples.size())
 				{
 					drawArrow(endX, endY, endH, color, Math::Min(arc->getLength() * 0.05, 0.1));
 				}
@@ -163,13 +179,13 @@ namespace Echo
 			double endH;
 
 			// Draw arc
-			i32    stepCount = std::max<i32>(i32(spiral->getLength() / 0.1), 1);
-			double stepLength = spiral->getLength() / stepCount;
+			RealVector samples;
+			spiral->sample(0.0, spiral->getLength(), DebugSampleTolerance, spiral->getLength(), samples);
 			Color  color = spiral->m_curvatureStart + spiral->m_curvatureEnd > 0.0 ? m_spiralColor : m_spiralColor * 0.75f;
-			for (i32 i = 0; i < stepCount; i++)
+			for (size_t i = 1; i < samples.size(); i++)
 			{
-				double ds0 = i * stepLength;
-				double ds1 = ds0 + stepLength;
+				double ds0 = samples[i - 1];
+				double ds1 = samples[i];
 
 				spiral->evaluate(ds0, startX, startY, startH);
 				spiral->evaluate(ds1, endX, endY, endH);
@@ -177,7 +193,7 @@ namespace Echo
 				m_gizmo->drawLine(OpenDrive::toVec3(startX, startY), OpenDrive::toVec3(endX, endY), color);
 
 				// Arrow
-				if ((i + 1) == stepCount)
+				if ((i + 1) == samples.size())
 				{
 					drawArrow(endX, endY, endH, color, Math::Min(spiral->getLength()*0.05, 0.1));
 				}
@@ -195,13 +211,13 @@ namespace Echo
 			double endH;
 
 			// Draw arc
-			i32    stepCount = std::max<i32>(i32(poly3->getLength() / 0.1), 1);
-			double stepLength = poly3->getLength() / stepCount;
+			RealVector samples;
+			poly3->sample(0.0, poly3->getLength(), DebugSampleTolerance, poly3->getLength(), samples);
 			Color  color = m_poly3Color;
-			for (i32 i = 0; i < stepCount; i++)
+			for (size_t i = 1; i < samples.size(); i++)
 			{
-				double ds0 = i * stepLength;
-				double ds1 = ds0 + stepLength;
+				double ds0 = samples[i - 1];
+				double ds1 = samples[i];
 
 				poly3->evaluate(ds0, startX, startY, startH);
 				poly3->evaluate(ds1, endX, endY, endH);
@@ -209,7 +225,7 @@ namespace Echo
 				m_gizmo->drawLine(OpenDrive::toVec3(startX, startY), OpenDrive::toVec3(endX, endY), color);
 
 				// Arrow
-				if ((i + 1) == stepCount)
+				if ((i + 1) == samples.size())
 				{
 					drawArrow(endX, endY, endH, color, Math::Min(poly3->getLength() * 0.05, 0.1));
 				}
@@ -227,13 +243,13 @@ namespace Echo
 			double endH;
 
 			// Draw arc
-			i32    stepCount = std::max<i32>(i32(paramPoly3->getLength() / 0.1), 1);
-			double stepLength = paramPoly3->getLength() / stepCount;
+			RealVector samples;
+			paramPoly3->sample(0.0, paramPoly3->getLength(), DebugSampleTolerance, paramPoly3->getLength(), samples);
 			Color  color = m_paramPoly3Color;
-			for (i32 i = 0; i < stepCount; i++)
+			for (size_t i = 1; i < samples.size(); i++)
 			{
-				double ds0 = i * stepLength;
-				double ds1 = ds0 + stepLength;
+				double ds0 = samples[i - 1];
+				double ds1 = samples[i];
 
 				paramPoly3->evaluate(ds0, startX, startY, startH);
 				paramPoly3->evaluate(ds1, endX, endY, endH);
@@ -241,7 +257,7 @@ namespace Echo
 				m_gizmo->drawLine(OpenDrive::toVec3(startX, startY), OpenDrive::toVec3(endX, endY), color);
 
 				// Arrow
-				if ((i + 1) == stepCount)
+				if ((i + 1) == samples.size())
 				{
 					drawArrow(endX, endY, endH, color, Math::Min(paramPoly3->getLength() * 0.05, 0.1));
 				}
@@ -262,18 +278,17 @@ namespace Echo
 		}
 	}
 
-	void OpenDriveDebugDraw::drawLaneOuterBorder(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection)
+	void OpenDriveDebugDraw::sampleLaneOuterBorder(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection, vector<BorderLine>::type& lines)
 	{
+		RealVector samples;
+		OpenDrive::sampleLaneSection(road, laneSection, DebugSampleTolerance, samples);
+
 		double startX, startY, startH;
 		double endX, endY, endH;
-
-		i32    stepCount = std::max<i32>(i32(laneSection.getLength() / 0.1), 1);
-		double stepLength = laneSection.getLength() / stepCount;
-
-		for (i32 i = 0; i < stepCount; i++)
+		for (size_t i = 1; i < samples.size(); i++)
 		{
-			double ds0 = i * stepLength + laneSection.m_s;
-			double ds1 = ds0 + stepLength;
+			double ds0 = samples[i - 1];
+			double ds1 = samples[i];
 
 			road.evaluate(ds0, startX, startY, startH);
 			road.evaluate(ds1, endX, endY, endH);
@@ -293,7 +308,11 @@ namespace Echo
 					Vector3 dir0 = OpenDrive::toDir3(startH + offsetH);
 					Vector3 dir1 = OpenDrive::toDir3(endH + offsetH);
 
-					m_gizmo->drawLine(center0 + dir0 * width0, center1 + dir1 * width1, lane.m_id > 0 ? m_laneBorderColor : m_laneBorderColor * 0.75f);
+					BorderLine line;
+					line.m_start = center0 + dir0 * width0;
+					line.m_end = center1 + dir1 * width1;
+					line.m_isLeft = lane.m_id > 0;
+					lines.emplace_back(line);
 				}
 			}
 		}
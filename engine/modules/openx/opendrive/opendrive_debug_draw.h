@@ -33,8 +33,14 @@ namespace Echo
 		void drawParamPoly3(OpenDrive::ParamPoly3* paramPoly3);
 		void drawArrow(double endX, double endY, double hdg, Color& color, double length);
 		
-		// Draw Lane Outer
-		void drawLaneOuterBorder(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection);
+		// Lane outer border segments, safe to run on worker threads
+		struct BorderLine
+		{
+			Vector3	m_start;
+			Vector3	m_end;
+			bool	m_isLeft = false;
+		};
+		static void sampleLaneOuterBorder(OpenDrive::Road& road, OpenDrive::LaneSection& laneSection, vector<BorderLine>::type& lines);
 
 	private:
 		Gizmos*		m_gizmo = nullptr;
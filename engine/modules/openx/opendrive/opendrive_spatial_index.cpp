@@ -0,0 +1,199 @@
+#include "opendrive_spatial_index.h"
+#include <functional>
+
+namespace Echo
+{
+	// Piece length of curved and straight geometries
+	static const double CurveSegmentLength = 5.0;
+	static const double LineSegmentLength = 20.0;
+
+	// Extra space around the lanes
+	static const double SegmentMargin = 1.0;
+
+	// Upper bound of grid cells, cell size grows for huge networks
+	static const i64 MaxCells = 1 << 22;
+
+	OpenDriveSpatialIndex::OpenDriveSpatialIndex()
+	{
+	}
+
+	OpenDriveSpatialIndex::~OpenDriveSpatialIndex()
+	{
+	}
+
+	void OpenDriveSpatialIndex::clear()
+	{
+		m_columns = 0;
+		m_rows = 0;
+		m_segments.clear();
+		m_cellStarts.clear();
+		m_cellSegments.clear();
+	}
+
+	void OpenDriveSpatialIndex::build(vector<OpenDrive::Road>::type& roads)
+	{
+		clear();
+
+		for (i32 roadIndex = 0; roadIndex < i32(roads.size()); roadIndex++)
+		{
+			OpenDrive::Road& road = roads[roadIndex];
+			for (i32 geometryIndex = 0; geometryIndex < i32(road.m_geometries.size()); geometryIndex++)
+			{
+				OpenDrive::Geometry* geometry = road.m_geometries[geometryIndex];
+				double pieceLength = geometry->isType(OpenDrive::Geometry::Line) ? LineSegmentLength : CurveSegmentLength;
+				i32    pieceCount = std::max<i32>(i32(std::ceil(geometry->getLength() / pieceLength)), 1);
+				for (i32 i = 0; i < pieceCount; i++)
+				{
+					Segment segment;
+					segment.m_roadIndex = roadIndex;
+					segment.m_geometryIndex = geometryIndex;
+					segment.m_ds0 = geometry->getLength() * i / pieceCount;
+					segment.m_ds1 = geometry->getLength() * (i + 1) / pieceCount;
+					segment.m_minX = segment.m_minY = std::numeric_limits<double>::max();
+					segment.m_maxX = segment.m_maxY = -std::numeric_limits<double>::max();
+
+					// start, middle and end cover the bulge of short curved pieces
+					double width = 0.0;
+					for (double ds : { segment.m_ds0, (segment.m_ds0 + segment.m_ds1) * 0.5, segment.m_ds1 })
+					{
+						double x, y, h, left, right;
+						geometry->evaluate(ds, x, y, h);
+						road.getWidth(geometry->m_s + ds, left, right);
+
+						width = std::max<double>(width, std::max<double>(left, right));
+						segment.m_minX = std::min<double>(segment.m_minX, x);
+						segment.m_minY = std::min<double>(segment.m_minY, y);
+						segment.m_maxX = std::max<double>(segment.m_maxX, x);
+						segment.m_maxY = std::max<double>(segment.m_maxY, y);
+					}
+
+					width += SegmentMargin;
+					segment.m_minX -= width;
+					segment.m_minY -= width;
+					segment.m_maxX += width;
+					segment.m_maxY += width;
+
+					m_segments.emplace_back(segment);
+				}
+			}
+		}
+
+		if (m_segments.empty())
+			return;
+
+		double minX = std::numeric_limits<double>::max();
+		double minY = std::numeric_limits<double>::max();
+		double maxX = -std::numeric_limits<double>::max();
+		double maxY = -std::numeric_limits<double>::max();
+		for (const Segment& segment : m_segments)
+		{
+			minX = std::min<double>(minX, segment.m_minX);
+			minY = std::min<double>(minY, segment.m_minY);
+			maxX = std::max<double>(maxX, segment.m_maxX);
+			maxY = std::max<double>(maxY, segment.m_maxY);
+		}
+
+		m_cellSize = 20.0;
+		while (i64(std::ceil((maxX - minX) / m_cellSize)) * i64(std::ceil((maxY - minY) / m_cellSize)) > MaxCells)
+			m_cellSize *= 2.0;
+
+		m_originX = minX;
+		m_originY = minY;
+		m_columns = std::max<i32>(i32(std::ceil((maxX - minX) / m_cellSize)), 1);
+		m_rows = std::max<i32>(i32(std::ceil((maxY - minY) / m_cellSize)), 1);
+
+		// count, prefix sum, then fill
+		auto forEachCell = [&](const Segment& segment, const std::function<void(i32)>& func)
+		{
+			i32 x0 = std::clamp<i32>(i32((segment.m_minX - m_originX) / m_cellSize), 0, m_columns - 1);
+			i32 x1 = std::clamp<i32>(i32((segment.m_maxX - m_originX) / m_cellSize), 0, m_columns - 1);
+			i32 y0 = std::clamp<i32>(i32((segment.m_minY - m_originY) / m_cellSize), 0, m_rows - 1);
+			i32 y1 = std::clamp<i32>(i32((segment.m_maxY - m_originY) / m_cellSize), 0, m_rows - 1);
+			for (i32 y = y0; y <= y1; y++)
+			{
+				for (i32 x = x0; x <= x1; x++)
+					func(y * m_columns + x);
+			}
+		};
+
+		m_cellStarts.assign(size_t(m_columns) * m_rows + 1, 0);
+		for (const Segment& segment : m_segments)
+			forEachCell(segment, [&](i32 cell) { m_cellStarts[cell + 1]++; });
+
+		for (size_t i = 1; i < m_cellStarts.size(); i++)
+			m_cellStarts[i] += m_cellStarts[i - 1];
+
+		vector<ui32>::type cursors(m_cellStarts.begin(), m_cellStarts.end() - 1);
+		m_cellSegments.resize(m_cellStarts.back());
+		for (ui32 i = 0; i < ui32(m_segments.size()); i++)
+			forEachCell(m_segments[i], [&](i32 cell) { m_cellSegments[cursors[cell]++] = i; });
+	}
+
+	i32 OpenDriveSpatialIndex::getCell(double x, double y) const
+	{
+		if (x < m_originX || y < m_originY)
+			return -1;
+
+		i32 column = i32((x - m_originX) / m_cellSize);
+		i32 row = i32((y - m_originY) / m_cellSize);
+		return (column < m_columns && row < m_rows) ? row * m_columns + column : -1;
+	}
+
+	bool OpenDriveSpatialIndex::localize(vector<OpenDrive::Road>::type& roads, double x, double y, OpenDrive::Location& location) const
+	{
+		location = OpenDrive::Location();
+
+		i32 cell = getCell(x, y);
+		if (cell < 0)
+			return false;
+
+		// distance outside of the lanes first, then distance to the reference line
+		double bestOutside = std::numeric_limits<double>::max();
+		double bestLateral = std::numeric_limits<double>::max();
+		for (ui32 i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; i++)
+		{
+			const Segment& segment = m_segments[m_cellSegments[i]];
+			if (x < segment.m_minX || x > segment.m_maxX || y < segment.m_minY || y > segment.m_maxY)
+				continue;
+
+			OpenDrive::Road& road = roads[segment.m_roadIndex];
+			OpenDrive::Geometry* geometry = road.m_geometries[segment.m_geometryIndex];
+			double ds = geometry->project(x, y, segment.m_ds0, segment.m_ds1);
+
+			double cx, cy, h;
+			geometry->evaluate(ds, cx, cy, h);
+
+			double dx = x - cx;
+			double dy = y - cy;
+			double along = dx * cos(h) + dy * sin(h);
+			double lateral = dy * cos(h) - dx * sin(h);
+
+			double s = geometry->m_s + ds;
+			double left, right;
+			road.getWidth(s, left, right);
+
+			// along is only left when the projection was clamped to the piece ends
+			double beyond = std::max<double>(std::fabs(lateral) - (lateral >= 0.0 ? left : right), 0.0);
+			double outside = sqrt(along * along + beyond * beyond);
+			if (outside < bestOutside - 1e-6 || (outside < bestOutside + 1e-6 && std::fabs(lateral) < bestLateral))
+			{
+				bestOutside = outside;
+				bestLateral = std::fabs(lateral);
+
+				location.m_roadIndex = segment.m_roadIndex;
+				location.m_roadId = road.m_id;
+				location.m_s = s;
+				location.m_t = lateral;
+				location.m_heading = h;
+			}
+		}
+
+		if (location.isValid())
+		{
+			location.m_laneId = roads[location.m_roadIndex].getLaneIdByT(location.m_s, location.m_t);
+			return true;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "opendrive.h"
+
+namespace Echo
+{
+	// Uniform grid over short pieces of road reference lines, widened by their lanes.
+	// A piece is stored in every cell its box touches, so a point query reads one cell only
+	class OpenDriveSpatialIndex
+	{
+	public:
+		OpenDriveSpatialIndex();
+		~OpenDriveSpatialIndex();
+
+		// Build
+		void build(vector<OpenDrive::Road>::type& roads);
+
+		// Clear
+		void clear();
+
+		// Localize inertial point, read only so it can run on many threads at once
+		bool localize(vector<OpenDrive::Road>::type& roads, double x, double y, OpenDrive::Location& location) const;
+
+	private:
+		// Piece of one geometry
+		struct Segment
+		{
+			i32		m_roadIndex = -1;
+			i32		m_geometryIndex = -1;
+			double	m_ds0 = 0.0;			// range inside geometry
+			double	m_ds1 = 0.0;
+			double	m_minX = 0.0;
+			double	m_minY = 0.0;
+			double	m_maxX = 0.0;
+			double	m_maxY = 0.0;
+		};
+
+		// Cell of point
+		i32 getCell(double x, double y) const;
+
+	private:
+		double					m_cellSize = 20.0;
+		double					m_originX = 0.0;
+		double					m_originY = 0.0;
+		i32						m_columns = 0;
+		i32						m_rows = 0;
+		vector<Segment>::type	m_segments;
+		vector<ui32>::type		m_cellStarts;		// columns * rows + 1 offsets into m_cellSegments
+		vector<ui32>::type		m_cellSegments;
+	};
+}
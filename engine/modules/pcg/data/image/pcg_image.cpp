@@ -12,25 +12,45 @@ namespace Echo
 
 	}
 
-	void PCGImage::set(i32 width, i32 height)
+	void PCGImage::set(i32 width, i32 height, i32 channels)
 	{
 		m_width = width;
 		m_height = height;
-		m_colors.resize(m_width * m_height, Color::BLACK);
+		m_channels = Math::Clamp(channels, 1, MaxChannels);
+
+		for (i32 i = 0; i < MaxChannels; i++)
+		{
+			if (i < m_channels)
+			{
+				m_planes[i].assign(size_t(m_width) * m_height, 0.f);
+			}
+			else
+			{
+				m_planes[i].clear();
+				m_planes[i].shrink_to_fit();
+			}
+		}
 	}
 
-	void PCGImage::setValue(i32 x, i32 y, const Color& color)
+	void PCGImage::setValue(i32 x, i32 y, float value, i32 channel)
 	{
-		if (x >= 0 && x < m_width && y >= 0 && y < m_height)
+		if (x >= 0 && x < m_width && y >= 0 && y < m_height && channel >= 0 && channel < m_channels)
 		{
-			i32 index = y * m_width + x;
-			m_colors[index] = color;
+			m_planes[channel][y * m_width + x] = value;
 		}
 	}
 
-	const Color& PCGImage::getValue(i32 x, i32 y) const
-	{ 
-		i32 index = y * m_width + x;
-		return m_colors[index];
+	Color PCGImage::getColor(i32 x, i32 y) const
+	{
+		return Color(getValue(x, y, 0), getValue(x, y, 1), getValue(x, y, 2), getValue(x, y, 3));
+	}
+
+	void PCGImage::setColor(i32 x, i32 y, const Color& color)
+	{
+		const float values[MaxChannels] = { color.r, color.g, color.b, color.a };
+		for (i32 i = 0; i < m_channels; i++)
+		{
+			setValue(x, y, values[i], i);
+		}
 	}
 }
@@ -7,6 +7,10 @@ namespace Echo
 {
 	class PCGImage : public PCGData
 	{
+	public:
+		// max channels
+		static const i32 MaxChannels = 4;
+
 	public:
 		PCGImage();
 		~PCGImage();
@@ -14,12 +18,16 @@ namespace Echo
 		// Type
 		virtual String getType() { return "Image"; }
 
-		// Set
-		void set(i32 width, i32 height);
+		// Set, every channel is a separate row major float plane, height data only needs one
+		void set(i32 width, i32 height, i32 channels = 1);
 
-		// Value
-		const Color& getValue(i32 x, i32 y) const;
-		void setValue(i32 x, i32 y, const Color& color);
+		// Value of one channel
+		float getValue(i32 x, i32 y, i32 channel = 0) const { return m_planes[std::min<i32>(channel, m_channels - 1)][y * m_width + x]; }
+		void setValue(i32 x, i32 y, float value, i32 channel = 0);
+
+		// Color, missing channels repeat the last plane (gray)
+		Color getColor(i32 x, i32 y) const;
+		void setColor(i32 x, i32 y, const Color& color);
 
 		// Width
 		i32 getWidth() const { return m_width; }
@@ -30,14 +38,19 @@ namespace Echo
 		// Depth
 		i32 getDepth() const { return m_depth; }
 
-		// Data
-		const vector<Color>::type& getColors() const { return m_colors; }
+		// Channels
+		i32 getChannels() const { return m_channels; }
+
+		// Plane of channel, channels out of range share the last plane
+		float* getPlane(i32 channel) { return m_planes[std::min<i32>(channel, m_channels - 1)].data(); }
+		const float* getPlane(i32 channel) const { return m_planes[std::min<i32>(channel, m_channels - 1)].data(); }
 
 	protected:
 		i32					m_width = 0;
 		i32					m_height = 0;
 		i32					m_depth = 1;
-		vector<Color>::type	m_colors;
+		i32					m_channels = 1;
+		vector<float>::type	m_planes[MaxChannels];
 	};
 	typedef ResRef<PCGImage> PCGImagePtr;
 }
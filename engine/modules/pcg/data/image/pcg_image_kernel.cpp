@@ -0,0 +1,96 @@
+#include "pcg_image_kernel.h"
+#include "engine/core/thread/job_system.h"
+
+namespace Echo
+{
+	void PCGImageKernel::forEachTile(i32 width, i32 height, const TileFunc& func)
+	{
+		const i32 tilesX = (width + TileSize - 1) / TileSize;
+		const i32 tilesY = (height + TileSize - 1) / TileSize;
+
+		JobSystem::instance()->parallelFor(tilesX * tilesY, [&](i32 tile)
+		{
+			i32 x0 = (tile % tilesX) * TileSize;
+			i32 y0 = (tile / tilesX) * TileSize;
+			func(x0, y0, std::min<i32>(x0 + TileSize, width), std::min<i32>(y0 + TileSize, height));
+		});
+	}
+
+	template<typename Op>
+	void PCGImageKernel::binary(const PCGImage& a, const PCGImage& b, PCGImage& out, Op op)
+	{
+		const i32 width = a.getWidth();
+		const i32 height = a.getHeight();
+		const i32 channels = std::max<i32>(a.getChannels(), b.getChannels());
+		const bool isSameSize = b.getWidth() == width && b.getHeight() == height;
+		if (b.getWidth() <= 0 || b.getHeight() <= 0)
+			return;
+
+		out.set(width, height, channels);
+		forEachTile(width, height, [&](i32 x0, i32 y0, i32 x1, i32 y1)
+		{
+			vector<float>::type row;
+			for (i32 c = 0; c < channels; c++)
+			{
+				const float* planeA = a.getPlane(c);
+				const float* planeB = b.getPlane(c);
+				float* planeOut = out.getPlane(c);
+				for (i32 y = y0; y < y1; y++)
+				{
+					const float* rowA = planeA + size_t(y) * width;
+					const float* rowB = nullptr;
+					if (isSameSize)
+					{
+						rowB = planeB + size_t(y) * width;
+					}
+					else
+					{
+						// gather the clamped row of b once, so the loop below stays contiguous
+						row.resize(x1);
+						const float* sourceB = planeB + size_t(std::min<i32>(y, b.getHeight() - 1)) * b.getWidth();
+						for (i32 x = x0; x < x1; x++)
+							row[x] = sourceB[std::min<i32>(x, b.getWidth() - 1)];
+
+						rowB = row.data();
+					}
+
+					float* rowOut = planeOut + size_t(y) * width;
+					for (i32 x = x0; x < x1; x++)
+						rowOut[x] = op(rowA[x], rowB[x]);
+				}
+			}
+		});
+	}
+
+	void PCGImageKernel::multiply(const PCGImage& a, const PCGImage& b, PCGImage& out)
+	{
+		binary(a, b, out, [](float va, float vb) { return va * vb; });
+	}
+
+	void PCGImageKernel::subtract(const PCGImage& a, const PCGImage& b, PCGImage& out)
+	{
+		binary(a, b, out, [](float va, float vb) { return va - vb; });
+	}
+
+	void PCGImageKernel::scale(const PCGImage& a, float scale, float offset, PCGImage& out)
+	{
+		const i32 width = a.getWidth();
+		const i32 height = a.getHeight();
+		const i32 channels = a.getChannels();
+
+		out.set(width, height, channels);
+		forEachTile(width, height, [&](i32 x0, i32 y0, i32 x1, i32 y1)
+		{
+			for (i32 c = 0; c < channels; c++)
+			{
+				for (i32 y = y0; y < y1; y++)
+				{
+					const float* rowA = a.getPlane(c) + size_t(y) * width;
+					float* rowOut = out.getPlane(c) + size_t(y) * width;
+					for (i32 x = x0; x < x1; x++)
+						rowOut[x] = rowA[x] * scale + offset;
+				}
+			}
+		});
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "pcg_image.h"
+#include <functional>
+
+namespace Echo
+{
+	// Image kernels run on square tiles spread over worker threads, inner loops walk contiguous
+	// float rows so the compiler can vectorize them
+	class PCGImageKernel
+	{
+	public:
+		// tile edge in pixels
+		static const i32 TileSize = 64;
+
+		// func(x0, y0, x1, y1) on every tile of [0, width) x [0, height)
+		typedef std::function<void(i32, i32, i32, i32)> TileFunc;
+
+	public:
+		// Run func on tiles in parallel
+		static void forEachTile(i32 width, i32 height, const TileFunc& func);
+
+		// out = a * b, out takes the size of a, b is sampled clamped if sizes differ
+		static void multiply(const PCGImage& a, const PCGImage& b, PCGImage& out);
+
+		// out = a - b
+		static void subtract(const PCGImage& a, const PCGImage& b, PCGImage& out);
+
+		// out = a * scale + offset
+		static void scale(const PCGImage& a, float scale, float offset, PCGImage& out);
+
+	private:
+		// out = op(a, b) by rows
+		template<typename Op> static void binary(const PCGImage& a, const PCGImage& b, PCGImage& out, Op op);
+	};
+}
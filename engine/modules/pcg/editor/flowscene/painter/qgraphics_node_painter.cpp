@@ -49,6 +49,12 @@ namespace Procedural
 			QRectF textRect = m_text->sceneBoundingRect();
 			m_text->setPos((m_width - textRect.width()) * 0.5f - halfWidth, (m_height - textRect.height()) * 0.5f - halfHeight);
 
+			// evaluation time and cache state of last run
+			m_statisticsText = m_graphicsScene->addSimpleText("");
+			m_statisticsText->setBrush(QBrush(m_style.m_fontColorFaded));
+			m_statisticsText->setParentItem(m_rect);
+			m_statisticsText->setPos(halfWidth + 4.f, -halfHeight);
+
 			buildInputConnectPoints();
 			buildOutputConnectPoints();
 		}
@@ -76,6 +82,7 @@ namespace Procedural
 		m_rect = nullptr;
 		m_rectFinal = nullptr;
 		m_text = nullptr;
+		m_statisticsText = nullptr;
 	}
 
 	void PCGNodePainter::buildInputConnectPoints()
@@ -156,6 +163,17 @@ namespace Procedural
 
 			if (m_text)
 				m_text->setText(m_pcgNode->getName().c_str());
+
+			if (m_statisticsText)
+			{
+				const Echo::PCGNode::Statistics& statistics = m_pcgNode->getStatistics();
+				if (statistics.m_hitCount + statistics.m_missCount > 0)
+				{
+					Echo::String text = statistics.m_isLastCached ? "cached" : Echo::StringUtil::Format("%.2f ms", statistics.m_lastTime);
+					text += Echo::StringUtil::Format("\nhit %u miss %u", statistics.m_hitCount, statistics.m_missCount);
+					m_statisticsText->setText(text.c_str());
+				}
+			}
 		}
 
 		updateInputConnectPoints();
@@ -77,6 +77,7 @@ namespace Procedural
 		float									m_height = 40;
 		float									m_connectPointRadius = 6.f;
 		QGraphicsSimpleTextItem*				m_text = nullptr;
+		QGraphicsSimpleTextItem*				m_statisticsText = nullptr;
 	};
 	typedef Echo::vector<PCGNodePainter*>::type PCGNodePainters;
 }
@@ -126,6 +126,8 @@ namespace Echo
 		if (m_flowGraph)
 		{
 			m_flowGraph->run();
+
+			EchoLogInfo("PCGFlowGraph [%s] run %.2f ms", m_flowGraph->getName().c_str(), m_flowGraph->getLastRunTime());
 		}
 	}
 }
@@ -0,0 +1,33 @@
+#include "pcg_image_multiply.h"
+#include "engine/modules/pcg/data/image/pcg_image_kernel.h"
+
+namespace Echo
+{
+	PCGImageMultiply::PCGImageMultiply()
+	{
+		m_inputs.push_back(EchoNew(PCGConnectPoint(this, "Image")));
+		m_inputs.push_back(EchoNew(PCGConnectPoint(this, "Image")));
+
+		m_resultImage = new PCGImage;
+		m_outputs.push_back(new PCGConnectPoint(this, m_resultImage.ptr()));
+	}
+
+	PCGImageMultiply::~PCGImageMultiply()
+	{
+
+	}
+
+	void PCGImageMultiply::bindMethods()
+	{
+	}
+
+	void PCGImageMultiply::run()
+	{
+		PCGImage* a = dynamic_cast<PCGImage*>(m_inputs[0]->getData().ptr());
+		PCGImage* b = dynamic_cast<PCGImage*>(m_inputs[1]->getData().ptr());
+		if (a && b)
+		{
+			PCGImageKernel::multiply(*a, *b, *m_resultImage);
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include "pcg_image_perlin_noise.h"
 #include "engine/modules/pcg/data/image/pcg_image.h"
+#include "engine/modules/pcg/data/image/pcg_image_kernel.h"
 
 namespace Echo
 {
@@ -74,36 +75,76 @@ namespace Echo
 	{
 		if (m_dirtyFlag)
 		{
-			m_resultImage->set(m_width, m_height);
+			m_resultImage->set(m_width, m_height, 1);
 
-			for (i32 x = 0; x < m_width; x++)
+			float* plane = m_resultImage->getPlane(0);
+			PCGImageKernel::forEachTile(m_width, m_height, [this, plane](i32 x0, i32 y0, i32 x1, i32 y1)
 			{
-				for (i32 y = 0; y < m_height; y++)
-				{
-					float grayScale = perlin((x + m_offset.x) / m_gridSize, (y + m_offset.y) / m_gridSize);
+				runTile(plane, x0, y0, x1, y1);
+			});
 
-					// Apply amplitude
-					grayScale = Math::Clamp(grayScale * m_amplitude, -1.f, 1.f);
+			m_dirtyFlag = false;
+		}
+	}
 
-					// Mapping from (-1, 1) to (0, 1)
-					grayScale = (grayScale + 1.f) * 0.5f;
+	void PCGImagePerlinNoise::runTile(float* plane, i32 x0, i32 y0, i32 x1, i32 y1)
+	{
+		const float invGridSize = 1.f / m_gridSize;
 
-					// Change image's value
-					assert(grayScale >= 0.f && grayScale <= 1.f);
-					m_resultImage->setValue(x, y, Color(grayScale, grayScale, grayScale, grayScale));
-				}
-			}
+		// gradients of the lattice points covering this tile, evaluated once instead of four times per pixel
+		const i32 gx0 = i32(std::floor((x0 + m_offset.x) * invGridSize));
+		const i32 gy0 = i32(std::floor((y0 + m_offset.y) * invGridSize));
+		const i32 gx1 = i32(std::floor((x1 - 1 + m_offset.x) * invGridSize)) + 1;
+		const i32 gy1 = i32(std::floor((y1 - 1 + m_offset.y) * invGridSize)) + 1;
+		const i32 stride = gx1 - gx0 + 1;
 
-			m_dirtyFlag = false;
+		vector<Vector2>::type gradients(size_t(stride) * (gy1 - gy0 + 1));
+		for (i32 gy = gy0; gy <= gy1; gy++)
+		{
+			for (i32 gx = gx0; gx <= gx1; gx++)
+				gradients[(gy - gy0) * stride + (gx - gx0)] = randomGradient(gx, gy);
+		}
+
+		for (i32 y = y0; y < y1; y++)
+		{
+			const float fy = (y + m_offset.y) * invGridSize;
+			const i32 iy = i32(std::floor(fy));
+			const float dy = fy - iy;
+			const float sy = sCurveInterpolate(dy);
+			const Vector2* row0 = &gradients[(iy - gy0) * stride];
+			const Vector2* row1 = row0 + stride;
+
+			float* dest = plane + size_t(y) * m_width;
+			for (i32 x = x0; x < x1; x++)
+			{
+				const float fx = (x + m_offset.x) * invGridSize;
+				const i32 ix = i32(std::floor(fx));
+				const float dx = fx - ix;
+				const float sx = sCurveInterpolate(dx);
+				const i32 cx = ix - gx0;
+
+				float n00 = dx * row0[cx].x + dy * row0[cx].y;
+				float n10 = (dx - 1.f) * row0[cx + 1].x + dy * row0[cx + 1].y;
+				float n01 = dx * row1[cx].x + (dy - 1.f) * row1[cx].y;
+				float n11 = (dx - 1.f) * row1[cx + 1].x + (dy - 1.f) * row1[cx + 1].y;
+
+				float ix0 = n00 + sx * (n10 - n00);
+				float ix1 = n01 + sx * (n11 - n01);
+				float grayScale = ix0 + sy * (ix1 - ix0);
+
+				// Apply amplitude, then map from (-1, 1) to (0, 1)
+				grayScale = Math::Clamp(grayScale * m_amplitude, -1.f, 1.f);
+				dest[x] = (grayScale + 1.f) * 0.5f;
+			}
 		}
 	}
 
 	float PCGImagePerlinNoise::perlin(float x, float y)
 	{
 		// Determin grid cell coordinates
-		i32 x0 = (i32)x;
+		i32 x0 = (i32)std::floor(x);
 		i32 x1 = x0 + 1;
-		i32 y0 = (i32)y;
+		i32 y0 = (i32)std::floor(y);
 		i32 y1 = y0 + 1;
 
 		// Determine interpolation weights
@@ -152,6 +193,6 @@ namespace Echo
 	// https://adrianb.io/2014/08/09/perlinnoise.html
 	float PCGImagePerlinNoise::sCurveInterpolate(float t)
 	{
-		return 6 * Math::Pow(t, 5.f) - 15 * Math::Pow(t, 4.f) + 10 * Math::Pow(t, 3.f);
+		return t * t * t * (t * (t * 6.f - 15.f) + 10.f);
 	}
 }
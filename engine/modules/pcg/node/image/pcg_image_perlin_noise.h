@@ -34,7 +34,7 @@ namespace Echo
 
 		// offset
 		const Vector2& getOffset() const { return m_offset; }
-		void setOffset(const Vector2& offset) { m_offset = offset; }
+		void setOffset(const Vector2& offset) { m_offset = offset; m_dirtyFlag = true; }
 
 		// get result
 		PCGImagePtr getResultImage() { return m_resultImage; }
@@ -58,6 +58,10 @@ namespace Echo
 		// Interpolate between a0 and a1
 		float sCurveInterpolate(float t);
 
+	protected:
+		// Evaluate one tile of the result plane
+		void runTile(float* plane, i32 x0, i32 y0, i32 x1, i32 y1);
+
 	protected:
 		i32				m_width = 128;
 		i32				m_height = 128;
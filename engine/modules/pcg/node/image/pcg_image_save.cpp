@@ -53,7 +53,10 @@ namespace Echo
 
 	void PCGImageSave::setFormat(const StringOption& format)
 	{
-		m_format.setValue(format);
+		if (m_format.setValue(format.getValue()))
+		{
+			m_dirtyFlag = true;
+		}
 	}
 
 	void PCGImageSave::run()
@@ -82,10 +85,10 @@ namespace Echo
 				{
 					vector<ui8>::type pixels(image->getWidth() * image->getHeight());
 
-					i32 idx = 0;
-					for (const Color& color : image->getColors())
+					const float* plane = image->getPlane(0);
+					for (size_t i = 0; i < pixels.size(); i++)
 					{
-						pixels[idx++] = color.r * 255.99f;
+						pixels[i] = ui8(Math::Clamp(plane[i], 0.f, 1.f) * 255.99f);
 					}
 
 					i32 pixelBytes = PixelUtil::GetPixelBytes(PixelFormat::PF_R8_UINT);
@@ -133,8 +136,7 @@ namespace Echo
 
 							for (i32 x = 0; x < image->getWidth(); x++)
 							{
-								const Color& color = image->getValue(x, y);
-								ui16 finalValue = ui16(Math::Clamp(color.r * 65535.f, 0.f, 65535.f));
+								ui16 finalValue = ui16(Math::Clamp(image->getValue(x, y) * 65535.f, 0.f, 65535.f));
 								row[x] = finalValue;
 							}
 						}
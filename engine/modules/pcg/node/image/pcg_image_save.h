@@ -27,6 +27,9 @@ namespace Echo
 		const StringOption& getFormat() const { return m_format; }
 		void setFormat(const StringOption& format);
 
+		// Writes files
+		virtual bool isThreadSafe() override { return false; }
+
 		// Run
 		virtual void run() override;
 
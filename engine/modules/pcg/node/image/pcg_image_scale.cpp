@@ -0,0 +1,56 @@
+#include "pcg_image_scale.h"
+#include "engine/modules/pcg/data/image/pcg_image_kernel.h"
+
+namespace Echo
+{
+	PCGImageScale::PCGImageScale()
+	{
+		m_inputs.push_back(EchoNew(PCGConnectPoint(this, "Image")));
+
+		m_resultImage = new PCGImage;
+		m_outputs.push_back(new PCGConnectPoint(this, m_resultImage.ptr()));
+	}
+
+	PCGImageScale::~PCGImageScale()
+	{
+
+	}
+
+	void PCGImageScale::bindMethods()
+	{
+		CLASS_BIND_METHOD(PCGImageScale, getScale);
+		CLASS_BIND_METHOD(PCGImageScale, setScale);
+		CLASS_BIND_METHOD(PCGImageScale, getOffset);
+		CLASS_BIND_METHOD(PCGImageScale, setOffset);
+
+		CLASS_REGISTER_PROPERTY(PCGImageScale, "Scale", Variant::Type::Real, getScale, setScale);
+		CLASS_REGISTER_PROPERTY(PCGImageScale, "Offset", Variant::Type::Real, getOffset, setOffset);
+	}
+
+	void PCGImageScale::setScale(float scale)
+	{
+		if (m_scale != scale)
+		{
+			m_scale = scale;
+			m_dirtyFlag = true;
+		}
+	}
+
+	void PCGImageScale::setOffset(float offset)
+	{
+		if (m_offset != offset)
+		{
+			m_offset = offset;
+			m_dirtyFlag = true;
+		}
+	}
+
+	void PCGImageScale::run()
+	{
+		PCGImage* image = dynamic_cast<PCGImage*>(m_inputs[0]->getData().ptr());
+		if (image)
+		{
+			PCGImageKernel::scale(*image, m_scale, m_offset, *m_resultImage);
+		}
+	}
+}
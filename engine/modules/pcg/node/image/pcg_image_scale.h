@@ -0,0 +1,38 @@
+#pragma once
+
+#include "engine/modules/pcg/node/pcg_node.h"
+#include "engine/modules/pcg/data/image/pcg_image.h"
+
+namespace Echo
+{
+	class PCGImageScale : public PCGNode
+	{
+		ECHO_CLASS(PCGImageScale, PCGNode);
+
+	public:
+		PCGImageScale();
+		virtual ~PCGImageScale();
+
+		// catergory
+		virtual String getCategory() const override { return "Image"; }
+
+		// scale
+		float getScale() const { return m_scale; }
+		void setScale(float scale);
+
+		// offset
+		float getOffset() const { return m_offset; }
+		void setOffset(float offset);
+
+		// get result
+		PCGImagePtr getResultImage() { return m_resultImage; }
+
+		// Run, result = image * scale + offset
+		virtual void run() override;
+
+	protected:
+		float			m_scale = 1.f;
+		float			m_offset = 0.f;
+		PCGImagePtr		m_resultImage;
+	};
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "engine/modules/pcg/node/pcg_node.h"
+#include "engine/modules/pcg/data/image/pcg_image.h"
+
+namespace Echo
+{
+	class PCGImageSubstract : public PCGNode
+	{
+		ECHO_CLASS(PCGImageSubstract, PCGNode);
+
+	public:
+		PCGImageSubstract();
+		virtual ~PCGImageSubstract();
+
+		// catergory
+		virtual String getCategory() const override { return "Image"; }
+
+		// get result
+		PCGImagePtr getResultImage() { return m_resultImage; }
+
+		// Run, result = a - b
+		virtual void run() override;
+
+	protected:
+		PCGImagePtr		m_resultImage;
+	};
+}
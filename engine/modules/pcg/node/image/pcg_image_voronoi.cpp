@@ -1,5 +1,7 @@
 #include "pcg_image_voronoi.h"
 #include "engine/modules/pcg/data/image/pcg_image.h"
+#include "engine/modules/pcg/data/image/pcg_image_kernel.h"
+#include <random>
 
 namespace Echo
 {
@@ -20,9 +22,18 @@ namespace Echo
 		CLASS_BIND_METHOD(PCGImageVoronoi, setWidth);
 		CLASS_BIND_METHOD(PCGImageVoronoi, getHeight);
 		CLASS_BIND_METHOD(PCGImageVoronoi, setHeight);
+		CLASS_BIND_METHOD(PCGImageVoronoi, getDistribution);
+		CLASS_BIND_METHOD(PCGImageVoronoi, setDistribution);
+		CLASS_BIND_METHOD(PCGImageVoronoi, getSeed);
+		CLASS_BIND_METHOD(PCGImageVoronoi, setSeed);
+		CLASS_BIND_METHOD(PCGImageVoronoi, getSampleCount);
+		CLASS_BIND_METHOD(PCGImageVoronoi, setSampleCount);
 
 		CLASS_REGISTER_PROPERTY(PCGImageVoronoi, "Width", Variant::Type::Int, getWidth, setWidth);
 		CLASS_REGISTER_PROPERTY(PCGImageVoronoi, "Height", Variant::Type::Int, getHeight, setHeight);
+		CLASS_REGISTER_PROPERTY(PCGImageVoronoi, "Distribution", Variant::Type::StringOption, getDistribution, setDistribution);
+		CLASS_REGISTER_PROPERTY(PCGImageVoronoi, "Seed", Variant::Type::Int, getSeed, setSeed);
+		CLASS_REGISTER_PROPERTY(PCGImageVoronoi, "SampleCount", Variant::Type::Int, getSampleCount, setSampleCount);
 	}
 
 	void PCGImageVoronoi::setWidth(i32 width)
@@ -43,32 +54,61 @@ namespace Echo
 		}
 	}
 
+	StringOption PCGImageVoronoi::getDistribution() const
+	{
+		return StringOption::fromEnum(m_distributionType);
+	}
+
+	void PCGImageVoronoi::setDistribution(const StringOption& option)
+	{
+		DistributionType distributionType = option.toEnum(DistributionType::Random);
+		if (m_distributionType != distributionType)
+		{
+			m_distributionType = distributionType;
+			m_dirtyFlag = true;
+		}
+	}
+
+	void PCGImageVoronoi::setSeed(i32 seed)
+	{
+		if (m_randomSeed != seed)
+		{
+			m_randomSeed = seed;
+			m_dirtyFlag = true;
+		}
+	}
+
+	void PCGImageVoronoi::setSampleCount(i32 count)
+	{
+		count = std::max<i32>(count, 1);
+		if (m_randomSamplingCount != count)
+		{
+			m_randomSamplingCount = count;
+			m_dirtyFlag = true;
+		}
+	}
+
 	void PCGImageVoronoi::run()
 	{
 		if (m_dirtyFlag)
 		{
-			m_resultImage->set(m_width, m_height);
+			m_resultImage->set(m_width, m_height, 1);
 
 			// step 1
 			generateSites();
+			buildSiteGrid();
 
-			for (i32 x = 0; x < m_width; x++)
+			// step 2, every pixel only visits the cells around it
+			float* plane = m_resultImage->getPlane(0);
+			PCGImageKernel::forEachTile(m_width, m_height, [this, plane](i32 x0, i32 y0, i32 x1, i32 y1)
 			{
-				for (i32 y = 0; y < m_height; y++)
+				for (i32 y = y0; y < y1; y++)
 				{
-					float grayScale = voronoi(x, y);
-
-					// Apply amplitude
-					grayScale = Math::Clamp(grayScale, -1.f, 1.f);
-
-					// Mapping from (-1, 1) to (0, 1)
-					grayScale = (grayScale + 1.f) * 0.5f;
-
-					// Change image's value
-					assert(grayScale >= 0.f && grayScale <= 1.f);
-					m_resultImage->setValue(x, y, Color(grayScale, grayScale, grayScale, grayScale));
+					float* dest = plane + size_t(y) * m_width;
+					for (i32 x = x0; x < x1; x++)
+						dest[x] = Math::Clamp(voronoi(float(x), float(y)), 0.f, 1.f);
 				}
-			}
+			});
 
 			m_dirtyFlag = false;
 		}
@@ -78,7 +118,45 @@ namespace Echo
 	// https://www.khanacademy.org/computing/pixar/pattern/dino/e/constructing-a-voronoi-partition
 	float PCGImageVoronoi::voronoi(float x, float y)
 	{
-		return 1.f;
+		if (m_sites.empty())
+			return 1.f;
+
+		const i32 cx = Math::Clamp(i32(x / m_cellSize), 0, m_cellColumns - 1);
+		const i32 cy = Math::Clamp(i32(y / m_cellSize), 0, m_cellRows - 1);
+		const i32 maxRing = std::max<i32>(m_cellColumns, m_cellRows);
+
+		float bestSquared = Math::MAX_REAL;
+		for (i32 ring = 0; ring <= maxRing; ring++)
+		{
+			for (i32 j = cy - ring; j <= cy + ring; j++)
+			{
+				if (j < 0 || j >= m_cellRows)
+					continue;
+
+				// inner rows only have the two cells on the ring border
+				const i32 step = (j == cy - ring || j == cy + ring) ? 1 : std::max<i32>(ring * 2, 1);
+				for (i32 i = cx - ring; i <= cx + ring; i += step)
+				{
+					if (i < 0 || i >= m_cellColumns)
+						continue;
+
+					const i32 cell = j * m_cellColumns + i;
+					for (i32 k = m_cellStarts[cell]; k < m_cellStarts[cell + 1]; k++)
+					{
+						const Vector2& site = m_sites[m_cellSites[k]];
+						float squared = (site.x - x) * (site.x - x) + (site.y - y) * (site.y - y);
+						bestSquared = std::min<float>(bestSquared, squared);
+					}
+				}
+			}
+
+			// cells beyond this ring are at least ring cells away
+			float reach = ring * m_cellSize;
+			if (bestSquared <= reach * reach)
+				break;
+		}
+
+		return std::sqrt(bestSquared) / m_cellSize;
 	}
 
 	void PCGImageVoronoi::generateSites()
@@ -87,9 +165,11 @@ namespace Echo
 
 		switch (m_distributionType)
 		{
-		case DistributionType::Poisson: poissonDiscSampling();	break;
-		case DistributionType::Random:	randomSampling();		break;
-		default:						poissonDiscSampling();	break;
+		case DistributionType::Poisson:		poissonDiscSampling();			break;
+		case DistributionType::Random:		randomSampling();				break;
+		case DistributionType::Grid:		gridSampling(false, false);		break;
+		case DistributionType::Hexagonal:	gridSampling(false, true);		break;
+		default:							poissonDiscSampling();			break;
 		}
 	}
 
@@ -99,15 +179,68 @@ namespace Echo
 	// https://www.youtube.com/watch?v=flQgnCUxHlw
 	void PCGImageVoronoi::poissonDiscSampling()
 	{
-
+		// jittered grid, one site per cell keeps sites evenly spread like poisson disc sampling
+		gridSampling(true, false);
 	}
 
 	void PCGImageVoronoi::randomSampling()
 	{
-		std::srand(m_randomSeed);
+		std::mt19937 random(m_randomSeed);
+		std::uniform_real_distribution<float> distributionX(0.f, float(m_width));
+		std::uniform_real_distribution<float> distributionY(0.f, float(m_height));
 		for (i32 i = 0; i < m_randomSamplingCount; i++)
 		{
-			m_sites.push_back(Vector2(std::rand() % m_width, std::rand() % m_height));
+			m_sites.push_back(Vector2(distributionX(random), distributionY(random)));
 		}
 	}
+
+	void PCGImageVoronoi::gridSampling(bool isJitter, bool isHexagonal)
+	{
+		std::mt19937 random(m_randomSeed);
+		std::uniform_real_distribution<float> distribution(0.f, 1.f);
+
+		const float cellSize = std::max<float>(std::sqrt(float(m_width) * m_height / m_randomSamplingCount), 1.f);
+		const i32 columns = std::max<i32>(i32(std::ceil(m_width / cellSize)), 1);
+		const i32 rows = std::max<i32>(i32(std::ceil(m_height / cellSize)), 1);
+		for (i32 row = 0; row < rows; row++)
+		{
+			float shift = (isHexagonal && (row & 1)) ? 0.5f : 0.f;
+			for (i32 column = 0; column < columns; column++)
+			{
+				float u = isJitter ? distribution(random) : 0.5f;
+				float v = isJitter ? distribution(random) : 0.5f;
+				Vector2 site((column + u + shift) * cellSize, (row + v) * cellSize);
+				if (site.x < m_width && site.y < m_height)
+					m_sites.push_back(site);
+			}
+		}
+	}
+
+	void PCGImageVoronoi::buildSiteGrid()
+	{
+		// about one site per cell
+		m_cellSize = std::max<float>(std::sqrt(float(m_width) * m_height / std::max<i32>(i32(m_sites.size()), 1)), 1.f);
+		m_cellColumns = std::max<i32>(i32(std::ceil(m_width / m_cellSize)), 1);
+		m_cellRows = std::max<i32>(i32(std::ceil(m_height / m_cellSize)), 1);
+
+		auto cellOf = [this](const Vector2& site)
+		{
+			i32 i = Math::Clamp(i32(site.x / m_cellSize), 0, m_cellColumns - 1);
+			i32 j = Math::Clamp(i32(site.y / m_cellSize), 0, m_cellRows - 1);
+			return j * m_cellColumns + i;
+		};
+
+		// counting sort of sites by cell
+		m_cellStarts.assign(m_cellColumns * m_cellRows + 1, 0);
+		for (const Vector2& site : m_sites)
+			m_cellStarts[cellOf(site) + 1]++;
+
+		for (size_t i = 1; i < m_cellStarts.size(); i++)
+			m_cellStarts[i] += m_cellStarts[i - 1];
+
+		vector<i32>::type cursor(m_cellStarts.begin(), m_cellStarts.end() - 1);
+		m_cellSites.resize(m_sites.size());
+		for (size_t i = 0; i < m_sites.size(); i++)
+			m_cellSites[cursor[cellOf(m_sites[i])]++] = i32(i);
+	}
 }
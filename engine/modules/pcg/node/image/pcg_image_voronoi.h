@@ -33,6 +33,18 @@ namespace Echo
 		i32 getHeight() const { return m_height; }
 		void setHeight(i32 height);
 
+		// distribution
+		StringOption getDistribution() const;
+		void setDistribution(const StringOption& option);
+
+		// seed
+		i32 getSeed() const { return m_randomSeed; }
+		void setSeed(i32 seed);
+
+		// sample count
+		i32 getSampleCount() const { return m_randomSamplingCount; }
+		void setSampleCount(i32 count);
+
 		// get result
 		PCGImagePtr getResultImage() { return m_resultImage; }
 
@@ -40,21 +52,31 @@ namespace Echo
 		virtual void run() override;
 
 	public:
-		// Compute Perlin noise at coordinates x, y
+		// Distance from x, y to the nearest site, in cell sizes
 		float voronoi(float x, float y);
 
 		// distribution
 		void generateSites();
 		void poissonDiscSampling();
 		void randomSampling();
+		void gridSampling(bool isJitter, bool isHexagonal);
+
+	protected:
+		// Bucket sites into cells, so a pixel only visits cells near it
+		void buildSiteGrid();
 
 	protected:
 		i32						m_width = 128;
 		i32						m_height = 128;
 		DistributionType		m_distributionType = DistributionType::Random;
-		i32						m_randomSeed;
+		i32						m_randomSeed = 0;
 		i32						m_randomSamplingCount = 32;
 		vector<Vector2>::type	m_sites;
+		float					m_cellSize = 1.f;
+		i32						m_cellColumns = 0;
+		i32						m_cellRows = 0;
+		vector<i32>::type		m_cellStarts;			// sites of cell i are m_cellSites[m_cellStarts[i], m_cellStarts[i+1])
+		vector<i32>::type		m_cellSites;
 		PCGImagePtr				m_resultImage;
 	};
 }
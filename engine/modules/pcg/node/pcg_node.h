@@ -10,6 +10,18 @@ namespace Echo
 	class PCGNode : public Object
 	{
 		ECHO_CLASS(PCGNode, Object);
+		friend class PCGFlowGraph;
+
+	public:
+		// Statistics of evaluation
+		struct Statistics
+		{
+			float	m_lastTime = 0.f;			// milliseconds of last run
+			float	m_totalTime = 0.f;			// milliseconds of all runs
+			bool	m_isLastCached = false;		// last evaluation reused the cached output
+			ui32	m_hitCount = 0;
+			ui32	m_missCount = 0;
+		};
 
 	public:
 		PCGNode();
@@ -39,10 +51,20 @@ namespace Echo
 
 		// is dirty
 		bool isDirty() { return m_dirtyFlag; }
+		void markDirty() { m_dirtyFlag = true; }
 
 		// check
 		bool check() { return true; }
 
+		// nodes touching scene or files should run on the calling thread
+		virtual bool isThreadSafe() { return true; }
+
+		// output version, increased every time the node really runs
+		ui32 getVersion() const { return m_version; }
+
+		// statistics
+		const Statistics& getStatistics() const { return m_statistics; }
+
 		// calculate
 		virtual void run();
 
@@ -53,6 +75,9 @@ namespace Echo
 		std::vector<PCGConnectPoint*>		m_outputs;
 		bool								m_dirtyFlag = true;
 		Vector2								m_position;
+		ui32								m_version = 0;
+		std::vector<ui32>					m_inputVersions;		// versions of dependent inputs at last run
+		Statistics							m_statistics;
 	};
 
 	LUA_PUSH_VALUE(PCGNode)
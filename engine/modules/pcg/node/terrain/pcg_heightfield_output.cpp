@@ -29,6 +29,7 @@ namespace Echo
 	void PCGHeightfieldOutput::setTerrainPath(const NodePath& terrainPath)
 	{
 		m_terrainPath.setPath(terrainPath.getPath());
+		m_dirtyFlag = true;
 	}
 
 	void PCGHeightfieldOutput::run()
@@ -44,13 +45,8 @@ namespace Echo
 					PCGImagePtr image = dynamic_cast<PCGImage*>(inputData.ptr());
 					if (image)
 					{
-						vector<float>::type heightData;
-						heightData.reserve(image->getColors().size());
-
-						for (const Color& color : image->getColors())
-						{
-							heightData.push_back(color.r);
-						}
+						const float* plane = image->getPlane(0);
+						vector<float>::type heightData(plane, plane + size_t(image->getWidth()) * image->getHeight());
 
 						terrain->setHeight(0, 0, image->getWidth(), image->getHeight(), heightData);
 					}
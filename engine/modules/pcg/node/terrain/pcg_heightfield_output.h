@@ -23,6 +23,9 @@ namespace Echo
 		bool isAutoCreate() const { return m_autoCreate; }
 		void setAutoCreate(bool autoCreate) { m_autoCreate = autoCreate; }
 
+		// Writes to the scene
+		virtual bool isThreadSafe() override { return false; }
+
 		// Run
 		virtual void run() override;
 
@@ -4,7 +4,9 @@
 #include "engine/core/log/log.h"
 #include "engine/core/main/Engine.h"
 #include "engine/core/scene/node_tree.h"
+#include "engine/core/thread/job_system.h"
 #include <queue>
+#include <chrono>
 #include <thirdparty/pugixml/pugixml.hpp>
 #include <thirdparty/pugixml/pugiconfig.hpp>
 #include <thirdparty/pugixml/pugixml_ext.hpp>
@@ -38,6 +40,8 @@ namespace Echo
 		EchoSafeDeleteContainer(m_connects, PCGConnect);
 
 		m_nodeOutput = nullptr;
+		m_schedule.clear();
+		m_isScheduleDirty = true;
 	}
 
 	void PCGFlowGraph::addNode(PCGNode* node)
@@ -51,6 +55,8 @@ namespace Echo
 
 			if (!m_nodeOutput)
 				m_nodeOutput = node;
+
+			m_isScheduleDirty = true;
 		}
 	}
 
@@ -61,6 +67,15 @@ namespace Echo
 		if (node == m_nodeOutput)
 			m_nodeOutput = nullptr;
 
+		// consumers lost an input
+		for (PCGConnect* connect : m_connects)
+		{
+			if (connect->getFrom() && connect->getTo() && connect->getFrom()->getOwner() == node)
+				connect->getTo()->getOwner()->markDirty();
+		}
+
+		m_isScheduleDirty = true;
+
 		EchoSafeDelete(node, PCGNode);
 	}
 
@@ -70,6 +85,9 @@ namespace Echo
 
 		connect->getFrom()->addConnect(connect);
 		connect->getTo()->addConnect(connect);
+		connect->getTo()->getOwner()->markDirty();
+
+		m_isScheduleDirty = true;
 	}
 
 	PCGConnect* PCGFlowGraph::addConnect(const String& fromNode, i32 fromIdx, const String& toNode, i32 toIdx)
@@ -101,6 +119,11 @@ namespace Echo
 	{
 		m_connects.erase(std::remove(m_connects.begin(), m_connects.end(), connect), m_connects.end());
 
+		if (connect->getTo())
+			connect->getTo()->getOwner()->markDirty();
+
+		m_isScheduleDirty = true;
+
 		EchoSafeDelete(connect, PCGConnect);
 	}
 
@@ -120,6 +143,7 @@ namespace Echo
 	void PCGFlowGraph::setAsOutput(PCGNode* node)
 	{
 		m_nodeOutput = isNodeExist(node) ? node : nullptr;
+		m_isScheduleDirty = true;
 	}
 
 	PCGNode* PCGFlowGraph::getOutputNode()
@@ -129,25 +153,133 @@ namespace Echo
 
 	void PCGFlowGraph::run()
 	{
-		if (m_nodeOutput)
+		auto startTime = std::chrono::steady_clock::now();
+
+		if (m_isScheduleDirty)
+			compileSchedule();
+
+		std::vector<PCGNode*> parallelNodes;
+		std::vector<PCGNode*> serialNodes;
+		for (std::vector<PCGNode*>& level : m_schedule)
 		{
-			runNode(m_nodeOutput);
+			// every input of this level was finished by previous levels
+			parallelNodes.clear();
+			serialNodes.clear();
+			for (PCGNode* node : level)
+			{
+				if (isNeedRun(node))
+				{
+					(node->isThreadSafe() ? parallelNodes : serialNodes).emplace_back(node);
+				}
+				else
+				{
+					node->m_statistics.m_isLastCached = true;
+					node->m_statistics.m_hitCount++;
+				}
+			}
+
+			JobSystem::instance()->parallelFor(i32(parallelNodes.size()), [&parallelNodes, this](i32 i) { runNode(parallelNodes[i]); });
+
+			for (PCGNode* node : serialNodes)
+				runNode(node);
 		}
+
+		m_lastRunTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 	}
 
-	void PCGFlowGraph::runNode(PCGNode* node)
+	void PCGFlowGraph::compileSchedule()
+	{
+		m_schedule.clear();
+
+		std::unordered_map<PCGNode*, i32> levels;
+		if (m_nodeOutput && calcLevel(m_nodeOutput, levels) < 0)
+		{
+			EchoLogError("PCGFlowGraph [%s] has a cycle, nothing will run", getName().c_str());
+			levels.clear();
+		}
+
+		for (auto& it : levels)
+		{
+			if (it.second >= i32(m_schedule.size()))
+				m_schedule.resize(it.second + 1);
+
+			m_schedule[it.second].emplace_back(it.first);
+		}
+
+		m_isScheduleDirty = false;
+	}
+
+	i32 PCGFlowGraph::calcLevel(PCGNode* node, std::unordered_map<PCGNode*, i32>& levels)
 	{
+		auto it = levels.find(node);
+		if (it != levels.end())
+			return it->second;
+
+		// -1 marks a node on the current path
+		levels[node] = -1;
+
+		i32 level = 0;
 		for (PCGConnectPoint* input : node->getDependentInputs())
 		{
 			PCGConnectPoint* from = input->getDependEndPoint();
 			if (from)
 			{
-				runNode(from->getOwner());
+				i32 fromLevel = calcLevel(from->getOwner(), levels);
+				if (fromLevel < 0)
+					return -1;
+
+				level = std::max<i32>(level, fromLevel + 1);
 			}
 		}
 
+		levels[node] = level;
+		return level;
+	}
+
+	bool PCGFlowGraph::isNeedRun(PCGNode* node)
+	{
+		if (node->isDirty())
+			return true;
+
+		std::vector<PCGConnectPoint*> inputs = node->getDependentInputs();
+		if (inputs.size() != node->m_inputVersions.size())
+			return true;
+
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			PCGConnectPoint* from = inputs[i]->getDependEndPoint();
+			if ((from ? from->getOwner()->getVersion() : 0) != node->m_inputVersions[i])
+				return true;
+		}
+
+		return false;
+	}
+
+	void PCGFlowGraph::runNode(PCGNode* node)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		// nodes skip their work when not dirty, inputs may have changed though
+		node->m_dirtyFlag = true;
 		if (node->check())
 			node->run();
+
+		node->m_dirtyFlag = false;
+		node->m_version++;
+
+		std::vector<PCGConnectPoint*> inputs = node->getDependentInputs();
+		node->m_inputVersions.resize(inputs.size());
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			PCGConnectPoint* from = inputs[i]->getDependEndPoint();
+			node->m_inputVersions[i] = from ? from->getOwner()->getVersion() : 0;
+		}
+
+		PCGNode::Statistics& statistics = node->m_statistics;
+		statistics.m_lastTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+		statistics.m_totalTime += statistics.m_lastTime;
+		statistics.m_isLastCached = false;
+		statistics.m_missCount++;
 	}
 
 	bool PCGFlowGraph::isNodeExist(PCGNode* node)
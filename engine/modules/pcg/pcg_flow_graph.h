@@ -46,9 +46,15 @@ namespace Echo
 		const String& getGraph();
 		void setGraph(const String& graph);
 
-		// run
+		// run, only nodes whose parameters or inputs changed are evaluated again
 		void run();
 
+		// schedule must be compiled again (dependent inputs of a node changed)
+		void markScheduleDirty() { m_isScheduleDirty = true; }
+
+		// milliseconds of last run
+		float getLastRunTime() const { return m_lastRunTime; }
+
 	public:
 		// Is Node Exist
 		bool isNodeExist(PCGNode* node);
@@ -57,13 +63,25 @@ namespace Echo
 		void makeNameUnique(PCGNode* node);
 
 	private:
-		// Run
+		// Compile nodes the output depends on into levels, nodes of one level never depend on each other
+		void compileSchedule();
+
+		// Level of node in schedule, -1 if a cycle is found
+		i32 calcLevel(PCGNode* node, std::unordered_map<PCGNode*, i32>& levels);
+
+		// Does node need to run again
+		bool isNeedRun(PCGNode* node);
+
+		// Run node and record statistics
 		void runNode(PCGNode* node);
 
 	protected:
-		String						m_graph;
-		vector<PCGNode*>::type		m_nodes;
-		PCGNode*					m_nodeOutput = nullptr;
-		std::vector<PCGConnect*>	m_connects;
+		String									m_graph;
+		vector<PCGNode*>::type					m_nodes;
+		PCGNode*								m_nodeOutput = nullptr;
+		std::vector<PCGConnect*>				m_connects;
+		bool									m_isScheduleDirty = true;
+		std::vector<std::vector<PCGNode*>>		m_schedule;
+		float									m_lastRunTime = 0.f;
 	};
 }
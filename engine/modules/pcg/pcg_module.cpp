@@ -3,6 +3,9 @@
 #include "node/primitive/pcg_box.h"
 #include "node/image/pcg_image_perlin_noise.h"
 #include "node/image/pcg_image_voronoi.h"
+#include "node/image/pcg_image_multiply.h"
+#include "node/image/pcg_image_substract.h"
+#include "node/image/pcg_image_scale.h"
 #include "node/image/pcg_image_save.h"
 #include "node/terrain/pcg_heightfield_output.h"
 #include "editor/pcg_flow_graph_editor.h"
@@ -36,6 +39,9 @@ namespace Echo
 
 		Class::registerType<PCGImagePerlinNoise>();
 		Class::registerType<PCGImageVoronoi>();
+		Class::registerType<PCGImageMultiply>();
+		Class::registerType<PCGImageSubstract>();
+		Class::registerType<PCGImageScale>();
 		Class::registerType<PCGImageSave>();
 
 		Class::registerType<PCGHeightfieldOutput>();
@@ -12,7 +12,12 @@ namespace Echo
 
 	PhysxBody::~PhysxBody()
 	{
-
+		if (m_pxBody)
+		{
+			PhysxModule::instance()->removeBody(this);
+			m_pxBody->release();
+			m_pxBody = nullptr;
+		}
 	}
 
 	void PhysxBody::bindMethods()
@@ -49,27 +54,78 @@ namespace Echo
 					m_pxBody = dyb;
 				}
 
+				// active actors are mapped back to their body by user data
+				m_pxBody->userData = this;
+				m_previousPose = pxTransform;
+				m_currentPose = pxTransform;
+				m_appliedPose = pxTransform;
+
 				PhysxModule::instance()->getPxScene()->addActor(*m_pxBody);
 			}
 		}
 
+		// in game, PhysxModule writes poses of moving bodies in one batch, nodes moved by anything
+		// else, kinematic bodies and teleports, are pushed to the body
 		if (m_pxBody)
 		{
 			if (IsGame)
 			{
-				physx::PxTransform pxTransform = m_pxBody->getGlobalPose();
-				this->setWorldPosition( (Vector3&)pxTransform.p - shift);
-				this->setWorldOrientation((Quaternion&)pxTransform.q);
+				syncNodePose();
 			}
 			else
 			{
-                Vector3 finalPosition = getWorldPosition() + shift;
+				Vector3 finalPosition = getWorldPosition() + shift;
 				physx::PxTransform pxTransform((physx::PxVec3&)finalPosition, (physx::PxQuat&)getWorldOrientation());
 				m_pxBody->setGlobalPose( pxTransform);
 			}
 		}
 	}
 
+	void PhysxBody::syncNodePose()
+	{
+		const Vector3& shift = PhysxModule::instance()->getShift();
+		Vector3 finalPosition = getWorldPosition() + shift;
+		physx::PxTransform pxTransform((physx::PxVec3&)finalPosition, (physx::PxQuat&)getWorldOrientation());
+		if ((pxTransform.p - m_appliedPose.p).magnitudeSquared() > 1e-8f || std::abs(pxTransform.q.dot(m_appliedPose.q)) < 1.f - 1e-6f)
+		{
+			m_pxBody->setGlobalPose(pxTransform);
+
+			// no interpolation across the jump
+			m_previousPose = pxTransform;
+			m_currentPose = pxTransform;
+			m_appliedPose = pxTransform;
+		}
+	}
+
+	void PhysxBody::setSimulatedPose(const physx::PxTransform& pose)
+	{
+		m_previousPose = m_currentPose;
+		m_currentPose = pose;
+	}
+
+	void PhysxBody::applyPose(float alpha)
+	{
+		const Vector3& shift = PhysxModule::instance()->getShift();
+		if (alpha >= 1.f)
+		{
+			setWorldPosition((Vector3&)m_currentPose.p - shift);
+			setWorldOrientation((Quaternion&)m_currentPose.q);
+		}
+		else
+		{
+			physx::PxVec3 position = m_previousPose.p + (m_currentPose.p - m_previousPose.p) * alpha;
+			Quaternion orientation;
+			Quaternion::Slerp(orientation, (Quaternion&)m_previousPose.q, (Quaternion&)m_currentPose.q, alpha, true);
+
+			setWorldPosition((Vector3&)position - shift);
+			setWorldOrientation(orientation);
+		}
+
+		// read back, so parent transforms don't make it look like a teleport
+		Vector3 finalPosition = getWorldPosition() + shift;
+		m_appliedPose = physx::PxTransform((physx::PxVec3&)finalPosition, (physx::PxQuat&)getWorldOrientation());
+	}
+
 	void PhysxBody::setLinearVelocity(const Vector3& velocity)
 	{
 		if (m_pxBody && m_type.getIdx() == 2)
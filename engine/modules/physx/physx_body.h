@@ -27,6 +27,19 @@ namespace Echo
 		// apply force
 		void addForce(const Vector3& force);
 
+	public:
+		// pose of the last step, called by PhysxModule for active actors only
+		void setSimulatedPose(const physx::PxTransform& pose);
+
+		// stop interpolating, the body rests at its last simulated pose
+		void setRest() { m_previousPose = m_currentPose; }
+
+		// write pose between the last two steps to node transform
+		void applyPose(float alpha);
+
+		// push the node transform to the body when something other than the simulation moved it
+		void syncNodePose();
+
 	private:
 		// update
 		virtual void updateInternal(float elapsedTime) override;
@@ -34,5 +47,8 @@ namespace Echo
 	private:
 		physx::PxRigidActor*m_pxBody = nullptr;
 		StringOption		m_type;
+		physx::PxTransform	m_previousPose = physx::PxTransform(physx::PxIdentity);
+		physx::PxTransform	m_currentPose = physx::PxTransform(physx::PxIdentity);
+		physx::PxTransform	m_appliedPose = physx::PxTransform(physx::PxIdentity);	// last pose written to or read from the node
 	};
 }
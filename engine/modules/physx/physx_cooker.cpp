@@ -0,0 +1,114 @@
+#include "physx_cooker.h"
+#include "engine/core/io/io.h"
+#include "engine/core/util/PathUtil.h"
+#include "engine/core/util/StringUtil.h"
+#include "engine/core/thread/job_system.h"
+#include <cstdio>
+
+namespace Echo
+{
+	void PhysxCooker::Hasher::add(const void* data, size_t bytes)
+	{
+		const Byte* bytePtr = static_cast<const Byte*>(data);
+		for (size_t i = 0; i < bytes; i++)
+		{
+			m_value ^= bytePtr[i];
+			m_value *= 1099511628211ull;
+		}
+	}
+
+	PhysxCooker::PhysxCooker(physx::PxCooking* cooking)
+		: m_pxCooking(cooking)
+	{
+		m_cacheDir = IO::instance()->getUserPath() + "physx/cooked/";
+		if (!PathUtil::IsDirExist(m_cacheDir))
+			PathUtil::CreateDir(m_cacheDir);
+	}
+
+	PhysxCooker::~PhysxCooker()
+	{
+	}
+
+	PhysxCooker::Hasher PhysxCooker::createHasher() const
+	{
+		const physx::PxCookingParams& params = m_pxCooking->getParams();
+
+		Hasher hasher;
+		hasher.add(ui32(PX_PHYSICS_VERSION));
+		hasher.add(params.scale.length);
+		hasher.add(params.scale.speed);
+		hasher.add(params.areaTestEpsilon);
+		hasher.add(params.planeTolerance);
+		hasher.add(ui32(params.convexMeshCookingType));
+		hasher.add(params.suppressTriangleMeshRemapTable);
+		hasher.add(params.buildTriangleAdjacencies);
+		hasher.add(params.buildGPUData);
+		hasher.add(ui32(params.meshPreprocessParams));
+		hasher.add(params.meshWeldTolerance);
+		hasher.add(ui32(params.midphaseDesc.getType()));
+		hasher.add(params.gaussMapLimit);
+
+		return hasher;
+	}
+
+	String PhysxCooker::getCachePath(ui64 key) const
+	{
+		return m_cacheDir + StringUtil::Format("%016llx.pxc", (unsigned long long)key);
+	}
+
+	PhysxCooker::TaskPtr PhysxCooker::cook(ui64 key, const CookFunc& func)
+	{
+		TaskPtr task = std::make_shared<Task>();
+		task->m_key = key;
+
+		String cachePath = getCachePath(key);
+		physx::PxCooking* cooking = m_pxCooking;
+		JobSystem::instance()->async([cooking, task, cachePath, func]()
+		{
+			run(cooking, task, cachePath, func);
+		});
+
+		return task;
+	}
+
+	void PhysxCooker::run(physx::PxCooking* cooking, const TaskPtr& task, const String& cachePath, const CookFunc& func)
+	{
+		// cache hit
+		if (FILE* file = fopen(cachePath.c_str(), "rb"))
+		{
+			fseek(file, 0, SEEK_END);
+			long size = ftell(file);
+			fseek(file, 0, SEEK_SET);
+			if (size > 0)
+			{
+				task->m_data.resize(size);
+				task->m_isOk = fread(task->m_data.data(), 1, size, file) == size_t(size);
+			}
+
+			fclose(file);
+		}
+
+		// cook, then write to a temporary file so a half written cache is never read
+		if (!task->m_isOk)
+		{
+			physx::PxDefaultMemoryOutputStream stream;
+			if (func(*cooking, stream))
+			{
+				task->m_data.assign(stream.getData(), stream.getData() + stream.getSize());
+				task->m_isOk = true;
+
+				String tempPath = cachePath + StringUtil::Format(".%p", task.get());
+				if (FILE* file = fopen(tempPath.c_str(), "wb"))
+				{
+					bool isWritten = fwrite(task->m_data.data(), 1, task->m_data.size(), file) == task->m_data.size();
+					fclose(file);
+
+					if (!isWritten || rename(tempPath.c_str(), cachePath.c_str()) != 0)
+						remove(tempPath.c_str());
+				}
+			}
+		}
+
+		task->m_isDone = true;
+	}
+}
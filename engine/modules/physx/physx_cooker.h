@@ -0,0 +1,58 @@
+#pragma once
+
+#include "physx_base.h"
+#include "engine/core/memory/MemAllocDef.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace Echo
+{
+	// Cooks on worker threads, cooked streams are cached on disk by a hash of
+	// the input geometry and the cooking parameters
+	class PhysxCooker
+	{
+	public:
+		typedef std::function<bool(physx::PxCooking& cooking, physx::PxOutputStream& stream)> CookFunc;
+
+		// One cooking request, polled by the owner on the main thread
+		struct Task
+		{
+			ui64					m_key = 0;
+			vector<Byte>::type		m_data;
+			std::atomic<bool>		m_isDone{ false };
+			bool					m_isOk = false;
+		};
+		typedef std::shared_ptr<Task> TaskPtr;
+
+		// Incremental FNV-1a hash
+		struct Hasher
+		{
+			ui64 m_value = 14695981039346656037ull;
+
+			void add(const void* data, size_t bytes);
+			template<typename T> void add(const T& value) { add(&value, sizeof(T)); }
+		};
+
+	public:
+		PhysxCooker(physx::PxCooking* cooking);
+		~PhysxCooker();
+
+		// hasher seeded with the cooking parameters, add geometry to it to get a key
+		Hasher createHasher() const;
+
+		// cook, the func runs on a worker thread and must own the data it reads
+		TaskPtr cook(ui64 key, const CookFunc& func);
+
+	private:
+		// cache file of key
+		String getCachePath(ui64 key) const;
+
+		// run on worker
+		static void run(physx::PxCooking* cooking, const TaskPtr& task, const String& cachePath, const CookFunc& func);
+
+	private:
+		physx::PxCooking*	m_pxCooking = nullptr;
+		String				m_cacheDir;
+	};
+}
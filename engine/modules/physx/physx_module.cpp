@@ -30,6 +30,7 @@
 #include "editor/physx_vehicle_wheel_editor.h"
 #include "editor/physx_vehicle_drive4w_editor.h"
 #include "engine/core/main/Engine.h"
+#include "engine/core/thread/job_system.h"
 
 namespace Echo
 {
@@ -54,16 +55,14 @@ namespace Echo
 				pxDesc.filterShader = physx::PxDefaultSimulationFilterShader;
 			}
 
-			//pxDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVETRANSFORMS;
-			//pxDesc.simulationOrder = physx::PxSimulationOrder::eCOLLIDE_SOLVE;
+			// only moved actors are synced back to nodes
+			pxDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS;
 
 			// create scene
 			m_pxScene = m_pxPhysics->createScene(pxDesc);
 			m_debugDraw = EchoNew(PhysxDebugDraw(m_pxScene));
 			m_pxControllerManager = PxCreateControllerManager(*m_pxScene);
 
-			m_vehicleSceneQueryData = physx::PxVehicleSceneQueryData::allocate(100, PX_MAX_NB_WHEELS, 1, 1, physx::PxWheelSceneQueryPreFilterBlocking, nullptr, *m_pxAllocatorCb);
-			m_vehicleBatchQuery = physx::PxVehicleSceneQueryData::setUpBatchedSceneQuery(0, *m_vehicleSceneQueryData, m_pxScene);
 			m_vehicleDefaultMaterial = m_pxPhysics->createMaterial(0.5f, 0.5f, 0.5f);
 			m_vehicleFrictionPairs = createFrictionPairs(m_vehicleDefaultMaterial);
 
@@ -76,6 +75,12 @@ namespace Echo
     
     PhysxModule::~PhysxModule()
     {
+		if (m_isSimulating)
+			m_pxScene->fetchResults(true);
+
+		if (m_vehicleBatchQuery) m_vehicleBatchQuery->release();
+		if (m_vehicleSceneQueryData) m_vehicleSceneQueryData->free(*m_pxAllocatorCb);
+
 		physx::PxCloseVehicleSDK();
 
 		if (m_pxScene) m_pxScene->release();
@@ -89,6 +94,7 @@ namespace Echo
 		EchoSafeDelete(m_pxAllocatorCb, PxAllocatorCallback);
 		EchoSafeDelete(m_pxErrorCb, PxErrorCallback);
 		EchoSafeDelete(m_debugDraw, PhysxDebugDraw);
+		EchoSafeDelete(m_cooker, PhysxCooker);
     }
 
 	PhysxModule* PhysxModule::instance()
@@ -105,11 +111,23 @@ namespace Echo
 		CLASS_BIND_METHOD(PhysxModule, setGravity);
 		CLASS_BIND_METHOD(PhysxModule, getShift);
 		CLASS_BIND_METHOD(PhysxModule, setShift);
+		CLASS_BIND_METHOD(PhysxModule, isAsync);
+		CLASS_BIND_METHOD(PhysxModule, setAsync);
+		CLASS_BIND_METHOD(PhysxModule, isInterpolate);
+		CLASS_BIND_METHOD(PhysxModule, setInterpolate);
 		CLASS_BIND_METHOD(PhysxModule, rayCast);
+		CLASS_BIND_METHOD(PhysxModule, addRaycasts);
+		CLASS_BIND_METHOD(PhysxModule, addSphereSweeps);
+		CLASS_BIND_METHOD(PhysxModule, addSphereOverlaps);
+		CLASS_BIND_METHOD(PhysxModule, getRaycastHits);
+		CLASS_BIND_METHOD(PhysxModule, getSweepHits);
+		CLASS_BIND_METHOD(PhysxModule, getOverlapHits);
 
         CLASS_REGISTER_PROPERTY(PhysxModule, "DebugDraw", Variant::Type::StringOption, getDebugDrawOption, setDebugDrawOption);
 		CLASS_REGISTER_PROPERTY(PhysxModule, "Gravity", Variant::Type::Vector3, getGravity, setGravity);
 		CLASS_REGISTER_PROPERTY(PhysxModule, "Shift", Variant::Type::Vector3, getShift, setShift);
+		CLASS_REGISTER_PROPERTY(PhysxModule, "Async", Variant::Type::Bool, isAsync, setAsync);
+		CLASS_REGISTER_PROPERTY(PhysxModule, "Interpolate", Variant::Type::Bool, isInterpolate, setInterpolate);
 	}
 
 	void PhysxModule::setGravity(const Vector3& gravity)
@@ -170,29 +188,29 @@ namespace Echo
 		{
 			bool isGame = Engine::instance()->getConfig().m_isGame;
 
-			// step
+			// step kicked off by last frame
+			fetchResults();
+
+			// suspension raycasts once per frame, later substeps reuse the hit planes
+			m_isVehicleRaycastDirty = true;
+
+			// step, in async mode the last step due is left for lateUpdate
 			m_accumulator += elapsedTime;
-			while (m_accumulator > m_stepLength)
+			float reserved = (m_isAsync && isGame) ? m_stepLength : 0.f;
+			while (m_accumulator > m_stepLength + reserved)
 			{
-				for (physx::PxVehicleWheels* vehicle : m_vehicles)
-				{
-					physx::PxVehicleWheels* vehicles[1] = { vehicle };
-					physx::PxRaycastQueryResult* raycastResults = m_vehicleSceneQueryData->getRaycastQueryResultBuffer(0);
-					const physx::PxU32 raycastResultsSize = m_vehicleSceneQueryData->getQueryResultBufferSize();
-					physx::PxVehicleSuspensionRaycasts(m_vehicleBatchQuery, 1, vehicles, raycastResultsSize, raycastResults);
-
-					const physx::PxVec3 grav = m_pxScene->getGravity();
-					physx::PxWheelQueryResult wheelQueryResults[PX_MAX_NB_WHEELS];
-					physx::PxVehicleWheelQueryResult vehicleQueryResults[1] = { {wheelQueryResults, vehicle->mWheelsSimData.getNbWheels()} };
-					physx::PxVehicleUpdates(m_stepLength, grav, *m_vehicleFrictionPairs, 1, vehicles, vehicleQueryResults);
-				}
-
-				m_pxScene->simulate(isGame ? m_stepLength : 0);
-				m_pxScene->fetchResults(true);
+				simulate(isGame);
+				fetchResults();
 
 				m_accumulator -= m_stepLength;
 			}
 
+			// moving bodies are written back in one batch. The reserved step always counts as lag, whether
+			// lateUpdate takes it this frame or not, so the shown time never goes back between frames
+			float alpha = (m_isInterpolate && isGame) ? Math::Clamp((m_accumulator - reserved) / m_stepLength, 0.f, 1.f) : 1.f;
+			for (PhysxBody* body : m_movingBodies)
+				body->applyPose(alpha);
+
 			// draw debug data
 			const StringOption& debugDrawOption = PhysxModule::instance()->getDebugDrawOption();
 			if (debugDrawOption.getIdx() == 3 || (debugDrawOption.getIdx() == 1 && !isGame) || (debugDrawOption.getIdx() == 2 && isGame))
@@ -209,6 +227,170 @@ namespace Echo
 		}
 	}
 
+	void PhysxModule::lateUpdate(float elapsedTime)
+	{
+		// queries queued by this frame's node update, run before the scene is written again
+		if (m_pxScene && m_queryBatch.getQueryCount())
+			m_queryBatch.execute(m_pxScene, m_shift);
+
+		// overlaps with rendering, results are fetched at the start of next frame
+		bool isGame = Engine::instance()->getConfig().m_isGame;
+		if (m_pxScene && m_isAsync && isGame && m_accumulator > m_stepLength)
+		{
+			simulate(isGame);
+			m_accumulator -= m_stepLength;
+		}
+	}
+
+	void PhysxModule::simulate(bool isGame)
+	{
+		updateVehicles();
+
+		m_pxScene->simulate(isGame ? m_stepLength : 0);
+		m_isSimulating = true;
+	}
+
+	void PhysxModule::prepareVehicles()
+	{
+		if (!m_isVehiclesDirty)
+			return;
+
+		// raycast results are consumed four wheels at a time, per vehicle
+		physx::PxU32 raycastCount = 0;
+		physx::PxU32 wheelCount = 0;
+		for (physx::PxVehicleWheels* vehicle : m_vehicles)
+		{
+			raycastCount += vehicle->mWheelsSimData.getNbWheels4() * 4;
+			wheelCount += vehicle->mWheelsSimData.getNbWheels();
+		}
+
+		// one batch query for all vehicles, grown on demand
+		if (raycastCount > m_vehicleRaycastCapacity)
+		{
+			if (m_vehicleBatchQuery) m_vehicleBatchQuery->release();
+			if (m_vehicleSceneQueryData) m_vehicleSceneQueryData->free(*m_pxAllocatorCb);
+
+			m_vehicleRaycastCapacity = std::max<physx::PxU32>(m_vehicleRaycastCapacity * 2, std::max<physx::PxU32>(raycastCount, 64));
+			m_vehicleSceneQueryData = physx::PxVehicleSceneQueryData::allocate(1, m_vehicleRaycastCapacity, 1, 1, physx::PxWheelSceneQueryPreFilterBlocking, nullptr, *m_pxAllocatorCb);
+			m_vehicleBatchQuery = physx::PxVehicleSceneQueryData::setUpBatchedSceneQuery(0, *m_vehicleSceneQueryData, m_pxScene);
+		}
+
+		// per vehicle views into flat wheel buffers
+		m_vehicleWheelResults.assign(wheelCount, physx::PxWheelQueryResult());
+		m_vehicleWheelUpdates.assign(wheelCount, physx::PxVehicleWheelConcurrentUpdateData());
+		m_vehicleQueryResults.resize(m_vehicles.size());
+		m_vehicleUpdates.assign(m_vehicles.size(), physx::PxVehicleConcurrentUpdateData());
+
+		physx::PxU32 offset = 0;
+		for (size_t i = 0; i < m_vehicles.size(); i++)
+		{
+			physx::PxU32 nbWheels = m_vehicles[i]->mWheelsSimData.getNbWheels();
+			m_vehicleQueryResults[i].wheelQueryResults = m_vehicleWheelResults.data() + offset;
+			m_vehicleQueryResults[i].nbWheelQueryResults = nbWheels;
+			m_vehicleUpdates[i].concurrentWheelUpdates = m_vehicleWheelUpdates.data() + offset;
+			m_vehicleUpdates[i].nbConcurrentWheelUpdates = nbWheels;
+			offset += nbWheels;
+		}
+
+		m_isVehiclesDirty = false;
+	}
+
+	void PhysxModule::updateVehicles()
+	{
+		if (m_vehicles.empty())
+			return;
+
+		prepareVehicles();
+
+		physx::PxU32 vehicleCount = physx::PxU32(m_vehicles.size());
+		if (m_isVehicleRaycastDirty)
+		{
+			physx::PxRaycastQueryResult* raycastResults = m_vehicleSceneQueryData->getRaycastQueryResultBuffer(0);
+			physx::PxVehicleSuspensionRaycasts(m_vehicleBatchQuery, vehicleCount, m_vehicles.data(), m_vehicleSceneQueryData->getQueryResultBufferSize(), raycastResults);
+			m_isVehicleRaycastDirty = false;
+		}
+
+		const physx::PxVec3 gravity = m_pxScene->getGravity();
+		const physx::PxU32 chunkSize = 32;
+		if (vehicleCount <= chunkSize)
+		{
+			physx::PxVehicleUpdates(m_stepLength, gravity, *m_vehicleFrictionPairs, vehicleCount, m_vehicles.data(), m_vehicleQueryResults.data());
+		}
+		else
+		{
+			// actor writes of concurrent updates are deferred, then applied in sequence
+			i32 chunkCount = i32((vehicleCount + chunkSize - 1) / chunkSize);
+			JobSystem::instance()->parallelFor(chunkCount, [&](i32 chunk)
+			{
+				physx::PxU32 begin = physx::PxU32(chunk) * chunkSize;
+				physx::PxU32 count = std::min<physx::PxU32>(chunkSize, vehicleCount - begin);
+				physx::PxVehicleUpdates(m_stepLength, gravity, *m_vehicleFrictionPairs, count, m_vehicles.data() + begin, m_vehicleQueryResults.data() + begin, m_vehicleUpdates.data() + begin);
+			});
+
+			physx::PxVehiclePostUpdates(m_vehicleUpdates.data(), vehicleCount, m_vehicles.data());
+		}
+	}
+
+	void PhysxModule::fetchResults()
+	{
+		if (m_isSimulating)
+		{
+			m_pxScene->fetchResults(true);
+			m_isSimulating = false;
+
+			syncActiveActors();
+		}
+	}
+
+	void PhysxModule::syncActiveActors()
+	{
+		// bodies that moved in the previous step interpolate from where it ended
+		for (PhysxBody* body : m_movingBodies)
+			body->setRest();
+
+		vector<PhysxBody*>::type stoppedBodies;
+		stoppedBodies.swap(m_movingBodies);
+
+		physx::PxU32 actorCount = 0;
+		physx::PxActor** actors = m_pxScene->getActiveActors(actorCount);
+		for (physx::PxU32 i = 0; i < actorCount; i++)
+		{
+			PhysxBody* body = static_cast<PhysxBody*>(actors[i]->userData);
+			physx::PxRigidActor* rigidActor = actors[i]->is<physx::PxRigidActor>();
+			if (body && rigidActor)
+			{
+				body->setSimulatedPose(rigidActor->getGlobalPose());
+				m_movingBodies.emplace_back(body);
+			}
+		}
+
+		// bodies that fell asleep get their final pose now, they are not visited again
+		if (!stoppedBodies.empty())
+		{
+			std::sort(stoppedBodies.begin(), stoppedBodies.end());
+			for (PhysxBody* body : m_movingBodies)
+			{
+				auto it = std::lower_bound(stoppedBodies.begin(), stoppedBodies.end(), body);
+				if (it != stoppedBodies.end() && *it == body)
+					*it = nullptr;
+			}
+
+			for (PhysxBody* body : stoppedBodies)
+			{
+				if (body)
+					body->applyPose(1.f);
+			}
+		}
+	}
+
+	void PhysxModule::removeBody(PhysxBody* body)
+	{
+		if (m_isSimulating)
+			fetchResults();
+
+		m_movingBodies.erase(std::remove(m_movingBodies.begin(), m_movingBodies.end(), body), m_movingBodies.end());
+	}
+
     void PhysxModule::setDebugDrawOption(const StringOption& option)
     {
         m_drawDebugOption.setValue(option.getValue());
@@ -236,6 +418,15 @@ namespace Echo
 		return m_pxPhysics ? true : false;
 	}
 
+	PhysxCooker* PhysxModule::getCooker()
+	{
+		// created on first use, user path is set up by then
+		if (!m_cooker && m_pxCooking)
+			m_cooker = EchoNew(PhysxCooker(m_pxCooking));
+
+		return m_cooker;
+	}
+
 	bool PhysxModule::rayCast(const Vector3& origin, const Vector3& dir, float maxDistance)
 	{
 		if (m_pxScene)
@@ -247,14 +438,95 @@ namespace Echo
 		return false;
 	}
 
+	i32 PhysxModule::addRaycasts(const RealVector& rays, ui32 mask)
+	{
+		i32 first = -1;
+		for (size_t i = 0; i + 7 <= rays.size(); i += 7)
+		{
+			i32 index = m_queryBatch.addRaycast(Vector3(rays[i], rays[i + 1], rays[i + 2]), Vector3(rays[i + 3], rays[i + 4], rays[i + 5]), rays[i + 6], mask);
+			first = first == -1 ? index : first;
+		}
+
+		return first;
+	}
+
+	i32 PhysxModule::addSphereSweeps(const RealVector& sweeps, ui32 mask)
+	{
+		i32 first = -1;
+		for (size_t i = 0; i + 8 <= sweeps.size(); i += 8)
+		{
+			i32 index = m_queryBatch.addSweep(physx::PxSphereGeometry(sweeps[i + 7]), Vector3(sweeps[i], sweeps[i + 1], sweeps[i + 2]), Quaternion::IDENTITY, Vector3(sweeps[i + 3], sweeps[i + 4], sweeps[i + 5]), sweeps[i + 6], mask);
+			first = first == -1 ? index : first;
+		}
+
+		return first;
+	}
+
+	i32 PhysxModule::addSphereOverlaps(const RealVector& spheres, ui32 mask)
+	{
+		i32 first = -1;
+		for (size_t i = 0; i + 4 <= spheres.size(); i += 4)
+		{
+			i32 index = m_queryBatch.addOverlap(physx::PxSphereGeometry(spheres[i + 3]), Vector3(spheres[i], spheres[i + 1], spheres[i + 2]), Quaternion::IDENTITY, mask);
+			first = first == -1 ? index : first;
+		}
+
+		return first;
+	}
+
+	static RealVector packHits(const PhysxQueryBatch::HitArray& hits, i32 first, i32 count)
+	{
+		RealVector result;
+		i32 end = std::min<i32>(first + count, i32(hits.size()));
+		for (i32 i = std::max<i32>(first, 0); i < end; i++)
+		{
+			const PhysxQueryBatch::Hit& hit = hits[i];
+			result.insert(result.end(), { hit.m_isHit ? 1.f : 0.f, hit.m_distance, hit.m_position.x, hit.m_position.y, hit.m_position.z, hit.m_normal.x, hit.m_normal.y, hit.m_normal.z });
+		}
+
+		return result;
+	}
+
+	RealVector PhysxModule::getRaycastHits(i32 first, i32 count)
+	{
+		return packHits(m_queryBatch.getRaycastHits(), first, count);
+	}
+
+	RealVector PhysxModule::getSweepHits(i32 first, i32 count)
+	{
+		return packHits(m_queryBatch.getSweepHits(), first, count);
+	}
+
+	RealVector PhysxModule::getOverlapHits(i32 first, i32 count)
+	{
+		RealVector result;
+		const PhysxQueryBatch::HitArray& hits = m_queryBatch.getOverlapHits();
+		i32 end = std::min<i32>(first + count, i32(hits.size()));
+		for (i32 i = std::max<i32>(first, 0); i < end; i++)
+		{
+			result.emplace_back(hits[i].m_isHit ? 1.f : 0.f);
+			result.emplace_back(hits[i].m_body ? float(hits[i].m_body->getId()) : -1.f);
+		}
+
+		return result;
+	}
+
 	void PhysxModule::addVehicle(physx::PxVehicleWheels* vehicle)
 	{
 		if (vehicle)
+		{
 			m_vehicles.emplace_back(vehicle);
+			m_isVehiclesDirty = true;
+			m_isVehicleRaycastDirty = true;
+		}
 	}
 
 	void PhysxModule::removeVehicle(physx::PxVehicleWheels* vehicle)
 	{
+		if (m_isSimulating)
+			fetchResults();
+
 		m_vehicles.erase(std::remove(m_vehicles.begin(), m_vehicles.end(), vehicle), m_vehicles.end());
+		m_isVehiclesDirty = true;
 	}
 }
@@ -4,9 +4,12 @@
 #include "physx_debug_draw.h"
 #include "physx_base.h"
 #include "vehicle/physx_vehicle_scene_query.h"
+#include "physx_cooker.h"
+#include "query/physx_query_batch.h"
 
 namespace Echo
 {
+	class PhysxBody;
 	class PhysxModule : public Module 
 	{
 		ECHO_SINGLETON_CLASS(PhysxModule, Module)
@@ -28,6 +31,9 @@ namespace Echo
 		// update physx world
 		virtual void update(float elapsedTime) override;
 
+		// kick off asynchronous step
+		virtual void lateUpdate(float elapsedTime) override;
+
 		// get pxPhysics
 		physx::PxPhysics* getPxPhysics() { return m_pxPhysics; }
 
@@ -37,6 +43,9 @@ namespace Echo
 		// cooking
 		physx::PxCooking* getPxCooking() { return m_pxCooking; }
 
+		// background cooking with disk cache
+		PhysxCooker* getCooker();
+
 		// get scene
 		physx::PxScene* getPxScene() { return m_pxScene; }
 
@@ -49,6 +58,20 @@ namespace Echo
 	public:
 		// ray casts
 		bool rayCast(const Vector3& origin, const Vector3& dir, float maxDistance);
+
+		// batched queries, executed after the simulation step in lateUpdate
+		PhysxQueryBatch* getQueryBatch() { return &m_queryBatch; }
+
+		// bulk queries for scripts, packed as [ox,oy,oz, dx,dy,dz, distance(, radius)] / [x,y,z, radius], returns index of the first one.
+		// mask is matched against the query layers of shapes, 0 or nil means all shapes
+		i32 addRaycasts(const RealVector& rays, ui32 mask);
+		i32 addSphereSweeps(const RealVector& sweeps, ui32 mask);
+		i32 addSphereOverlaps(const RealVector& spheres, ui32 mask);
+
+		// bulk results of last execute, [hit, distance, px,py,pz, nx,ny,nz] per ray or sweep, [hit, body id] per overlap
+		RealVector getRaycastHits(i32 first, i32 count);
+		RealVector getSweepHits(i32 first, i32 count);
+		RealVector getOverlapHits(i32 first, i32 count);
         
     public:
         // debug draw
@@ -63,6 +86,18 @@ namespace Echo
 		const Vector3& getShift() const { return m_shift; }
 		void setShift(const Vector3& shift);
 
+		// async, simulate at the end of one frame and fetch at the start of the next (game only)
+		bool isAsync() const { return m_isAsync; }
+		void setAsync(bool isAsync) { m_isAsync = isAsync; }
+
+		// interpolate rendered body poses between the last two fixed steps
+		bool isInterpolate() const { return m_isInterpolate; }
+		void setInterpolate(bool isInterpolate) { m_isInterpolate = isInterpolate; }
+
+	public:
+		// body removed
+		void removeBody(PhysxBody* body);
+
 	public:
 		// vehicle
 		void addVehicle(physx::PxVehicleWheels* vehicle);
@@ -71,6 +106,21 @@ namespace Echo
 	private:
 		// initialize
 		bool initPhysx();
+
+		// one fixed step
+		void simulate(bool isGame);
+
+		// wait for the running step, then sync moving bodies
+		void fetchResults();
+
+		// read poses of actors moved by the last step
+		void syncActiveActors();
+
+		// size result buffers for all vehicles
+		void prepareVehicles();
+
+		// raycast and update all vehicles in one batch
+		void updateVehicles();
         
     private:
         StringOption					m_drawDebugOption = StringOption("Editor", { "None","Editor","Game","All" });
@@ -80,18 +130,31 @@ namespace Echo
 		physx::PxPvd*					m_pxPvd = nullptr;
 		physx::PxPhysics*				m_pxPhysics = nullptr;
 		physx::PxCooking*				m_pxCooking = nullptr;
+		PhysxCooker*					m_cooker = nullptr;
 		physx::PxDefaultCpuDispatcher*	m_pxCPUDispatcher = nullptr;
 		Vector3							m_gravity = Vector3(0.f, -9.8f, 0.f);
 		Vector3							m_shift = Vector3::ZERO;
 		physx::PxScene*					m_pxScene = nullptr;
 		physx::PxControllerManager*		m_pxControllerManager = nullptr;
 		PhysxVehicleArray				m_vehicles;
+		bool							m_isVehiclesDirty = true;
+		bool							m_isVehicleRaycastDirty = true;
+		physx::PxU32					m_vehicleRaycastCapacity = 0;
+		vector<physx::PxWheelQueryResult>::type					m_vehicleWheelResults;
+		vector<physx::PxVehicleWheelQueryResult>::type			m_vehicleQueryResults;
+		vector<physx::PxVehicleWheelConcurrentUpdateData>::type	m_vehicleWheelUpdates;
+		vector<physx::PxVehicleConcurrentUpdateData>::type		m_vehicleUpdates;
 		physx::PxVehicleSceneQueryData*	m_vehicleSceneQueryData = nullptr;
 		physx::PxBatchQuery*			m_vehicleBatchQuery = nullptr;
 		physx::PxMaterial*				m_vehicleDefaultMaterial = nullptr;
 		PxVehicleSurfaceTireFriction*	m_vehicleFrictionPairs = nullptr;
 		float							m_stepLength = 0.025f;
 		float							m_accumulator = 0.f;
+		bool							m_isAsync = false;
+		bool							m_isInterpolate = true;
+		bool							m_isSimulating = false;
+		vector<PhysxBody*>::type		m_movingBodies;
+		PhysxQueryBatch					m_queryBatch;
 		PhysxDebugDraw*					m_debugDraw = nullptr;
 	};
 }
@@ -0,0 +1,124 @@
+#include "physx_query_batch.h"
+#include "../physx_body.h"
+#include "engine/core/thread/job_system.h"
+
+namespace Echo
+{
+	static physx::PxQueryFilterData makeFilterData(ui32 mask, bool isAnyHit)
+	{
+		physx::PxQueryFlags flags = physx::PxQueryFlag::eSTATIC | physx::PxQueryFlag::eDYNAMIC;
+		if (isAnyHit)
+			flags |= physx::PxQueryFlag::eANY_HIT;
+
+		return physx::PxQueryFilterData(physx::PxFilterData(mask, 0, 0, 0), flags);
+	}
+
+	PhysxQueryBatch::PhysxQueryBatch()
+	{
+	}
+
+	PhysxQueryBatch::~PhysxQueryBatch()
+	{
+	}
+
+	i32 PhysxQueryBatch::addRaycast(const Vector3& origin, const Vector3& unitDir, float distance, ui32 mask)
+	{
+		m_raycasts.push_back({ (const physx::PxVec3&)origin, (const physx::PxVec3&)unitDir, distance, mask });
+		return i32(m_raycasts.size()) - 1;
+	}
+
+	i32 PhysxQueryBatch::addSweep(const physx::PxGeometry& geometry, const Vector3& position, const Quaternion& rotation, const Vector3& unitDir, float distance, ui32 mask)
+	{
+		Shape query;
+		query.m_geometry.storeAny(geometry);
+		query.m_pose = physx::PxTransform((const physx::PxVec3&)position, (const physx::PxQuat&)rotation);
+		query.m_unitDir = (const physx::PxVec3&)unitDir;
+		query.m_distance = distance;
+		query.m_mask = mask;
+		m_sweeps.emplace_back(query);
+
+		return i32(m_sweeps.size()) - 1;
+	}
+
+	i32 PhysxQueryBatch::addOverlap(const physx::PxGeometry& geometry, const Vector3& position, const Quaternion& rotation, ui32 mask)
+	{
+		Shape query;
+		query.m_geometry.storeAny(geometry);
+		query.m_pose = physx::PxTransform((const physx::PxVec3&)position, (const physx::PxQuat&)rotation);
+		query.m_unitDir = physx::PxVec3(0.f);
+		query.m_distance = 0.f;
+		query.m_mask = mask;
+		m_overlaps.emplace_back(query);
+
+		return i32(m_overlaps.size()) - 1;
+	}
+
+	void PhysxQueryBatch::execute(physx::PxScene* scene, const Vector3& shift)
+	{
+		i32 raycastCount = i32(m_raycasts.size());
+		i32 sweepCount = i32(m_sweeps.size());
+		i32 overlapCount = i32(m_overlaps.size());
+
+		m_raycastHits.assign(raycastCount, Hit());
+		m_sweepHits.assign(sweepCount, Hit());
+		m_overlapHits.assign(overlapCount, Hit());
+
+		// scene reads are safe to run concurrently while nothing writes to it
+		if (scene)
+		{
+			const physx::PxVec3& pxShift = (const physx::PxVec3&)shift;
+			JobSystem::instance()->parallelFor(raycastCount + sweepCount + overlapCount, [&](i32 i)
+			{
+				if (i < raycastCount)
+					raycast(scene, pxShift, m_raycasts[i], m_raycastHits[i]);
+				else if (i < raycastCount + sweepCount)
+					sweep(scene, pxShift, m_sweeps[i - raycastCount], m_sweepHits[i - raycastCount]);
+				else
+					overlap(scene, pxShift, m_overlaps[i - raycastCount - sweepCount], m_overlapHits[i - raycastCount - sweepCount]);
+			}, 64);
+		}
+
+		m_raycasts.clear();
+		m_sweeps.clear();
+		m_overlaps.clear();
+	}
+
+	void PhysxQueryBatch::raycast(physx::PxScene* scene, const physx::PxVec3& shift, const Raycast& query, Hit& hit)
+	{
+		physx::PxRaycastBuffer buffer;
+		if (scene->raycast(query.m_origin + shift, query.m_unitDir, query.m_distance, buffer, physx::PxHitFlag::eDEFAULT, makeFilterData(query.m_mask, false)) && buffer.hasBlock)
+		{
+			hit.m_isHit = true;
+			hit.m_distance = buffer.block.distance;
+			hit.m_position = (const Vector3&)buffer.block.position - (const Vector3&)shift;
+			hit.m_normal = (const Vector3&)buffer.block.normal;
+			hit.m_body = buffer.block.actor ? static_cast<PhysxBody*>(buffer.block.actor->userData) : nullptr;
+		}
+	}
+
+	void PhysxQueryBatch::sweep(physx::PxScene* scene, const physx::PxVec3& shift, const Shape& query, Hit& hit)
+	{
+		physx::PxTransform pose(query.m_pose.p + shift, query.m_pose.q);
+		physx::PxSweepBuffer buffer;
+		if (scene->sweep(query.m_geometry.any(), pose, query.m_unitDir, query.m_distance, buffer, physx::PxHitFlag::eDEFAULT, makeFilterData(query.m_mask, false)) && buffer.hasBlock)
+		{
+			hit.m_isHit = true;
+			hit.m_distance = buffer.block.distance;
+			hit.m_position = (const Vector3&)buffer.block.position - (const Vector3&)shift;
+			hit.m_normal = (const Vector3&)buffer.block.normal;
+			hit.m_body = buffer.block.actor ? static_cast<PhysxBody*>(buffer.block.actor->userData) : nullptr;
+		}
+	}
+
+	void PhysxQueryBatch::overlap(physx::PxScene* scene, const physx::PxVec3& shift, const Shape& query, Hit& hit)
+	{
+		physx::PxTransform pose(query.m_pose.p + shift, query.m_pose.q);
+		physx::PxOverlapBuffer buffer;
+		if (scene->overlap(query.m_geometry.any(), pose, buffer, makeFilterData(query.m_mask, true)) && buffer.hasBlock)
+		{
+			hit.m_isHit = true;
+			hit.m_position = (const Vector3&)query.m_pose.p;
+			hit.m_body = buffer.block.actor ? static_cast<PhysxBody*>(buffer.block.actor->userData) : nullptr;
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../physx_base.h"
+#include "engine/core/math/Math.h"
+#include "engine/core/memory/MemAllocDef.h"
+
+namespace Echo
+{
+	class PhysxBody;
+
+	// Raycasts, sweeps and overlaps queued during the frame, executed together
+	// in one parallel pass after the simulation step. Results are flat arrays
+	// indexed by the value returned when the query was added.
+	class PhysxQueryBatch
+	{
+	public:
+		// Result of one query
+		struct Hit
+		{
+			bool		m_isHit = false;
+			float		m_distance = 0.f;
+			Vector3		m_position = Vector3::ZERO;
+			Vector3		m_normal = Vector3::ZERO;
+			PhysxBody*	m_body = nullptr;
+		};
+		typedef vector<Hit>::type HitArray;
+
+	public:
+		PhysxQueryBatch();
+		~PhysxQueryBatch();
+
+		// queue queries, mask is matched against the query layers of shapes (0 means all shapes)
+		i32 addRaycast(const Vector3& origin, const Vector3& unitDir, float distance, ui32 mask = 0);
+		i32 addSweep(const physx::PxGeometry& geometry, const Vector3& position, const Quaternion& rotation, const Vector3& unitDir, float distance, ui32 mask = 0);
+		i32 addOverlap(const physx::PxGeometry& geometry, const Vector3& position, const Quaternion& rotation, ui32 mask = 0);
+
+		// queued count
+		i32 getQueryCount() const { return i32(m_raycasts.size() + m_sweeps.size() + m_overlaps.size()); }
+
+		// run all queued queries, results stay valid until next execute
+		void execute(physx::PxScene* scene, const Vector3& shift);
+
+		// results of last execute
+		const HitArray& getRaycastHits() const { return m_raycastHits; }
+		const HitArray& getSweepHits() const { return m_sweepHits; }
+		const HitArray& getOverlapHits() const { return m_overlapHits; }
+
+	private:
+		struct Raycast
+		{
+			physx::PxVec3		m_origin;
+			physx::PxVec3		m_unitDir;
+			float				m_distance;
+			ui32				m_mask;
+		};
+
+		struct Shape
+		{
+			physx::PxGeometryHolder	m_geometry;
+			physx::PxTransform		m_pose;
+			physx::PxVec3			m_unitDir;
+			float					m_distance;
+			ui32					m_mask;
+		};
+
+		// run one query
+		void raycast(physx::PxScene* scene, const physx::PxVec3& shift, const Raycast& query, Hit& hit);
+		void sweep(physx::PxScene* scene, const physx::PxVec3& shift, const Shape& query, Hit& hit);
+		void overlap(physx::PxScene* scene, const physx::PxVec3& shift, const Shape& query, Hit& hit);
+
+	private:
+		vector<Raycast>::type	m_raycasts;
+		vector<Shape>::type		m_sweeps;
+		vector<Shape>::type		m_overlaps;
+		HitArray				m_raycastHits;
+		HitArray				m_sweepHits;
+		HitArray				m_overlapHits;
+	};
+}
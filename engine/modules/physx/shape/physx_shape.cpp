@@ -12,6 +12,11 @@ namespace Echo
 	}
 
 	PhysxShape::~PhysxShape()
+	{
+		releasePxShape();
+	}
+
+	void PhysxShape::releasePxShape()
 	{
 		if (m_pxShape)
 		{
@@ -27,7 +32,21 @@ namespace Echo
 
 	void PhysxShape::bindMethods()
 	{
+		CLASS_BIND_METHOD(PhysxShape, getQueryLayers);
+		CLASS_BIND_METHOD(PhysxShape, setQueryLayers);
+
+		CLASS_REGISTER_PROPERTY(PhysxShape, "QueryLayers", Variant::Type::Int, getQueryLayers, setQueryLayers);
+	}
 
+	void PhysxShape::setQueryLayers(i32 layers)
+	{
+		m_queryLayers = layers;
+		if (m_pxShape)
+		{
+			physx::PxFilterData filterData = m_pxShape->getQueryFilterData();
+			filterData.word0 = physx::PxU32(m_queryLayers);
+			m_pxShape->setQueryFilterData(filterData);
+		}
 	}
 
 	void PhysxShape::updateInternal(float elapsedTime)
@@ -46,6 +65,7 @@ namespace Echo
 						m_pxShape->setLocalPose(localTransform);
 
 						physx::PxFilterData filterData;
+						filterData.word0 = physx::PxU32(m_queryLayers);
 						filterData.word3 = 0xffff0000;
 						m_pxShape->setQueryFilterData(filterData);
 
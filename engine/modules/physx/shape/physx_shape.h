@@ -16,6 +16,10 @@ namespace Echo
 		// Sweep
 		virtual bool sweep(const Vector3& unitDir, float distance) { return false; }
 
+		// Query layers, bits matched against the mask of batched queries
+		i32 getQueryLayers() const { return m_queryLayers; }
+		void setQueryLayers(i32 layers);
+
 	protected:
 		// Update self
 		virtual void updateInternal(float elapsedTime) override;
@@ -23,8 +27,12 @@ namespace Echo
 		// Create shape
 		virtual physx::PxShape* createPxShape() { return nullptr; }
 
+		// Detach and release the shape, it is created again by the next update
+		void releasePxShape();
+
 	protected:
 		physx::PxMaterial*	m_pxMaterial = nullptr;
 		physx::PxShape*		m_pxShape = nullptr;
+		i32					m_queryLayers = 1;
 	};
 }
\ No newline at end of file
@@ -13,7 +13,11 @@ namespace Echo
 
 	PhysxShapeHeightfield::~PhysxShapeHeightfield()
 	{
-
+		if (m_pxHeightField)
+		{
+			m_pxHeightField->release();
+			m_pxHeightField = nullptr;
+		}
 	}
 
 	void PhysxShapeHeightfield::bindMethods()
@@ -29,42 +33,87 @@ namespace Echo
 		if (m_dataPath.setPath(path.getPath()))
 		{
 			String heightmapPath = m_dataPath.getPath() + "heightmap.png";
+			m_heightmapImage = nullptr;
 			if (IO::instance()->isExist(heightmapPath))
 			{
 				m_heightmapImage = Image::loadFromFile(heightmapPath);
 			}
+
+			releasePxShape();
+			if (m_pxHeightField)
+			{
+				m_pxHeightField->release();
+				m_pxHeightField = nullptr;
+			}
+
+			m_cookTask.reset();
 		}
 	}
 
-	physx::PxShape* PhysxShapeHeightfield::createPxShape()
+	void PhysxShapeHeightfield::startCooking()
 	{
-		using namespace physx;
+		struct Samples
+		{
+			i32										m_width = 0;
+			i32										m_height = 0;
+			vector<physx::PxHeightFieldSample>::type	m_samples;
+		};
 
-		PxPhysics* physics = PhysxModule::instance()->getPxPhysics();
-		if (physics && m_heightmapImage)
+		// copy samples on the main thread, the worker owns them from here
+		std::shared_ptr<Samples> samples = std::make_shared<Samples>();
+		samples->m_width = m_heightmapImage->getWidth();
+		samples->m_height = m_heightmapImage->getHeight();
+		samples->m_samples.resize(samples->m_width * samples->m_height);
+		for (i32 r = 0; r < samples->m_height; r++)
 		{
-			i32 bytes = sizeof(physx::PxHeightFieldSample) * m_heightmapImage->getWidth() * m_heightmapImage->getHeight();
-			physx::PxHeightFieldSample* samples = (physx::PxHeightFieldSample*)EchoMalloc(bytes);
-			for (i32 r = 0; r < m_heightmapImage->getHeight(); r++)
+			for (i32 w = 0; w < samples->m_width; w++)
 			{
-				for (i32 w = 0; w < m_heightmapImage->getWidth(); w++)
-				{
-					i32 offset = r * m_heightmapImage->getWidth() + w;
-					samples[offset].height = (m_heightmapImage->getColor(w, r, 0).r * 2.f - 1.f) * m_heightRange;
-					samples[offset].materialIndex0 = 0;
-					samples[offset].materialIndex1 = 0;
-				}
+				physx::PxHeightFieldSample& sample = samples->m_samples[r * samples->m_width + w];
+				sample.height = physx::PxI16((m_heightmapImage->getColor(w, r, 0).r * 2.f - 1.f) * m_heightRange);
+				sample.materialIndex0 = 0;
+				sample.materialIndex1 = 0;
 			}
+		}
+
+		PhysxCooker* cooker = PhysxModule::instance()->getCooker();
+		PhysxCooker::Hasher hasher = cooker->createHasher();
+		hasher.add(samples->m_width);
+		hasher.add(samples->m_height);
+		hasher.add(samples->m_samples.data(), samples->m_samples.size() * sizeof(physx::PxHeightFieldSample));
 
+		m_cookTask = cooker->cook(hasher.m_value, [samples](physx::PxCooking& cooking, physx::PxOutputStream& stream)
+		{
 			physx::PxHeightFieldDesc hfDesc;
 			hfDesc.format = physx::PxHeightFieldFormat::eS16_TM;
-			hfDesc.nbColumns = m_heightmapImage->getWidth();
-			hfDesc.nbRows = m_heightmapImage->getHeight();
-			hfDesc.samples.data = samples;
+			hfDesc.nbColumns = samples->m_width;
+			hfDesc.nbRows = samples->m_height;
+			hfDesc.samples.data = samples->m_samples.data();
 			hfDesc.samples.stride = sizeof(physx::PxHeightFieldSample);
 
-			m_pxHeightField = PhysxModule::instance()->getPxCooking()->createHeightField(hfDesc, physics->getPhysicsInsertionCallback());
+			return cooking.cookHeightField(hfDesc, stream);
+		});
+	}
 
+	physx::PxShape* PhysxShapeHeightfield::createPxShape()
+	{
+		using namespace physx;
+
+		PxPhysics* physics = PhysxModule::instance()->getPxPhysics();
+		if (physics && m_heightmapImage && !m_pxHeightField)
+		{
+			if (!m_cookTask)
+				startCooking();
+
+			if (!m_cookTask->m_isDone || !m_cookTask->m_isOk)
+				return nullptr;
+
+			PxDefaultMemoryInputData input(m_cookTask->m_data.data(), PxU32(m_cookTask->m_data.size()));
+			m_pxHeightField = physics->createHeightField(input);
+			m_cookTask->m_data.clear();
+		}
+
+		if (physics && m_pxHeightField)
+		{
 			physx::PxTransform pxTransform((physx::PxVec3&)getLocalPosition(), (physx::PxQuat&)getLocalOrientation());
 			PxShape* shape = physics->createShape(PxHeightFieldGeometry(m_pxHeightField, PxMeshGeometryFlags(), 1.f, 1.f, 1.f), *m_pxMaterial);
 			shape->setLocalPose(pxTransform);
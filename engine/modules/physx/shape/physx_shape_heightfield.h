@@ -1,6 +1,7 @@
 #pragma once
 
 #include "physx_shape.h"
+#include "../physx_cooker.h"
 
 namespace Echo
 {
@@ -17,12 +18,16 @@ namespace Echo
 		const ResourcePath& getDataPath() { return m_dataPath; }
 
 	protected:
-		// create shape
+		// create shape, returns nullptr until background cooking is done
 		virtual physx::PxShape* createPxShape() override;
 
+		// start cooking samples of the heightmap
+		void startCooking();
+
 	private:
 		ResourcePath            m_dataPath = ResourcePath("", "");
 		ImagePtr				m_heightmapImage;
+		PhysxCooker::TaskPtr	m_cookTask;
 		physx::PxHeightField*	m_pxHeightField = nullptr;
 		float					m_heightRange = 256.f;
 	};
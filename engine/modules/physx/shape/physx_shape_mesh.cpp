@@ -1,39 +1,92 @@
 #include "physx_shape_mesh.h"
 #include "../physx_module.h"
-#include "engine/core/io/io.h"
+#include "engine/core/render/base/mesh/mesh.h"
+#include "engine/core/log/Log.h"
 
 namespace Echo
 {
 	PhysxShapeMesh::PhysxShapeMesh()
 	{
-		// set default rotation
-		Quaternion quat; quat.fromAxisAngle(Vector3::UNIT_Z, Math::PI_DIV2);
-		setLocalOrientation(quat);
 	}
 
 	PhysxShapeMesh::~PhysxShapeMesh()
 	{
-
+		if (m_pxTriangleMesh)
+		{
+			m_pxTriangleMesh->release();
+			m_pxTriangleMesh = nullptr;
+		}
 	}
 
 	void PhysxShapeMesh::bindMethods()
 	{
-		CLASS_BIND_METHOD(PhysxShapeMesh, getDataPath);
-		CLASS_BIND_METHOD(PhysxShapeMesh, setDataPath);
+		CLASS_BIND_METHOD(PhysxShapeMesh, getMeshRes);
+		CLASS_BIND_METHOD(PhysxShapeMesh, setMeshRes);
 
-		CLASS_REGISTER_PROPERTY(PhysxShapeMesh, "Data", Variant::Type::ResourcePath, getDataPath, setDataPath);
+		CLASS_REGISTER_PROPERTY(PhysxShapeMesh, "Mesh", Variant::Type::ResourcePath, getMeshRes, setMeshRes);
 	}
 
-	void PhysxShapeMesh::setDataPath(const ResourcePath& path)
+	void PhysxShapeMesh::setMeshRes(const ResourcePath& path)
 	{
-		if (m_dataPath.setPath(path.getPath()))
+		if (m_meshRes.setPath(path.getPath()))
 		{
-			String heightmapPath = m_dataPath.getPath() + "heightmap.png";
-			if (IO::instance()->isExist(heightmapPath))
+			releasePxShape();
+			if (m_pxTriangleMesh)
 			{
-				m_heightmapImage = Image::loadFromFile(heightmapPath);
+				m_pxTriangleMesh->release();
+				m_pxTriangleMesh = nullptr;
 			}
+
+			m_cookTask.reset();
+		}
+	}
+
+	void PhysxShapeMesh::startCooking()
+	{
+		struct Geometry
+		{
+			vector<physx::PxVec3>::type	m_positions;
+			vector<ui32>::type			m_indices;
+		};
+
+		MeshPtr mesh = m_meshRes.isEmpty() ? nullptr : ECHO_DOWN_CAST<Mesh*>(Res::get(m_meshRes));
+		if (!mesh || mesh->getTopologyType() != Mesh::TT_TRIANGLELIST || !mesh->getIndexCount())
+		{
+			EchoLogError("Physx shape mesh [%s] needs a triangle list mesh", getNodePath().c_str());
+			m_cookTask = std::make_shared<PhysxCooker::Task>();
+			m_cookTask->m_isDone = true;
+			return;
 		}
+
+		// copy geometry on the main thread, the worker owns it from here
+		std::shared_ptr<Geometry> geometry = std::make_shared<Geometry>();
+		MeshVertexData& vertexData = mesh->getVertexData();
+		geometry->m_positions.resize(vertexData.getVertexCount());
+		for (ui32 i = 0; i < vertexData.getVertexCount(); i++)
+			geometry->m_positions[i] = (const physx::PxVec3&)vertexData.getPosition(i);
+
+		geometry->m_indices.resize(mesh->getIndexCount());
+		const Byte* indices = (const Byte*)mesh->getIndices();
+		for (ui32 i = 0; i < mesh->getIndexCount(); i++)
+			geometry->m_indices[i] = mesh->getIndexStride() == sizeof(ui32) ? ((const ui32*)indices)[i] : ((const ui16*)indices)[i];
+
+		PhysxCooker* cooker = PhysxModule::instance()->getCooker();
+		PhysxCooker::Hasher hasher = cooker->createHasher();
+		hasher.add(geometry->m_positions.data(), geometry->m_positions.size() * sizeof(physx::PxVec3));
+		hasher.add(geometry->m_indices.data(), geometry->m_indices.size() * sizeof(ui32));
+
+		m_cookTask = cooker->cook(hasher.m_value, [geometry](physx::PxCooking& cooking, physx::PxOutputStream& stream)
+		{
+			physx::PxTriangleMeshDesc meshDesc;
+			meshDesc.points.count = physx::PxU32(geometry->m_positions.size());
+			meshDesc.points.stride = sizeof(physx::PxVec3);
+			meshDesc.points.data = geometry->m_positions.data();
+			meshDesc.triangles.count = physx::PxU32(geometry->m_indices.size() / 3);
+			meshDesc.triangles.stride = 3 * sizeof(ui32);
+			meshDesc.triangles.data = geometry->m_indices.data();
+
+			return cooking.cookTriangleMesh(meshDesc, stream);
+		});
 	}
 
 	physx::PxShape* PhysxShapeMesh::createPxShape()
@@ -41,37 +94,26 @@ namespace Echo
 		using namespace physx;
 
 		PxPhysics* physics = PhysxModule::instance()->getPxPhysics();
-		if (physics && m_heightmapImage)
+		if (physics && !m_pxTriangleMesh)
 		{
-			i32 bytes = sizeof(physx::PxHeightFieldSample) * m_heightmapImage->getWidth() * m_heightmapImage->getHeight();
-			physx::PxHeightFieldSample* samples = (physx::PxHeightFieldSample*)EchoMalloc(bytes);
-			for (i32 r = 0; r < m_heightmapImage->getHeight(); r++)
-			{
-				for (i32 w = 0; w < m_heightmapImage->getWidth(); w++)
-				{
-					i32 offset = r * m_heightmapImage->getWidth() + w;
-					samples[offset].height = m_heightmapImage->getColor(w, r, 0).r * 65535;
-					samples[offset].materialIndex0 = 0;
-					samples[offset].materialIndex1 = 0;
-				}
-			}
-
-			physx::PxHeightFieldDesc hfDesc;
-			hfDesc.format = physx::PxHeightFieldFormat::eS16_TM;
-			hfDesc.nbColumns = m_heightmapImage->getWidth();
-			hfDesc.nbRows = m_heightmapImage->getHeight();
-			hfDesc.samples.data = samples;
-			hfDesc.samples.stride = sizeof(physx::PxHeightFieldSample);
+			if (!m_cookTask)
+				startCooking();
 
-			m_pxHeightField = PhysxModule::instance()->getPxCooking()->createHeightField(hfDesc, physics->getPhysicsInsertionCallback());
+			if (!m_cookTask->m_isDone || !m_cookTask->m_isOk)
+				return nullptr;
 
-			physx::PxTransform pxTransform((physx::PxVec3&)getLocalPosition(), (physx::PxQuat&)getLocalOrientation());
-			PxShape* shape = physics->createShape(PxHeightFieldGeometry(m_pxHeightField, PxMeshGeometryFlags(), 1.f, 1.f, 1.f), *m_pxMaterial);
-			shape->setLocalPose(pxTransform);
+			PxDefaultMemoryInputData input(m_cookTask->m_data.data(), PxU32(m_cookTask->m_data.size()));
+			m_pxTriangleMesh = physics->createTriangleMesh(input);
+			m_cookTask->m_data.clear();
+		}
 
+		if (physics && m_pxTriangleMesh)
+		{
+			PxMeshScale scale((const PxVec3&)getLocalScaling(), PxQuat(PxIdentity));
+			PxShape* shape = physics->createShape(PxTriangleMeshGeometry(m_pxTriangleMesh, scale), *m_pxMaterial);
 			return shape;
 		}
 
 		return nullptr;
 	}
-}
\ No newline at end of file
+}
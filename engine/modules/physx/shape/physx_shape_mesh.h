@@ -1,6 +1,7 @@
 #pragma once
 
 #include "physx_shape.h"
+#include "../physx_cooker.h"
 
 namespace Echo
 {
@@ -12,17 +13,20 @@ namespace Echo
 		PhysxShapeMesh();
 		virtual ~PhysxShapeMesh();
 
-		// font res path
-		void setDataPath(const ResourcePath& path);
-		const ResourcePath& getDataPath() { return m_dataPath; }
+		// mesh res path
+		void setMeshRes(const ResourcePath& path);
+		const ResourcePath& getMeshRes() { return m_meshRes; }
 
 	protected:
-		// create shape
+		// create shape, returns nullptr until background cooking is done
 		virtual physx::PxShape* createPxShape() override;
 
+		// start cooking triangles of the mesh
+		void startCooking();
+
 	private:
-		ResourcePath            m_dataPath = ResourcePath("", "");
-		ImagePtr				m_heightmapImage;
-		physx::PxHeightField*	m_pxHeightField = nullptr;
+		ResourcePath				m_meshRes = ResourcePath("", ".mesh");
+		PhysxCooker::TaskPtr		m_cookTask;
+		physx::PxTriangleMesh*		m_pxTriangleMesh = nullptr;
 	};
-}
\ No newline at end of file
+}
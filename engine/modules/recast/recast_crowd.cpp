@@ -0,0 +1,195 @@
+#include "recast_crowd.h"
+#include "recast_crowd_agent.h"
+#include "recast_nav_builder.h"
+#include <DetourCommon.h>
+
+namespace Echo
+{
+	RecastCrowd::RecastCrowd(dtNavMesh* navMesh, RecastPathService* pathService, i32 maxAgents, float maxAgentRadius)
+		: m_pathService(pathService)
+	{
+		m_crowd = dtAllocCrowd();
+		m_crowd->init(maxAgents, maxAgentRadius, navMesh);
+		m_crowd->getEditableFilter(0)->setIncludeFlags(ui16(RecastNavFlag::All) ^ ui16(RecastNavFlag::Disabled));
+		m_slots.resize(maxAgents);
+		m_activeAgents.resize(maxAgents);
+	}
+
+	RecastCrowd::~RecastCrowd()
+	{
+		// agents attach again to the next crowd
+		for (Slot& slot : m_slots)
+		{
+			if (slot.m_agent)
+				slot.m_agent->onCrowdDetached();
+		}
+
+		dtFreeCrowd(m_crowd);
+	}
+
+	void RecastCrowd::getAgentParams(RecastCrowdAgent* agent, dtCrowdAgentParams& params)
+	{
+		memset(&params, 0, sizeof(params));
+		params.radius = agent->getRadius();
+		params.height = agent->getHeight();
+		params.maxSpeed = agent->getMaxSpeed();
+		params.maxAcceleration = agent->getMaxAcceleration();
+		params.collisionQueryRange = params.radius * 12.f;
+		params.pathOptimizationRange = params.radius * 30.f;
+		params.separationWeight = 2.f;
+		params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO;
+		params.obstacleAvoidanceType = 0;
+		params.queryFilterType = 0;
+		params.userData = agent;
+	}
+
+	i32 RecastCrowd::addAgent(RecastCrowdAgent* agent)
+	{
+		dtCrowdAgentParams params;
+		getAgentParams(agent, params);
+
+		const Vector3& position = agent->getWorldPosition();
+		i32 index = m_crowd->addAgent(&position.x, &params);
+		if (index >= 0)
+		{
+			m_slots[index] = Slot();
+			m_slots[index].m_agent = agent;
+		}
+
+		return index;
+	}
+
+	void RecastCrowd::removeAgent(i32 index)
+	{
+		if (index >= 0 && index < i32(m_slots.size()))
+		{
+			Slot& slot = m_slots[index];
+			if (slot.m_pathRequest)
+				m_pathService->cancel(slot.m_pathRequest);
+
+			slot = Slot();
+			m_crowd->removeAgent(index);
+		}
+	}
+
+	void RecastCrowd::updateAgentParams(i32 index)
+	{
+		dtCrowdAgentParams params;
+		getAgentParams(m_slots[index].m_agent, params);
+		m_crowd->updateAgentParameters(index, &params);
+	}
+
+	void RecastCrowd::requestMoveTarget(i32 index, const Vector3& target)
+	{
+		// only the latest target of a frame is searched
+		Slot& slot = m_slots[index];
+		slot.m_target = target;
+		slot.m_isTargetDirty = true;
+	}
+
+	void RecastCrowd::resetMoveTarget(i32 index)
+	{
+		Slot& slot = m_slots[index];
+		if (slot.m_pathRequest)
+		{
+			m_pathService->cancel(slot.m_pathRequest);
+			slot.m_pathRequest = 0;
+		}
+
+		slot.m_isTargetDirty = false;
+		m_crowd->resetMoveTarget(index);
+	}
+
+	void RecastCrowd::preUpdate()
+	{
+		for (i32 i = 0; i < i32(m_slots.size()); i++)
+		{
+			Slot& slot = m_slots[i];
+			if (slot.m_isTargetDirty)
+			{
+				if (slot.m_pathRequest)
+					m_pathService->cancel(slot.m_pathRequest);
+				else
+					m_waitingSlots.emplace_back(i);
+
+				// path starts where the crowd has the agent, it keeps its old corridor meanwhile
+				const dtCrowdAgent* agent = m_crowd->getAgent(i);
+				slot.m_pathRequest = m_pathService->request(Vector3(agent->npos[0], agent->npos[1], agent->npos[2]), slot.m_target, m_crowd->getFilter(0));
+				slot.m_isTargetDirty = false;
+			}
+		}
+	}
+
+	bool RecastCrowd::applyPath(i32 index, RecastPathService::Result& result)
+	{
+		dtCrowdAgent* agent = m_crowd->getEditableAgent(index);
+		vector<dtPolyRef>::type& path = result.m_path;
+		if (path.empty() || agent->state != DT_CROWDAGENT_STATE_WALKING)
+			return false;
+
+		// agent may have left the start polygon while the request was searched
+		vector<dtPolyRef>::type::iterator it = std::find(path.begin(), path.end(), agent->corridor.getFirstPoly());
+		if (it == path.end())
+			return false;
+
+		path.erase(path.begin(), it);
+
+		// partial path, constrain target inside the last polygon
+		float target[3];
+		dtVcopy(target, &result.m_end.x);
+		agent->partial = path.back() != result.m_endRef;
+		if (agent->partial && dtStatusFailed(m_crowd->getNavMeshQuery()->closestPointOnPoly(path.back(), &result.m_end.x, target, nullptr)))
+			return false;
+
+		agent->corridor.setCorridor(target, path.data(), i32(path.size()));
+		agent->boundary.reset();
+		agent->targetRef = result.m_endRef;
+		dtVcopy(agent->targetPos, &result.m_end.x);
+		agent->targetPathqRef = DT_PATHQ_INVALID;
+		agent->targetReplan = false;
+		agent->targetReplanTime = 0.f;
+		agent->targetState = DT_CROWDAGENT_TARGET_VALID;
+
+		return true;
+	}
+
+	void RecastCrowd::update(float elapsedTime)
+	{
+		// only agents waiting for a path are visited
+		for (size_t i = 0; i < m_waitingSlots.size();)
+		{
+			Slot& slot = m_slots[m_waitingSlots[i]];
+			RecastPathService::Result result;
+			if (slot.m_pathRequest && m_pathService->fetch(slot.m_pathRequest, result))
+			{
+				slot.m_pathRequest = 0;
+				if (!applyPath(m_waitingSlots[i], result) && dtStatusSucceed(result.m_status) && slot.m_agent)
+				{
+					// search again from the current position
+					slot.m_isTargetDirty = true;
+				}
+			}
+
+			if (!slot.m_pathRequest)
+			{
+				m_waitingSlots[i] = m_waitingSlots.back();
+				m_waitingSlots.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		m_crowd->update(elapsedTime, nullptr);
+
+		// write back in one pass over active agents
+		i32 count = m_crowd->getActiveAgents(m_activeAgents.data(), i32(m_activeAgents.size()));
+		for (i32 i = 0; i < count; i++)
+		{
+			const dtCrowdAgent* agent = m_activeAgents[i];
+			RecastCrowdAgent* node = static_cast<RecastCrowdAgent*>(agent->params.userData);
+			node->onCrowdMoved(Vector3(agent->npos[0], agent->npos[1], agent->npos[2]), Vector3(agent->vel[0], agent->vel[1], agent->vel[2]));
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "recast_path_service.h"
+#include <DetourCrowd.h>
+
+namespace Echo
+{
+	class RecastCrowdAgent;
+
+	// dtCrowd of one nav mesh. Long paths come from the path service,
+	// agents are simulated in one batch and their nodes written back in bulk
+	class RecastCrowd
+	{
+	public:
+		RecastCrowd(dtNavMesh* navMesh, RecastPathService* pathService, i32 maxAgents, float maxAgentRadius);
+		~RecastCrowd();
+
+		// agents, index is -1 if the crowd is full or the position is off the nav mesh
+		i32 addAgent(RecastCrowdAgent* agent);
+		void removeAgent(i32 index);
+		void updateAgentParams(i32 index);
+
+		// move target, searched by the path service
+		void requestMoveTarget(i32 index, const Vector3& target);
+		void resetMoveTarget(i32 index);
+
+		// is agent waiting for its path
+		bool isPathPending(i32 index) const { return m_slots[index].m_pathRequest != 0; }
+
+		// main thread nav mesh query
+		const dtNavMeshQuery* getNavMeshQuery() const { return m_crowd->getNavMeshQuery(); }
+
+		// issue path requests, before the path service update
+		void preUpdate();
+
+		// apply finished paths, simulate and write agent transforms
+		void update(float elapsedTime);
+
+	private:
+		// agent slot
+		struct Slot
+		{
+			RecastCrowdAgent*	m_agent = nullptr;
+			Vector3				m_target = Vector3::ZERO;
+			bool				m_isTargetDirty = false;
+			ui32				m_pathRequest = 0;
+		};
+		typedef vector<Slot>::type SlotArray;
+
+		// install a polygon corridor to the agent
+		bool applyPath(i32 index, RecastPathService::Result& result);
+
+		// crowd agent params of agent node
+		static void getAgentParams(RecastCrowdAgent* agent, dtCrowdAgentParams& params);
+
+	private:
+		dtCrowd*					m_crowd = nullptr;
+		RecastPathService*			m_pathService = nullptr;
+		SlotArray					m_slots;
+		vector<i32>::type			m_waitingSlots;
+		vector<dtCrowdAgent*>::type	m_activeAgents;
+	};
+}
@@ -1,9 +1,132 @@
 #include "recast_crowd_agent.h"
+#include "recast_crowd.h"
+#include "recast_nav_mesh.h"
 
 namespace Echo
 {
+	RecastCrowdAgent::RecastCrowdAgent()
+	{
+	}
+
+	RecastCrowdAgent::~RecastCrowdAgent()
+	{
+		if (m_crowd)
+			m_crowd->removeAgent(m_index);
+	}
+
 	void RecastCrowdAgent::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastCrowdAgent, getRadius);
+		CLASS_BIND_METHOD(RecastCrowdAgent, setRadius);
+		CLASS_BIND_METHOD(RecastCrowdAgent, getHeight);
+		CLASS_BIND_METHOD(RecastCrowdAgent, setHeight);
+		CLASS_BIND_METHOD(RecastCrowdAgent, getMaxSpeed);
+		CLASS_BIND_METHOD(RecastCrowdAgent, setMaxSpeed);
+		CLASS_BIND_METHOD(RecastCrowdAgent, getMaxAcceleration);
+		CLASS_BIND_METHOD(RecastCrowdAgent, setMaxAcceleration);
+		CLASS_BIND_METHOD(RecastCrowdAgent, requestMoveTarget);
+		CLASS_BIND_METHOD(RecastCrowdAgent, resetMoveTarget);
+		CLASS_BIND_METHOD(RecastCrowdAgent, getVelocity);
+		CLASS_BIND_METHOD(RecastCrowdAgent, isPathPending);
+
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "Radius", Variant::Type::Real, getRadius, setRadius);
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "Height", Variant::Type::Real, getHeight, setHeight);
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "MaxSpeed", Variant::Type::Real, getMaxSpeed, setMaxSpeed);
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "MaxAcceleration", Variant::Type::Real, getMaxAcceleration, setMaxAcceleration);
+	}
+
+	void RecastCrowdAgent::setRadius(float radius)
+	{
+		m_radius = std::max<float>(radius, 0.f);
+		onParamsChanged();
+	}
+
+	void RecastCrowdAgent::setHeight(float height)
+	{
+		m_height = std::max<float>(height, 0.f);
+		onParamsChanged();
+	}
+
+	void RecastCrowdAgent::setMaxSpeed(float maxSpeed)
+	{
+		m_maxSpeed = std::max<float>(maxSpeed, 0.f);
+		onParamsChanged();
+	}
+
+	void RecastCrowdAgent::setMaxAcceleration(float maxAcceleration)
+	{
+		m_maxAcceleration = std::max<float>(maxAcceleration, 0.f);
+		onParamsChanged();
+	}
+
+	void RecastCrowdAgent::onParamsChanged()
+	{
+		if (m_crowd)
+			m_crowd->updateAgentParams(m_index);
+	}
+
+	void RecastCrowdAgent::requestMoveTarget(const Vector3& target)
+	{
+		m_target = target;
+		m_hasTarget = true;
+		if (m_crowd)
+			m_crowd->requestMoveTarget(m_index, target);
+	}
+
+	void RecastCrowdAgent::resetMoveTarget()
+	{
+		m_hasTarget = false;
+		if (m_crowd)
+			m_crowd->resetMoveTarget(m_index);
+	}
+
+	bool RecastCrowdAgent::isPathPending() const
+	{
+		return m_crowd ? m_crowd->isPathPending(m_index) : m_hasTarget;
+	}
+
+	void RecastCrowdAgent::onCrowdMoved(const Vector3& position, const Vector3& velocity)
+	{
+		m_velocity = velocity;
+		if (position != getWorldPosition())
+			setWorldPosition(position);
+	}
+
+	void RecastCrowdAgent::onCrowdDetached()
+	{
+		m_crowd = nullptr;
+		m_index = -1;
+		m_velocity = Vector3::ZERO;
+	}
+
+	RecastNavMesh* RecastCrowdAgent::getNavMesh()
+	{
+		for (Node* node = getParent(); node; node = node->getParent())
+		{
+			if (RecastNavMesh* navMesh = dynamic_cast<RecastNavMesh*>(node))
+				return navMesh;
+		}
+
+		return nullptr;
+	}
+
+	void RecastCrowdAgent::updateInternal(float elapsedTime)
+	{
+		// attached agents are moved by the crowd update of the nav mesh
+		if (m_crowd)
+			return;
 
+		RecastNavMesh* navMesh = getNavMesh();
+		RecastCrowd* crowd = navMesh ? navMesh->getCrowd() : nullptr;
+		if (crowd)
+		{
+			m_index = crowd->addAgent(this);
+			if (m_index >= 0)
+			{
+				m_crowd = crowd;
+				if (m_hasTarget)
+					m_crowd->requestMoveTarget(m_index, m_target);
+			}
+		}
 	}
-}
\ No newline at end of file
+}
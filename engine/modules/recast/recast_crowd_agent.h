@@ -4,10 +4,66 @@
 
 namespace Echo
 {
+	class RecastCrowd;
+	class RecastNavMesh;
 	class RecastCrowdAgent : public Node
 	{
 		ECHO_CLASS(RecastCrowdAgent, Node)
 
 	public:
+		RecastCrowdAgent();
+		virtual ~RecastCrowdAgent();
+
+		// radius
+		float getRadius() const { return m_radius; }
+		void setRadius(float radius);
+
+		// height
+		float getHeight() const { return m_height; }
+		void setHeight(float height);
+
+		// max speed
+		float getMaxSpeed() const { return m_maxSpeed; }
+		void setMaxSpeed(float maxSpeed);
+
+		// max acceleration
+		float getMaxAcceleration() const { return m_maxAcceleration; }
+		void setMaxAcceleration(float maxAcceleration);
+
+		// move to target, the path is searched time sliced by the nav mesh path service
+		void requestMoveTarget(const Vector3& target);
+		void resetMoveTarget();
+
+		// velocity
+		const Vector3& getVelocity() const { return m_velocity; }
+
+		// is waiting for its path
+		bool isPathPending() const;
+
+	public:
+		// called by crowd
+		void onCrowdMoved(const Vector3& position, const Vector3& velocity);
+		void onCrowdDetached();
+
+	protected:
+		// update
+		virtual void updateInternal(float elapsedTime) override;
+
+		// nearest nav mesh ancestor
+		RecastNavMesh* getNavMesh();
+
+		// params changed
+		void onParamsChanged();
+
+	private:
+		float			m_radius = 0.6f;
+		float			m_height = 2.f;
+		float			m_maxSpeed = 3.5f;
+		float			m_maxAcceleration = 8.f;
+		RecastCrowd*	m_crowd = nullptr;
+		i32				m_index = -1;
+		Vector3			m_target = Vector3::ZERO;
+		bool			m_hasTarget = false;
+		Vector3			m_velocity = Vector3::ZERO;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,262 @@
+#include "recast_nav_builder.h"
+#include "engine/core/thread/job_system.h"
+#include "engine/core/log/Log.h"
+#include <Recast.h>
+#include <DetourCommon.h>
+#include "zlib/zlib.h"
+
+namespace Echo
+{
+	void RecastNavGeometry::addTriangles(const Vector3* positions, i32 positionCount, const ui32* indices, i32 indexCount, const Matrix4& matrix)
+	{
+		i32 base = i32(m_vertices.size() / 3);
+		for (i32 i = 0; i < positionCount; i++)
+		{
+			Vector3 position = positions[i] * matrix;
+			m_vertices.insert(m_vertices.end(), { position.x, position.y, position.z });
+			m_box.addPoint(position);
+		}
+
+		for (i32 i = 0; i + 2 < indexCount; i += 3)
+		{
+			m_indices.insert(m_indices.end(), { base + i32(indices[i]), base + i32(indices[i + 1]), base + i32(indices[i + 2]) });
+		}
+	}
+
+	int RecastNavCompressor::maxCompressedSize(const int bufferSize)
+	{
+		return int(compressBound(uLong(bufferSize)));
+	}
+
+	dtStatus RecastNavCompressor::compress(const unsigned char* buffer, const int bufferSize, unsigned char* compressed, const int maxCompressedSize, int* compressedSize)
+	{
+		uLongf size = uLongf(maxCompressedSize);
+		if (compress2(compressed, &size, buffer, uLong(bufferSize), Z_BEST_SPEED) != Z_OK)
+			return DT_FAILURE;
+
+		*compressedSize = int(size);
+		return DT_SUCCESS;
+	}
+
+	dtStatus RecastNavCompressor::decompress(const unsigned char* compressed, const int compressedSize, unsigned char* buffer, const int maxBufferSize, int* bufferSize)
+	{
+		uLongf size = uLongf(maxBufferSize);
+		if (uncompress(buffer, &size, compressed, uLong(compressedSize)) != Z_OK)
+			return DT_FAILURE;
+
+		*bufferSize = int(size);
+		return DT_SUCCESS;
+	}
+
+	void RecastNavBuilder::getTileGrid(const RecastNavSettings& settings, const AABB& box, i32& tileWidth, i32& tileHeight)
+	{
+		i32 gridWidth = 0;
+		i32 gridHeight = 0;
+		rcCalcGridSize(&box.vMin.x, &box.vMax.x, settings.m_cellSize, &gridWidth, &gridHeight);
+
+		tileWidth = (gridWidth + settings.m_tileSize - 1) / settings.m_tileSize;
+		tileHeight = (gridHeight + settings.m_tileSize - 1) / settings.m_tileSize;
+	}
+
+	void RecastNavBuilder::getTileCacheParams(const RecastNavSettings& settings, const AABB& box, dtTileCacheParams& params)
+	{
+		i32 tileWidth = 0;
+		i32 tileHeight = 0;
+		getTileGrid(settings, box, tileWidth, tileHeight);
+
+		memset(&params, 0, sizeof(params));
+		dtVcopy(params.orig, &box.vMin.x);
+		params.cs = settings.m_cellSize;
+		params.ch = settings.m_cellHeight;
+		params.width = settings.m_tileSize;
+		params.height = settings.m_tileSize;
+		params.walkableHeight = settings.m_agentHeight;
+		params.walkableRadius = settings.m_agentRadius;
+		params.walkableClimb = settings.m_agentMaxClimb;
+		params.maxSimplificationError = settings.m_edgeMaxError;
+		params.maxTiles = tileWidth * tileHeight * 4;
+		params.maxObstacles = settings.m_maxObstacles;
+	}
+
+	bool RecastNavBuilder::build(const RecastNavSettings& settings, const RecastNavGeometry& geometry, const RecastNavVolumes& volumes, RecastNavTileLayers& layers)
+	{
+		layers.clear();
+		if (geometry.m_indices.empty())
+			return false;
+
+		i32 tileWidth = 0;
+		i32 tileHeight = 0;
+		getTileGrid(settings, geometry.m_box, tileWidth, tileHeight);
+
+		// bucket triangles by the tiles they touch, border included
+		const float tileWorldSize = settings.m_tileSize * settings.m_cellSize;
+		const float border = (ceilf(settings.m_agentRadius / settings.m_cellSize) + 3.f) * settings.m_cellSize;
+		const float* origin = &geometry.m_box.vMin.x;
+		vector<vector<i32>::type>::type tileTriangles(tileWidth * tileHeight);
+		for (size_t t = 0; t < geometry.m_indices.size() / 3; t++)
+		{
+			float minX = Math::MAX_REAL, minZ = Math::MAX_REAL, maxX = -Math::MAX_REAL, maxZ = -Math::MAX_REAL;
+			for (i32 k = 0; k < 3; k++)
+			{
+				const float* v = &geometry.m_vertices[geometry.m_indices[t * 3 + k] * 3];
+				minX = std::min<float>(minX, v[0]); maxX = std::max<float>(maxX, v[0]);
+				minZ = std::min<float>(minZ, v[2]); maxZ = std::max<float>(maxZ, v[2]);
+			}
+
+			i32 x0 = Math::Clamp<i32>(i32(floorf((minX - border - origin[0]) / tileWorldSize)), 0, tileWidth - 1);
+			i32 x1 = Math::Clamp<i32>(i32(floorf((maxX + border - origin[0]) / tileWorldSize)), 0, tileWidth - 1);
+			i32 z0 = Math::Clamp<i32>(i32(floorf((minZ - border - origin[2]) / tileWorldSize)), 0, tileHeight - 1);
+			i32 z1 = Math::Clamp<i32>(i32(floorf((maxZ + border - origin[2]) / tileWorldSize)), 0, tileHeight - 1);
+			for (i32 z = z0; z <= z1; z++)
+			{
+				for (i32 x = x0; x <= x1; x++)
+					tileTriangles[z * tileWidth + x].emplace_back(i32(t));
+			}
+		}
+
+		// tiles are independent
+		vector<RecastNavTileLayers>::type tileLayers(tileWidth * tileHeight);
+		std::atomic<i32> failedCount(0);
+		JobSystem::instance()->parallelFor(tileWidth * tileHeight, [&](i32 i)
+		{
+			if (!tileTriangles[i].empty())
+			{
+				if (!buildTile(settings, geometry, tileTriangles[i], volumes, i % tileWidth, i / tileWidth, tileLayers[i]))
+					failedCount++;
+			}
+		});
+
+		for (RecastNavTileLayers& tile : tileLayers)
+		{
+			for (RecastNavTileLayer& layer : tile)
+				layers.emplace_back(std::move(layer));
+		}
+
+		if (failedCount)
+			EchoLogError("Recast navigation mesh: %d tiles failed to build", failedCount.load());
+
+		return failedCount == 0;
+	}
+
+	bool RecastNavBuilder::buildTile(const RecastNavSettings& settings, const RecastNavGeometry& geometry, const vector<i32>::type& triangles, const RecastNavVolumes& volumes, i32 tx, i32 ty, RecastNavTileLayers& layers)
+	{
+		rcConfig cfg;
+		memset(&cfg, 0, sizeof(cfg));
+		cfg.cs = settings.m_cellSize;
+		cfg.ch = settings.m_cellHeight;
+		cfg.walkableSlopeAngle = settings.m_agentMaxSlope;
+		cfg.walkableHeight = i32(ceilf(settings.m_agentHeight / cfg.ch));
+		cfg.walkableClimb = i32(floorf(settings.m_agentMaxClimb / cfg.ch));
+		cfg.walkableRadius = i32(ceilf(settings.m_agentRadius / cfg.cs));
+		cfg.maxEdgeLen = i32(12.f / cfg.cs);
+		cfg.maxSimplificationError = settings.m_edgeMaxError;
+		cfg.minRegionArea = 8 * 8;
+		cfg.mergeRegionArea = 20 * 20;
+		cfg.maxVertsPerPoly = DT_VERTS_PER_POLYGON;
+		cfg.tileSize = settings.m_tileSize;
+		cfg.borderSize = cfg.walkableRadius + 3;
+		cfg.width = cfg.tileSize + cfg.borderSize * 2;
+		cfg.height = cfg.tileSize + cfg.borderSize * 2;
+		cfg.detailSampleDist = cfg.cs * 6.f;
+		cfg.detailSampleMaxError = cfg.ch;
+
+		const float tileWorldSize = cfg.tileSize * cfg.cs;
+		rcVcopy(cfg.bmin, &geometry.m_box.vMin.x);
+		rcVcopy(cfg.bmax, &geometry.m_box.vMax.x);
+		cfg.bmin[0] += tx * tileWorldSize - cfg.borderSize * cfg.cs;
+		cfg.bmin[2] += ty * tileWorldSize - cfg.borderSize * cfg.cs;
+		cfg.bmax[0] = geometry.m_box.vMin.x + (tx + 1) * tileWorldSize + cfg.borderSize * cfg.cs;
+		cfg.bmax[2] = geometry.m_box.vMin.z + (ty + 1) * tileWorldSize + cfg.borderSize * cfg.cs;
+
+		// every worker has its own context
+		rcContext ctx(false);
+		rcHeightfield* solid = rcAllocHeightfield();
+		rcCompactHeightfield* chf = nullptr;
+		rcHeightfieldLayerSet* lset = nullptr;
+		bool result = false;
+
+		do
+		{
+			if (!solid || !rcCreateHeightfield(&ctx, *solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
+				break;
+
+			vector<i32>::type tileIndices;
+			tileIndices.reserve(triangles.size() * 3);
+			for (i32 t : triangles)
+				tileIndices.insert(tileIndices.end(), geometry.m_indices.begin() + t * 3, geometry.m_indices.begin() + t * 3 + 3);
+
+			i32 vertexCount = i32(geometry.m_vertices.size() / 3);
+			i32 triangleCount = i32(triangles.size());
+			vector<unsigned char>::type triangleAreas(triangleCount, RC_NULL_AREA);
+			rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, geometry.m_vertices.data(), vertexCount, tileIndices.data(), triangleCount, triangleAreas.data());
+			if (!rcRasterizeTriangles(&ctx, geometry.m_vertices.data(), vertexCount, tileIndices.data(), triangleAreas.data(), triangleCount, *solid, cfg.walkableClimb))
+				break;
+
+			rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *solid);
+			rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid);
+			rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *solid);
+
+			chf = rcAllocCompactHeightfield();
+			if (!chf || !rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid, *chf))
+				break;
+
+			if (!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf))
+				break;
+
+			for (const RecastNavVolume& volume : volumes)
+			{
+				// recast wants xyz vertices
+				vector<float>::type vertices;
+				for (size_t i = 0; i + 1 < volume.m_vertices.size(); i += 2)
+					vertices.insert(vertices.end(), { volume.m_vertices[i], volume.m_minHeight, volume.m_vertices[i + 1] });
+
+				rcMarkConvexPolyArea(&ctx, vertices.data(), i32(vertices.size() / 3), volume.m_minHeight, volume.m_maxHeight, (unsigned char)volume.m_area, *chf);
+			}
+
+			lset = rcAllocHeightfieldLayerSet();
+			if (!lset || !rcBuildHeightfieldLayers(&ctx, *chf, cfg.borderSize, cfg.walkableHeight, *lset))
+				break;
+
+			RecastNavCompressor compressor;
+			result = true;
+			for (i32 i = 0; i < lset->nlayers && result; i++)
+			{
+				const rcHeightfieldLayer& layer = lset->layers[i];
+
+				dtTileCacheLayerHeader header;
+				header.magic = DT_TILECACHE_MAGIC;
+				header.version = DT_TILECACHE_VERSION;
+				header.tx = tx;
+				header.ty = ty;
+				header.tlayer = i;
+				dtVcopy(header.bmin, layer.bmin);
+				dtVcopy(header.bmax, layer.bmax);
+				header.width = (unsigned char)layer.width;
+				header.height = (unsigned char)layer.height;
+				header.minx = (unsigned char)layer.minx;
+				header.maxx = (unsigned char)layer.maxx;
+				header.miny = (unsigned char)layer.miny;
+				header.maxy = (unsigned char)layer.maxy;
+				header.hmin = (unsigned short)layer.hmin;
+				header.hmax = (unsigned short)layer.hmax;
+
+				unsigned char* data = nullptr;
+				int dataSize = 0;
+				if (dtStatusFailed(dtBuildTileCacheLayer(&compressor, &header, layer.heights, layer.areas, layer.cons, &data, &dataSize)))
+				{
+					result = false;
+					break;
+				}
+
+				layers.emplace_back(data, data + dataSize);
+				dtFree(data);
+			}
+		} while (false);
+
+		rcFreeHeightfieldLayerSet(lset);
+		rcFreeCompactHeightfield(chf);
+		rcFreeHeightField(solid);
+
+		return result;
+	}
+}
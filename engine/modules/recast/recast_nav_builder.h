@@ -0,0 +1,98 @@
+#pragma once
+
+#include "engine/core/memory/MemAllocDef.h"
+#include "engine/core/math/Math.h"
+#include "engine/core/geom/AABB.h"
+#include <DetourTileCache.h>
+#include <DetourTileCacheBuilder.h>
+#include <DetourNavMesh.h>
+
+namespace Echo
+{
+	// Poly areas, Blocked is RC_NULL_AREA
+	enum class RecastNavArea
+	{
+		Blocked,
+		Ground,
+		Water,
+		Road,
+		Grass,
+		Door,
+		Jump,
+	};
+
+	// Poly flags, used by query filters
+	enum class RecastNavFlag : ui16
+	{
+		Walk = 0x01,
+		Swim = 0x02,
+		Door = 0x04,
+		Jump = 0x08,
+		Disabled = 0x10,
+		All = 0xffff,
+	};
+
+	// Bake settings
+	struct RecastNavSettings
+	{
+		float	m_cellSize = 0.3f;
+		float	m_cellHeight = 0.2f;
+		i32		m_tileSize = 48;			// cells per tile side
+		float	m_agentHeight = 2.f;
+		float	m_agentRadius = 0.6f;
+		float	m_agentMaxClimb = 0.9f;
+		float	m_agentMaxSlope = 45.f;
+		float	m_edgeMaxError = 1.3f;
+		i32		m_maxObstacles = 1024;
+	};
+
+	// World space triangles
+	struct RecastNavGeometry
+	{
+		vector<float>::type		m_vertices;
+		vector<i32>::type		m_indices;
+		AABB					m_box;
+
+		// append triangles, positions are transformed by matrix
+		void addTriangles(const Vector3* positions, i32 positionCount, const ui32* indices, i32 indexCount, const Matrix4& matrix);
+	};
+
+	// Convex area volume, vertices are xz pairs
+	struct RecastNavVolume
+	{
+		vector<float>::type		m_vertices;
+		float					m_minHeight = 0.f;
+		float					m_maxHeight = 0.f;
+		RecastNavArea			m_area = RecastNavArea::Ground;
+	};
+	typedef vector<RecastNavVolume>::type RecastNavVolumes;
+
+	// Compressed tile cache layer
+	typedef vector<unsigned char>::type RecastNavTileLayer;
+	typedef vector<RecastNavTileLayer>::type RecastNavTileLayers;
+
+	// Tile cache layer compression, zlib
+	struct RecastNavCompressor : public dtTileCacheCompressor
+	{
+		virtual int maxCompressedSize(const int bufferSize) override;
+		virtual dtStatus compress(const unsigned char* buffer, const int bufferSize, unsigned char* compressed, const int maxCompressedSize, int* compressedSize) override;
+		virtual dtStatus decompress(const unsigned char* compressed, const int compressedSize, unsigned char* buffer, const int maxBufferSize, int* bufferSize) override;
+	};
+
+	class RecastNavBuilder
+	{
+	public:
+		// tiles covering the box
+		static void getTileGrid(const RecastNavSettings& settings, const AABB& box, i32& tileWidth, i32& tileHeight);
+
+		// tile cache params
+		static void getTileCacheParams(const RecastNavSettings& settings, const AABB& box, dtTileCacheParams& params);
+
+		// build compressed layers of all tiles, tiles are rasterized in parallel
+		static bool build(const RecastNavSettings& settings, const RecastNavGeometry& geometry, const RecastNavVolumes& volumes, RecastNavTileLayers& layers);
+
+	private:
+		// rasterize one tile into layers
+		static bool buildTile(const RecastNavSettings& settings, const RecastNavGeometry& geometry, const vector<i32>::type& triangles, const RecastNavVolumes& volumes, i32 tx, i32 ty, RecastNavTileLayers& layers);
+	};
+}
@@ -2,8 +2,54 @@
 
 namespace Echo
 {
+	RecastNavConvexVolume::RecastNavConvexVolume()
+	{
+	}
+
+	RecastNavConvexVolume::~RecastNavConvexVolume()
+	{
+	}
+
 	void RecastNavConvexVolume::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastNavConvexVolume, getSize);
+		CLASS_BIND_METHOD(RecastNavConvexVolume, setSize);
+		CLASS_BIND_METHOD(RecastNavConvexVolume, getArea);
+		CLASS_BIND_METHOD(RecastNavConvexVolume, setArea);
+
+		CLASS_REGISTER_PROPERTY(RecastNavConvexVolume, "Size", Variant::Type::Vector3, getSize, setSize);
+		CLASS_REGISTER_PROPERTY(RecastNavConvexVolume, "Area", Variant::Type::StringOption, getArea, setArea);
+	}
+
+	StringOption RecastNavConvexVolume::getArea() const
+	{
+		return StringOption::fromEnum(m_area);
+	}
+
+	void RecastNavConvexVolume::setArea(const StringOption& option)
+	{
+		m_area = option.toEnum(RecastNavArea::Blocked);
+	}
+
+	RecastNavVolume RecastNavConvexVolume::getVolume()
+	{
+		RecastNavVolume volume;
+		volume.m_area = m_area;
+
+		// footprint corners in counter clockwise order
+		const Matrix4& matrix = getWorldMatrix();
+		const Vector3 half = m_size * 0.5f;
+		const Vector3 corners[4] = { Vector3(-half.x, 0.f, -half.z), Vector3(-half.x, 0.f, half.z), Vector3(half.x, 0.f, half.z), Vector3(half.x, 0.f, -half.z) };
+		for (const Vector3& corner : corners)
+		{
+			Vector3 position = corner * matrix;
+			volume.m_vertices.insert(volume.m_vertices.end(), { position.x, position.z });
+		}
+
+		const Vector3& center = getWorldPosition();
+		volume.m_minHeight = center.y - half.y * getWorldScaling().y;
+		volume.m_maxHeight = center.y + half.y * getWorldScaling().y;
 
+		return volume;
 	}
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/core/scene/node.h"
+#include "recast_nav_builder.h"
 
 namespace Echo
 {
@@ -9,5 +10,22 @@ namespace Echo
 		ECHO_CLASS(RecastNavConvexVolume, Node)
 
 	public:
+		RecastNavConvexVolume();
+		virtual ~RecastNavConvexVolume();
+
+		// box size, centered on this node and rotated by its yaw
+		const Vector3& getSize() const { return m_size; }
+		void setSize(const Vector3& size) { m_size = size; }
+
+		// area
+		StringOption getArea() const;
+		void setArea(const StringOption& option);
+
+		// world space volume
+		RecastNavVolume getVolume();
+
+	private:
+		Vector3			m_size = Vector3(2.f, 2.f, 2.f);
+		RecastNavArea	m_area = RecastNavArea::Blocked;
 	};
-}
\ No newline at end of file
+}
@@ -1,9 +1,70 @@
 #include "recast_nav_input_geom.h"
+#include "engine/core/render/base/mesh/mesh.h"
+#include "engine/modules/model/mesh_render.h"
 
 namespace Echo
 {
+	RecastNavInputGeom::RecastNavInputGeom()
+	{
+	}
+
+	RecastNavInputGeom::~RecastNavInputGeom()
+	{
+	}
+
 	void RecastNavInputGeom::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastNavInputGeom, getMeshRes);
+		CLASS_BIND_METHOD(RecastNavInputGeom, setMeshRes);
+
+		CLASS_REGISTER_PROPERTY(RecastNavInputGeom, "Mesh", Variant::Type::ResourcePath, getMeshRes, setMeshRes);
+	}
+
+	void RecastNavInputGeom::setMeshRes(const ResourcePath& path)
+	{
+		m_meshRes.setPath(path.getPath());
+	}
+
+	void RecastNavInputGeom::collect(RecastNavGeometry& geometry)
+	{
+		if (!m_meshRes.isEmpty())
+		{
+			MeshPtr mesh = ECHO_DOWN_CAST<Mesh*>(Res::get(m_meshRes));
+			collectMesh(mesh, getWorldMatrix(), geometry);
+		}
+
+		for (Node* child : getChildren())
+			collectNode(child, geometry);
+	}
+
+	void RecastNavInputGeom::collectNode(Node* node, RecastNavGeometry& geometry)
+	{
+		if (!node->isEnable())
+			return;
+
+		MeshRender* meshRender = dynamic_cast<MeshRender*>(node);
+		if (meshRender)
+			collectMesh(meshRender->getMesh(), meshRender->getWorldMatrix(), geometry);
+
+		for (Node* child : node->getChildren())
+			collectNode(child, geometry);
+	}
+
+	void RecastNavInputGeom::collectMesh(Mesh* mesh, const Matrix4& matrix, RecastNavGeometry& geometry)
+	{
+		if (!mesh || mesh->getTopologyType() != Mesh::TT_TRIANGLELIST || !mesh->getIndexCount())
+			return;
+
+		MeshVertexData& vertexData = mesh->getVertexData();
+		vector<Vector3>::type positions(vertexData.getVertexCount());
+		for (ui32 i = 0; i < vertexData.getVertexCount(); i++)
+			positions[i] = vertexData.getPosition(i);
+
+		vector<ui32>::type indices(mesh->getIndexCount());
+		const Byte* indexData = (const Byte*)mesh->getIndices();
+		for (ui32 i = 0; i < mesh->getIndexCount(); i++)
+			indices[i] = mesh->getIndexStride() == sizeof(ui32) ? ((const ui32*)indexData)[i] : ((const ui16*)indexData)[i];
 
+		geometry.addTriangles(positions.data(), i32(positions.size()), indices.data(), i32(indices.size()), matrix);
 	}
-}
\ No newline at end of file
+}
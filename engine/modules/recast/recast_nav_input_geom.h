@@ -1,13 +1,34 @@
 #pragma once
 
 #include "engine/core/scene/node.h"
+#include "recast_nav_builder.h"
 
 namespace Echo
 {
+	class Mesh;
 	class RecastNavInputGeom : public Node
 	{
 		ECHO_CLASS(RecastNavInputGeom, Node)
 
 	public:
+		RecastNavInputGeom();
+		virtual ~RecastNavInputGeom();
+
+		// mesh res, optional, mesh renders below this node are always collected
+		void setMeshRes(const ResourcePath& path);
+		const ResourcePath& getMeshRes() { return m_meshRes; }
+
+		// collect world space triangles
+		void collect(RecastNavGeometry& geometry);
+
+	private:
+		// triangles of one mesh
+		static void collectMesh(Mesh* mesh, const Matrix4& matrix, RecastNavGeometry& geometry);
+
+		// mesh renders of the subtree
+		static void collectNode(Node* node, RecastNavGeometry& geometry);
+
+	private:
+		ResourcePath	m_meshRes = ResourcePath("", ".mesh");
 	};
-}
\ No newline at end of file
+}
@@ -1,9 +1,450 @@
 #include "recast_nav_mesh.h"
+#include "recast_nav_input_geom.h"
+#include "recast_nav_convex_volume.h"
+#include "recast_off_mesh_link.h"
+#include "recast_path_service.h"
+#include "recast_crowd.h"
+#include "engine/core/io/io.h"
+#include "engine/core/io/memory_reader.h"
+#include "engine/core/log/Log.h"
+#include <DetourNavMesh.h>
+#include <DetourNavMeshBuilder.h>
+#include <DetourCommon.h>
 
 namespace Echo
 {
+	// navmesh file header, followed by [size, data] of every compressed layer
+	struct NavMeshFileHeader
+	{
+		i32					m_magic;
+		i32					m_version;
+		i32					m_layerCount;
+		dtTileCacheParams	m_params;
+	};
+	static const i32 NavMeshFileMagic = 'E' << 24 | 'N' << 16 | 'A' << 8 | 'V';
+	static const i32 NavMeshFileVersion = 1;
+
+	// poly flags of area
+	static unsigned short getAreaFlags(unsigned char area)
+	{
+		switch (RecastNavArea(area))
+		{
+		case RecastNavArea::Water:	return ui16(RecastNavFlag::Swim);
+		case RecastNavArea::Door:	return ui16(RecastNavFlag::Walk) | ui16(RecastNavFlag::Door);
+		case RecastNavArea::Jump:	return ui16(RecastNavFlag::Jump);
+		default:					return ui16(RecastNavFlag::Walk);
+		}
+	}
+
+	// called by the tile cache every time a tile is (re)built
+	struct RecastNavMesh::MeshProcess : public dtTileCacheMeshProcess
+	{
+		const OffMeshLinks* m_links = nullptr;
+
+		virtual void process(dtNavMeshCreateParams* params, unsigned char* polyAreas, unsigned short* polyFlags) override
+		{
+			for (i32 i = 0; i < params->polyCount; i++)
+			{
+				if (polyAreas[i] == DT_TILECACHE_WALKABLE_AREA)
+					polyAreas[i] = (unsigned char)RecastNavArea::Ground;
+
+				polyFlags[i] = getAreaFlags(polyAreas[i]);
+			}
+
+			// detour keeps the links that start inside the tile
+			if (m_links && !m_links->m_ids.empty())
+			{
+				params->offMeshConVerts = m_links->m_vertices.data();
+				params->offMeshConRad = m_links->m_radius.data();
+				params->offMeshConDir = m_links->m_directions.data();
+				params->offMeshConAreas = m_links->m_areas.data();
+				params->offMeshConFlags = m_links->m_flags.data();
+				params->offMeshConUserID = m_links->m_ids.data();
+				params->offMeshConCount = i32(m_links->m_ids.size());
+			}
+		}
+	};
+
+	RecastNavMesh::RecastNavMesh()
+	{
+		memset(&m_tileCacheParams, 0, sizeof(m_tileCacheParams));
+		m_tileCacheMeshProcess = EchoNew(MeshProcess);
+		m_tileCacheMeshProcess->m_links = &m_offMeshLinks;
+		m_queryFilter.setIncludeFlags(ui16(RecastNavFlag::All) ^ ui16(RecastNavFlag::Disabled));
+	}
+
+	RecastNavMesh::~RecastNavMesh()
+	{
+		clear();
+		EchoSafeDelete(m_tileCacheMeshProcess, MeshProcess);
+	}
+
 	void RecastNavMesh::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastNavMesh, getDataPath);
+		CLASS_BIND_METHOD(RecastNavMesh, setDataPath);
+		CLASS_BIND_METHOD(RecastNavMesh, getCellSize);
+		CLASS_BIND_METHOD(RecastNavMesh, setCellSize);
+		CLASS_BIND_METHOD(RecastNavMesh, getCellHeight);
+		CLASS_BIND_METHOD(RecastNavMesh, setCellHeight);
+		CLASS_BIND_METHOD(RecastNavMesh, getTileSize);
+		CLASS_BIND_METHOD(RecastNavMesh, setTileSize);
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentHeight);
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentHeight);
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentRadius);
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentRadius);
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentMaxClimb);
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentMaxClimb);
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentMaxSlope);
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentMaxSlope);
+		CLASS_BIND_METHOD(RecastNavMesh, getMaxObstacles);
+		CLASS_BIND_METHOD(RecastNavMesh, setMaxObstacles);
+		CLASS_BIND_METHOD(RecastNavMesh, getMaxAgents);
+		CLASS_BIND_METHOD(RecastNavMesh, setMaxAgents);
+		CLASS_BIND_METHOD(RecastNavMesh, getPathIterations);
+		CLASS_BIND_METHOD(RecastNavMesh, setPathIterations);
+		CLASS_BIND_METHOD(RecastNavMesh, bake);
+		CLASS_BIND_METHOD(RecastNavMesh, requestPath);
+		CLASS_BIND_METHOD(RecastNavMesh, isPathPending);
+		CLASS_BIND_METHOD(RecastNavMesh, getPath);
+		CLASS_BIND_METHOD(RecastNavMesh, getPathQueueDepth);
+		CLASS_BIND_METHOD(RecastNavMesh, getPathLatency);
+		CLASS_BIND_METHOD(RecastNavMesh, getPathMaxLatency);
+
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "Data", Variant::Type::ResourcePath, getDataPath, setDataPath);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "CellSize", Variant::Type::Real, getCellSize, setCellSize);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "CellHeight", Variant::Type::Real, getCellHeight, setCellHeight);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "TileSize", Variant::Type::Int, getTileSize, setTileSize);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentHeight", Variant::Type::Real, getAgentHeight, setAgentHeight);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentRadius", Variant::Type::Real, getAgentRadius, setAgentRadius);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentMaxClimb", Variant::Type::Real, getAgentMaxClimb, setAgentMaxClimb);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentMaxSlope", Variant::Type::Real, getAgentMaxSlope, setAgentMaxSlope);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "MaxObstacles", Variant::Type::Int, getMaxObstacles, setMaxObstacles);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "MaxAgents", Variant::Type::Int, getMaxAgents, setMaxAgents);
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "PathIterations", Variant::Type::Int, getPathIterations, setPathIterations);
+	}
+
+	void RecastNavMesh::setDataPath(const ResourcePath& path)
+	{
+		if (m_dataPath.setPath(path.getPath()))
+		{
+			// loaded on next update, once off mesh links below us exist
+			m_isLoadDirty = !m_dataPath.isEmpty();
+		}
+	}
+
+	void RecastNavMesh::setPathIterations(i32 iterations)
+	{
+		m_pathIterations = std::max<i32>(iterations, 1);
+		if (m_pathService)
+			m_pathService->setMaxIterations(m_pathIterations);
+	}
+
+	void RecastNavMesh::collectOffMeshLinks(Node* node)
+	{
+		for (Node* child : node->getChildren())
+		{
+			RecastOffMeshLink* link = dynamic_cast<RecastOffMeshLink*>(child);
+			if (link && link->isEnable())
+			{
+				const Vector3& start = link->getWorldPosition();
+				Vector3 end = link->getWorldEnd();
+				m_offMeshLinks.m_vertices.insert(m_offMeshLinks.m_vertices.end(), { start.x, start.y, start.z, end.x, end.y, end.z });
+				m_offMeshLinks.m_radius.emplace_back(link->getRadius());
+				m_offMeshLinks.m_directions.emplace_back(link->isBidirectional() ? DT_OFFMESH_CON_BIDIR : 0);
+				m_offMeshLinks.m_areas.emplace_back((unsigned char)RecastNavArea::Jump);
+				m_offMeshLinks.m_flags.emplace_back(ui16(RecastNavFlag::Jump));
+				m_offMeshLinks.m_ids.emplace_back(link->getId());
+			}
+
+			collectOffMeshLinks(child);
+		}
+	}
+
+	bool RecastNavMesh::bake()
+	{
+		RecastNavGeometry geometry;
+		RecastNavVolumes volumes;
+		std::function<void(Node*)> collect = [&](Node* node)
+		{
+			for (Node* child : node->getChildren())
+			{
+				if (!child->isEnable())
+					continue;
+
+				if (RecastNavInputGeom* inputGeom = dynamic_cast<RecastNavInputGeom*>(child))
+					inputGeom->collect(geometry);
+				else if (RecastNavConvexVolume* volume = dynamic_cast<RecastNavConvexVolume*>(child))
+					volumes.emplace_back(volume->getVolume());
+
+				collect(child);
+			}
+		};
+		collect(this);
+
+		if (geometry.m_indices.empty())
+		{
+			EchoLogError("Recast navigation mesh [%s] has no input geometry", getNodePath().c_str());
+			return false;
+		}
+
+		RecastNavTileLayers layers;
+		RecastNavBuilder::build(m_settings, geometry, volumes, layers);
+
+		dtTileCacheParams params;
+		RecastNavBuilder::getTileCacheParams(m_settings, geometry.m_box, params);
+
+		m_offMeshLinks = OffMeshLinks();
+		collectOffMeshLinks(this);
+		if (!init(params, layers))
+			return false;
+
+		if (!m_dataPath.isEmpty())
+			save(m_dataPath.getPath());
+
+		m_isLoadDirty = false;
+		return true;
+	}
+
+	bool RecastNavMesh::init(const dtTileCacheParams& params, RecastNavTileLayers& layers)
+	{
+		clear();
+
+		m_tileCacheParams = params;
+		m_tileCacheParams.maxTiles = std::max<i32>(params.maxTiles, i32(layers.size()));
+		m_tileCacheParams.maxObstacles = m_settings.m_maxObstacles;
+
+		m_tileCache = dtAllocTileCache();
+		if (!m_tileCache || dtStatusFailed(m_tileCache->init(&m_tileCacheParams, &m_tileCacheAlloc, &m_tileCacheCompressor, m_tileCacheMeshProcess)))
+		{
+			EchoLogError("Recast navigation mesh [%s] could not init tile cache", getNodePath().c_str());
+			clear();
+			return false;
+		}
+
+		// tile and poly bits share 22 bits of a poly ref
+		i32 tileBits = std::min<i32>(i32(dtIlog2(dtNextPow2(ui32(m_tileCacheParams.maxTiles)))), 14);
+		dtNavMeshParams navMeshParams;
+		memset(&navMeshParams, 0, sizeof(navMeshParams));
+		dtVcopy(navMeshParams.orig, m_tileCacheParams.orig);
+		navMeshParams.tileWidth = m_tileCacheParams.width * m_tileCacheParams.cs;
+		navMeshParams.tileHeight = m_tileCacheParams.height * m_tileCacheParams.cs;
+		navMeshParams.maxTiles = 1 << tileBits;
+		navMeshParams.maxPolys = 1 << (22 - tileBits);
+
+		m_navMesh = dtAllocNavMesh();
+		if (!m_navMesh || dtStatusFailed(m_navMesh->init(&navMeshParams)))
+		{
+			EchoLogError("Recast navigation mesh [%s] could not init detour nav mesh", getNodePath().c_str());
+			clear();
+			return false;
+		}
+
+		// the tile cache owns its copy of every layer
+		for (RecastNavTileLayer& layer : layers)
+		{
+			unsigned char* data = (unsigned char*)dtAlloc(layer.size(), DT_ALLOC_PERM);
+			memcpy(data, layer.data(), layer.size());
+			if (dtStatusFailed(m_tileCache->addTile(data, i32(layer.size()), DT_COMPRESSEDTILE_FREE_DATA, nullptr)))
+				dtFree(data);
+		}
+
+		for (i32 i = 0; i < m_tileCache->getTileCount(); i++)
+		{
+			const dtCompressedTile* tile = m_tileCache->getTile(i);
+			if (tile && tile->header)
+				m_tileCache->buildNavMeshTile(m_tileCache->getTileRef(tile), m_navMesh);
+		}
+
+		m_pathService = EchoNew(RecastPathService(m_navMesh));
+		m_pathService->setMaxIterations(m_pathIterations);
+		m_crowd = EchoNew(RecastCrowd(m_navMesh, m_pathService, m_maxAgents, m_settings.m_agentRadius * 2.f));
+
+		m_generation++;
+		return true;
+	}
+
+	void RecastNavMesh::clear()
+	{
+		EchoSafeDelete(m_crowd, RecastCrowd);
+		EchoSafeDelete(m_pathService, RecastPathService);
 
+		if (m_tileCache)
+		{
+			dtFreeTileCache(m_tileCache);
+			m_tileCache = nullptr;
+		}
+
+		if (m_navMesh)
+		{
+			dtFreeNavMesh(m_navMesh);
+			m_navMesh = nullptr;
+		}
+	}
+
+	bool RecastNavMesh::load(const String& path)
+	{
+		MemoryReader reader(path);
+		const char* data = reader.getData<const char*>();
+		const char* end = data + reader.getSize();
+		if (!data || reader.getSize() < sizeof(NavMeshFileHeader))
+			return false;
+
+		NavMeshFileHeader header;
+		memcpy(&header, data, sizeof(header));
+		data += sizeof(header);
+		if (header.m_magic != NavMeshFileMagic || header.m_version != NavMeshFileVersion)
+		{
+			EchoLogError("Recast navigation mesh [%s] is not a valid navmesh file", path.c_str());
+			return false;
+		}
+
+		RecastNavTileLayers layers(header.m_layerCount);
+		for (RecastNavTileLayer& layer : layers)
+		{
+			i32 size = 0;
+			if (data + sizeof(i32) > end)
+				return false;
+
+			memcpy(&size, data, sizeof(i32));
+			data += sizeof(i32);
+			if (size < 0 || data + size > end)
+				return false;
+
+			layer.assign(data, data + size);
+			data += size;
+		}
+
+		m_offMeshLinks = OffMeshLinks();
+		collectOffMeshLinks(this);
+		return init(header.m_params, layers);
+	}
+
+	bool RecastNavMesh::save(const String& path)
+	{
+		if (!m_tileCache)
+			return false;
+
+		NavMeshFileHeader header;
+		header.m_magic = NavMeshFileMagic;
+		header.m_version = NavMeshFileVersion;
+		header.m_layerCount = 0;
+		header.m_params = m_tileCacheParams;
+		for (i32 i = 0; i < m_tileCache->getTileCount(); i++)
+		{
+			const dtCompressedTile* tile = m_tileCache->getTile(i);
+			if (tile && tile->header && tile->dataSize)
+				header.m_layerCount++;
+		}
+
+		DataStream* stream = IO::instance()->open(path, DataStream::WRITE);
+		if (stream && stream->isWriteable())
+		{
+			stream->write(&header, sizeof(header));
+			for (i32 i = 0; i < m_tileCache->getTileCount(); i++)
+			{
+				const dtCompressedTile* tile = m_tileCache->getTile(i);
+				if (tile && tile->header && tile->dataSize)
+				{
+					stream->write(&tile->dataSize, sizeof(i32));
+					stream->write(tile->data, tile->dataSize);
+				}
+			}
+
+			stream->close();
+			EchoSafeDelete(stream, DataStream);
+			return true;
+		}
+
+		EchoSafeDelete(stream, DataStream);
+		return false;
+	}
+
+	ui32 RecastNavMesh::addObstacle(const Vector3& position, float radius, float height)
+	{
+		dtObstacleRef ref = 0;
+		if (m_tileCache && dtStatusFailed(m_tileCache->addObstacle(&position.x, radius, height, &ref)))
+			ref = 0;
+
+		return ref;
+	}
+
+	ui32 RecastNavMesh::addBoxObstacle(const Vector3& center, const Vector3& halfExtents, float yaw)
+	{
+		dtObstacleRef ref = 0;
+		if (m_tileCache && dtStatusFailed(m_tileCache->addBoxObstacle(&center.x, &halfExtents.x, yaw, &ref)))
+			ref = 0;
+
+		return ref;
+	}
+
+	void RecastNavMesh::removeObstacle(ui32 obstacle)
+	{
+		if (m_tileCache && obstacle)
+			m_tileCache->removeObstacle(obstacle);
+	}
+
+	void RecastNavMesh::updateInternal(float elapsedTime)
+	{
+		if (m_isLoadDirty)
+		{
+			if (!load(m_dataPath.getPath()))
+				EchoLogError("Recast navigation mesh [%s] failed to load [%s]", getNodePath().c_str(), m_dataPath.getPath().c_str());
+
+			m_isLoadDirty = false;
+		}
+
+		// only tiles touched by added or removed obstacles are rebuilt
+		if (m_tileCache && m_navMesh)
+			m_tileCache->update(elapsedTime, m_navMesh);
+
+		// tiles stay unchanged while paths are searched on worker threads
+		if (m_crowd)
+		{
+			m_crowd->preUpdate();
+			m_pathService->update();
+			m_crowd->update(elapsedTime);
+		}
+	}
+
+	ui32 RecastNavMesh::requestPath(const Vector3& start, const Vector3& end)
+	{
+		return m_pathService ? m_pathService->request(start, end, &m_queryFilter) : 0;
+	}
+
+	bool RecastNavMesh::isPathPending(ui32 request)
+	{
+		return m_pathService ? m_pathService->getStatus(request) == RecastPathService::Status::Pending : false;
+	}
+
+	RealVector RecastNavMesh::getPath(ui32 request)
+	{
+		RealVector points;
+		RecastPathService::Result result;
+		if (m_pathService && m_pathService->fetch(request, result) && !result.m_path.empty())
+		{
+			static const i32 MaxPoints = 256;
+			float straightPath[MaxPoints * 3];
+			i32 count = 0;
+			if (dtStatusSucceed(m_crowd->getNavMeshQuery()->findStraightPath(&result.m_start.x, &result.m_end.x, result.m_path.data(), i32(result.m_path.size()), straightPath, nullptr, nullptr, &count, MaxPoints)))
+				points.assign(straightPath, straightPath + count * 3);
+		}
+
+		return points;
+	}
+
+	i32 RecastNavMesh::getPathQueueDepth()
+	{
+		return m_pathService ? m_pathService->getStats().m_queueDepth : 0;
+	}
+
+	float RecastNavMesh::getPathLatency()
+	{
+		return m_pathService ? m_pathService->getStats().m_averageLatency : 0.f;
+	}
+
+	float RecastNavMesh::getPathMaxLatency()
+	{
+		return m_pathService ? m_pathService->getStats().m_maxLatency : 0.f;
 	}
-}
\ No newline at end of file
+}
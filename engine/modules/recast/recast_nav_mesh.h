@@ -1,13 +1,131 @@
 #pragma once
 
 #include "engine/core/scene/node.h"
+#include "recast_nav_builder.h"
+#include <DetourNavMeshQuery.h>
+
+class dtNavMesh;
+class dtTileCache;
 
 namespace Echo
 {
+	class RecastCrowd;
+	class RecastPathService;
 	class RecastNavMesh : public Node
 	{
 		ECHO_CLASS(RecastNavMesh, Node)
 
 	public:
+		RecastNavMesh();
+		virtual ~RecastNavMesh();
+
+		// data res path (.navmesh)
+		void setDataPath(const ResourcePath& path);
+		const ResourcePath& getDataPath() { return m_dataPath; }
+
+		// settings
+		float getCellSize() const { return m_settings.m_cellSize; }
+		void setCellSize(float cellSize) { m_settings.m_cellSize = cellSize; }
+		float getCellHeight() const { return m_settings.m_cellHeight; }
+		void setCellHeight(float cellHeight) { m_settings.m_cellHeight = cellHeight; }
+		i32 getTileSize() const { return m_settings.m_tileSize; }
+		void setTileSize(i32 tileSize) { m_settings.m_tileSize = std::max<i32>(tileSize, 8); }
+		float getAgentHeight() const { return m_settings.m_agentHeight; }
+		void setAgentHeight(float height) { m_settings.m_agentHeight = height; }
+		float getAgentRadius() const { return m_settings.m_agentRadius; }
+		void setAgentRadius(float radius) { m_settings.m_agentRadius = radius; }
+		float getAgentMaxClimb() const { return m_settings.m_agentMaxClimb; }
+		void setAgentMaxClimb(float maxClimb) { m_settings.m_agentMaxClimb = maxClimb; }
+		float getAgentMaxSlope() const { return m_settings.m_agentMaxSlope; }
+		void setAgentMaxSlope(float maxSlope) { m_settings.m_agentMaxSlope = maxSlope; }
+		i32 getMaxObstacles() const { return m_settings.m_maxObstacles; }
+		void setMaxObstacles(i32 maxObstacles) { m_settings.m_maxObstacles = std::max<i32>(maxObstacles, 0); }
+
+		// max crowd agents, applied when the detour nav mesh is recreated
+		i32 getMaxAgents() const { return m_maxAgents; }
+		void setMaxAgents(i32 maxAgents) { m_maxAgents = std::max<i32>(maxAgents, 1); }
+
+		// pathfinder iterations per frame, shared by all worker threads
+		i32 getPathIterations() const { return m_pathIterations; }
+		void setPathIterations(i32 iterations);
+
+		// bake from input geometry below this node, tiles are built on worker threads
+		bool bake();
+
+		// detour
+		dtNavMesh* getDtNavMesh() { return m_navMesh; }
+		dtTileCache* getDtTileCache() { return m_tileCache; }
+
+		// incremented every time the detour nav mesh is recreated
+		ui32 getGeneration() const { return m_generation; }
+
+		// crowd and path service, null until the detour nav mesh exists
+		RecastCrowd* getCrowd() { return m_crowd; }
+		RecastPathService* getPathService() { return m_pathService; }
+
+	public:
+		// path query, the result is fetched once as straight path points [x, y, z, ...]
+		ui32 requestPath(const Vector3& start, const Vector3& end);
+		bool isPathPending(ui32 request);
+		RealVector getPath(ui32 request);
+
+		// path service stats, latency in milliseconds
+		i32 getPathQueueDepth();
+		float getPathLatency();
+		float getPathMaxLatency();
+
+	public:
+		// temp obstacles, affected tiles are rebuilt incrementally in update
+		ui32 addObstacle(const Vector3& position, float radius, float height);
+		ui32 addBoxObstacle(const Vector3& center, const Vector3& halfExtents, float yaw);
+		void removeObstacle(ui32 obstacle);
+
+	protected:
+		// update
+		virtual void updateInternal(float elapsedTime) override;
+
+		// create detour objects from layers
+		bool init(const dtTileCacheParams& params, RecastNavTileLayers& layers);
+
+		// release detour objects
+		void clear();
+
+		// load|save
+		bool load(const String& path);
+		bool save(const String& path);
+
+		// off mesh links below this node
+		void collectOffMeshLinks(Node* node);
+
+	private:
+		struct OffMeshLinks
+		{
+			vector<float>::type				m_vertices;
+			vector<float>::type				m_radius;
+			vector<unsigned char>::type		m_directions;
+			vector<unsigned char>::type		m_areas;
+			vector<unsigned short>::type	m_flags;
+			vector<unsigned int>::type		m_ids;
+		};
+
+		struct MeshProcess;
+
+	private:
+		ResourcePath				m_dataPath = ResourcePath("", ".navmesh");
+		bool						m_isLoadDirty = false;
+		RecastNavSettings			m_settings;
+		dtTileCacheParams			m_tileCacheParams;
+		dtTileCacheAlloc			m_tileCacheAlloc;
+		RecastNavCompressor			m_tileCacheCompressor;
+		MeshProcess*				m_tileCacheMeshProcess = nullptr;
+		OffMeshLinks				m_offMeshLinks;
+		i32							m_maxAgents = 1024;
+		i32							m_pathIterations = 4096;
+		dtQueryFilter				m_queryFilter;
+		RecastPathService*			m_pathService = nullptr;
+		RecastCrowd*				m_crowd = nullptr;
+		dtNavMesh*					m_navMesh = nullptr;
+		dtTileCache*				m_tileCache = nullptr;
+		ui32						m_generation = 0;
 	};
-}
\ No newline at end of file
+}
@@ -1,9 +1,83 @@
 #include "recast_nav_temp_obstacle.h"
+#include "recast_nav_mesh.h"
 
 namespace Echo
 {
+	RecastNavTempObstacle::RecastNavTempObstacle()
+	{
+	}
+
+	RecastNavTempObstacle::~RecastNavTempObstacle()
+	{
+		removeObstacle();
+	}
+
 	void RecastNavTempObstacle::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastNavTempObstacle, getRadius);
+		CLASS_BIND_METHOD(RecastNavTempObstacle, setRadius);
+		CLASS_BIND_METHOD(RecastNavTempObstacle, getHeight);
+		CLASS_BIND_METHOD(RecastNavTempObstacle, setHeight);
+
+		CLASS_REGISTER_PROPERTY(RecastNavTempObstacle, "Radius", Variant::Type::Real, getRadius, setRadius);
+		CLASS_REGISTER_PROPERTY(RecastNavTempObstacle, "Height", Variant::Type::Real, getHeight, setHeight);
+	}
+
+	void RecastNavTempObstacle::setRadius(float radius)
+	{
+		m_radius = std::max<float>(radius, 0.f);
+		m_isDirty = true;
+	}
+
+	void RecastNavTempObstacle::setHeight(float height)
+	{
+		m_height = std::max<float>(height, 0.f);
+		m_isDirty = true;
+	}
+
+	RecastNavMesh* RecastNavTempObstacle::getNavMesh()
+	{
+		for (Node* node = getParent(); node; node = node->getParent())
+		{
+			if (RecastNavMesh* navMesh = dynamic_cast<RecastNavMesh*>(node))
+				return navMesh;
+		}
+
+		return nullptr;
+	}
+
+	void RecastNavTempObstacle::removeObstacle()
+	{
+		// obstacles of an old generation died with the old tile cache
+		if (m_navMesh && m_obstacle && m_generation == m_navMesh->getGeneration())
+			m_navMesh->removeObstacle(m_obstacle);
+
+		m_obstacle = 0;
+	}
+
+	void RecastNavTempObstacle::updateInternal(float elapsedTime)
+	{
+		RecastNavMesh* navMesh = getNavMesh();
+		if (navMesh != m_navMesh)
+		{
+			removeObstacle();
+			m_navMesh = navMesh;
+			m_isDirty = true;
+		}
+
+		if (!m_navMesh || !m_navMesh->getDtTileCache())
+			return;
+
+		const Vector3& position = getWorldPosition();
+		if (m_isDirty || !m_obstacle || position != m_position || m_generation != m_navMesh->getGeneration())
+		{
+			removeObstacle();
 
+			// fails while the tile cache request queue is full, retried next frame
+			m_generation = m_navMesh->getGeneration();
+			m_obstacle = m_navMesh->addObstacle(position, m_radius, m_height);
+			m_position = position;
+			m_isDirty = false;
+		}
 	}
-}
\ No newline at end of file
+}
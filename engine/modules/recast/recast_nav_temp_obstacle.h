@@ -4,10 +4,40 @@
 
 namespace Echo
 {
+	class RecastNavMesh;
 	class RecastNavTempObstacle : public Node
 	{
 		ECHO_CLASS(RecastNavTempObstacle, Node)
 
 	public:
+		RecastNavTempObstacle();
+		virtual ~RecastNavTempObstacle();
+
+		// radius
+		float getRadius() const { return m_radius; }
+		void setRadius(float radius);
+
+		// height
+		float getHeight() const { return m_height; }
+		void setHeight(float height);
+
+	protected:
+		// update
+		virtual void updateInternal(float elapsedTime) override;
+
+		// nearest nav mesh ancestor
+		RecastNavMesh* getNavMesh();
+
+		// remove from nav mesh
+		void removeObstacle();
+
+	private:
+		float				m_radius = 0.5f;
+		float				m_height = 2.f;
+		RecastNavMesh*		m_navMesh = nullptr;
+		ui32				m_obstacle = 0;
+		ui32				m_generation = 0;
+		Vector3				m_position = Vector3::INVALID;
+		bool				m_isDirty = true;
 	};
-}
\ No newline at end of file
+}
@@ -2,8 +2,30 @@
 
 namespace Echo
 {
+	RecastOffMeshLink::RecastOffMeshLink()
+	{
+	}
+
+	RecastOffMeshLink::~RecastOffMeshLink()
+	{
+	}
+
 	void RecastOffMeshLink::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastOffMeshLink, getEnd);
+		CLASS_BIND_METHOD(RecastOffMeshLink, setEnd);
+		CLASS_BIND_METHOD(RecastOffMeshLink, getRadius);
+		CLASS_BIND_METHOD(RecastOffMeshLink, setRadius);
+		CLASS_BIND_METHOD(RecastOffMeshLink, isBidirectional);
+		CLASS_BIND_METHOD(RecastOffMeshLink, setBidirectional);
+
+		CLASS_REGISTER_PROPERTY(RecastOffMeshLink, "End", Variant::Type::Vector3, getEnd, setEnd);
+		CLASS_REGISTER_PROPERTY(RecastOffMeshLink, "Radius", Variant::Type::Real, getRadius, setRadius);
+		CLASS_REGISTER_PROPERTY(RecastOffMeshLink, "Bidirectional", Variant::Type::Bool, isBidirectional, setBidirectional);
+	}
 
+	Vector3 RecastOffMeshLink::getWorldEnd()
+	{
+		return m_end * getWorldMatrix();
 	}
-}
\ No newline at end of file
+}
@@ -9,5 +9,27 @@ namespace Echo
 		ECHO_CLASS(RecastOffMeshLink, Node)
 
 	public:
+		RecastOffMeshLink();
+		virtual ~RecastOffMeshLink();
+
+		// end point, relative to this node (the start point)
+		const Vector3& getEnd() const { return m_end; }
+		void setEnd(const Vector3& end) { m_end = end; }
+
+		// radius of the end points
+		float getRadius() const { return m_radius; }
+		void setRadius(float radius) { m_radius = radius; }
+
+		// bidirectional
+		bool isBidirectional() const { return m_isBidirectional; }
+		void setBidirectional(bool isBidirectional) { m_isBidirectional = isBidirectional; }
+
+		// world space end point
+		Vector3 getWorldEnd();
+
+	private:
+		Vector3		m_end = Vector3(0.f, 0.f, 2.f);
+		float		m_radius = 0.5f;
+		bool		m_isBidirectional = true;
 	};
-}
\ No newline at end of file
+}
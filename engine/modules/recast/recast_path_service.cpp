@@ -0,0 +1,207 @@
+#include "recast_path_service.h"
+#include "engine/core/thread/job_system.h"
+#include "engine/core/util/Timer.h"
+
+namespace Echo
+{
+	// search box around request positions
+	static const float PolyExtents[3] = { 2.f, 4.f, 2.f };
+
+	RecastPathService::RecastPathService(dtNavMesh* navMesh, i32 maxPath, i32 maxSearchNodes)
+		: m_maxPath(maxPath)
+	{
+		i32 threadCount = JobSystem::instance()->getThreadCount();
+		for (i32 i = 0; i < threadCount; i++)
+		{
+			Worker* worker = EchoNew(Worker);
+			worker->m_queue.init(maxPath, maxSearchNodes, navMesh);
+			worker->m_requests.reserve(QueueCapacity);
+			m_workers.emplace_back(worker);
+		}
+	}
+
+	RecastPathService::~RecastPathService()
+	{
+		EchoSafeDeleteContainer(m_workers, Worker);
+	}
+
+	ui32 RecastPathService::request(const Vector3& start, const Vector3& end, const dtQueryFilter* filter)
+	{
+		// 0 is never a valid id
+		m_nextId = std::max<ui32>(m_nextId + 1, 1);
+
+		Request request;
+		request.m_id = m_nextId;
+		request.m_start = start;
+		request.m_end = end;
+		request.m_filter = filter;
+		request.m_submitTime = Time::instance()->getMicroseconds();
+		m_waiting.emplace_back(request);
+
+		return request.m_id;
+	}
+
+	void RecastPathService::cancel(ui32 id)
+	{
+		if (m_results.erase(id))
+			return;
+
+		for (RequestQueue::iterator it = m_waiting.begin(); it != m_waiting.end(); it++)
+		{
+			if (it->m_id == id)
+			{
+				m_waiting.erase(it);
+				return;
+			}
+		}
+
+		// in flight, discarded once done
+		m_cancelled.insert(id);
+	}
+
+	RecastPathService::Status RecastPathService::getStatus(ui32 id) const
+	{
+		if (m_results.count(id))
+			return Status::Done;
+
+		for (const Request& request : m_waiting)
+		{
+			if (request.m_id == id)
+				return Status::Pending;
+		}
+
+		for (const Worker* worker : m_workers)
+		{
+			for (const Request& request : worker->m_requests)
+			{
+				if (request.m_id == id)
+					return m_cancelled.count(id) ? Status::Unknown : Status::Pending;
+			}
+		}
+
+		return Status::Unknown;
+	}
+
+	bool RecastPathService::fetch(ui32 id, Result& result)
+	{
+		map<ui32, Result>::type::iterator it = m_results.find(id);
+		if (it != m_results.end())
+		{
+			result = std::move(it->second);
+			m_results.erase(it);
+			return true;
+		}
+
+		return false;
+	}
+
+	void RecastPathService::updateWorker(Worker& worker, i32 maxIterations)
+	{
+		const dtNavMeshQuery* query = worker.m_queue.getNavQuery();
+		for (Request& request : worker.m_requests)
+		{
+			if (request.m_ref == DT_PATHQ_INVALID && !request.m_isDone)
+			{
+				float start[3], end[3];
+				dtPolyRef startRef = 0;
+				dtPolyRef endRef = 0;
+				query->findNearestPoly(&request.m_start.x, PolyExtents, request.m_filter, &startRef, start);
+				query->findNearestPoly(&request.m_end.x, PolyExtents, request.m_filter, &endRef, end);
+				if (startRef && endRef)
+					request.m_ref = worker.m_queue.request(startRef, endRef, start, end, request.m_filter);
+
+				if (request.m_ref != DT_PATHQ_INVALID)
+				{
+					request.m_result.m_start = Vector3(start[0], start[1], start[2]);
+					request.m_result.m_end = Vector3(end[0], end[1], end[2]);
+					request.m_result.m_endRef = endRef;
+				}
+				else
+				{
+					request.m_result.m_status = DT_FAILURE;
+					request.m_isDone = true;
+				}
+			}
+		}
+
+		worker.m_queue.update(maxIterations);
+
+		for (Request& request : worker.m_requests)
+		{
+			if (request.m_isDone)
+				continue;
+
+			dtStatus status = worker.m_queue.getRequestStatus(request.m_ref);
+			if (!dtStatusSucceed(status) && !dtStatusFailed(status))
+				continue;
+
+			// reading the result frees the queue slot, failed or not
+			i32 count = 0;
+			Result& result = request.m_result;
+			result.m_path.resize(m_maxPath);
+			dtStatus details = worker.m_queue.getPathResult(request.m_ref, result.m_path.data(), &count, m_maxPath);
+			result.m_path.resize(dtStatusFailed(status) ? 0 : count);
+			result.m_status = dtStatusFailed(status) ? status : details;
+			request.m_isDone = true;
+		}
+	}
+
+	void RecastPathService::update()
+	{
+		// hand waiting requests round robin to queues with free slots
+		bool isAssigned = true;
+		while (isAssigned && !m_waiting.empty())
+		{
+			isAssigned = false;
+			for (Worker* worker : m_workers)
+			{
+				if (!m_waiting.empty() && worker->m_requests.size() < QueueCapacity)
+				{
+					worker->m_requests.emplace_back(std::move(m_waiting.front()));
+					m_waiting.pop_front();
+					isAssigned = true;
+				}
+			}
+		}
+
+		i32 maxIterations = std::max<i32>(m_maxIterations / i32(m_workers.size()), 1);
+		JobSystem::instance()->parallelFor(i32(m_workers.size()), [&](i32 i)
+		{
+			if (!m_workers[i]->m_requests.empty())
+				updateWorker(*m_workers[i], maxIterations);
+		});
+
+		// collect done requests
+		ulong now = Time::instance()->getMicroseconds();
+		m_stats.m_completed = 0;
+		m_stats.m_maxLatency = 0.f;
+		m_stats.m_queueDepth = i32(m_waiting.size());
+		for (Worker* worker : m_workers)
+		{
+			RequestArray& requests = worker->m_requests;
+			for (size_t i = 0; i < requests.size();)
+			{
+				Request& request = requests[i];
+				if (request.m_isDone)
+				{
+					if (!m_cancelled.erase(request.m_id))
+						m_results[request.m_id] = std::move(request.m_result);
+
+					float latency = float(now - request.m_submitTime) * 0.001f;
+					m_stats.m_averageLatency = m_stats.m_completed || m_stats.m_averageLatency > 0.f ? m_stats.m_averageLatency * 0.95f + latency * 0.05f : latency;
+					m_stats.m_maxLatency = std::max<float>(m_stats.m_maxLatency, latency);
+					m_stats.m_completed++;
+
+					requests[i] = std::move(requests.back());
+					requests.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+
+			m_stats.m_queueDepth += i32(requests.size());
+		}
+	}
+}
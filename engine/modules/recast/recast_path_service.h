@@ -0,0 +1,108 @@
+#pragma once
+
+#include "engine/core/memory/MemAllocDef.h"
+#include "engine/core/math/Math.h"
+#include <DetourNavMeshQuery.h>
+#include <DetourPathQueue.h>
+
+namespace Echo
+{
+	// Path requests queued on the main thread, searched time sliced by
+	// one dtPathQueue per job system thread within a per frame budget
+	class RecastPathService
+	{
+	public:
+		// Request status
+		enum class Status
+		{
+			Unknown,
+			Pending,
+			Done,
+		};
+
+		// Polygon corridor from start to end, partial if end is unreachable
+		struct Result
+		{
+			dtStatus					m_status = 0;
+			Vector3						m_start = Vector3::ZERO;	// start snapped onto the nav mesh
+			Vector3						m_end = Vector3::ZERO;		// end snapped onto the nav mesh
+			dtPolyRef					m_endRef = 0;
+			vector<dtPolyRef>::type		m_path;
+		};
+
+		// Stats
+		struct Stats
+		{
+			i32		m_queueDepth = 0;			// waiting and in flight requests
+			i32		m_completed = 0;			// requests completed by the last update
+			float	m_averageLatency = 0.f;		// milliseconds, moving average
+			float	m_maxLatency = 0.f;			// milliseconds, of the last update
+		};
+
+	public:
+		RecastPathService(dtNavMesh* navMesh, i32 maxPath = 256, i32 maxSearchNodes = 2048);
+		~RecastPathService();
+
+		// queue a request, filter must outlive it
+		ui32 request(const Vector3& start, const Vector3& end, const dtQueryFilter* filter);
+
+		// drop a request, its result is discarded
+		void cancel(ui32 id);
+
+		// status
+		Status getStatus(ui32 id) const;
+
+		// take the result of a done request
+		bool fetch(ui32 id, Result& result);
+
+		// pathfinder iterations per update, shared by all threads
+		i32 getMaxIterations() const { return m_maxIterations; }
+		void setMaxIterations(i32 maxIterations) { m_maxIterations = std::max<i32>(maxIterations, 1); }
+
+		// search queued requests, the nav mesh must not change meanwhile
+		void update();
+
+		// stats
+		const Stats& getStats() const { return m_stats; }
+
+	private:
+		// one request
+		struct Request
+		{
+			ui32					m_id = 0;
+			Vector3					m_start;
+			Vector3					m_end;
+			const dtQueryFilter*	m_filter = nullptr;
+			ulong					m_submitTime = 0;
+			dtPathQueueRef			m_ref = DT_PATHQ_INVALID;
+			bool					m_isDone = false;
+			Result					m_result;
+		};
+		typedef deque<Request>::type RequestQueue;
+		typedef vector<Request>::type RequestArray;
+
+		// one path queue, only touched by one thread during update
+		struct Worker
+		{
+			dtPathQueue				m_queue;
+			RequestArray			m_requests;
+		};
+		typedef vector<Worker*>::type WorkerArray;
+
+		// dtPathQueue slots
+		static const i32 QueueCapacity = 8;
+
+		// run on a job system thread
+		void updateWorker(Worker& worker, i32 maxIterations);
+
+	private:
+		i32							m_maxPath = 256;
+		i32							m_maxIterations = 4096;
+		ui32						m_nextId = 0;
+		RequestQueue				m_waiting;
+		WorkerArray					m_workers;
+		set<ui32>::type				m_cancelled;
+		map<ui32, Result>::type		m_results;
+		Stats						m_stats;
+	};
+}
@@ -11,6 +11,8 @@ namespace Echo
 
 	RvoAgent::~RvoAgent()
 	{
+		if (m_index >= 0)
+			RvoModule::instance()->removeAgent(m_index);
 	}
 
 	void RvoAgent::bindMethods()
@@ -33,8 +35,19 @@ namespace Echo
 		{
 			m_radius = radius;
 
-			if (m_rvoAgent)
-				m_rvoAgent->setRadius(m_radius);
+			if (m_index >= 0)
+				RvoModule::instance()->updateAgent(m_index);
+		}
+	}
+
+	void RvoAgent::setSpeed(float speed)
+	{
+		if (m_speed != speed)
+		{
+			m_speed = speed;
+
+			if (m_index >= 0)
+				RvoModule::instance()->updateAgent(m_index);
 		}
 	}
 
@@ -43,48 +56,23 @@ namespace Echo
 		if (m_goal != goal)
 		{
 			m_goal = goal;
+
+			if (m_index >= 0)
+				RvoModule::instance()->updateAgent(m_index);
 		}
 	}
 
 	Vector3 RvoAgent::getVelocity() const
 	{
-		if (m_rvoAgent)
-		{
-			Vector3 velocity(m_rvoAgent->velocity_.x(), 0.f, m_rvoAgent->velocity_.y());
-			return velocity;
-		}
-
-		return Vector3::ZERO;
+		return m_index >= 0 ? RvoModule::instance()->getAgentVelocity(m_index) : Vector3::ZERO;
 	}
 
 	void RvoAgent::updateInternal(float elapsedTime)
 	{
-		if (!m_rvoAgent)
+		// once added, preferred velocity and position are synced by RvoModule in one pass
+		if (m_index < 0)
 		{
-			Vector3 wpos = getWorldPosition();
-			m_rvoAgent = RvoModule::instance()->getRvoSimulator()->addAgent(RVO::Vector2(wpos.x, wpos.z));
-			m_rvoAgent->setUserData(this);
-			m_rvoAgent->setRadius(m_radius);
-		}
-
-		if (m_rvoAgent && IsGame)
-		{
-			Vector3 goalDir = m_goal - getWorldPosition(); 
-					goalDir.y = 0.f;
-			float   goalLen = goalDir.len();
-			if (goalLen > m_radius)
-			{
-				Vector3 dir = m_speed * goalDir / goalLen;
-				m_rvoAgent->setPrefVelocity(RVO::Vector2(dir.x, dir.z));
-			}
-			else
-			{
-				Vector3 dir = m_speed * goalDir;
-				m_rvoAgent->setPrefVelocity(RVO::Vector2(dir.x, dir.z));
-			}
-
-			const RVO::Vector2& pos = m_rvoAgent->position_;
-			this->setWorldPosition(Vector3(pos.x(), getWorldPosition().y, pos.y()));
+			m_index = RvoModule::instance()->addAgent(this);
 		}
 	}
-}
\ No newline at end of file
+}
@@ -19,7 +19,7 @@ namespace Echo
 
 		// Velocity
 		float getSpeed() const { return m_speed; }
-		void setSpeed(float speed) { m_speed = speed; }
+		void setSpeed(float speed);
 
 		// Goal
 		const Vector3& getGoal() const { return m_goal; }
@@ -33,7 +33,7 @@ namespace Echo
 		virtual void updateInternal(float elapsedTime) override;
 
 	public:
-		RVO::Agent* m_rvoAgent = nullptr;
+		i32			m_index = -1;		// index of RvoModule agent arrays
 		float		m_radius = 1.f;
 		float		m_speed = 1.f;
 		Vector3		m_goal = Vector3::ZERO;
@@ -12,6 +12,7 @@ namespace Echo
 		m_rvoSimulator = EchoNew(RVO::RVOSimulator);
 		m_rvoSimulator->setTimeStep(0.1f);
 		m_rvoSimulator->setAgentDefaults(15.0f, 10, 10.0f, 5.0f, 2.0f, 2.0f);
+		m_rvoSimulator->setAgentTreeRebuildInterval(m_treeRebuildInterval);
 	}
 
 	RvoModule::~RvoModule()
@@ -29,8 +30,14 @@ namespace Echo
 	{
 		CLASS_BIND_METHOD(RvoModule, getDebugDrawOption);
 		CLASS_BIND_METHOD(RvoModule, setDebugDrawOption);
+		CLASS_BIND_METHOD(RvoModule, isInterpolate);
+		CLASS_BIND_METHOD(RvoModule, setInterpolate);
+		CLASS_BIND_METHOD(RvoModule, getTreeRebuildInterval);
+		CLASS_BIND_METHOD(RvoModule, setTreeRebuildInterval);
 
 		CLASS_REGISTER_PROPERTY(RvoModule, "DebugDraw", Variant::Type::StringOption, getDebugDrawOption, setDebugDrawOption);
+		CLASS_REGISTER_PROPERTY(RvoModule, "Interpolate", Variant::Type::Bool, isInterpolate, setInterpolate);
+		CLASS_REGISTER_PROPERTY(RvoModule, "TreeRebuildInterval", Variant::Type::Int, getTreeRebuildInterval, setTreeRebuildInterval);
 	}
 
 	void RvoModule::registerTypes()
@@ -50,6 +57,104 @@ namespace Echo
 		m_debugDrawOption = option.toEnum(DebugDrawOption::Editor);
 	}
 
+	void RvoModule::setTreeRebuildInterval(i32 interval)
+	{
+		m_treeRebuildInterval = std::max<i32>(interval, 1);
+		m_rvoSimulator->setAgentTreeRebuildInterval(m_treeRebuildInterval);
+	}
+
+	i32 RvoModule::addAgent(RvoAgent* agent)
+	{
+		const Vector3& wpos = agent->getWorldPosition();
+		RVO::Agent* rvoAgent = m_rvoSimulator->addAgent(RVO::Vector2(wpos.x, wpos.z));
+		if (!rvoAgent)
+			return -1;
+
+		rvoAgent->setUserData(agent);
+		rvoAgent->setRadius(agent->getRadius());
+
+		m_agents.emplace_back(agent);
+		m_goals.emplace_back(agent->getGoal());
+		m_speeds.emplace_back(agent->getSpeed());
+		m_previousPositions.emplace_back(rvoAgent->position_);
+		m_positions.emplace_back(rvoAgent->position_);
+
+		return i32(m_agents.size()) - 1;
+	}
+
+	void RvoModule::removeAgent(i32 index)
+	{
+		// the simulator moves its last agent into the hole, so do we
+		m_rvoSimulator->removeAgent(index);
+
+		i32 last = i32(m_agents.size()) - 1;
+		if (index != last)
+		{
+			m_agents[index] = m_agents[last];
+			m_goals[index] = m_goals[last];
+			m_speeds[index] = m_speeds[last];
+			m_previousPositions[index] = m_previousPositions[last];
+			m_positions[index] = m_positions[last];
+			m_agents[index]->m_index = index;
+		}
+
+		m_agents.pop_back();
+		m_goals.pop_back();
+		m_speeds.pop_back();
+		m_previousPositions.pop_back();
+		m_positions.pop_back();
+	}
+
+	void RvoModule::updateAgent(i32 index)
+	{
+		RvoAgent* agent = m_agents[index];
+		m_goals[index] = agent->getGoal();
+		m_speeds[index] = agent->getSpeed();
+		m_rvoSimulator->getAgents()[index]->setRadius(agent->getRadius());
+	}
+
+	Vector3 RvoModule::getAgentVelocity(i32 index) const
+	{
+		const RVO::Vector2& velocity = m_rvoSimulator->getAgentVelocity(index);
+		return Vector3(velocity.x(), 0.f, velocity.y());
+	}
+
+	void RvoModule::syncPrefVelocities()
+	{
+		const std::vector<RVO::Agent*>& rvoAgents = m_rvoSimulator->getAgents();
+		for (size_t i = 0; i < rvoAgents.size(); i++)
+		{
+			RVO::Agent* rvoAgent = rvoAgents[i];
+			RVO::Vector2 goalDir(m_goals[i].x - m_positions[i].x(), m_goals[i].z - m_positions[i].y());
+			float goalLen = RVO::abs(goalDir);
+			if (goalLen > rvoAgent->getRadius())
+				rvoAgent->setPrefVelocity(goalDir * (m_speeds[i] / goalLen));
+			else
+				rvoAgent->setPrefVelocity(goalDir * m_speeds[i]);
+		}
+	}
+
+	void RvoModule::syncPositions()
+	{
+		const std::vector<RVO::Agent*>& rvoAgents = m_rvoSimulator->getAgents();
+		for (size_t i = 0; i < rvoAgents.size(); i++)
+		{
+			m_previousPositions[i] = m_positions[i];
+			m_positions[i] = rvoAgents[i]->position_;
+		}
+	}
+
+	void RvoModule::applyPositions(float alpha)
+	{
+		for (size_t i = 0; i < m_agents.size(); i++)
+		{
+			RVO::Vector2 position = m_previousPositions[i] + (m_positions[i] - m_previousPositions[i]) * alpha;
+			const Vector3& wpos = m_agents[i]->getWorldPosition();
+			if (wpos.x != position.x() || wpos.z != position.y())
+				m_agents[i]->setWorldPosition(Vector3(position.x(), wpos.y, position.y()));
+		}
+	}
+
 	void RvoModule::update(float elapsedTime)
 	{
 		float stepLength = m_rvoSimulator->getTimeStep();
@@ -57,11 +162,19 @@ namespace Echo
 		m_accumulator += elapsedTime;
 		while (m_accumulator > stepLength)
 		{
+			if (IsGame)
+				syncPrefVelocities();
+
 			m_rvoSimulator->doStep();
+			syncPositions();
 
 			m_accumulator -= stepLength;
 		}
 
+		// rendered positions trail the simulation by at most one step
+		if (IsGame)
+			applyPositions(m_isInterpolate ? m_accumulator / stepLength : 1.f);
+
 		if ((m_debugDrawOption == DebugDrawOption::All) || 
 			(m_debugDrawOption == DebugDrawOption::Editor && !IsGame) || 
 			(m_debugDrawOption == DebugDrawOption::Game && IsGame))
@@ -37,14 +37,49 @@ namespace Echo
 		// Rvo simulator
 		RVO::RVOSimulator* getRvoSimulator() { return m_rvoSimulator; }
 
+		// Agents, index is the agent number of the rvo simulator
+		i32 addAgent(RvoAgent* agent);
+		void removeAgent(i32 index);
+
+		// Copy goal, speed and radius of agent node
+		void updateAgent(i32 index);
+
+		// Agent velocity
+		Vector3 getAgentVelocity(i32 index) const;
+
+		// Interpolate agent positions between simulation steps
+		bool isInterpolate() const { return m_isInterpolate; }
+		void setInterpolate(bool isInterpolate) { m_isInterpolate = isInterpolate; }
+
+		// Steps the agent kd-tree is refit before it is rebuilt
+		i32 getTreeRebuildInterval() const { return m_treeRebuildInterval; }
+		void setTreeRebuildInterval(i32 interval);
+
 		// Debug draw
 		StringOption getDebugDrawOption() const;
 		void setDebugDrawOption(const StringOption& option);
 
+	private:
+		// Set preferred velocities of all agents
+		void syncPrefVelocities();
+
+		// Read positions after a simulation step
+		void syncPositions();
+
+		// Write agent node positions
+		void applyPositions(float alpha);
+
 	private:
 		RVO::RVOSimulator*  m_rvoSimulator = nullptr;
 		float				m_accumulator = 0.f;
 		RvoDebugDraw		m_rvoDebugDraw;
 		DebugDrawOption		m_debugDrawOption = DebugDrawOption::Editor;
+		bool				m_isInterpolate = true;
+		i32					m_treeRebuildInterval = 8;
+		vector<RvoAgent*>::type			m_agents;
+		vector<Vector3>::type			m_goals;
+		vector<float>::type				m_speeds;
+		vector<RVO::Vector2>::type		m_previousPositions;
+		vector<RVO::Vector2>::type		m_positions;
 	};
 }
@@ -1,13 +1,16 @@
 #include "terrain.h"
 #include "engine/core/log/Log.h"
+#include "engine/core/io/io.h"
 #include "engine/core/scene/node_tree.h"
 #include "base/renderer.h"
 #include "base/shader/shader_program.h"
 #include "engine/core/main/Engine.h"
-#include "engine/modules/ui/font/font_library.h"
 
 namespace Echo
 {
+    // frames an unselected tile keeps its mesh before being released
+    static const ui32 TileEvictFrames = 120;
+
     Terrain::Terrain()
     {
         setRenderType("3d");
@@ -28,222 +31,304 @@ namespace Echo
 		CLASS_BIND_METHOD(Terrain, setHeightRange);
 		CLASS_BIND_METHOD(Terrain, getGridSpacing);
 		CLASS_BIND_METHOD(Terrain, setGridSpacing);
+        CLASS_BIND_METHOD(Terrain, getLodDistance);
+        CLASS_BIND_METHOD(Terrain, setLodDistance);
         CLASS_BIND_METHOD(Terrain, getMaterial);
         CLASS_BIND_METHOD(Terrain, setMaterial);
         
         CLASS_REGISTER_PROPERTY(Terrain, "Data", Variant::Type::ResourcePath, getDataPath, setDataPath);
 		CLASS_REGISTER_PROPERTY(Terrain, "HeightRange", Variant::Type::Real, getHeightRange, setHeightRange);
 		CLASS_REGISTER_PROPERTY(Terrain, "GridSpacing", Variant::Type::Int, getGridSpacing, setGridSpacing);
+        CLASS_REGISTER_PROPERTY(Terrain, "LodDistance", Variant::Type::Real, getLodDistance, setLodDistance);
         CLASS_REGISTER_PROPERTY(Terrain, "Material", Variant::Type::Object, getMaterial, setMaterial);
         CLASS_REGISTER_PROPERTY_HINT(Terrain, "Material", PropertyHintType::ObjectType, "Material");
     }
     
     void Terrain::setDataPath(const ResourcePath& path)
     {
-        EchoSafeDelete(m_heightmapImage, Image);
-        EchoSafeDeleteContainer(m_layerImages, Image);
+        m_data.clear();
 
         if (m_dataPath.setPath(path.getPath()))
         {
-            String heightmapPath = m_dataPath.getPath() + "heightmap.png";
-            if (IO::instance()->isExist(heightmapPath))
+            // terrain.raw is mapped directly, delete it to import the images again
+            String rawPath = m_dataPath.getPath() + "terrain.raw";
+            if (!IO::instance()->isExist(rawPath) || !m_data.load(rawPath))
             {
-				m_heightmapImage = Image::loadFromFile(heightmapPath);
-				if (m_heightmapImage)
-				{
-					m_columns = m_heightmapImage->getWidth();
-					m_rows = m_heightmapImage->getHeight();
-
-                    m_heightData.clear();
-                    for (i32 column = 0; column < m_columns; column++)
+                String heightmapPath = m_dataPath.getPath() + "heightmap.png";
+                if (IO::instance()->isExist(heightmapPath))
+                {
+                    Image* heightmapImage = Image::loadFromFile(heightmapPath);
+
+                    vector<Image*>::type layerImages;
+                    for (i32 i = 0; i < 4; i++)
                     {
-                        for (i32 row = 0; row < m_rows; row++)
-                        {
-							Color color = m_heightmapImage->getColor(column, row, 0);
-                            m_heightData.push_back(color.r);
-                        }
+                        String layerImagePath = m_dataPath.getPath() + StringUtil::Format("layer_%i.png", i);
+                        layerImages.emplace_back(IO::instance()->isExist(layerImagePath) ? Image::loadFromFile(layerImagePath) : nullptr);
                     }
 
-					m_isRenderableDirty = true;
-				}
-            }
+                    if (m_data.import(heightmapImage, layerImages) && !IsGame)
+                        m_data.save(rawPath);
 
-            for (i32 i = 0; i < 4; i++)
-            {
-                String layerImagePath = m_dataPath.getPath() + StringUtil::Format("layer_%i.png", i);
-                if (IO::instance()->isExist(layerImagePath))
-                {
-					Image* layerImage = Image::loadFromFile(layerImagePath);
-					m_layerImages.emplace_back(layerImage);
-                }
-                else
-                {
-                    m_layerImages.emplace_back(nullptr);
+                    EchoSafeDelete(heightmapImage, Image);
+                    EchoSafeDeleteContainer(layerImages, Image);
                 }
             }
         }
+
+        onDataChanged();
     }
 
     void Terrain::setHeight(i32 minX, i32 minY, i32 width, i32 height, vector<float>::type& heightData)
     {
-        m_rows = width;
-        m_columns = height;
-        m_heightData = heightData;
+        if (width <= 0 || height <= 0 || heightData.size() < size_t(width * height))
+            return;
 
-        m_isRenderableDirty = true;
+        // edits inside the current terrain only rebuild the tiles they touch
+        bool isInside = m_data.isValid() && minX >= 0 && minY >= 0 && minX + width <= m_rows && minY + height <= m_columns;
+        if (!isInside)
+            m_data.create(minX + width, minY + height, false);
+
+        for (i32 z = 0; z < height; z++)
+        {
+            for (i32 x = 0; x < width; x++)
+                m_data.setHeight(minX + x, minY + z, heightData[z * width + x]);
+        }
+
+        if (isInside)
+            markTilesDirty(minX, minY, minX + width - 1, minY + height - 1);
+        else
+            onDataChanged();
     }
 
 	void Terrain::setHeightRange(float range)
 	{ 
 		m_heightRange = range;
 
-		m_isRenderableDirty = true;
+		onDataChanged();
 	}
 
 	void Terrain::setGridSpacing(i32 gridSpacing)
 	{ 
 		m_gridSpacing = Math::Clamp(gridSpacing, 1, 512);
 
-        m_isRenderableDirty = true;
+        onDataChanged();
 	}
 
+    void Terrain::setLodDistance(float lodDistance)
+    {
+        m_lodDistance = std::max<float>(lodDistance, 0.f);
+    }
+
     void Terrain::setMaterial( Object* material)
     {
         m_material = (Material*)material;
         
-        m_isRenderableDirty = true;
+        // render proxies hold the old material
+        clearTiles();
     }
-    
-    void Terrain::buildRenderable()
+
+    void Terrain::checkMaterial()
     {
-        if (m_isRenderableDirty && m_columns > 0 && m_rows > 0)
+        if(!m_material)
         {
-            clearRenderable();
-            
-            // make sure one material is valid
-            if(!m_material)
-            {
-                ShaderProgramPtr shader = ShaderProgram::getDefault3D({ "HAS_NORMALS" });
-                
-                // material
-                m_material = ECHO_CREATE_RES(Material);
-                m_material->setShaderPath(shader->getPath());
-            }
+            ShaderProgramPtr shader = ShaderProgram::getDefault3D({ "HAS_NORMALS" });
             
-            // mesh
-			updateMeshBuffer();
-            
-			// create renderable
-            m_renderable = RenderProxy::create(m_mesh, m_material, this, true);
-            
-            m_isRenderableDirty = false;
+            // material
+            m_material = ECHO_CREATE_RES(Material);
+            m_material->setShaderPath(shader->getPath());
         }
     }
-    
-    void Terrain::updateInternal(float elapsedTime)
+
+    void Terrain::onDataChanged()
     {
-        if (isNeedRender())
-            buildRenderable();
+        clearTiles();
+
+        m_rows = m_data.isValid() ? m_data.getWidth() : 0;
+        m_columns = m_data.isValid() ? m_data.getHeight() : 0;
 
-        if (m_renderable)
-            m_renderable->setSubmitToRenderQueue(isNeedRender());
+        // root tile covers the whole terrain, leaf tiles are one sample per quad
+        m_maxDepth = 0;
+        while ((TerrainTile::Quads << m_maxDepth) < std::max<i32>(m_rows, m_columns) - 1)
+            m_maxDepth++;
+
+        m_localAABB.reset();
+        if (m_rows > 0 && m_columns > 0)
+        {
+            m_localAABB.addPoint(Vector3(0.f, -m_heightRange, 0.f));
+            m_localAABB.addPoint(Vector3(float((m_rows - 1) * m_gridSpacing), m_heightRange, float((m_columns - 1) * m_gridSpacing)));
+        }
     }
     
-    void Terrain::buildMeshData(VertexArray& oVertices, IndiceArray& oIndices)
+    void Terrain::updateInternal(float elapsedTime)
     {
-        if(m_columns>0 && m_rows>0)
+        m_frame++;
+        m_selectedTiles.clear();
+
+        if (isNeedRender() && m_rows > 1 && m_columns > 1)
         {
-            // vertex buffer
-			for (i32 row = 0; row < m_rows; row++)
+            checkMaterial();
+
+            Camera* camera = getCamera();
+            if (camera)
             {
-				for (i32 column = 0; column < m_columns; column++)
-                {
-                    VertexFormat vert;
-                    vert.m_position = Vector3(row * m_gridSpacing, getHeight(row, column), column * m_gridSpacing);
-                    vert.m_color = 0xFFFFFFFF;
-                    vert.m_normal = getNormal(row, column);
-                    vert.m_uv = Vector2(row, column);
-                    vert.m_layerIndices = Color(0, 1, 2, 3).getABGR();
-
-                    float weight = Math::IntervalRandom(0.f, 1.f);
-                    vert.m_layerWeights = Vector4(getWeight(row, column, 0), getWeight(row, column, 1), getWeight(row, column, 2), getWeight(row, column, 3));
-                    oVertices.emplace_back(vert);
-                }
+                Matrix4 invWorld = getWorldMatrix();
+                invWorld.detInverse();
+
+                selectTiles(invWorld.transform(camera->getPosition()), 0, 0, 0);
             }
-            
-            // index buffer
-			i32 rowLength = m_rows - 1;
-			i32 columnLength = m_columns - 1;
-			for (i32 row = 0; row < rowLength; row++)
-			{
-				for (i32 column = 0; column < columnLength; column++)
+
+            // stitch masks depend on the whole selection, so they are calculated after it
+            for (auto& it : m_selectedTiles)
+            {
+                it.second->setStitchMask(calcStitchMask(it.second));
+                it.second->update(true);
+            }
+        }
+
+        for (auto it = m_tiles.begin(); it != m_tiles.end();)
+        {
+            TerrainTile* tile = it->second;
+            if (tile->getSelectedFrame() != m_frame)
+            {
+                if (m_frame - tile->getSelectedFrame() > TileEvictFrames)
                 {
-                    i32 indexLeftTop = row * m_columns + column;
-                    i32 indexRightTop = indexLeftTop + 1;
-                    i32 indexLeftBottom = indexLeftTop + m_columns;
-                    i32 indexRightBottom = indexRightTop + m_columns;
-                    
-                    oIndices.emplace_back(indexLeftTop);
-                    oIndices.emplace_back(indexRightBottom);
-                    oIndices.emplace_back(indexRightTop);
-                    oIndices.emplace_back(indexLeftTop);
-                    oIndices.emplace_back(indexLeftBottom);
-                    oIndices.emplace_back(indexRightBottom);
+                    EchoSafeDelete(tile, TerrainTile);
+                    it = m_tiles.erase(it);
+                    continue;
                 }
+
+                tile->hide();
             }
+
+            it++;
         }
     }
-    
-    void Terrain::updateMeshBuffer()
+
+    void Terrain::selectTiles(const Vector3& eye, i32 depth, i32 x, i32 z)
     {
-		// create mesh
-		if (!m_mesh) m_mesh = Mesh::create(true, true);
+        const i32 step = 1 << (m_maxDepth - depth);
+        const i32 size = TerrainTile::Quads * step;
+        const i32 originX = x * size;
+        const i32 originZ = z * size;
+        if (originX >= m_rows - 1 || originZ >= m_columns - 1)
+            return;
 
-		// update data
-        VertexArray    vertices;
-        IndiceArray    indices;
-        buildMeshData(vertices, indices);
-        
-        MeshVertexFormat define;
-        define.m_isUseNormal = true;
-        define.m_isUseVertexColor = true;
-        define.m_isUseUV = true;
-        define.m_isUseBlendingData = true;
-        
-        m_mesh->updateIndices(static_cast<ui32>(indices.size()), sizeof(ui32), indices.data());
-        m_mesh->updateVertexs(define, static_cast<ui32>(vertices.size()), (const Byte*)vertices.data());
+        // distance from eye to the tile bounds
+        const float spacing = float(m_gridSpacing);
+        AABB box(originX * spacing, -m_heightRange, originZ * spacing, std::min<i32>(originX + size, m_rows - 1) * spacing, m_heightRange, std::min<i32>(originZ + size, m_columns - 1) * spacing);
+        Vector3 delta(std::max<float>(std::max<float>(box.vMin.x - eye.x, eye.x - box.vMax.x), 0.f),
+                      std::max<float>(std::max<float>(box.vMin.y - eye.y, eye.y - box.vMax.y), 0.f),
+                      std::max<float>(std::max<float>(box.vMin.z - eye.z, eye.z - box.vMax.z), 0.f));
 
-        m_localAABB = m_mesh->getLocalBox();
+        if (depth < m_maxDepth && delta.len() < size * spacing * m_lodDistance)
+        {
+            selectTiles(eye, depth + 1, x * 2,     z * 2);
+            selectTiles(eye, depth + 1, x * 2 + 1, z * 2);
+            selectTiles(eye, depth + 1, x * 2,     z * 2 + 1);
+            selectTiles(eye, depth + 1, x * 2 + 1, z * 2 + 1);
+        }
+        else
+        {
+            TerrainTile* tile = getTile(depth, x, z);
+            tile->setSelectedFrame(m_frame);
+            m_selectedTiles[tile->getKey()] = tile;
+        }
+    }
+
+    i32 Terrain::getSelectedDepth(i32 sampleX, i32 sampleZ, i32 maxDepth)
+    {
+        if (sampleX < 0 || sampleZ < 0 || sampleX >= m_rows - 1 || sampleZ >= m_columns - 1)
+            return -1;
+
+        for (i32 depth = maxDepth; depth >= 0; depth--)
+        {
+            i32 size = TerrainTile::Quads << (m_maxDepth - depth);
+            if (m_selectedTiles.count(TerrainTile::makeKey(depth, sampleX / size, sampleZ / size)))
+                return depth;
+        }
+
+        return -1;
+    }
+
+    ui32 Terrain::calcStitchMask(TerrainTile* tile)
+    {
+        // only coarser neighbours are stitched, a finer neighbour stitches itself to this tile
+        const i32 depth = tile->getDepth();
+        const i32 size = TerrainTile::Quads * tile->getStep();
+        const i32 originX = tile->getOriginX();
+        const i32 originZ = tile->getOriginZ();
+        const i32 neighbours[4] =
+        {
+            getSelectedDepth(originX - 1,    originZ,        depth),
+            getSelectedDepth(originX + size, originZ,        depth),
+            getSelectedDepth(originX,        originZ - 1,    depth),
+            getSelectedDepth(originX,        originZ + size, depth),
+        };
+
+        ui32 mask = 0;
+        for (i32 edge = 0; edge < 4; edge++)
+        {
+            if (neighbours[edge] >= 0)
+                mask |= ui32(std::min<i32>(depth - neighbours[edge], 15)) << (edge * 4);
+        }
+
+        return mask;
+    }
+
+    void Terrain::markTilesDirty(i32 minX, i32 minZ, i32 maxX, i32 maxZ)
+    {
+        // normals look one step outside the tile
+        for (auto& it : m_tiles)
+        {
+            TerrainTile* tile = it.second;
+            i32 step = tile->getStep();
+            i32 size = TerrainTile::Quads * step;
+            if (tile->getOriginX() - step <= maxX && tile->getOriginX() + size + step >= minX &&
+                tile->getOriginZ() - step <= maxZ && tile->getOriginZ() + size + step >= minZ)
+                tile->markDirty();
+        }
+    }
+
+    TerrainTile* Terrain::getTile(i32 depth, i32 x, i32 z)
+    {
+        TerrainTile*& tile = m_tiles[TerrainTile::makeKey(depth, x, z)];
+        if (!tile)
+            tile = EchoNew(TerrainTile(this, depth, x, z, 1 << (m_maxDepth - depth)));
+
+        return tile;
     }
     
     void Terrain::clear()
     {
-        clearRenderable();
+        clearTiles();
+        m_data.clear();
     }
     
-    void Terrain::clearRenderable()
+    void Terrain::clearTiles()
     {
-        m_renderable.reset();
-        m_mesh.reset();
+        for (auto& it : m_tiles)
+            EchoSafeDelete(it.second, TerrainTile);
+
+        m_tiles.clear();
+        m_selectedTiles.clear();
     }
     
     float Terrain::getHeight(i32 x, i32 z)
     {
-        i32 offset = z * m_rows + x;
-        return offset < m_heightData.size() ? (m_heightData[offset] * 2.f - 1.f) * m_heightRange : 0.f;
+        return m_data.isValid() ? (m_data.getHeight(x, z) * 2.f - 1.f) * m_heightRange : 0.f;
     }
     
-    Vector3 Terrain::getNormal( i32 x, i32 z)
+    Vector3 Terrain::getNormal( i32 x, i32 z, i32 step)
     {
-        if(!m_heightData.empty())
+        if(m_data.isValid())
         {
-            float h0 = getHeight(   x,   z);
-            float h1 = getHeight( x+1,   z) - h0;
-            float h2 = getHeight(   x, z-1) - h0;
-            float h3 = getHeight( x-1,   z) - h0;
-            float h4 = getHeight(   x, z+1) - h0;
+            float h0 = getHeight(       x,        z);
+            float h1 = getHeight(x + step,        z) - h0;
+            float h2 = getHeight(       x, z - step) - h0;
+            float h3 = getHeight(x - step,        z) - h0;
+            float h4 = getHeight(       x, z + step) - h0;
             
-            Vector3 normal( h3 - h1, 2, h2 - h4);
+            Vector3 normal( h3 - h1, 2.f * step * m_gridSpacing, h2 - h4);
             normal.normalize();
             
             return normal;
@@ -254,17 +339,9 @@ namespace Echo
 
     float Terrain::getWeight(i32 x, i32 z, i32 index)
     {
-        if (index<m_layerImages.size() && m_layerImages[index])
-        {
-			i32 column = Math::Clamp(x, 0, m_columns - 1);
-			i32 row = Math::Clamp(z, 0, m_rows - 1);
-			Color color = m_layerImages[index]->getColor(column, row, 0);
-			float height = color.r;
-
-			return height;
-        }
+        if (index >= 0 && index < 4 && m_data.isHaveLayers())
+            return ((m_data.getWeights(x, z) >> (index * 8)) & 0xFF) / 255.f;
 
         return 0.f;
     }
 }
-
@@ -6,6 +6,7 @@
 #include "engine/core/render/base/proxy/render_proxy.h"
 #include "engine/core/render/base/image/image.h"
 #include "terrain_tile.h"
+#include "terrain_data.h"
 
 namespace Echo
 {
@@ -49,6 +50,10 @@ namespace Echo
 		// grid spacing
 		i32 getGridSpacing() const { return m_gridSpacing; }
 		void setGridSpacing(i32 gridSpacing);
+
+        // lod distance, a tile splits when camera is closer than (tile size * lod distance)
+        float getLodDistance() const { return m_lodDistance; }
+        void setLodDistance(float lodDistance);
         
         // material
         Material* getMaterial() const { return m_material; }
@@ -57,42 +62,53 @@ namespace Echo
         // get height
         float getHeight(i32 x, i32 z);
         
-        // get normal
-        Vector3 getNormal(i32 x, i32 z);
+        // get normal (central difference over step samples)
+        Vector3 getNormal(i32 x, i32 z, i32 step=1);
 
         // get weight
         float getWeight(i32 x, i32 z, i32 index);
         
     protected:
-        // build drawable
-        void buildRenderable();
-        void clearRenderable();
-        
         // update
         virtual void updateInternal(float elapsedTime) override;
-        
-        // update vertex buffer
-        void updateMeshBuffer();
-        
-        // build mesh data by drawables data
-        void buildMeshData(VertexArray& oVertices, IndiceArray& oIndices);
-        
+
+        // data changed, rebuild quadtree
+        void onDataChanged();
+
+        // select tiles of the quadtree by camera distance
+        void selectTiles(const Vector3& eye, i32 depth, i32 x, i32 z);
+
+        // stitch mask of a selected tile
+        ui32 calcStitchMask(TerrainTile* tile);
+
+        // depth of the selected tile covering sample, -1 if none
+        i32 getSelectedDepth(i32 sampleX, i32 sampleZ, i32 maxDepth);
+
+        // mark tiles overlapping the sample region dirty
+        void markTilesDirty(i32 minX, i32 minZ, i32 maxX, i32 maxZ);
+
+        // get or create tile
+        TerrainTile* getTile(i32 depth, i32 x, i32 z);
+
+        // make sure one material is valid
+        void checkMaterial();
+
         // clear
         void clear();
+        void clearTiles();
         
     private:
-        bool                    m_isRenderableDirty = true;
         ResourcePath            m_dataPath = ResourcePath("", "");
-        ImagePtr                m_heightmapImage = nullptr;
-        vector<Image*>::type    m_layerImages;
 		float					m_heightRange = 256.f;
 		i32						m_gridSpacing = 1;
-        MeshPtr                 m_mesh;
+        float                   m_lodDistance = 2.f;
         MaterialPtr             m_material;
-        RenderProxyPtr          m_renderable = nullptr;
         i32                     m_columns = 0;
         i32                     m_rows = 0;
-        vector<float>::type     m_heightData;
-		//TerrainTiles			m_tiles;
+        TerrainData             m_data;
+        i32                     m_maxDepth = 0;
+        ui32                    m_frame = 0;
+		TerrainTiles			m_tiles;
+        TerrainTiles            m_selectedTiles;
     };
 }
@@ -0,0 +1,190 @@
+#include "terrain_data.h"
+#include "engine/core/io/io.h"
+#include "engine/core/log/Log.h"
+#include "engine/core/render/base/image/pixel_util.h"
+
+namespace Echo
+{
+	TerrainData::TerrainData()
+	{
+	}
+
+	TerrainData::~TerrainData()
+	{
+		clear();
+	}
+
+	size_t TerrainData::getTexelIndex(i32 x, i32 z) const
+	{
+		x = Math::Clamp<i32>(x, 0, m_header.m_width - 1);
+		z = Math::Clamp<i32>(z, 0, m_header.m_height - 1);
+
+		const ui32 pageSize = m_header.m_pageSize;
+		size_t page = size_t(z / pageSize) * m_pagesX + (x / pageSize);
+
+		return page * pageSize * pageSize + (z % pageSize) * pageSize + (x % pageSize);
+	}
+
+	size_t TerrainData::getPageCount() const
+	{
+		const ui32 pageSize = m_header.m_pageSize;
+		size_t pagesZ = (m_header.m_height + pageSize - 1) / pageSize;
+
+		return pagesZ * m_pagesX;
+	}
+
+	void TerrainData::bindPointers(Byte* data)
+	{
+		const ui32 pageSize = m_header.m_pageSize;
+		m_pagesX = (m_header.m_width + pageSize - 1) / pageSize;
+
+		size_t texels = getPageCount() * pageSize * pageSize;
+		m_heights = reinterpret_cast<ui16*>(data);
+		m_weights = m_header.m_layerCount ? reinterpret_cast<ui32*>(data + ((texels * sizeof(ui16) + 3) & ~size_t(3))) : nullptr;
+	}
+
+	bool TerrainData::load(const String& path)
+	{
+		clear();
+
+		if (m_file.open(path, MemoryMappedFile::Access::CopyOnWrite) && m_file.getSize() >= sizeof(Header))
+		{
+			const Header* header = m_file.getData<const Header*>();
+			if (std::memcmp(header->m_magic, "ETRN", 4) == 0 && header->m_version == 1 && header->m_pageSize > 0)
+			{
+				m_header = *header;
+				bindPointers(m_file.getData<Byte*>() + sizeof(Header));
+
+				const Byte* end = m_file.getData<Byte*>() + m_file.getSize();
+				const Byte* dataEnd = m_weights ? (Byte*)(m_weights + getPageCount() * m_header.m_pageSize * m_header.m_pageSize) :
+												  (Byte*)(m_heights + getPageCount() * m_header.m_pageSize * m_header.m_pageSize);
+				if (dataEnd <= end)
+					return true;
+			}
+
+			EchoLogError("TerrainData::load failed, invalid raw file [%s]", path.c_str());
+		}
+
+		clear();
+		return false;
+	}
+
+	bool TerrainData::save(const String& path)
+	{
+		if (!isValid())
+			return false;
+
+		const size_t texels = getPageCount() * m_header.m_pageSize * m_header.m_pageSize;
+		const size_t heightBytes = (texels * sizeof(ui16) + 3) & ~size_t(3);
+		const size_t weightBytes = m_weights ? texels * sizeof(ui32) : 0;
+
+		DataStream* stream = IO::instance()->open(path, DataStream::WRITE);
+		if (stream && stream->isWriteable())
+		{
+			stream->write(&m_header, sizeof(Header));
+			stream->write(m_heights, heightBytes);
+			if (weightBytes)
+				stream->write(m_weights, weightBytes);
+
+			stream->close();
+			EchoSafeDelete(stream, DataStream);
+
+			return true;
+		}
+
+		EchoSafeDelete(stream, DataStream);
+		return false;
+	}
+
+	void TerrainData::create(i32 width, i32 height, bool isHaveLayers)
+	{
+		clear();
+
+		m_header.m_width = std::max<i32>(width, 1);
+		m_header.m_height = std::max<i32>(height, 1);
+		m_header.m_layerCount = isHaveLayers ? 4 : 0;
+		m_pagesX = (m_header.m_width + m_header.m_pageSize - 1) / m_header.m_pageSize;
+
+		const size_t texels = getPageCount() * m_header.m_pageSize * m_header.m_pageSize;
+		const size_t heightBytes = (texels * sizeof(ui16) + 3) & ~size_t(3);
+		m_memory.assign(heightBytes + (isHaveLayers ? texels * sizeof(ui32) : 0), 0);
+
+		// mid height, same as the flat terrain of normalized height 0.5
+		bindPointers(m_memory.data());
+		std::fill(m_heights, m_heights + texels, ui16(32768));
+	}
+
+	bool TerrainData::import(Image* heightmap, const vector<Image*>::type& layers)
+	{
+		if (!heightmap)
+			return false;
+
+		// image rows map to x, image columns map to z
+		const i32 width = heightmap->getHeight();
+		const i32 height = heightmap->getWidth();
+
+		bool isHaveLayers = false;
+		for (Image* layer : layers)
+			isHaveLayers = isHaveLayers || (layer && layer->getWidth() == ui32(height) && layer->getHeight() == ui32(width));
+
+		create(width, height, isHaveLayers);
+
+		// decode row by row straight from the pixel buffer
+		Color color;
+		const ui32 pixelSize = PixelUtil::GetPixelBytes(heightmap->getPixelFormat());
+		const Byte* pixels = heightmap->getData();
+		for (i32 row = 0; row < width; row++)
+		{
+			for (i32 column = 0; column < height; column++, pixels += pixelSize)
+			{
+				PixelUtil::UnpackColor(color, heightmap->getPixelFormat(), pixels);
+				setHeight(row, column, color.r);
+			}
+		}
+
+		for (size_t i = 0; isHaveLayers && i < layers.size() && i < 4; i++)
+		{
+			Image* layer = layers[i];
+			if (layer && layer->getWidth() == ui32(height) && layer->getHeight() == ui32(width))
+			{
+				const ui32 layerPixelSize = PixelUtil::GetPixelBytes(layer->getPixelFormat());
+				const Byte* layerPixels = layer->getData();
+				for (i32 row = 0; row < width; row++)
+				{
+					for (i32 column = 0; column < height; column++, layerPixels += layerPixelSize)
+					{
+						PixelUtil::UnpackColor(color, layer->getPixelFormat(), layerPixels);
+						ui32 weight = ui32(Math::Clamp(color.r, 0.f, 1.f) * 255.f + 0.5f);
+						ui32& weights = m_weights[getTexelIndex(row, column)];
+						weights = (weights & ~(0xFFu << (i * 8))) | (weight << (i * 8));
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void TerrainData::clear()
+	{
+		m_file.close();
+		m_memory.clear();
+		m_memory.shrink_to_fit();
+		m_heights = nullptr;
+		m_weights = nullptr;
+		m_header = Header();
+		m_pagesX = 0;
+	}
+
+	void TerrainData::setHeight(i32 x, i32 z, float height)
+	{
+		if (x >= 0 && z >= 0 && x < getWidth() && z < getHeight())
+			m_heights[getTexelIndex(x, z)] = ui16(Math::Clamp(height, 0.f, 1.f) * 65535.f + 0.5f);
+	}
+
+	void TerrainData::setWeights(i32 x, i32 z, ui32 weights)
+	{
+		if (m_weights && x >= 0 && z >= 0 && x < getWidth() && z < getHeight())
+			m_weights[getTexelIndex(x, z)] = weights;
+	}
+}
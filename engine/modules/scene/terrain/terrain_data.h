@@ -0,0 +1,77 @@
+#pragma once
+
+#include "engine/core/io/memory_mapped_file.h"
+#include "engine/core/render/base/image/image.h"
+
+namespace Echo
+{
+	// Height and layer weights stored in square pages, so a terrain tile only touches a few
+	// contiguous blocks of the (memory mapped) raw file
+	class TerrainData
+	{
+	public:
+		// Raw file header
+		struct Header
+		{
+			char	m_magic[4] = { 'E', 'T', 'R', 'N' };
+			ui32	m_version = 1;
+			ui32	m_width = 0;				// samples along x
+			ui32	m_height = 0;				// samples along z
+			ui32	m_pageSize = 64;
+			ui32	m_layerCount = 0;			// 0 or 4, weights are packed as rgba8
+		};
+
+	public:
+		TerrainData();
+		~TerrainData();
+
+		// Map a raw file, writes stay in memory (copy on write)
+		bool load(const String& path);
+
+		// Save as raw file
+		bool save(const String& path);
+
+		// Create in memory
+		void create(i32 width, i32 height, bool isHaveLayers);
+
+		// Import from images, height from red channel, layer weights from layer images (optional)
+		bool import(Image* heightmap, const vector<Image*>::type& layers);
+
+		// Clear
+		void clear();
+
+		// Is valid
+		bool isValid() const { return m_heights != nullptr; }
+
+		// Size
+		i32 getWidth() const { return m_header.m_width; }
+		i32 getHeight() const { return m_header.m_height; }
+		bool isHaveLayers() const { return m_weights != nullptr; }
+
+		// Normalized height [0, 1], coordinates are clamped
+		float getHeight(i32 x, i32 z) const { return m_heights[getTexelIndex(x, z)] / 65535.f; }
+		void setHeight(i32 x, i32 z, float height);
+
+		// Layer weights packed as rgba8
+		ui32 getWeights(i32 x, i32 z) const { return m_weights ? m_weights[getTexelIndex(x, z)] : 0; }
+		void setWeights(i32 x, i32 z, ui32 weights);
+
+	private:
+		// Texel index
+		size_t getTexelIndex(i32 x, i32 z) const;
+
+		// Page count
+		size_t getPageCount() const;
+
+		// Bind data pointers
+		void bindPointers(Byte* data);
+
+	private:
+		Header				m_header;
+		i32					m_pagesX = 0;
+		MemoryMappedFile	m_file;
+		vector<Byte>::type	m_memory;
+		ui16*				m_heights = nullptr;
+		ui32*				m_weights = nullptr;
+	};
+}
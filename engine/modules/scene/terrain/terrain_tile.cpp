@@ -3,13 +3,167 @@
 
 namespace Echo
 {
-	TerrainTile::TerrainTile()
+	TerrainTile::TerrainTile(Terrain* terrain, i32 depth, i32 x, i32 z, i32 step)
+		: m_terrain(terrain)
+		, m_depth(depth)
+		, m_x(x)
+		, m_z(z)
+		, m_step(step)
 	{
-
 	}
 
 	TerrainTile::~TerrainTile()
 	{
+		clearRenderable();
+	}
+
+	void TerrainTile::setStitchMask(ui32 mask)
+	{
+		if (m_stitchMask != mask)
+		{
+			m_stitchMask = mask;
+			m_isDirty = true;
+		}
+	}
+
+	void TerrainTile::update(bool isNeedRender)
+	{
+		if (isNeedRender && m_isDirty)
+			buildRenderable();
+
+		if (m_renderable)
+			m_renderable->setSubmitToRenderQueue(isNeedRender);
+	}
+
+	void TerrainTile::hide()
+	{
+		if (m_renderable)
+			m_renderable->setSubmitToRenderQueue(false);
+	}
+
+	float TerrainTile::getVertexHeight(i32 vx, i32 vz, i32 quadsX, i32 quadsZ)
+	{
+		i32 originX = getOriginX();
+		i32 originZ = getOriginZ();
+
+		// vertices between the vertices of a coarser neighbour lie on its edge line, so no crack
+		i32 edge = -1;
+		i32 along = 0;
+		i32 length = 0;
+		if (vx == 0)			 { edge = Left;	  along = vz; length = quadsZ; }
+		else if (vx == quadsX)	 { edge = Right;  along = vz; length = quadsZ; }
+		else if (vz == 0)		 { edge = Bottom; along = vx; length = quadsX; }
+		else if (vz == quadsZ)	 { edge = Top;	  along = vx; length = quadsX; }
+
+		i32 diff = edge >= 0 ? (m_stitchMask >> (edge * 4)) & 0xF : 0;
+		if (diff > 0)
+		{
+			i32 stride = std::min<i32>(1 << diff, Quads);
+			i32 a = along - along % stride;
+			i32 b = std::min<i32>(a + stride, length);
+			if (a != along && b != a)
+			{
+				float t = float(along - a) / float(b - a);
+				bool isAlongZ = edge == Left || edge == Right;
+				i32 ax = isAlongZ ? vx : a, az = isAlongZ ? a : vz;
+				i32 bx = isAlongZ ? vx : b, bz = isAlongZ ? b : vz;
+				float ha = m_terrain->getHeight(originX + ax * m_step, originZ + az * m_step);
+				float hb = m_terrain->getHeight(originX + bx * m_step, originZ + bz * m_step);
+
+				return ha + (hb - ha) * t;
+			}
+		}
+
+		return m_terrain->getHeight(originX + vx * m_step, originZ + vz * m_step);
+	}
+
+	void TerrainTile::buildRenderable()
+	{
+		const i32 lastX = m_terrain->getRows() - 1;
+		const i32 lastZ = m_terrain->getColumns() - 1;
+		const i32 originX = getOriginX();
+		const i32 originZ = getOriginZ();
+
+		// tiles on the far border are cut to the terrain size
+		const i32 quadsX = Math::Clamp<i32>((lastX - originX + m_step - 1) / m_step, 0, Quads);
+		const i32 quadsZ = Math::Clamp<i32>((lastZ - originZ + m_step - 1) / m_step, 0, Quads);
+		if (quadsX <= 0 || quadsZ <= 0)
+		{
+			clearRenderable();
+			m_isDirty = false;
+			return;
+		}
+
+		Terrain::VertexArray vertices;
+		Terrain::IndiceArray indices;
+		vertices.reserve((quadsX + 1) * (quadsZ + 1));
+		indices.reserve(quadsX * quadsZ * 6);
+
+		AABB aabb;
+		const float spacing = float(m_terrain->getGridSpacing());
+		for (i32 vx = 0; vx <= quadsX; vx++)
+		{
+			i32 x = std::min<i32>(originX + vx * m_step, lastX);
+			for (i32 vz = 0; vz <= quadsZ; vz++)
+			{
+				i32 z = std::min<i32>(originZ + vz * m_step, lastZ);
+
+				Terrain::VertexFormat vert;
+				vert.m_position = Vector3(x * spacing, getVertexHeight(vx, vz, quadsX, quadsZ), z * spacing);
+				vert.m_color = 0xFFFFFFFF;
+				vert.m_normal = m_terrain->getNormal(x, z, m_step);
+				vert.m_uv = Vector2(float(x), float(z));
+				vert.m_layerIndices = Color(0, 1, 2, 3).getABGR();
+				vert.m_layerWeights = Vector4(m_terrain->getWeight(x, z, 0), m_terrain->getWeight(x, z, 1), m_terrain->getWeight(x, z, 2), m_terrain->getWeight(x, z, 3));
+				vertices.emplace_back(vert);
+
+				aabb.addPoint(vert.m_position);
+			}
+		}
+
+		const i32 stride = quadsZ + 1;
+		for (i32 vx = 0; vx < quadsX; vx++)
+		{
+			for (i32 vz = 0; vz < quadsZ; vz++)
+			{
+				ui32 indexLeftTop = vx * stride + vz;
+				ui32 indexRightTop = indexLeftTop + 1;
+				ui32 indexLeftBottom = indexLeftTop + stride;
+				ui32 indexRightBottom = indexRightTop + stride;
 
+				indices.emplace_back(indexLeftTop);
+				indices.emplace_back(indexRightBottom);
+				indices.emplace_back(indexRightTop);
+				indices.emplace_back(indexLeftTop);
+				indices.emplace_back(indexLeftBottom);
+				indices.emplace_back(indexRightBottom);
+			}
+		}
+
+		if (!m_mesh)
+			m_mesh = Mesh::create(true, true);
+
+		MeshVertexFormat define;
+		define.m_isUseNormal = true;
+		define.m_isUseVertexColor = true;
+		define.m_isUseUV = true;
+		define.m_isUseBlendingData = true;
+
+		m_mesh->updateIndices(static_cast<ui32>(indices.size()), sizeof(ui32), indices.data());
+		m_mesh->updateVertexs(define, static_cast<ui32>(vertices.size()), (const Byte*)vertices.data());
+
+		if (!m_renderable)
+			m_renderable = RenderProxy::create(m_mesh, m_terrain->getMaterial(), m_terrain, true);
+
+		if (m_renderable)
+			m_renderable->setLocalAABB(aabb);
+
+		m_isDirty = false;
+	}
+
+	void TerrainTile::clearRenderable()
+	{
+		m_renderable.reset();
+		m_mesh.reset();
 	}
 }
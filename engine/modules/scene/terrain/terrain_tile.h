@@ -1,16 +1,77 @@
 #pragma once
 
+#include "engine/core/render/base/mesh/mesh.h"
+#include "engine/core/render/base/proxy/render_proxy.h"
+
 namespace Echo
 {
 	class Terrain;
-    class TerrainTile
-    {
-    public:
-		TerrainTile();
+	class TerrainTile
+	{
+	public:
+		// quads per tile edge, every tile has (Quads + 1)^2 vertices whatever its lod
+		static const i32 Quads = 32;
+
+		// edges, used by stitch mask (4 bits each, lod difference to the coarser neighbour)
+		enum Edge
+		{
+			Left = 0,		// -x
+			Right,			// +x
+			Bottom,			// -z
+			Top,			// +z
+		};
+
+	public:
+		TerrainTile(Terrain* terrain, i32 depth, i32 x, i32 z, i32 step);
 		~TerrainTile();
 
+		// quadtree key
+		static ui64 makeKey(i32 depth, i32 x, i32 z) { return (ui64(depth) << 48) | (ui64(ui32(z) & 0xFFFFFF) << 24) | ui64(ui32(x) & 0xFFFFFF); }
+		ui64 getKey() const { return makeKey(m_depth, m_x, m_z); }
+
+		// sample region
+		i32 getOriginX() const { return m_x * Quads * m_step; }
+		i32 getOriginZ() const { return m_z * Quads * m_step; }
+		i32 getStep() const { return m_step; }
+		i32 getDepth() const { return m_depth; }
+
+		// mark dirty, mesh will be rebuilt on next update
+		void markDirty() { m_isDirty = true; }
+
+		// stitch mask
+		void setStitchMask(ui32 mask);
+
+		// frame of last selection
+		ui32 getSelectedFrame() const { return m_selectedFrame; }
+		void setSelectedFrame(ui32 frame) { m_selectedFrame = frame; }
+
+		// update
+		void update(bool isNeedRender);
+
+		// hide
+		void hide();
+
+	private:
+		// build
+		void buildRenderable();
+
+		// clear
+		void clearRenderable();
+
+		// height of the vertex, interpolated on stitched edges
+		float getVertexHeight(i32 vx, i32 vz, i32 quadsX, i32 quadsZ);
+
 	private:
-		//Terrain*	m_terrain;
-    };
-	typedef map<String, TerrainTile*> TerrainTiles;
+		Terrain*			m_terrain = nullptr;
+		i32					m_depth = 0;
+		i32					m_x = 0;
+		i32					m_z = 0;
+		i32					m_step = 1;
+		ui32				m_stitchMask = 0;
+		ui32				m_selectedFrame = 0;
+		bool				m_isDirty = true;
+		MeshPtr				m_mesh;
+		RenderProxyPtr		m_renderable;
+	};
+	typedef std::unordered_map<ui64, TerrainTile*> TerrainTiles;
 }
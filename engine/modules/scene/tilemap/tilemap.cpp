@@ -4,19 +4,21 @@
 #include "base/renderer.h"
 #include "base/shader/shader_program.h"
 #include "engine/core/main/Engine.h"
-#include "engine/modules/ui/font/font_library.h"
 
 namespace Echo
 {
     TileMap::TileMap()
-    : Node()
+    : Render()
     {
+        setRenderType("2d");
+        resizeChunks(m_width, m_height);
     }
-    
+
     TileMap::~TileMap()
     {
+        clearChunks();
     }
-    
+
     void TileMap::bindMethods()
     {
         CLASS_BIND_METHOD(TileMap, getTileShape);
@@ -31,7 +33,20 @@ namespace Echo
 		CLASS_BIND_METHOD(TileMap, setFlipX);
 		CLASS_BIND_METHOD(TileMap, isFlipY);
 		CLASS_BIND_METHOD(TileMap, setFlipY);
+        CLASS_BIND_METHOD(TileMap, getAtlasRes);
+        CLASS_BIND_METHOD(TileMap, setAtlasRes);
+        CLASS_BIND_METHOD(TileMap, getAtlasColumns);
+        CLASS_BIND_METHOD(TileMap, setAtlasColumns);
+        CLASS_BIND_METHOD(TileMap, getAtlasRows);
+        CLASS_BIND_METHOD(TileMap, setAtlasRows);
+        CLASS_BIND_METHOD(TileMap, getMaterial);
+        CLASS_BIND_METHOD(TileMap, setMaterial);
         CLASS_BIND_METHOD(TileMap, getTileCenter);
+        CLASS_BIND_METHOD(TileMap, getTileId);
+        CLASS_BIND_METHOD(TileMap, setTileId);
+        CLASS_BIND_METHOD(TileMap, clearTileIds);
+        CLASS_BIND_METHOD(TileMap, getTileData);
+        CLASS_BIND_METHOD(TileMap, setTileData);
         CLASS_BIND_METHOD(TileMap, getTile);
         CLASS_BIND_METHOD(TileMap, setTile);
 
@@ -41,6 +56,15 @@ namespace Echo
         CLASS_REGISTER_PROPERTY(TileMap, "TileSize", Variant::Type::Vector2, getTileSize, setTileSize);
         CLASS_REGISTER_PROPERTY(TileMap, "FlipX", Variant::Type::Bool, isFlipX, setFlipX);
         CLASS_REGISTER_PROPERTY(TileMap, "FlipY", Variant::Type::Bool, isFlipY, setFlipY);
+        CLASS_REGISTER_PROPERTY(TileMap, "Atlas", Variant::Type::ResourcePath, getAtlasRes, setAtlasRes);
+        CLASS_REGISTER_PROPERTY(TileMap, "AtlasColumns", Variant::Type::Int, getAtlasColumns, setAtlasColumns);
+        CLASS_REGISTER_PROPERTY(TileMap, "AtlasRows", Variant::Type::Int, getAtlasRows, setAtlasRows);
+        CLASS_REGISTER_PROPERTY(TileMap, "Material", Variant::Type::Object, getMaterial, setMaterial);
+        CLASS_REGISTER_PROPERTY(TileMap, "TileData", Variant::Type::String, getTileData, setTileData);
+
+        CLASS_REGISTER_PROPERTY_HINT(TileMap, "Material", PropertyHintType::ObjectType, "Material");
+        CLASS_REGISTER_PROPERTY_HINT(TileMap, "TileData", PropertyHintType::ReadOnly, "true");
+        CLASS_REGISTER_PROPERTY_HINT(TileMap, "TileData", PropertyHintType::XmlCData, "true");
     }
 
     void TileMap::setTileShape(const StringOption& option)
@@ -48,6 +72,107 @@ namespace Echo
         m_tileShape.setValue(option.getValue());
     }
 
+    void TileMap::setWidth(i32 width)
+    {
+        if (m_width != width)
+            resizeChunks(std::max<i32>(width, 0), m_height);
+    }
+
+    void TileMap::setHeight(i32 height)
+    {
+        if (m_height != height)
+            resizeChunks(m_width, std::max<i32>(height, 0));
+    }
+
+    void TileMap::setTileSize(const Vector2& tileSize)
+    {
+        if (m_tileSize != tileSize)
+        {
+            m_tileSize = tileSize;
+            markChunksDirty();
+        }
+    }
+
+    void TileMap::setFlipX(bool isFlipX)
+    {
+        if (m_isFlipX != isFlipX)
+        {
+            m_isFlipX = isFlipX;
+            markChunksDirty();
+        }
+    }
+
+    void TileMap::setFlipY(bool isFlipY)
+    {
+        if (m_isFlipY != isFlipY)
+        {
+            m_isFlipY = isFlipY;
+            markChunksDirty();
+        }
+    }
+
+    void TileMap::setAtlasRes(const ResourcePath& path)
+    {
+        if (m_atlasRes.setPath(path.getPath()))
+        {
+            if (m_material && m_material->isUniformExist("BaseTexture"))
+                m_material->setUniformTexture("BaseTexture", m_atlasRes.getPath());
+        }
+    }
+
+    void TileMap::setAtlasColumns(i32 columns)
+    {
+        columns = std::max<i32>(columns, 1);
+        if (m_atlasColumns != columns)
+        {
+            m_atlasColumns = columns;
+            markChunksDirty();
+        }
+    }
+
+    void TileMap::setAtlasRows(i32 rows)
+    {
+        rows = std::max<i32>(rows, 1);
+        if (m_atlasRows != rows)
+        {
+            m_atlasRows = rows;
+            markChunksDirty();
+        }
+    }
+
+    Material* TileMap::getMaterial()
+    {
+        // one atlas material shared by all chunks
+        if (!m_material)
+        {
+            m_material = ECHO_CREATE_RES(Material);
+            m_material->setShaderPath(m_transparentShader);
+
+            if (!m_atlasRes.getPath().empty() && m_material->isUniformExist("BaseTexture"))
+                m_material->setUniformTexture("BaseTexture", m_atlasRes.getPath());
+        }
+
+        return m_material;
+    }
+
+    void TileMap::setMaterial(Object* material)
+    {
+        if (m_material != material)
+        {
+            m_material = (Material*)material;
+
+            // render proxies hold the old material
+            for (TileMapChunk* chunk : m_chunks)
+            {
+                if (chunk)
+                {
+                    chunk->clearRenderable();
+                    chunk->markDirty();
+                }
+            }
+        }
+    }
+
     Vector3 TileMap::flip(const Vector3& pos)
     {
         Vector3 result = pos;
@@ -65,6 +190,106 @@ namespace Echo
         return flip(Vector3( (x+0.5)*getTileSize().x, (y+0.5)*getTileSize().y, 0.f));
     }
 
+    void TileMap::setTileId(i32 x, i32 y, i32 id)
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            return;
+
+        i32 chunkX = x / TileMapChunk::Size;
+        i32 chunkY = y / TileMapChunk::Size;
+        TileMapChunk*& chunk = m_chunks[chunkY * getChunkColumns() + chunkX];
+        if (!chunk)
+        {
+            if (id < 0)
+                return;
+
+            chunk = EchoNew(TileMapChunk(this, chunkX, chunkY));
+        }
+
+        chunk->setTileId(x - chunkX * TileMapChunk::Size, y - chunkY * TileMapChunk::Size, id);
+        if (!chunk->getTileCount())
+        {
+            EchoSafeDelete(chunk, TileMapChunk);
+        }
+    }
+
+    i32 TileMap::getTileId(i32 x, i32 y)
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            return -1;
+
+        i32 chunkX = x / TileMapChunk::Size;
+        i32 chunkY = y / TileMapChunk::Size;
+        const TileMapChunk* chunk = m_chunks[chunkY * getChunkColumns() + chunkX];
+
+        return chunk ? chunk->getTileId(x - chunkX * TileMapChunk::Size, y - chunkY * TileMapChunk::Size) : -1;
+    }
+
+    void TileMap::clearTileIds()
+    {
+        for (TileMapChunk*& chunk : m_chunks)
+        {
+            EchoSafeDelete(chunk, TileMapChunk);
+        }
+    }
+
+    String TileMap::getTileData()
+    {
+        // "id*count" runs separated by ','
+        String result;
+        i32 runId = -1;
+        i32 runCount = 0;
+        auto flushRun = [&]()
+        {
+            if (runCount)
+            {
+                if (!result.empty()) result += ",";
+                result += runCount > 1 ? StringUtil::Format("%d*%d", runId, runCount) : StringUtil::ToString(runId);
+            }
+        };
+
+        for (i32 y = 0; y < m_height; y++)
+        {
+            for (i32 x = 0; x < m_width; x++)
+            {
+                i32 id = getTileId(x, y);
+                if (id != runId)
+                {
+                    flushRun();
+                    runId = id;
+                    runCount = 0;
+                }
+
+                runCount++;
+            }
+        }
+
+        // trailing empty tiles are implied
+        if (runId != -1)
+            flushRun();
+
+        return result;
+    }
+
+    void TileMap::setTileData(const String& data)
+    {
+        clearTileIds();
+
+        i32 idx = 0;
+        i32 total = m_width * m_height;
+        for (const String& run : StringUtil::Split(data, ","))
+        {
+            StringArray values = StringUtil::Split(run, "*");
+            i32 id = values.size() > 0 ? StringUtil::ParseInt(values[0], -1) : -1;
+            i32 count = values.size() > 1 ? StringUtil::ParseInt(values[1], 1) : 1;
+            for (i32 i = 0; i < count && idx < total; i++, idx++)
+            {
+                if (id >= 0)
+                    setTileId(idx % m_width, idx / m_width, id);
+            }
+        }
+    }
+
     void TileMap::setTile(i32 x, i32 y, const String& nodePath)
     {
         Vector3 position = getTileCenter(x, y);
@@ -72,7 +297,7 @@ namespace Echo
         Node* node = getTile(x, y);
         if (node)
         {
-            EchoSafeDelete(node, Node);
+            node->queueFree();
         }
 
         node = Echo::Node::loadLink(nodePath, false);
@@ -88,4 +313,69 @@ namespace Echo
     {
         return getChild(getTileName(x, y).c_str());
     }
+
+    void TileMap::updateInternal(float elapsedTime)
+    {
+        bool isRender = isNeedRender();
+        for (TileMapChunk* chunk : m_chunks)
+        {
+            if (chunk)
+                chunk->update(isRender);
+        }
+    }
+
+    void TileMap::resizeChunks(i32 width, i32 height)
+    {
+        i32 chunkColumns = (width + TileMapChunk::Size - 1) / TileMapChunk::Size;
+        i32 chunkRows = (height + TileMapChunk::Size - 1) / TileMapChunk::Size;
+
+        Chunks chunks(chunkColumns * chunkRows, nullptr);
+        for (TileMapChunk* chunk : m_chunks)
+        {
+            if (!chunk)
+                continue;
+
+            if (chunk->getChunkX() < chunkColumns && chunk->getChunkY() < chunkRows)
+            {
+                // drop tiles of the boundary chunks that fall out of the new size
+                for (i32 localY = 0; localY < TileMapChunk::Size; localY++)
+                {
+                    for (i32 localX = 0; localX < TileMapChunk::Size; localX++)
+                    {
+                        i32 x = chunk->getChunkX() * TileMapChunk::Size + localX;
+                        i32 y = chunk->getChunkY() * TileMapChunk::Size + localY;
+                        if (x >= width || y >= height)
+                            chunk->setTileId(localX, localY, -1);
+                    }
+                }
+
+                if (chunk->getTileCount())
+                {
+                    chunks[chunk->getChunkY() * chunkColumns + chunk->getChunkX()] = chunk;
+                    continue;
+                }
+            }
+
+            EchoSafeDelete(chunk, TileMapChunk);
+        }
+
+        m_chunks.swap(chunks);
+        m_width = width;
+        m_height = height;
+    }
+
+    void TileMap::markChunksDirty()
+    {
+        for (TileMapChunk* chunk : m_chunks)
+        {
+            if (chunk)
+                chunk->markDirty();
+        }
+    }
+
+    void TileMap::clearChunks()
+    {
+        clearTileIds();
+        m_chunks.clear();
+    }
 }
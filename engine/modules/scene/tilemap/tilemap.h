@@ -1,42 +1,58 @@
 #pragma once
 
-#include "engine/core/scene/node.h"
+#include "engine/core/scene/render_node.h"
+#include "engine/core/render/base/shader/material.h"
+#include "tilemap_chunk.h"
 
 namespace Echo
 {
-    class TileMap : public Node
+    class TileMap : public Render
     {
-        ECHO_CLASS(TileMap, Node)
+        ECHO_CLASS(TileMap, Render)
 
-        typedef std::unordered_map<i32, Node*> Tiles;
+        typedef vector<TileMapChunk*>::type Chunks;
 
     public:
         TileMap();
         virtual ~TileMap();
-        
+
         // tile shape
         const StringOption& getTileShape() const { return m_tileShape; }
         void setTileShape(const StringOption& option);
 
 		// width
 		i32 getWidth() const { return m_width; }
-        void setWidth(i32 width) { m_width = width; }
+        void setWidth(i32 width);
 
 		// height
 		i32 getHeight() const { return m_height; }
-        void setHeight(i32 height) { m_height = height; }
+        void setHeight(i32 height);
 
 		// grid size
 		const Vector2& getTileSize() const { return m_tileSize; }
-        void setTileSize(const Vector2& tileSize) { m_tileSize = tileSize; }
+        void setTileSize(const Vector2& tileSize);
 
 		// flip x
 		bool isFlipX() const { return m_isFlipX; }
-		void setFlipX(bool isFlipX) { m_isFlipX = isFlipX; }
+		void setFlipX(bool isFlipX);
 
 		// flip y
 		bool isFlipY() const { return m_isFlipY; }
-		void setFlipY(bool isFlipY) { m_isFlipY = isFlipY; }
+		void setFlipY(bool isFlipY);
+
+        // atlas texture
+        const ResourcePath& getAtlasRes() const { return m_atlasRes; }
+        void setAtlasRes(const ResourcePath& path);
+
+        // atlas grid, tile id is (row * columns + column)
+        i32 getAtlasColumns() const { return m_atlasColumns; }
+        void setAtlasColumns(i32 columns);
+        i32 getAtlasRows() const { return m_atlasRows; }
+        void setAtlasRows(i32 rows);
+
+        // material
+        Material* getMaterial();
+        void setMaterial(Object* material);
 
         // flip
         Vector3 flip(const Vector3& pos);
@@ -44,13 +60,39 @@ namespace Echo
         // position
         Vector3 getTileCenter(i32 x, i32 y);
 
-        // tile
+        // static tile id, drawn by chunk meshes (-1 means empty)
+        void setTileId(i32 x, i32 y, i32 id);
+        i32 getTileId(i32 x, i32 y);
+        void clearTileIds();
+
+        // tile id data (run length encoded, row major)
+        String getTileData();
+        void setTileData(const String& data);
+
+        // node backed tile, only for tiles that carry logic
         void setTile(i32 x, i32 y, const String& nodePath);
         Node* getTile(i32 x, i32 y);
 
         // tile name
         String getTileName(i32 x, i32 y) const { return StringUtil::Format("tile_x%d_y%d", x, y); }
-   
+
+    protected:
+        // update
+        virtual void updateInternal(float elapsedTime) override;
+
+        // chunk grid
+        i32 getChunkColumns() const { return (m_width + TileMapChunk::Size - 1) / TileMapChunk::Size; }
+        i32 getChunkRows() const { return (m_height + TileMapChunk::Size - 1) / TileMapChunk::Size; }
+
+        // resize chunk grid, tiles out of range are dropped
+        void resizeChunks(i32 width, i32 height);
+
+        // all chunk meshes will be rebuilt
+        void markChunksDirty();
+
+        // clear
+        void clearChunks();
+
     private:
         StringOption        m_tileShape = StringOption("Square", { "Square"/*,"Isometric","Hexagon"*/ });
 		i32                 m_width = 8;
@@ -58,5 +100,11 @@ namespace Echo
         Vector2             m_tileSize = Vector2(60.f, 60.f);
         bool                m_isFlipX = false;
         bool                m_isFlipY = false;
+        ResourcePath        m_atlasRes = ResourcePath("", ".png");
+        i32                 m_atlasColumns = 1;
+        i32                 m_atlasRows = 1;
+        ResourcePath        m_transparentShader = ResourcePath("Module://Effect/shader/Transparent.shader", ".shader");
+        MaterialPtr         m_material;
+        Chunks              m_chunks;
     };
 }
@@ -0,0 +1,124 @@
+#include "tilemap_chunk.h"
+#include "tilemap.h"
+
+namespace Echo
+{
+	TileMapChunk::TileMapChunk(TileMap* tileMap, i32 chunkX, i32 chunkY)
+		: m_tileMap(tileMap)
+		, m_chunkX(chunkX)
+		, m_chunkY(chunkY)
+	{
+		m_tiles.assign(Size * Size, -1);
+	}
+
+	TileMapChunk::~TileMapChunk()
+	{
+		clearRenderable();
+	}
+
+	bool TileMapChunk::setTileId(i32 localX, i32 localY, i32 id)
+	{
+		i32& tile = m_tiles[localY * Size + localX];
+		if (tile != id)
+		{
+			m_tileCount += (id >= 0 ? 1 : 0) - (tile >= 0 ? 1 : 0);
+			tile = id;
+			m_isDirty = true;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void TileMapChunk::update(bool isNeedRender)
+	{
+		if (isNeedRender && m_isDirty)
+			buildRenderable();
+
+		if (m_renderable)
+			m_renderable->setSubmitToRenderQueue(isNeedRender);
+	}
+
+	void TileMapChunk::buildRenderable()
+	{
+		VertexArray vertices;
+		IndiceArray indices;
+		AABB		aabb;
+		buildMeshData(vertices, indices, aabb);
+
+		if (!indices.empty())
+		{
+			if (!m_mesh)
+				m_mesh = Mesh::create(true, true);
+
+			MeshVertexFormat define;
+			define.m_isUseUV = true;
+
+			m_mesh->updateIndices(static_cast<ui32>(indices.size()), sizeof(Word), indices.data());
+			m_mesh->updateVertexs(define, static_cast<ui32>(vertices.size()), (const Byte*)vertices.data());
+
+			if (!m_renderable)
+				m_renderable = RenderProxy::create(m_mesh, m_tileMap->getMaterial(), m_tileMap, false);
+
+			if (m_renderable)
+				m_renderable->setLocalAABB(aabb);
+		}
+		else
+		{
+			clearRenderable();
+		}
+
+		m_isDirty = false;
+	}
+
+	void TileMapChunk::buildMeshData(VertexArray& oVertices, IndiceArray& oIndices, AABB& oAABB)
+	{
+		oVertices.reserve(m_tileCount * 4);
+		oIndices.reserve(m_tileCount * 6);
+
+		const Vector2& tileSize = m_tileMap->getTileSize();
+		const i32 atlasColumns = m_tileMap->getAtlasColumns();
+		const i32 atlasRows = m_tileMap->getAtlasRows();
+		const float hw = tileSize.x * 0.5f;
+		const float hh = tileSize.y * 0.5f;
+		const float du = 1.f / atlasColumns;
+		const float dv = 1.f / atlasRows;
+
+		for (i32 localY = 0; localY < Size; localY++)
+		{
+			for (i32 localX = 0; localX < Size; localX++)
+			{
+				i32 id = m_tiles[localY * Size + localX];
+				if (id < 0)
+					continue;
+
+				Vector3 center = m_tileMap->getTileCenter(m_chunkX * Size + localX, m_chunkY * Size + localY);
+				float u0 = (id % atlasColumns) * du;
+				float v0 = ((id / atlasColumns) % atlasRows) * dv;
+
+				Word base = static_cast<Word>(oVertices.size());
+				oVertices.emplace_back(center + Vector3(-hw, -hh, 0.f), Vector2(u0,		 v0 + dv));
+				oVertices.emplace_back(center + Vector3(-hw,  hh, 0.f), Vector2(u0,		 v0));
+				oVertices.emplace_back(center + Vector3( hw,  hh, 0.f), Vector2(u0 + du, v0));
+				oVertices.emplace_back(center + Vector3( hw, -hh, 0.f), Vector2(u0 + du, v0 + dv));
+
+				oIndices.emplace_back(base);
+				oIndices.emplace_back(base + 1);
+				oIndices.emplace_back(base + 2);
+				oIndices.emplace_back(base);
+				oIndices.emplace_back(base + 2);
+				oIndices.emplace_back(base + 3);
+
+				oAABB.addPoint(center + Vector3(-hw, -hh, 0.f));
+				oAABB.addPoint(center + Vector3( hw,  hh, 0.f));
+			}
+		}
+	}
+
+	void TileMapChunk::clearRenderable()
+	{
+		m_renderable.reset();
+		m_mesh.reset();
+	}
+}
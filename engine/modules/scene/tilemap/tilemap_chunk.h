@@ -0,0 +1,70 @@
+#pragma once
+
+#include "engine/core/render/base/mesh/mesh.h"
+#include "engine/core/render/base/shader/material.h"
+#include "engine/core/render/base/proxy/render_proxy.h"
+
+namespace Echo
+{
+	class TileMap;
+	class TileMapChunk
+	{
+	public:
+		// Tiles per chunk edge
+		static const i32 Size = 32;
+
+		// Vertex Format
+		struct VertexFormat
+		{
+			Vector3		m_position;
+			Vector2		m_uv;
+
+			VertexFormat(const Vector3& pos, const Vector2& uv)
+				: m_position(pos), m_uv(uv)
+			{}
+		};
+		typedef vector<VertexFormat>::type	VertexArray;
+		typedef vector<Word>::type			IndiceArray;
+
+	public:
+		TileMapChunk(TileMap* tileMap, i32 chunkX, i32 chunkY);
+		~TileMapChunk();
+
+		// Chunk coordinate
+		i32 getChunkX() const { return m_chunkX; }
+		i32 getChunkY() const { return m_chunkY; }
+
+		// Tile id by chunk local coordinate, -1 means empty
+		i32 getTileId(i32 localX, i32 localY) const { return m_tiles[localY * Size + localX]; }
+		bool setTileId(i32 localX, i32 localY, i32 id);
+
+		// Tile count
+		i32 getTileCount() const { return m_tileCount; }
+
+		// Mesh will be rebuilt on next update
+		void markDirty() { m_isDirty = true; }
+
+		// Rebuild mesh if dirty and submit
+		void update(bool isNeedRender);
+
+		// Clear
+		void clearRenderable();
+
+	private:
+		// Build mesh data
+		void buildMeshData(VertexArray& oVertices, IndiceArray& oIndices, AABB& oAABB);
+
+		// Rebuild mesh
+		void buildRenderable();
+
+	private:
+		TileMap*			m_tileMap = nullptr;
+		i32					m_chunkX = 0;
+		i32					m_chunkY = 0;
+		vector<i32>::type	m_tiles;
+		i32					m_tileCount = 0;
+		bool				m_isDirty = true;
+		MeshPtr				m_mesh;
+		RenderProxyPtr		m_renderable;
+	};
+}
@@ -6,6 +6,7 @@
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/math/color.h"
 #include "engine/core/main/Engine.h"
+#include "engine/modules/anim/anim_module.h"
 #include <spine/spine.h>
 #include <spine/extension.h>
 #include "AttachmentLoader.h"
@@ -144,12 +145,24 @@ namespace Echo
 
 			if (m_spSkeleton && m_spAnimState)
 			{
-				spSkeleton_update(m_spSkeleton, delta);
+				// culled frames only accumulate time for the skeleton, the next evaluation catches up
+				AABB worldBox;
+				if (m_localAABB.isValid())
+					buildWorldAABB(worldBox);
+
+				float elapsed = 0.f;
+				bool isEvaluate = AnimModule::instance()->getLod().update(m_lodState, worldBox, getCamera(), delta, elapsed, false);
+
+				// the animation state advances every frame, so its events fire on time even while culled
 				spAnimationState_update(m_spAnimState, delta);
-				spAnimationState_apply(m_spAnimState, m_spSkeleton);
-				spSkeleton_updateWorldTransform(m_spSkeleton);
+				if (isEvaluate)
+				{
+					spSkeleton_update(m_spSkeleton, elapsed);
+					spAnimationState_apply(m_spAnimState, m_spSkeleton);
+					spSkeleton_updateWorldTransform(m_spSkeleton);
 
-				submitToRenderQueue();
+					submitToRenderQueue();
+				}
 			}
 		}
 	}
@@ -243,6 +256,11 @@ namespace Echo
 			m_batch.merge( *attachmentVertices);
 		}
 
+		// bounds for culling and animation lod
+		m_localAABB.reset();
+		for (const SpineVertexFormat& vertex : m_batch.m_verticesData)
+			m_localAABB.addPoint(vertex.m_position);
+
 		updateRenderable();
 		
 		if (m_renderable)
@@ -5,6 +5,7 @@
 #include "engine/core/render/base/mesh/mesh.h"
 #include "engine/core/render/base/shader/material.h"
 #include "engine/core/render/base/proxy/render_proxy.h"
+#include "engine/modules/anim/anim_lod.h"
 #include "AttachmentLoader.h"
 
 struct spAtlas;
@@ -82,5 +83,6 @@ namespace Echo
         ShaderProgramPtr    m_shader;
 		Material*			m_material;
 		RenderProxy*		m_renderable;
+		AnimLodState		m_lodState;
 	};
 }
@@ -5,6 +5,7 @@
 #include "base/shader/shader_program.h"
 #include "engine/core/main/Engine.h"
 #include "engine/modules/ui/ui_module.h"
+#include "engine/modules/ui/layout/layout.h"
 
 namespace Echo
 {
@@ -46,6 +47,7 @@ namespace Echo
             m_width = width;
             
             clearRenderable();
+            UiLayout::markLayoutDirty(this);
         }
     }
     
@@ -56,6 +58,7 @@ namespace Echo
             m_height = height;
             
             clearRenderable();
+            UiLayout::markLayoutDirty(this);
         }
     }
 
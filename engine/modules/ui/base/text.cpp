@@ -6,6 +6,7 @@
 #include "engine/core/main/Engine.h"
 #include "engine/modules/ui/font/font_library.h"
 #include "engine/modules/ui/ui_module.h"
+#include "engine/modules/ui/layout/layout.h"
 
 namespace Echo
 {
@@ -74,6 +75,7 @@ namespace Echo
             m_width = width;
             
 			updateMeshBuffer();
+            UiLayout::markLayoutDirty(this);
         }
     }
     
@@ -84,6 +86,7 @@ namespace Echo
             m_height = height;
             
             updateMeshBuffer();
+            UiLayout::markLayoutDirty(this);
         }
     }
     
@@ -0,0 +1,89 @@
+#include "form_layout.h"
+
+namespace Echo
+{
+	UiFormLayout::UiFormLayout()
+		: UiLayout()
+	{
+		m_align = Align::Stretch;
+	}
+
+	UiFormLayout::~UiFormLayout()
+	{
+	}
+
+	void UiFormLayout::bindMethods()
+	{
+		CLASS_BIND_METHOD(UiFormLayout, getLabelAlign);
+		CLASS_BIND_METHOD(UiFormLayout, setLabelAlign);
+
+		CLASS_REGISTER_PROPERTY(UiFormLayout, "LabelAlign", Variant::Type::StringOption, getLabelAlign, setLabelAlign);
+	}
+
+	StringOption UiFormLayout::getLabelAlign() const
+	{
+		return StringOption::fromEnum(m_labelAlign);
+	}
+
+	void UiFormLayout::setLabelAlign(const StringOption& option)
+	{
+		Align align = option.toEnum(Align::End);
+		if (m_labelAlign != align)
+		{
+			m_labelAlign = align;
+			markLayoutDirty();
+		}
+	}
+
+	Vector2 UiFormLayout::measureItems(ItemArray& items)
+	{
+		size_t rows = (items.size() + 1) / 2;
+		m_rowHeights.assign(rows, 0.f);
+		m_labelWidth = 0.f;
+		m_fieldWidth = 0.f;
+
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			const Vector2& desired = items[i].m_desiredSize;
+			float& columnWidth = (i % 2) ? m_fieldWidth : m_labelWidth;
+			columnWidth = std::max<float>(columnWidth, desired.x);
+			m_rowHeights[i / 2] = std::max<float>(m_rowHeights[i / 2], desired.y);
+		}
+
+		Vector2 result(m_labelWidth + m_fieldWidth + m_spacing, 0.f);
+		for (float height : m_rowHeights)
+			result.y += height;
+
+		result.y += rows ? m_spacing * (rows - 1) : 0.f;
+
+		return result;
+	}
+
+	void UiFormLayout::arrangeItems(ItemArray& items, const Vector2& contentSize)
+	{
+		// the field column takes what the labels leave
+		float fieldX = m_labelWidth + m_spacing;
+		float fieldWidth = std::max<float>(contentSize.x - fieldX, m_fieldWidth);
+
+		float y = 0.f;
+		for (size_t row = 0; row < m_rowHeights.size(); row++)
+		{
+			float rowHeight = m_rowHeights[row];
+
+			Item& label = items[row * 2];
+			Align labelAlign = m_labelAlign == Align::Stretch && !label.m_layout ? Align::Center : m_labelAlign;
+			alignInSlot(0.f, m_labelWidth, label.m_desiredSize.x, labelAlign, label.m_position.x, label.m_size.x);
+			alignInSlot(y, rowHeight, label.m_desiredSize.y, Align::Center, label.m_position.y, label.m_size.y);
+
+			if (row * 2 + 1 < items.size())
+			{
+				Item& field = items[row * 2 + 1];
+				Align fieldAlign = m_align == Align::Stretch && !field.m_layout ? Align::Start : m_align;
+				alignInSlot(fieldX, fieldWidth, field.m_desiredSize.x, fieldAlign, field.m_position.x, field.m_size.x);
+				alignInSlot(y, rowHeight, field.m_desiredSize.y, Align::Center, field.m_position.y, field.m_size.y);
+			}
+
+			y += rowHeight + m_spacing;
+		}
+	}
+}
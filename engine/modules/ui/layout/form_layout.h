@@ -0,0 +1,33 @@
+#pragma once
+
+#include "layout.h"
+
+namespace Echo
+{
+	// Two columns of label/field pairs, children are consumed in order (label, field, label, field...)
+	class UiFormLayout : public UiLayout
+	{
+		ECHO_CLASS(UiFormLayout, UiLayout)
+
+	public:
+		UiFormLayout();
+		virtual ~UiFormLayout();
+
+		// Label align
+		StringOption getLabelAlign() const;
+		void setLabelAlign(const StringOption& option);
+
+	protected:
+		// Measure
+		virtual Vector2 measureItems(ItemArray& items) override;
+
+		// Arrange
+		virtual void arrangeItems(ItemArray& items, const Vector2& contentSize) override;
+
+	private:
+		Align					m_labelAlign = Align::End;
+		float					m_labelWidth = 0.f;
+		float					m_fieldWidth = 0.f;
+		vector<float>::type		m_rowHeights;
+	};
+}
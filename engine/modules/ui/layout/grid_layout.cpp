@@ -0,0 +1,96 @@
+#include "grid_layout.h"
+
+namespace Echo
+{
+	UiGridLayout::UiGridLayout()
+		: UiLayout()
+	{
+	}
+
+	UiGridLayout::~UiGridLayout()
+	{
+	}
+
+	void UiGridLayout::bindMethods()
+	{
+		CLASS_BIND_METHOD(UiGridLayout, getColumns);
+		CLASS_BIND_METHOD(UiGridLayout, setColumns);
+
+		CLASS_REGISTER_PROPERTY(UiGridLayout, "Columns", Variant::Type::Int, getColumns, setColumns);
+	}
+
+	void UiGridLayout::setColumns(i32 columns)
+	{
+		columns = std::max<i32>(columns, 1);
+		if (m_columns != columns)
+		{
+			m_columns = columns;
+			markLayoutDirty();
+		}
+	}
+
+	Vector2 UiGridLayout::measureItems(ItemArray& items)
+	{
+		size_t rows = (items.size() + m_columns - 1) / m_columns;
+		m_columnWidths.assign(m_columns, 0.f);
+		m_rowHeights.assign(rows, 0.f);
+
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			float& width = m_columnWidths[i % m_columns];
+			float& height = m_rowHeights[i / m_columns];
+			width = std::max<float>(width, items[i].m_desiredSize.x);
+			height = std::max<float>(height, items[i].m_desiredSize.y);
+		}
+
+		Vector2 result = Vector2::ZERO;
+		for (float width : m_columnWidths)
+			result.x += width;
+
+		for (float height : m_rowHeights)
+			result.y += height;
+
+		result.x += m_spacing * (m_columns - 1);
+		result.y += rows ? m_spacing * (rows - 1) : 0.f;
+
+		return result;
+	}
+
+	void UiGridLayout::arrangeItems(ItemArray& items, const Vector2& contentSize)
+	{
+		if (items.empty())
+			return;
+
+		// free space is shared by all columns and rows
+		float usedWidth = m_spacing * (m_columns - 1);
+		float usedHeight = m_spacing * (m_rowHeights.size() - 1);
+		for (float width : m_columnWidths) usedWidth += width;
+		for (float height : m_rowHeights) usedHeight += height;
+
+		float growX = std::max<float>(contentSize.x - usedWidth, 0.f) / m_columnWidths.size();
+		float growY = std::max<float>(contentSize.y - usedHeight, 0.f) / m_rowHeights.size();
+
+		float y = 0.f;
+		for (size_t row = 0; row < m_rowHeights.size(); row++)
+		{
+			float x = 0.f;
+			float cellHeight = m_rowHeights[row] + growY;
+			for (size_t column = 0; column < m_columnWidths.size(); column++)
+			{
+				size_t idx = row * m_columns + column;
+				if (idx >= items.size())
+					break;
+
+				Item& item = items[idx];
+				float cellWidth = m_columnWidths[column] + growX;
+				Align align = (m_align == Align::Stretch && !item.m_layout) ? Align::Center : m_align;
+				alignInSlot(x, cellWidth, item.m_desiredSize.x, align, item.m_position.x, item.m_size.x);
+				alignInSlot(y, cellHeight, item.m_desiredSize.y, align, item.m_position.y, item.m_size.y);
+
+				x += cellWidth + m_spacing;
+			}
+
+			y += cellHeight + m_spacing;
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "layout.h"
+
+namespace Echo
+{
+	class UiGridLayout : public UiLayout
+	{
+		ECHO_CLASS(UiGridLayout, UiLayout)
+
+	public:
+		UiGridLayout();
+		virtual ~UiGridLayout();
+
+		// Columns
+		i32 getColumns() const { return m_columns; }
+		void setColumns(i32 columns);
+
+	protected:
+		// Measure
+		virtual Vector2 measureItems(ItemArray& items) override;
+
+		// Arrange
+		virtual void arrangeItems(ItemArray& items, const Vector2& contentSize) override;
+
+	private:
+		i32						m_columns = 2;
+		vector<float>::type		m_columnWidths;
+		vector<float>::type		m_rowHeights;
+	};
+}
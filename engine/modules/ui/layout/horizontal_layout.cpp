@@ -0,0 +1,17 @@
+#include "horizontal_layout.h"
+
+namespace Echo
+{
+	UiHorizontalLayout::UiHorizontalLayout()
+		: UiBoxLayout(0)
+	{
+	}
+
+	UiHorizontalLayout::~UiHorizontalLayout()
+	{
+	}
+
+	void UiHorizontalLayout::bindMethods()
+	{
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "layout.h"
+
+namespace Echo
+{
+	class UiHorizontalLayout : public UiBoxLayout
+	{
+		ECHO_CLASS(UiHorizontalLayout, UiBoxLayout)
+
+	public:
+		UiHorizontalLayout();
+		virtual ~UiHorizontalLayout();
+	};
+}
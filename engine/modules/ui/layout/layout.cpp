@@ -0,0 +1,329 @@
+#include "layout.h"
+#include "../base/image.h"
+#include "../base/text.h"
+
+namespace Echo
+{
+	UiLayout::UiLayout()
+		: Node()
+	{
+	}
+
+	UiLayout::~UiLayout()
+	{
+	}
+
+	void UiLayout::bindMethods()
+	{
+		CLASS_BIND_METHOD(UiLayout, getSize);
+		CLASS_BIND_METHOD(UiLayout, setSize);
+		CLASS_BIND_METHOD(UiLayout, getSpacing);
+		CLASS_BIND_METHOD(UiLayout, setSpacing);
+		CLASS_BIND_METHOD(UiLayout, getPadding);
+		CLASS_BIND_METHOD(UiLayout, setPadding);
+		CLASS_BIND_METHOD(UiLayout, getAlign);
+		CLASS_BIND_METHOD(UiLayout, setAlign);
+		CLASS_BIND_METHOD(UiLayout, getArrangedSize);
+
+		CLASS_REGISTER_PROPERTY(UiLayout, "Size", Variant::Type::Vector2, getSize, setSize);
+		CLASS_REGISTER_PROPERTY(UiLayout, "Spacing", Variant::Type::Real, getSpacing, setSpacing);
+		CLASS_REGISTER_PROPERTY(UiLayout, "Padding", Variant::Type::Real, getPadding, setPadding);
+		CLASS_REGISTER_PROPERTY(UiLayout, "Align", Variant::Type::StringOption, getAlign, setAlign);
+	}
+
+	void UiLayout::setSize(const Vector2& size)
+	{
+		if (m_size != size)
+		{
+			m_size = size;
+			markLayoutDirty();
+		}
+	}
+
+	void UiLayout::setSpacing(float spacing)
+	{
+		if (m_spacing != spacing)
+		{
+			m_spacing = spacing;
+			markLayoutDirty();
+		}
+	}
+
+	void UiLayout::setPadding(float padding)
+	{
+		if (m_padding != padding)
+		{
+			m_padding = padding;
+			markLayoutDirty();
+		}
+	}
+
+	StringOption UiLayout::getAlign() const
+	{
+		return StringOption::fromEnum(m_align);
+	}
+
+	void UiLayout::setAlign(const StringOption& option)
+	{
+		Align align = option.toEnum(Align::Center);
+		if (m_align != align)
+		{
+			m_align = align;
+			markLayoutDirty();
+		}
+	}
+
+	void UiLayout::markLayoutDirty()
+	{
+		// node transforms written by our own batch apply must not dirty us again
+		if (m_isApplying)
+			return;
+
+		// dirty bits always propagate to the root layout, so stop at the first dirty ancestor
+		UiLayout* layout = this;
+		while (layout && !layout->m_isMeasureDirty)
+		{
+			layout->m_isMeasureDirty = true;
+			layout->m_isArrangeDirty = true;
+			layout = dynamic_cast<UiLayout*>(layout->getParent());
+		}
+	}
+
+	void UiLayout::markLayoutDirty(Node* node)
+	{
+		UiLayout* layout = node ? dynamic_cast<UiLayout*>(node->getParent()) : nullptr;
+		if (layout)
+			layout->markLayoutDirty();
+	}
+
+	void UiLayout::onChildrenChanged()
+	{
+		m_isItemsDirty = true;
+		markLayoutDirty();
+	}
+
+	bool UiLayout::isNestedLayout() const
+	{
+		return dynamic_cast<UiLayout*>(m_parent) ? true : false;
+	}
+
+	void UiLayout::collectItems()
+	{
+		m_items.clear();
+		for (Node* child : m_children)
+		{
+			if (child->isEnable())
+			{
+				Item item;
+				item.m_node = child;
+				item.m_layout = dynamic_cast<UiLayout*>(child);
+				m_items.emplace_back(item);
+			}
+		}
+
+		m_isItemsDirty = false;
+	}
+
+	Vector2 UiLayout::measureNode(Node* node)
+	{
+		Vector2 size = Vector2::ZERO;
+		if (UiImage* image = dynamic_cast<UiImage*>(node))
+			size = Vector2(float(image->getWidth()), float(image->getHeight()));
+		else if (UiText* text = dynamic_cast<UiText*>(node))
+			size = Vector2(float(text->getWidth()), float(text->getHeight()));
+
+		const Vector3& scale = node->getLocalScaling();
+		return Vector2(size.x * std::abs(scale.x), size.y * std::abs(scale.y));
+	}
+
+	const Vector2& UiLayout::measure()
+	{
+		if (m_isMeasureDirty)
+		{
+			if (m_isItemsDirty)
+				collectItems();
+
+			// clean nested layouts return their cached size here
+			for (Item& item : m_items)
+				item.m_desiredSize = item.m_layout ? item.m_layout->measure() : measureNode(item.m_node);
+
+			Vector2 contentSize = measureItems(m_items);
+			m_desiredSize.x = m_size.x > 0.f ? m_size.x : contentSize.x + m_padding * 2.f;
+			m_desiredSize.y = m_size.y > 0.f ? m_size.y : contentSize.y + m_padding * 2.f;
+
+			m_isMeasureDirty = false;
+		}
+
+		return m_desiredSize;
+	}
+
+	void UiLayout::arrange(const Vector2& finalSize)
+	{
+		if (!m_isArrangeDirty && m_arrangedSize == finalSize)
+			return;
+
+		measure();
+
+		Vector2 contentSize(std::max<float>(finalSize.x - m_padding * 2.f, 0.f), std::max<float>(finalSize.y - m_padding * 2.f, 0.f));
+		arrangeItems(m_items, contentSize);
+
+		m_arrangedSize = finalSize;
+		m_isArrangeDirty = false;
+
+		applyItems();
+	}
+
+	void UiLayout::applyItems()
+	{
+		m_isApplying = true;
+
+		// layout rect is centered on this node, y up
+		float left = -m_arrangedSize.x * 0.5f + m_padding;
+		float top = m_arrangedSize.y * 0.5f - m_padding;
+		for (Item& item : m_items)
+		{
+			if (item.m_layout)
+				item.m_layout->arrange(item.m_size);
+
+			const Vector3& localPosition = item.m_node->getLocalPosition();
+			Vector3 position(left + item.m_position.x + item.m_size.x * 0.5f, top - item.m_position.y - item.m_size.y * 0.5f, localPosition.z);
+			if (position != localPosition)
+				item.m_node->setLocalPosition(position);
+		}
+
+		m_isApplying = false;
+	}
+
+	void UiLayout::alignInSlot(float slotStart, float slotSize, float desired, Align align, float& oStart, float& oSize)
+	{
+		switch (align)
+		{
+		case Align::Start:	 oStart = slotStart;							 oSize = desired;	break;
+		case Align::Center:	 oStart = slotStart + (slotSize - desired) * 0.5f; oSize = desired;	break;
+		case Align::End:	 oStart = slotStart + slotSize - desired;		 oSize = desired;	break;
+		case Align::Stretch: oStart = slotStart;							 oSize = slotSize;	break;
+		}
+	}
+
+	void UiLayout::updateInternal(float elapsedTime)
+	{
+		// nested layouts are measured and arranged by the root layout
+		if (isLayoutDirty() && !isNestedLayout())
+		{
+			arrange(measure());
+		}
+	}
+
+	UiBoxLayout::UiBoxLayout(i32 axis)
+		: UiLayout()
+		, m_axis(axis)
+	{
+	}
+
+	UiBoxLayout::~UiBoxLayout()
+	{
+	}
+
+	void UiBoxLayout::bindMethods()
+	{
+		CLASS_BIND_METHOD(UiBoxLayout, getJustify);
+		CLASS_BIND_METHOD(UiBoxLayout, setJustify);
+		CLASS_BIND_METHOD(UiBoxLayout, isFill);
+		CLASS_BIND_METHOD(UiBoxLayout, setFill);
+
+		CLASS_REGISTER_PROPERTY(UiBoxLayout, "Justify", Variant::Type::StringOption, getJustify, setJustify);
+		CLASS_REGISTER_PROPERTY(UiBoxLayout, "Fill", Variant::Type::Bool, isFill, setFill);
+	}
+
+	StringOption UiBoxLayout::getJustify() const
+	{
+		return StringOption::fromEnum(m_justify);
+	}
+
+	void UiBoxLayout::setJustify(const StringOption& option)
+	{
+		Justify justify = option.toEnum(Justify::Start);
+		if (m_justify != justify)
+		{
+			m_justify = justify;
+			markLayoutDirty();
+		}
+	}
+
+	void UiBoxLayout::setFill(bool isFill)
+	{
+		if (m_isFill != isFill)
+		{
+			m_isFill = isFill;
+			markLayoutDirty();
+		}
+	}
+
+	Vector2 UiBoxLayout::measureItems(ItemArray& items)
+	{
+		const i32 main = m_axis;
+		const i32 cross = 1 - m_axis;
+
+		Vector2 result = Vector2::ZERO;
+		for (const Item& item : items)
+		{
+			result[main] += item.m_desiredSize[main];
+			result[cross] = std::max<float>(result[cross], item.m_desiredSize[cross]);
+		}
+
+		if (!items.empty())
+			result[main] += m_spacing * (items.size() - 1);
+
+		return result;
+	}
+
+	void UiBoxLayout::arrangeItems(ItemArray& items, const Vector2& contentSize)
+	{
+		if (items.empty())
+			return;
+
+		const i32 main = m_axis;
+		const i32 cross = 1 - m_axis;
+
+		// free space of the main axis
+		float used = m_spacing * (items.size() - 1);
+		i32   growCount = 0;
+		for (const Item& item : items)
+		{
+			used += item.m_desiredSize[main];
+			growCount += item.m_layout ? 1 : 0;
+		}
+
+		float freeSpace = std::max<float>(contentSize[main] - used, 0.f);
+		float grow = 0.f;
+		float cursor = 0.f;
+		float gap = m_spacing;
+		if (m_isFill && growCount)
+		{
+			grow = freeSpace / growCount;
+		}
+		else
+		{
+			switch (m_justify)
+			{
+			case Justify::Start:		break;
+			case Justify::Center:		cursor = freeSpace * 0.5f;	break;
+			case Justify::End:			cursor = freeSpace;			break;
+			case Justify::SpaceBetween:	gap += items.size() > 1 ? freeSpace / (items.size() - 1) : 0.f; break;
+			}
+		}
+
+		for (Item& item : items)
+		{
+			float mainSize = item.m_desiredSize[main] + (item.m_layout ? grow : 0.f);
+			item.m_position[main] = cursor;
+			item.m_size[main] = mainSize;
+
+			// only nested layouts can be stretched, leaf widgets keep their own size
+			Align align = (m_align == Align::Stretch && !item.m_layout) ? Align::Center : m_align;
+			alignInSlot(0.f, contentSize[cross], item.m_desiredSize[cross], align, item.m_position[cross], item.m_size[cross]);
+
+			cursor += mainSize + gap;
+		}
+	}
+}
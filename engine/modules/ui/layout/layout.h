@@ -0,0 +1,151 @@
+#pragma once
+
+#include "engine/core/scene/node.h"
+
+namespace Echo
+{
+	class UiLayout : public Node
+	{
+		ECHO_VIRTUAL_CLASS(UiLayout, Node)
+
+	public:
+		// Cross axis alignment of an item inside its slot
+		enum Align
+		{
+			Start,
+			Center,
+			End,
+			Stretch,
+		};
+
+		// Cached measure/arrange result of one child
+		struct Item
+		{
+			Node*		m_node = nullptr;
+			UiLayout*	m_layout = nullptr;				// not null if the child is a nested layout
+			Vector2		m_desiredSize = Vector2::ZERO;
+			Vector2		m_position = Vector2::ZERO;		// slot top left, relative to layout top left
+			Vector2		m_size = Vector2::ZERO;			// slot size
+		};
+		typedef vector<Item>::type ItemArray;
+
+	public:
+		UiLayout();
+		virtual ~UiLayout();
+
+		// Size (0 means fit content on that axis)
+		const Vector2& getSize() const { return m_size; }
+		void setSize(const Vector2& size);
+
+		// Spacing between items
+		float getSpacing() const { return m_spacing; }
+		void setSpacing(float spacing);
+
+		// Padding around the items
+		float getPadding() const { return m_padding; }
+		void setPadding(float padding);
+
+		// Align
+		StringOption getAlign() const;
+		void setAlign(const StringOption& option);
+
+		// Is layout dirty
+		bool isLayoutDirty() const { return m_isMeasureDirty || m_isArrangeDirty; }
+
+		// Mark this layout and all layout ancestors dirty
+		void markLayoutDirty();
+
+		// Mark the layout that owns this node dirty
+		static void markLayoutDirty(Node* node);
+
+		// Measure desired size, only dirty subtrees are measured again
+		const Vector2& measure();
+
+		// Arrange items into the final size, results are applied to node transforms in one batch
+		void arrange(const Vector2& finalSize);
+
+		// Final arranged size
+		const Vector2& getArrangedSize() const { return m_arrangedSize; }
+
+	protected:
+		// Update
+		virtual void updateInternal(float elapsedTime) override;
+
+		// Children changed
+		virtual void onChildrenChanged() override;
+
+		// Compute desired size of the items (without padding)
+		virtual Vector2 measureItems(ItemArray& items) { return Vector2::ZERO; }
+
+		// Compute slot of every item inside content size (without padding)
+		virtual void arrangeItems(ItemArray& items, const Vector2& contentSize) {}
+
+		// Place an item of desired size inside slot on the cross axis
+		static void alignInSlot(float slotStart, float slotSize, float desired, Align align, float& oStart, float& oSize);
+
+	private:
+		// Is parent a layout
+		bool isNestedLayout() const;
+
+		// Collect enabled children
+		void collectItems();
+
+		// Apply item slots to node transforms
+		void applyItems();
+
+		// Size query of a leaf child
+		static Vector2 measureNode(Node* node);
+
+	protected:
+		Vector2				m_size = Vector2::ZERO;
+		float				m_spacing = 0.f;
+		float				m_padding = 0.f;
+		Align				m_align = Align::Center;
+		bool				m_isMeasureDirty = true;
+		bool				m_isArrangeDirty = true;
+		bool				m_isItemsDirty = true;
+		bool				m_isApplying = false;
+		ItemArray			m_items;
+		Vector2				m_desiredSize = Vector2::ZERO;
+		Vector2				m_arrangedSize = Vector2::INVALID;
+	};
+
+	class UiBoxLayout : public UiLayout
+	{
+		ECHO_VIRTUAL_CLASS(UiBoxLayout, UiLayout)
+
+	public:
+		// Main axis distribution of free space
+		enum Justify
+		{
+			Start,
+			Center,
+			End,
+			SpaceBetween,
+		};
+
+	public:
+		UiBoxLayout(i32 axis = 0);
+		virtual ~UiBoxLayout();
+
+		// Justify
+		StringOption getJustify() const;
+		void setJustify(const StringOption& option);
+
+		// Fill, free space of main axis is shared by nested layouts (flex grow)
+		bool isFill() const { return m_isFill; }
+		void setFill(bool isFill);
+
+	protected:
+		// Measure
+		virtual Vector2 measureItems(ItemArray& items) override;
+
+		// Arrange
+		virtual void arrangeItems(ItemArray& items, const Vector2& contentSize) override;
+
+	protected:
+		i32					m_axis = 0;			// 0 horizontal, 1 vertical
+		Justify				m_justify = Justify::Start;
+		bool				m_isFill = false;
+	};
+}
@@ -0,0 +1,17 @@
+#include "vertical_layout.h"
+
+namespace Echo
+{
+	UiVerticalLayout::UiVerticalLayout()
+		: UiBoxLayout(1)
+	{
+	}
+
+	UiVerticalLayout::~UiVerticalLayout()
+	{
+	}
+
+	void UiVerticalLayout::bindMethods()
+	{
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "layout.h"
+
+namespace Echo
+{
+	class UiVerticalLayout : public UiBoxLayout
+	{
+		ECHO_CLASS(UiVerticalLayout, UiBoxLayout)
+
+	public:
+		UiVerticalLayout();
+		virtual ~UiVerticalLayout();
+	};
+}
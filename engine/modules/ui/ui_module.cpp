@@ -13,6 +13,10 @@
 #include "event/gesture/tap_gesture_recognizer.h"
 #include "base/text.h"
 #include "base/image.h"
+#include "layout/horizontal_layout.h"
+#include "layout/vertical_layout.h"
+#include "layout/grid_layout.h"
+#include "layout/form_layout.h"
 #include "font/font_library.h"
 #include "editor/text_editor.h"
 #include "editor/image_editor.h"
@@ -61,6 +65,12 @@ namespace Echo
 		Class::registerType<UiRender>();
         Class::registerType<UiText>();
         Class::registerType<UiImage>();
+		Class::registerType<UiLayout>();
+		Class::registerType<UiBoxLayout>();
+		Class::registerType<UiHorizontalLayout>();
+		Class::registerType<UiVerticalLayout>();
+		Class::registerType<UiGridLayout>();
+		Class::registerType<UiFormLayout>();
 
 		CLASS_REGISTER_EDITOR(UiText, UiTextEditor)
 		CLASS_REGISTER_EDITOR(UiImage, UiImageEditor)
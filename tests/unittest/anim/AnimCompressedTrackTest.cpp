@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <engine/modules/anim/anim_compressed_track.h>
+
+namespace Echo
+{
+	// tolerances used by the gltf importer
+	static const float TranslationTolerance = 0.0005f;
+	static const float RotationTolerance = 0.0005f;
+	static const float ScaleTolerance = 0.0005f;
+
+	static const i32 KeyCount = 300;
+	static const ui32 KeyInterval = 33;
+
+	static AnimCurve::TimeArray makeTimes()
+	{
+		AnimCurve::TimeArray times;
+		for (i32 i = 0; i < KeyCount; i++)
+			times.push_back(i * KeyInterval);
+
+		return times;
+	}
+
+	// max error of every channel at every source key
+	static float maxError(AnimCompressedTrack* track, const AnimCurve::TimeArray& times, const vector<float>::type& values, i32 channels)
+	{
+		float result = 0.f;
+		i32 cursor = 0;
+		for (size_t i = 0; i < times.size(); i++)
+		{
+			float sampled[4];
+			track->sample(times[i], sampled, cursor);
+			for (i32 c = 0; c < channels; c++)
+				result = std::max<float>(result, std::abs(sampled[c] - values[i * channels + c]));
+		}
+
+		return result;
+	}
+
+	TEST(AnimCompressedTrack, Translation)
+	{
+		// a short range stays quantized, a range of 100 m can't be within half a millimeter in 16 bit
+		AnimCurve::TimeArray times = makeTimes();
+		vector<float>::type values;
+		for (i32 i = 0; i < KeyCount; i++)
+		{
+			float t = float(i) / float(KeyCount);
+			values.insert(values.end(), { t * 100.f, std::sin(t * 6.f), std::sin(t * 40.f) * 0.3f });
+		}
+
+		AnimCompressedTrack* track = AnimCompressedTrack::compress(times, values.data(), 3, AnimCurve::InterpolationType::Linear, KeyCount * KeyInterval, TranslationTolerance);
+		ASSERT_TRUE(track != nullptr);
+		EXPECT_EQ(track->m_rawChannels, 1u);
+		EXPECT_LT(track->m_times.size(), times.size());
+		EXPECT_LE(maxError(track, times, values, 3), TranslationTolerance);
+
+		EchoSafeDelete(track, AnimCompressedTrack);
+	}
+
+	TEST(AnimCompressedTrack, Scale)
+	{
+		AnimCurve::TimeArray times = makeTimes();
+		vector<float>::type values;
+		for (i32 i = 0; i < KeyCount; i++)
+		{
+			float scale = 1.f + 0.5f * std::sin(float(i) * 0.05f);
+			values.insert(values.end(), { scale, scale, 1.f });
+		}
+
+		AnimCompressedTrack* track = AnimCompressedTrack::compress(times, values.data(), 3, AnimCurve::InterpolationType::Linear, KeyCount * KeyInterval, ScaleTolerance);
+		ASSERT_TRUE(track != nullptr);
+		EXPECT_EQ(track->m_rawChannels, 0u);
+		EXPECT_LE(maxError(track, times, values, 3), ScaleTolerance);
+
+		EchoSafeDelete(track, AnimCompressedTrack);
+	}
+
+	// angle between two rotations, well conditioned for small angles
+	static double angleBetween(const Quaternion& a, const Quaternion& b)
+	{
+		double sign = a.dot(b) < 0.f ? -1.0 : 1.0;
+		double diff = 0.0;
+		double sum = 0.0;
+		for (i32 c = 0; c < 4; c++)
+		{
+			diff += (a.m[c] - sign * b.m[c]) * (a.m[c] - sign * b.m[c]);
+			sum += (a.m[c] + sign * b.m[c]) * (a.m[c] + sign * b.m[c]);
+		}
+
+		return 4.0 * std::atan2(std::sqrt(diff), std::sqrt(sum));
+	}
+
+	TEST(AnimCompressedTrack, Rotation)
+	{
+		AnimCurve::TimeArray times = makeTimes();
+		vector<Quaternion>::type values;
+		for (i32 i = 0; i < KeyCount; i++)
+		{
+			Vector3 axis(std::sin(float(i) * 0.02f), 1.f, 0.3f);
+			axis.normalize();
+
+			Quaternion q;
+			q.fromAxisAngle(axis, float(i) * 0.03f);
+			values.emplace_back(q);
+		}
+
+		AnimCompressedTrack* track = AnimCompressedTrack::compressRotations(times, values.data(), KeyCount * KeyInterval, RotationTolerance);
+		ASSERT_TRUE(track != nullptr);
+
+		i32 cursor = 0;
+		for (i32 i = 0; i < KeyCount; i++)
+		{
+			Quaternion sampled;
+			track->sample(times[i], sampled, cursor);
+
+			EXPECT_LE(angleBetween(sampled, values[i]), RotationTolerance);
+		}
+
+		EchoSafeDelete(track, AnimCompressedTrack);
+
+		// quantization alone misses a tolerance this tight, the source keys are kept
+		EXPECT_TRUE(AnimCompressedTrack::compressRotations(times, values.data(), KeyCount * KeyInterval, 1e-6f) == nullptr);
+	}
+}
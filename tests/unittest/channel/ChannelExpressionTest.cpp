@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <engine/core/base/channel.h>
+#include <engine/core/base/channel_expression.h>
+#include <engine/core/scene/node.h>
+
+namespace Echo
+{
+	// root with the children a, b and c
+	struct ChannelTestScene
+	{
+		Node*	m_root;
+		Node*	m_a;
+		Node*	m_b;
+		Node*	m_c;
+
+		ChannelTestScene()
+		{
+			Class::registerType<Node>();
+
+			m_root = createNode("root", nullptr);
+			m_a = createNode("a", m_root);
+			m_b = createNode("b", m_root);
+			m_c = createNode("c", m_root);
+		}
+
+		~ChannelTestScene()
+		{
+			freeNode(m_c);
+			freeNode(m_b);
+			freeNode(m_a);
+			freeNode(m_root);
+		}
+
+		static Node* createNode(const char* name, Node* parent)
+		{
+			Node* node = EchoNew(Node);
+			node->setName(name);
+			if (parent)
+				parent->addChild(node);
+
+			return node;
+		}
+
+		static void freeNode(Node*& node)
+		{
+			if (node)
+			{
+				node->remove();
+				EchoSafeDelete(node, Node);
+			}
+		}
+	};
+
+	TEST(ChannelExpression, Parse)
+	{
+		ChannelExpression expression;
+		ASSERT_TRUE(expression.compile("ch(\"../a\", \"Position\").y * 2 + ch( '../b' , 'Enable' )"));
+
+		const ChannelExpression::InputArray& inputs = expression.getInputs();
+		ASSERT_EQ(inputs.size(), 2u);
+		EXPECT_EQ(inputs[0].m_path, "../a");
+		EXPECT_EQ(inputs[0].m_propertyName, "Position");
+		EXPECT_EQ(inputs[0].m_component, 1);
+		EXPECT_EQ(inputs[1].m_path, "../b");
+		EXPECT_EQ(inputs[1].m_propertyName, "Enable");
+		EXPECT_EQ(inputs[1].m_component, -1);
+
+		// malformed references
+		EXPECT_FALSE(ChannelExpression().compile("ch(\"../a\")"));
+		EXPECT_FALSE(ChannelExpression().compile("ch(\"../a\", \"Position\""));
+		EXPECT_FALSE(ChannelExpression().compile("ch(../a, Position)"));
+	}
+
+	TEST(ChannelExpression, Components)
+	{
+		const char* names[] = { "x", "y", "z", "w", "r", "g", "b", "a" };
+		for (i32 i = 0; i < 8; i++)
+		{
+			ChannelExpression expression;
+			ASSERT_TRUE(expression.compile(StringUtil::Format("ch(\"../a\", \"Position\").%s + 1", names[i])));
+			EXPECT_EQ(expression.getInputs()[0].m_component, i % 4);
+		}
+
+		// a longer identifier isn't a component, tinyexpr fails on it
+		EXPECT_FALSE(ChannelExpression().compile("ch(\"../a\", \"Position\").xy"));
+	}
+
+	TEST(ChannelExpression, Dedup)
+	{
+		ChannelExpression same;
+		ASSERT_TRUE(same.compile("ch(\"../a\", \"Position\").x * ch(\"../a\", \"Position\").x"));
+		EXPECT_EQ(same.getInputs().size(), 1u);
+
+		ChannelExpression components;
+		ASSERT_TRUE(components.compile("ch(\"../a\", \"Position\").x + ch(\"../a\", \"Position\").y + ch(\"../b\", \"Position\").x"));
+		EXPECT_EQ(components.getInputs().size(), 3u);
+	}
+
+	TEST(ChannelExpression, Passthrough)
+	{
+		ChannelExpression single;
+		ASSERT_TRUE(single.compile(" ch(\"../a\", \"Position\") "));
+		EXPECT_TRUE(single.isPassthrough());
+
+		ChannelExpression arithmetic;
+		ASSERT_TRUE(arithmetic.compile("ch(\"../a\", \"Enable\") + 0"));
+		EXPECT_FALSE(arithmetic.isPassthrough());
+
+		ChannelExpression component;
+		ASSERT_TRUE(component.compile("ch(\"../a\", \"Position\").x"));
+		EXPECT_FALSE(component.isPassthrough());
+	}
+
+	TEST(ChannelExpression, LuaOperators)
+	{
+		// evaluated by lua, tinyexpr gives -2^2 = 4 and 2^3^2 = 64
+		EXPECT_FALSE(ChannelExpression().compile("-2^2"));
+		EXPECT_FALSE(ChannelExpression().compile("2^3^2"));
+		EXPECT_FALSE(ChannelExpression().compile("-5 % 3"));
+
+		ChannelExpression negate;
+		ASSERT_TRUE(negate.compile("-(1 + 2) * 3"));
+
+		Variant result;
+		ASSERT_TRUE(negate.evaluate(Variant::Type::Real, result));
+		EXPECT_EQ(result.toDouble(), -9.0);
+	}
+
+	TEST(ChannelExpression, ChangeDetection)
+	{
+		ChannelTestScene scene;
+		scene.m_a->setLocalPosition(Vector3(1.f, 2.f, 3.f));
+
+		ChannelExpression expression;
+		ASSERT_TRUE(expression.compile("ch(\"../a\", \"Position\").y * 2"));
+		ASSERT_TRUE(expression.resolve(scene.m_b));
+
+		Variant result;
+		EXPECT_TRUE(expression.readInputs());
+		ASSERT_TRUE(expression.evaluate(Variant::Type::Real, result));
+		EXPECT_EQ(result.toDouble(), 4.0);
+
+		// nothing changed
+		EXPECT_FALSE(expression.readInputs());
+
+		scene.m_a->setLocalPosition(Vector3(1.f, 5.f, 3.f));
+		EXPECT_TRUE(expression.readInputs());
+		ASSERT_TRUE(expression.evaluate(Variant::Type::Real, result));
+		EXPECT_EQ(result.toDouble(), 10.0);
+
+		// a freed node unresolves the input, a missing one never resolves
+		ChannelTestScene::freeNode(scene.m_a);
+		expression.readInputs();
+		EXPECT_FALSE(expression.isResolved());
+
+		ChannelExpression missing;
+		ASSERT_TRUE(missing.compile("ch(\"../missing\", \"Position\").x"));
+		EXPECT_FALSE(missing.resolve(scene.m_b));
+	}
+
+	TEST(Channel, DependencyOrder)
+	{
+		ChannelTestScene scene;
+
+		// registered before the channel it reads, still synced after it in one pass
+		scene.m_c->registerChannel("Position", "ch(\"../b\", \"Position\")");
+		scene.m_b->registerChannel("Position", "ch(\"../a\", \"Position\")");
+
+		scene.m_a->setLocalPosition(Vector3(1.f, 2.f, 3.f));
+		Channel::syncAll();
+		EXPECT_TRUE(scene.m_c->getLocalPosition() == Vector3(1.f, 2.f, 3.f));
+
+		scene.m_a->setLocalPosition(Vector3(4.f, 5.f, 6.f));
+		Channel::syncAll();
+		EXPECT_TRUE(scene.m_b->getLocalPosition() == Vector3(4.f, 5.f, 6.f));
+		EXPECT_TRUE(scene.m_c->getLocalPosition() == Vector3(4.f, 5.f, 6.f));
+
+		scene.m_c->unregisterChannels();
+		scene.m_b->unregisterChannels();
+	}
+}
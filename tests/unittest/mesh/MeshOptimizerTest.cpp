@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <engine/core/render/base/mesh/mesh_optimizer.h>
+#include <algorithm>
+#include <array>
+
+namespace Echo
+{
+	static const ui32 GridSize = 200;
+	static const ui32 CacheSize = 16;
+
+	typedef std::array<ui32, 3> Triangle;
+
+	// vertices with a position only
+	static void makeGridVertices(MeshVertexData& vertexData, ui32 count)
+	{
+		MeshVertexFormat format;
+		vertexData.set(format, count);
+	}
+
+	// grid of quads, vertex x + y * (GridSize + 1) is at (x, 0, y)
+	static void makeGrid(MeshVertexData& vertexData, vector<ui32>::type& indices)
+	{
+		ui32 row = GridSize + 1;
+		makeGridVertices(vertexData, row * row);
+		for (ui32 y = 0; y < row; y++)
+		{
+			for (ui32 x = 0; x < row; x++)
+				vertexData.setPosition(x + y * row, Vector3(float(x), 0.f, float(y)));
+		}
+
+		indices.clear();
+		for (ui32 y = 0; y < GridSize; y++)
+		{
+			for (ui32 x = 0; x < GridSize; x++)
+			{
+				ui32 v = x + y * row;
+				indices.insert(indices.end(), { v, v + row, v + 1, v + 1, v + row, v + row + 1 });
+			}
+		}
+	}
+
+	// triangles in a random order, the worst case for the cache
+	static void shuffleTriangles(vector<ui32>::type& indices)
+	{
+		ui32 seed = 12345;
+		for (ui32 t = ui32(indices.size() / 3) - 1; t > 0; t--)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			ui32 other = (seed >> 8) % (t + 1);
+			for (ui32 i = 0; i < 3; i++)
+				std::swap(indices[t * 3 + i], indices[other * 3 + i]);
+		}
+	}
+
+	// triangles by grid vertex, rotated to start at the smallest one so winding is kept
+	static vector<Triangle>::type gridTriangles(MeshVertexData& vertexData, const vector<ui32>::type& indices)
+	{
+		vector<Triangle>::type result;
+		for (size_t t = 0; t < indices.size(); t += 3)
+		{
+			Triangle triangle;
+			for (ui32 i = 0; i < 3; i++)
+			{
+				const Vector3& position = vertexData.getPosition(indices[t + i]);
+				triangle[i] = ui32(position.x) + ui32(position.z) * (GridSize + 1);
+			}
+
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			result.emplace_back(triangle);
+		}
+
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	TEST(MeshOptimizer, WeldVertices)
+	{
+		MeshVertexData grid;
+		vector<ui32>::type gridIndices;
+		makeGrid(grid, gridIndices);
+
+		// every triangle with its own vertices
+		MeshVertexData vertexData;
+		vector<ui32>::type indices(gridIndices.size());
+		makeGridVertices(vertexData, ui32(gridIndices.size()));
+		for (ui32 i = 0; i < gridIndices.size(); i++)
+		{
+			vertexData.setPosition(i, grid.getPosition(gridIndices[i]));
+			indices[i] = i;
+		}
+
+		ui32 vertexCount = MeshOptimizer::weldVertices(vertexData, indices);
+		EXPECT_EQ(vertexCount, (GridSize + 1) * (GridSize + 1));
+		EXPECT_EQ(vertexData.getVertexCount(), vertexCount);
+		EXPECT_TRUE(gridTriangles(vertexData, indices) == gridTriangles(grid, gridIndices));
+	}
+
+	TEST(MeshOptimizer, OptimizeVertexCache)
+	{
+		MeshVertexData vertexData;
+		vector<ui32>::type indices;
+		makeGrid(vertexData, indices);
+		shuffleTriangles(indices);
+
+		vector<Triangle>::type triangles = gridTriangles(vertexData, indices);
+		float acmrBefore = MeshOptimizer::calcACMR(indices, vertexData.getVertexCount(), CacheSize);
+
+		vector<ui32>::type clusters;
+		MeshOptimizer::optimizeVertexCache(indices, vertexData.getVertexCount(), CacheSize, clusters);
+		float acmrAfter = MeshOptimizer::calcACMR(indices, vertexData.getVertexCount(), CacheSize);
+
+		// a vertex is shared by six triangles, 0.5 is the lower bound
+		EXPECT_GT(acmrBefore, 2.5f);
+		EXPECT_LT(acmrAfter, 0.7f);
+		EXPECT_TRUE(gridTriangles(vertexData, indices) == triangles);
+
+		ASSERT_FALSE(clusters.empty());
+		EXPECT_EQ(clusters[0], 0u);
+		EXPECT_TRUE(std::is_sorted(clusters.begin(), clusters.end()));
+	}
+
+	TEST(MeshOptimizer, OptimizeVertexFetch)
+	{
+		MeshVertexData grid;
+		vector<ui32>::type indices;
+		makeGrid(grid, indices);
+		shuffleTriangles(indices);
+
+		// one more vertex that is never used and gets dropped
+		ui32 gridVertexCount = grid.getVertexCount();
+		MeshVertexData vertexData;
+		makeGridVertices(vertexData, gridVertexCount + 1);
+		for (ui32 i = 0; i < gridVertexCount; i++)
+			vertexData.setPosition(i, grid.getPosition(i));
+
+		vertexData.setPosition(gridVertexCount, Vector3(-1.f, 0.f, -1.f));
+
+		vector<Triangle>::type triangles = gridTriangles(vertexData, indices);
+		MeshOptimizer::optimizeVertexFetch(vertexData, indices);
+		EXPECT_EQ(vertexData.getVertexCount(), gridVertexCount);
+		EXPECT_TRUE(gridTriangles(vertexData, indices) == triangles);
+
+		// vertices are numbered by first use
+		ui32 next = 0;
+		for (ui32 index : indices)
+		{
+			ASSERT_LE(index, next);
+			if (index == next)
+				next++;
+		}
+	}
+}
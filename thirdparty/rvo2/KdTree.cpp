@@ -37,7 +37,7 @@
 #include "Obstacle.h"
 
 namespace RVO {
-	KdTree::KdTree(RVOSimulator *sim) : obstacleTree_(NULL), sim_(sim) { }
+	KdTree::KdTree(RVOSimulator *sim) : obstacleTree_(NULL), sim_(sim), isAgentsDirty_(false), refitCount_(0), rebuildInterval_(1) { }
 
 	KdTree::~KdTree()
 	{
@@ -46,16 +46,60 @@ namespace RVO {
 
 	void KdTree::buildAgentTree()
 	{
-		if (agents_.size() < sim_->agents_.size()) {
+		bool isRebuild = false;
+		if (isAgentsDirty_) {
+			/* Agents removed, start over from the simulator order. */
+			agents_ = sim_->agents_;
+			agentTree_.resize(agents_.empty() ? 0 : 2 * agents_.size() - 1);
+			isAgentsDirty_ = false;
+			isRebuild = true;
+		}
+		else if (agents_.size() < sim_->agents_.size()) {
 			for (size_t i = agents_.size(); i < sim_->agents_.size(); ++i) {
 				agents_.push_back(sim_->agents_[i]);
 			}
 
 			agentTree_.resize(2 * agents_.size() - 1);
+			isRebuild = true;
 		}
 
 		if (!agents_.empty()) {
-			buildAgentTreeRecursive(0, agents_.size(), 0);
+			/* Agents move little per step, so the tree is refit in between
+			 * rebuilds. A rebuild partitions the previous order in place. */
+			if (isRebuild || ++refitCount_ >= rebuildInterval_) {
+				buildAgentTreeRecursive(0, agents_.size(), 0);
+				refitCount_ = 0;
+			}
+			else {
+				refitAgentTreeRecursive(0);
+			}
+		}
+	}
+
+	void KdTree::refitAgentTreeRecursive(size_t node)
+	{
+		AgentTreeNode &treeNode = agentTree_[node];
+		if (treeNode.end - treeNode.begin <= MAX_LEAF_SIZE) {
+			treeNode.minX = treeNode.maxX = agents_[treeNode.begin]->position_.x();
+			treeNode.minY = treeNode.maxY = agents_[treeNode.begin]->position_.y();
+
+			for (size_t i = treeNode.begin + 1; i < treeNode.end; ++i) {
+				treeNode.maxX = std::max(treeNode.maxX, agents_[i]->position_.x());
+				treeNode.minX = std::min(treeNode.minX, agents_[i]->position_.x());
+				treeNode.maxY = std::max(treeNode.maxY, agents_[i]->position_.y());
+				treeNode.minY = std::min(treeNode.minY, agents_[i]->position_.y());
+			}
+		}
+		else {
+			refitAgentTreeRecursive(treeNode.left);
+			refitAgentTreeRecursive(treeNode.right);
+
+			const AgentTreeNode &left = agentTree_[treeNode.left];
+			const AgentTreeNode &right = agentTree_[treeNode.right];
+			treeNode.minX = std::min(left.minX, right.minX);
+			treeNode.maxX = std::max(left.maxX, right.maxX);
+			treeNode.minY = std::min(left.minY, right.minY);
+			treeNode.maxY = std::max(left.maxY, right.maxY);
 		}
 	}
 
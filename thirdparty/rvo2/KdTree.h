@@ -132,6 +132,13 @@ namespace RVO {
 
 		void buildAgentTreeRecursive(size_t begin, size_t end, size_t node);
 
+		/**
+		 * \brief      Recomputes the bounds of the agent <i>k</i>d-tree nodes
+		 *             bottom up, keeping its topology. Queries stay exact, only
+		 *             their cost grows as agents drift from their split.
+		 */
+		void refitAgentTreeRecursive(size_t node);
+
 		/**
 		 * \brief      Builds an obstacle <i>k</i>d-tree.
 		 */
@@ -192,6 +199,9 @@ namespace RVO {
 		std::vector<AgentTreeNode> agentTree_;
 		ObstacleTreeNode *obstacleTree_;
 		RVOSimulator *sim_;
+		bool isAgentsDirty_;
+		size_t refitCount_;
+		size_t rebuildInterval_;
 
 		static const size_t MAX_LEAF_SIZE = 10;
 
@@ -157,6 +157,27 @@ namespace RVO {
 		return obstacleNo;
 	}
 
+	void RVOSimulator::removeAgent(size_t agentNo)
+	{
+		if (agentNo < agents_.size()) {
+			delete agents_[agentNo];
+
+			if (agentNo + 1 < agents_.size()) {
+				agents_[agentNo] = agents_.back();
+				agents_[agentNo]->id_ = agentNo;
+			}
+
+			agents_.pop_back();
+
+			kdTree_->isAgentsDirty_ = true;
+		}
+	}
+
+	void RVOSimulator::setAgentTreeRebuildInterval(size_t interval)
+	{
+		kdTree_->rebuildInterval_ = std::max<size_t>(interval, 1);
+	}
+
 	void RVOSimulator::doStep()
 	{
 		kdTree_->buildAgentTree();
@@ -205,6 +205,19 @@ namespace RVO {
 		 */
 		size_t addObstacle(const std::vector<Vector2> &vertices);
 
+		/**
+		 * \brief      Removes an agent. The last agent takes its number.
+		 * \param      agentNo         The number of the agent to remove.
+		 */
+		void removeAgent(size_t agentNo);
+
+		/**
+		 * \brief      Sets how many simulation steps the agent <i>k</i>d-tree is
+		 *             refit in place before it is rebuilt, 1 rebuilds every step.
+		 * \param      interval        The number of steps between rebuilds.
+		 */
+		void setAgentTreeRebuildInterval(size_t interval);
+
 		/*
 		 * get all agents 
 		 */